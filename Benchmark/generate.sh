@@ -0,0 +1,111 @@
+#!/bin/bash
+# Generates a parameterized MathDH workload and writes it to STDOUT.
+#
+# Usage: bash Benchmark/generate.sh KIND SIZE [ITERATIONS]
+#
+#   nested       SIZE nested while loops with ITERATIONS iterations each
+#   chain        loop with ITERATIONS iterations over an arithmetic chain of
+#                SIZE terms
+#   branchy      loop with ITERATIONS iterations over SIZE if/else statements
+#   declarations SIZE declarations, each initialized from its predecessor
+#   statements   SIZE straight-line assignments on a few variables
+
+KIND=$1
+SIZE=$2
+ITERATIONS=${3:-10}
+
+if [ -z "${KIND}" ] || [ -z "${SIZE}" ]
+then
+    echo "Usage: $0 KIND SIZE [ITERATIONS]" >&2
+    exit 1
+fi
+
+echo "# Generated workload: ${KIND} ${SIZE} ${ITERATIONS}"
+
+case "${KIND}" in
+    nested)
+        echo -n "int S = 0"
+        for ((i = 1; i <= SIZE; i++))
+        do
+            echo -n ", I${i} = 0"
+        done
+        echo ";"
+
+        for ((i = 1; i <= SIZE; i++))
+        do
+            printf "%*sI${i} = 0;\n" $((4 * (i - 1))) ""
+            printf "%*swhile (I${i} < ${ITERATIONS}) do\n" $((4 * (i - 1))) ""
+        done
+        printf "%*sS = S + 1;\n" $((4 * SIZE)) ""
+        for ((i = SIZE; i >= 1; i--))
+        do
+            printf "%*s++I${i};\n" $((4 * i)) ""
+            printf "%*send;\n" $((4 * (i - 1))) ""
+        done
+        echo "exit S;"
+        ;;
+
+    chain)
+        echo "int I = 0, A = 1, B = 2, C = 3, X = 0;"
+        echo "while (I < ${ITERATIONS}) do"
+        echo -n "    X = A"
+        for ((i = 1; i < SIZE; i++))
+        do
+            case $((i % 4)) in
+                0) echo -n " + A" ;;
+                1) echo -n " - B" ;;
+                2) echo -n " + C * 3" ;;
+                3) echo -n " - A % 7" ;;
+            esac
+        done
+        echo ";"
+        echo "    A = B;"
+        echo "    B = C;"
+        echo "    C = X % 1000;"
+        echo "    ++I;"
+        echo "end;"
+        echo "exit C;"
+        ;;
+
+    branchy)
+        echo "int I = 0, S = 0;"
+        echo "while (I < ${ITERATIONS}) do"
+        for ((i = 1; i <= SIZE; i++))
+        do
+            echo "    if (I % $((i % 7 + 2)) == $((i % 2))) then"
+            echo "        S = S + ${i};"
+            echo "    else"
+            echo "        S = S - 1;"
+            echo "    end;"
+        done
+        echo "    ++I;"
+        echo "end;"
+        echo "exit S;"
+        ;;
+
+    declarations)
+        echo "int V1 = 1;"
+        awk -v size=${SIZE} 'BEGIN {
+            for (i = 2; i <= size; i++) printf "int V%d = V%d + 1;\n", i, i - 1
+        }'
+        echo "exit V${SIZE};"
+        ;;
+
+    statements)
+        echo "int A = 1, B = 2, C = 3;"
+        awk -v size=${SIZE} 'BEGIN {
+            for (i = 1; i <= size; i++)
+            {
+                if (i % 3 == 1) print "A = B + C % 7;"
+                else if (i % 3 == 2) print "B = A - C;"
+                else print "C = A * 2 % 1000;"
+            }
+        }'
+        echo "exit C;"
+        ;;
+
+    *)
+        echo "Unknown workload: ${KIND}" >&2
+        exit 1
+        ;;
+esac
@@ -0,0 +1,275 @@
+#!/bin/bash
+# Measures the execution time of every intermediate code operation (per type
+# combination) in the interpreter and compares it against a stored baseline.
+#
+# Usage: bash Benchmark/microbenchmark.sh record FILE  [-r REPEATS] [COMPILER OPTIONS]
+#        bash Benchmark/microbenchmark.sh compare FILE [-r REPEATS] [-t PERCENT] [COMPILER OPTIONS]
+#
+#   record   runs all microbenchmarks and stores the results as baseline JSON
+#   compare  runs all microbenchmarks and compares them against the baseline;
+#            exits with 1 if an operation is slower by more than PERCENT
+#            (default: 10) and the difference is significant (one-sided Welch
+#            t-test, 95%)
+#
+# Every microbenchmark is a while loop executing STATEMENTS copies of one
+# statement. The time per operation is the CPU time of runCode minus the time
+# of the empty loop, divided by the number of executed statements. Statements
+# which need an assignment to store their result (e.g. C = A + B) are measured
+# without the cost of the assignment itself. Writing the execution output
+# (3_execution) is part of every operation.
+# The optimizer (-O) is rejected: it fuses, folds or replaces the measured
+# statements and even the loop itself by closed-form updates (also for a
+# loop bound read from an input), so nothing of the operation would remain.
+# Requires a compiler built by build.sh.
+
+MODE=$1
+BASELINE=$2
+if [ "${MODE}" != "record" ] && [ "${MODE}" != "compare" ] || [ -z "${BASELINE}" ]
+then
+    echo "Usage: $0 record|compare FILE [-r REPEATS] [-t PERCENT] [COMPILER OPTIONS]" >&2
+    exit 1
+fi
+BASELINE=$(realpath -m "${BASELINE}")
+shift 2
+
+REPEATS=5
+THRESHOLD=10
+OPTIONS=()
+while [ $# -gt 0 ]
+do
+    case "$1" in
+        -r) REPEATS=$2; shift ;;
+        -t) THRESHOLD=$2; shift ;;
+        -O) echo "The optimizer would remove the measured operations" >&2
+            exit 1 ;;
+        *) OPTIONS+=("$1") ;;
+    esac
+    shift
+done
+
+ITERATIONS=1000
+STATEMENTS=20
+
+ROOT_DIR=$(cd "$(dirname "$0")/.." && pwd)
+COMPILER=${ROOT_DIR}/bin/compiler
+if [ ! -x "${COMPILER}" ]
+then
+    echo "Compiler not found, run build.sh first" >&2
+    exit 1
+fi
+if [ "${MODE}" == "compare" ] && [ ! -f "${BASELINE}" ]
+then
+    echo "Baseline ${BASELINE} not found" >&2
+    exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+# Microbenchmarks: name|statement|reference
+# The time of the reference is subtracted ("loop" is the empty loop).
+BENCHMARKS=(
+    "loop||loop"
+    "OP_ASSIGN(INTEGER)|C = A;|loop"
+    "OP_ASSIGN(REAL)|Z = X;|loop"
+    "OP_ASSIGN(BOOLEAN)|R = P;|loop"
+    "OP_INT_CONSTANT|C = 5;|OP_ASSIGN(INTEGER)"
+    "OP_FLOAT_CONSTANT|Z = 2.5;|OP_ASSIGN(REAL)"
+    "OP_BOOL_CONSTANT|R = true;|OP_ASSIGN(BOOLEAN)"
+    "OP_INCREMENT(INTEGER)|++C;|loop"
+    "OP_DECREMENT(INTEGER)|--C;|loop"
+)
+for op in "PLUS +" "MINUS -" "MULTIPLY *" "DIVIDE /"
+do
+    read operation symbol <<< "${op}"
+    BENCHMARKS+=(
+        "OP_${operation}(INTEGER,INTEGER)|C = A ${symbol} B;|OP_ASSIGN(INTEGER)"
+        "OP_${operation}(REAL,REAL)|Z = X ${symbol} Y;|OP_ASSIGN(REAL)"
+        "OP_${operation}(INTEGER,REAL)|Z = A ${symbol} Y;|OP_ASSIGN(REAL)"
+        "OP_${operation}(REAL,INTEGER)|Z = X ${symbol} B;|OP_ASSIGN(REAL)"
+    )
+done
+BENCHMARKS+=("OP_MODULO(INTEGER,INTEGER)|C = A % B;|OP_ASSIGN(INTEGER)")
+for op in "EQUAL ==" "NOT_EQUAL !=" "LESS_OR_EQUAL <=" "GREATER_OR_EQUAL >=" \
+          "GREATER >" "LESS <"
+do
+    read operation symbol <<< "${op}"
+    BENCHMARKS+=(
+        "OP_${operation}(INTEGER,INTEGER)|R = A ${symbol} B;|OP_ASSIGN(BOOLEAN)"
+        "OP_${operation}(REAL,REAL)|R = X ${symbol} Y;|OP_ASSIGN(BOOLEAN)"
+        "OP_${operation}(INTEGER,REAL)|R = A ${symbol} Y;|OP_ASSIGN(BOOLEAN)"
+    )
+done
+BENCHMARKS+=(
+    "OP_AND(BOOLEAN,BOOLEAN)|R = P and Q;|OP_ASSIGN(BOOLEAN)"
+    "OP_OR(BOOLEAN,BOOLEAN)|R = P or Q;|OP_ASSIGN(BOOLEAN)"
+    "OP_NOT(BOOLEAN)|R = not P;|OP_ASSIGN(BOOLEAN)"
+    "OP_IF(BOOLEAN)|if (P) then end;|loop"
+    "OP_IF(INTEGER<INTEGER)|if (A < B) then end;|loop"
+    "OP_WHILE(BOOLEAN)|while (Q) do end;|loop"
+)
+
+# Generate one program per microbenchmark
+rm -f "${WORK_DIR}/references"
+index=0
+for benchmark in "${BENCHMARKS[@]}"
+do
+    IFS='|' read name statement reference <<< "${benchmark}"
+    echo "${name} ${reference}" >> "${WORK_DIR}/references"
+    {
+        echo "int I = 0, A = 7, B = 3, C = 0;"
+        echo "float X = 2.5, Y = 1.5, Z = 0.0;"
+        echo "bool P = true, Q = false, R = false;"
+        echo "while (I < ${ITERATIONS}) do"
+        for ((i = 0; i < STATEMENTS; i++))
+        do
+            [ -n "${statement}" ] && echo "    ${statement}"
+        done
+        echo "    ++I;"
+        echo "end;"
+    } > "${WORK_DIR}/${index}.math"
+    index=$((index + 1))
+done
+
+# Run all microbenchmarks once per repeat to spread drift over all of them
+rm -f "${WORK_DIR}/results"
+for ((run = 1; run <= REPEATS; run++))
+do
+    index=0
+    for benchmark in "${BENCHMARKS[@]}"
+    do
+        name=${benchmark%%|*}
+        (cd "${WORK_DIR}" && "${COMPILER}" --stats "${OPTIONS[@]}" \
+            < "${index}.math" > stats 2>&1)
+        if [ $? -ne 0 ]
+        then
+            echo "${name}: compiler failed" >&2
+            exit 1
+        fi
+        awk -v run=${run} -v name="${name}" '
+            /^ Total/ { phases = 1 }
+            !phases && $1 == "runCode" { print run, name, $3 }
+            ' "${WORK_DIR}/stats" >> "${WORK_DIR}/results"
+        index=$((index + 1))
+    done
+done
+
+# Calculate the time per operation (in ns) of every run and store it as JSON
+awk -v operations=$((ITERATIONS * STATEMENTS)) -v repeats=${REPEATS} \
+    -v iterations=${ITERATIONS} -v statements=${STATEMENTS} \
+    -v options="${OPTIONS[*]}" '
+    FNR == NR { reference[$1] = $2; order[++count] = $1; next }
+    { time[$1, $2] = $3 }
+    END {
+        for (run = 1; run <= repeats; run++)
+        {
+            for (i = 1; i <= count; i++)
+            {
+                name = order[i]
+                raw[run, name] = (time[run, name] - time[run, "loop"]) * 1e6 / operations
+            }
+        }
+        printf "{\n  \"iterations\": %d,\n  \"statements\": %d,\n", iterations, statements
+        printf "  \"repeats\": %d,\n  \"options\": \"%s\",\n  \"operations\": {\n", repeats, options
+        first = 1
+        for (i = 1; i <= count; i++)
+        {
+            name = order[i]
+            if (name == "loop")
+            {
+                continue
+            }
+            sum = 0; sq = 0; samples = ""
+            for (run = 1; run <= repeats; run++)
+            {
+                ns = raw[run, name]
+                if (reference[name] != "loop")
+                {
+                    ns -= raw[run, reference[name]]
+                }
+                sum += ns; sq += ns * ns
+                samples = samples (run > 1 ? ", " : "") sprintf("%.3f", ns)
+            }
+            mean = sum / repeats
+            var = (repeats > 1) ? (sq - repeats * mean * mean) / (repeats - 1) : 0
+            printf "%s    \"%s\": {\"mean\": %.3f, \"stddev\": %.3f, \"samples\": [%s]}",
+                   first ? "" : ",\n", name, mean, sqrt(var > 0 ? var : 0), samples
+            first = 0
+        }
+        printf "\n  }\n}\n"
+    }' "${WORK_DIR}/references" "${WORK_DIR}/results" > "${WORK_DIR}/current.json"
+
+if [ "${MODE}" == "record" ]
+then
+    cp "${WORK_DIR}/current.json" "${BASELINE}"
+    echo "Baseline written to ${BASELINE}"
+    exit 0
+fi
+
+# Compare mean time per operation against the baseline
+awk -v threshold=${THRESHOLD} '
+    # One-sided critical values of the t distribution (95%) by degrees of freedom
+    function critical(df)
+    {
+        split("6.314 2.920 2.353 2.132 2.015 1.943 1.895 1.860 1.833 1.812 " \
+              "1.796 1.782 1.771 1.761 1.753 1.746 1.740 1.734 1.729 1.725 " \
+              "1.721 1.717 1.714 1.711 1.708 1.706 1.703 1.701 1.699 1.697", table, " ")
+        df = int(df)
+        if (df < 1) return table[1]
+        return (df <= 30) ? table[df] : 1.645
+    }
+    match($0, /"[^"]+": \{"mean"/) {
+        name = substr($0, RSTART + 1, RLENGTH - 11)
+        match($0, /"mean": [-0-9.]+/); mean = substr($0, RSTART + 8, RLENGTH - 8) + 0
+        match($0, /"stddev": [-0-9.]+/); dev = substr($0, RSTART + 10, RLENGTH - 10) + 0
+        match($0, /\[[^]]*\]/); n = split(substr($0, RSTART + 1, RLENGTH - 2), s, ",")
+        if (FNR == NR) { base[name] = mean; baseDev[name] = dev; baseN[name] = n }
+        else { order[++count] = name; cur[name] = mean; curDev[name] = dev; curN[name] = n }
+    }
+    END {
+        printf "%-36s %12s %12s %9s %8s  %s\n", "Operation", "Base [ns]", "Now [ns]", "Change", "t", "Status"
+        failed = 0
+        for (i = 1; i <= count; i++)
+        {
+            name = order[i]
+            if (!(name in base))
+            {
+                printf "%-36s %12s %12.3f %9s %8s  %s\n", name, "-", cur[name], "-", "-", "new"
+                continue
+            }
+            v0 = baseDev[name] ^ 2 / baseN[name]
+            v1 = curDev[name] ^ 2 / curN[name]
+            diff = cur[name] - base[name]
+            if (v0 + v1 > 0)
+            {
+                t = diff / sqrt(v0 + v1)
+                df = (v0 + v1) ^ 2 / ((baseN[name] > 1 ? v0 ^ 2 / (baseN[name] - 1) : 0) + \
+                                      (curN[name] > 1 ? v1 ^ 2 / (curN[name] - 1) : 0) + 1e-30)
+                significant = t > critical(df)
+                faster = -t > critical(df)
+            }
+            else
+            {
+                t = 0
+                significant = diff > 0
+                faster = diff < 0
+            }
+            change = (base[name] != 0) ? 100 * diff / (base[name] < 0 ? -base[name] : base[name]) : 0
+            status = "ok"
+            if (significant && change > threshold)
+            {
+                status = "REGRESSION"
+                failed++
+            }
+            else if (change < -threshold && faster)
+            {
+                status = "improved"
+            }
+            printf "%-36s %12.3f %12.3f %8.1f%% %8.2f  %s\n", name, base[name], cur[name], change, t, status
+        }
+        if (failed)
+        {
+            printf "%d operation(s) regressed by more than %s%%\n", failed, threshold
+            exit 1
+        }
+    }' "${BASELINE}" "${WORK_DIR}/current.json"
@@ -0,0 +1,143 @@
+#!/bin/bash
+# Measures how the front end (parser, symbol table, code generation and
+# printing) scales with the size of the source program.
+#
+# Usage: bash Benchmark/scaling.sh [-s START] [-m MAX] [-f FACTOR] [-l SECONDS]
+#                                  [-x EXPONENT] [COMPILER OPTIONS]
+#
+#   -s START     number of source lines of the smallest program (default: 10000)
+#   -m MAX       number of source lines of the largest program (default: 10000000)
+#   -f FACTOR    growth factor between two program sizes (default: 2)
+#   -l SECONDS   stop growing a workload once a run takes longer (default: 60)
+#   -x EXPONENT  growth exponent above which a measurement is flagged as
+#                super-linear (default: 1.2)
+#
+# For every workload (see Benchmark/generate.sh) and size the compiler is run
+# once in compile-only mode. The growth exponent of a measurement between two
+# sizes n1 < n2 is log(t2 / t1) / log(n2 / n1), i.e. 1 for linear and 2 for
+# quadratic behavior. Symbol table operations are measured by the number of
+# walked through entries and code generation by the number of calls, the
+# phases by their wall time.
+# Requires a compiler built by build.sh.
+
+START=10000
+MAX=10000000
+FACTOR=2
+LIMIT=60
+EXPONENT=1.2
+OPTIONS=()
+while [ $# -gt 0 ]
+do
+    case "$1" in
+        -s) START=$2; shift ;;
+        -m) MAX=$2; shift ;;
+        -f) FACTOR=$2; shift ;;
+        -l) LIMIT=$2; shift ;;
+        -x) EXPONENT=$2; shift ;;
+        *) OPTIONS+=("$1") ;;
+    esac
+    shift
+done
+
+ROOT_DIR=$(cd "$(dirname "$0")/.." && pwd)
+COMPILER=${ROOT_DIR}/bin/compiler
+if [ ! -x "${COMPILER}" ]
+then
+    echo "Compiler not found, run build.sh first" >&2
+    exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+MEASUREMENTS="yyparse[ms] symbol-table[steps] code-generation[calls]
+              printSymbolTable[ms] printCode[ms]"
+
+for workload in statements declarations
+do
+    echo "== ${workload} =="
+    printf "%10s" "Lines"
+    for measurement in ${MEASUREMENTS}
+    do
+        printf " %22s %6s" "${measurement}" "exp"
+    done
+    printf "\n"
+
+    rm -f "${WORK_DIR}/${workload}.results"
+    for ((size = START; size <= MAX; size *= FACTOR))
+    do
+        bash "${ROOT_DIR}/Benchmark/generate.sh" ${workload} ${size} \
+            > "${WORK_DIR}/program.math"
+
+        start=$(date +%s)
+        (cd "${WORK_DIR}" && "${COMPILER}" -c --stats "${OPTIONS[@]}" \
+            < program.math > stats 2>&1)
+        if [ $? -ne 0 ]
+        then
+            echo "${workload} ${size}: compiler failed" >&2
+            break
+        fi
+        elapsed=$(( $(date +%s) - start ))
+
+        # One line per size: lines and the value of every measurement
+        awk -v size=${size} '
+            /^ Total/ { phases = 1 }
+            !phases && $1 == "yyparse" { parse = $2 }
+            !phases && $1 == "printSymbolTable" { symbols = $2 }
+            !phases && $1 == "printCode" { code = $2 }
+            $1 == "symbol" && $2 == "table" { table = $4 }
+            $1 == "code" && $2 == "generation" { generation = $3 }
+            END { print size, parse, table, generation, symbols, code }
+            ' "${WORK_DIR}/stats" >> "${WORK_DIR}/${workload}.results"
+
+        # Print the measurements with the growth exponent to the previous size
+        tail -n 2 "${WORK_DIR}/${workload}.results" | awk '
+            NR == 1 { for (i = 1; i <= NF; i++) previous[i] = $i }
+            END {
+                printf "%10d", $1
+                for (i = 2; i <= NF; i++)
+                {
+                    if (NR > 1 && previous[i] > 0 && $i > 0)
+                    {
+                        printf " %22.3f %6.2f", $i, log($i / previous[i]) / log($1 / previous[1])
+                    }
+                    else
+                    {
+                        printf " %22.3f %6s", $i, "-"
+                    }
+                }
+                printf "\n"
+            }'
+
+        if [ ${elapsed} -ge ${LIMIT} ]
+        then
+            echo "(stopped: run took ${elapsed}s)"
+            break
+        fi
+    done
+
+    # Flag measurements whose growth exponent over the largest sizes is too high
+    awk -v limit=${EXPONENT} -v names="${MEASUREMENTS}" '
+        { count++; for (i = 1; i <= NF; i++) value[count, i] = $i }
+        END {
+            split(names, name, " ")
+            if (count < 2)
+            {
+                print "Not enough sizes to determine the growth"
+                exit
+            }
+            for (i = 2; i <= NF; i++)
+            {
+                first = (count > 2) ? count - 2 : 1
+                if (value[first, i] <= 0 || value[count, i] <= 0)
+                {
+                    continue
+                }
+                growth = log(value[count, i] / value[first, i]) / \
+                         log(value[count, 1] / value[first, 1])
+                printf "%-22s growth exponent %5.2f  %s\n", name[i - 1], growth,
+                       (growth > limit) ? "SUPER-LINEAR" : "linear"
+            }
+        }' "${WORK_DIR}/${workload}.results"
+    echo
+done
@@ -0,0 +1,1026 @@
+/**
+ * @file assembly.c
+ * @brief This contains all function implementations for translating the
+ *        intermediate code into x86-64 assembly (GNU assembler, AT&T syntax)
+ *        and for creating an executable from it.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "assembly.h"
+#include "context.h"
+
+/**
+ * Variable to enable/disable debug mode.<BR>
+ * [defined in file compiler.c]
+ */
+extern int debug;
+
+/**
+ * General purpose registers available for INTEGER and BOOLEAN variables.<BR>
+ * <code>eax</code>, <code>ecx</code> and <code>edx</code> are not part of this
+ * list as they are used as scratch registers (and by <code>idiv</code>).
+ */
+char* integerRegisters[] = {"%ebx", "%esi", "%edi", "%r8d", "%r9d", "%r10d",
+                            "%r11d", "%r12d", "%r13d", "%r14d", "%r15d"};
+
+/**
+ * Number of entries in integerRegisters.
+ */
+int integerRegisterCount = 11;
+
+/**
+ * SSE registers available for REAL variables.<BR>
+ * <code>xmm0</code> and <code>xmm1</code> are not part of this list as they
+ * are used as scratch registers.
+ */
+char* realRegisters[] = {"%xmm2", "%xmm3", "%xmm4", "%xmm5", "%xmm6", "%xmm7",
+                         "%xmm8", "%xmm9", "%xmm10", "%xmm11", "%xmm12",
+                         "%xmm13", "%xmm14", "%xmm15"};
+
+/**
+ * Number of entries in realRegisters.
+ */
+int realRegisterCount = 14;
+
+/**
+ * This writes the current intermediate code as x86-64 assembly into a file
+ * called <code>2_intermediate.s</code>.<BR>
+ * Variables are kept in registers as assigned by allocateRegisters (general
+ * purpose registers for INTEGER and BOOLEAN, SSE registers for REAL), all
+ * other variables are stored in memory. The program does not depend on the C
+ * library: it prints the result of the RETURN statement like the interpreter
+ * and exits with it as exit status by system calls.
+ */
+void printAssembly()
+{
+    compilationContext* context = compilation;
+
+    allocateRegisters();
+    context->assemblyLabel = 0;
+
+    FILE *f = fopen("2_intermediate.s", "w");
+    fprintf(f, "# Generated by the MathDH compiler\n");
+    fprintf(f, "#\n# Variable   Location     Live interval\n");
+    symbolTableEntry* symbol = context->symbolTable;
+    while (symbol != 0)
+    {
+        if (context->liveStart[symbol->index] >= 0)
+        {
+            fprintf(f, "# %-10s %-12s %d-%d\n", symbol->name,
+                    getAssemblyOperand(symbol),
+                    context->liveStart[symbol->index],
+                    context->liveEnd[symbol->index]);
+        }
+        symbol = symbol->next;
+    }
+
+    fprintf(f, "\n    .text\n    .globl _start\n_start:\n");
+
+    // Variables in memory are zero already (.bss), registers are not
+    symbol = context->symbolTable;
+    while (symbol != 0)
+    {
+        if (context->liveAtEntry[symbol->index]
+            && (context->assignedRegister[symbol->index] >= 0))
+        {
+            char* operand = getAssemblyOperand(symbol);
+            fprintf(f, "    %s %s, %s\n",
+                    (symbol->type == REAL) ? "pxor" : "xorl", operand,
+                    operand);
+        }
+        symbol = symbol->next;
+    }
+    printAssemblyList(f, context->codeList);
+    fprintf(f, "    jmp mathdh_exit\n\n");
+
+    printAssemblyRuntime(f);
+
+    // Variables without register
+    fprintf(f, "\n    .bss\n    .align 8\n");
+    fprintf(f, "mathdh_result:\n    .zero 8\n");
+    fprintf(f, "mathdh_result_type:\n    .zero 8\n");
+    fprintf(f, "mathdh_buffer:\n    .zero 32\n");
+    fprintf(f, "mathdh_number:\n    .zero 144\n");
+    fprintf(f, "mathdh_digits:\n    .zero 320\n");
+    symbol = context->symbolTable;
+    while (symbol != 0)
+    {
+        if ((context->liveStart[symbol->index] >= 0)
+            && (context->assignedRegister[symbol->index] < 0))
+        {
+            fprintf(f, "v_%s:\n    .zero 8\n", symbol->name);
+        }
+        symbol = symbol->next;
+    }
+    fclose(f);
+}
+
+/**
+ * This assembles and links the file <code>2_intermediate.s</code> (see
+ * printAssembly) into an executable by calling <code>as</code> and
+ * <code>ld</code>.
+ * @param executable File name of the executable to be created.
+ * @return <code>1</code> if the executable has been created.<BR>
+ *         <code>0</code> if the assembler or linker failed.
+ */
+int assembleProgram(char* executable)
+{
+    char* object = (char*)malloc(strlen(executable) + 3);
+    sprintf(object, "%s.o", executable);
+    char* quotedObject = quoteShellText(object);
+    char* quoted = quoteShellText(executable);
+    char* command = (char*)malloc(strlen(quotedObject) * 2 + strlen(quoted)
+                                  + 100);
+    sprintf(command, "as -o %s 2_intermediate.s && ld -o %s %s",
+            quotedObject, quoted, quotedObject);
+    int status = system(command);
+    free(quotedObject);
+    free(quoted);
+
+    remove(object);
+    free(object);
+    free(command);
+
+    if (status != 0)
+    {
+        fprintf(stderr, "Error while assembling 2_intermediate.s into %s\n",
+                executable);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Compares the live intervals of two variables by their start position (for
+ * <code>qsort</code>).
+ * @param first  Pointer to the 1st variable.
+ * @param second Pointer to the 2nd variable.
+ * @return Negative, zero or positive value if the 1st interval starts before,
+ *         together with or after the 2nd one.
+ */
+int compareLiveStart(const void* first, const void* second)
+{
+    symbolTableEntry* symbol1 = *(symbolTableEntry**)first;
+    symbolTableEntry* symbol2 = *(symbolTableEntry**)second;
+    return compilation->liveStart[symbol1->index]
+           - compilation->liveStart[symbol2->index];
+}
+
+/**
+ * This assigns registers to all variables by linear scan register
+ * allocation.<BR>
+ * The live interval of a variable reaches from its first to its last use
+ * within the code (numbered in the order of the code list including nested
+ * code lists). Intervals which overlap a loop are extended to the whole loop.
+ * Variables which do not get a register are stored in memory.
+ */
+void allocateRegisters()
+{
+    compilationContext* context = compilation;
+
+    int symbols = 0;
+    symbolTableEntry* symbol = context->symbolTable;
+    while (symbol != 0)
+    {
+        symbols++;
+        symbol = symbol->next;
+    }
+
+    context->liveStart = (int*)malloc(sizeof(int) * (symbols + 1));
+    context->liveEnd = (int*)malloc(sizeof(int) * (symbols + 1));
+    context->liveAtEntry = (int*)calloc(symbols + 1, sizeof(int));
+    context->assignedRegister = (int*)malloc(sizeof(int) * (symbols + 1));
+    context->assemblyOperand = (char**)malloc(sizeof(char*) * (symbols + 1));
+    int i;
+    for (i = 0; i < symbols; i++)
+    {
+        context->liveStart[i] = -1;
+        context->liveEnd[i] = -1;
+        context->assignedRegister[i] = -1;
+    }
+
+    context->loopCount = 0;
+    int position = 0;
+    computeLiveIntervals(context->codeList, &position, 0);
+    for (i = 0; i < symbols; i++)
+    {
+        if (context->liveAtEntry[i])
+        {
+            context->liveStart[i] = 0;
+        }
+    }
+
+    // A variable used within a loop needs to keep its register for the whole
+    // loop (repeat for nested loops until nothing changes)
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (i = 0; i < symbols; i++)
+        {
+            int loop;
+            for (loop = 0;
+                 (context->liveStart[i] >= 0) && (loop < context->loopCount);
+                 loop++)
+            {
+                if ((context->liveStart[i] > context->loopEnd[loop])
+                    || (context->liveEnd[i] < context->loopStart[loop]))
+                {
+                    continue;
+                }
+                if (context->liveStart[i] > context->loopStart[loop])
+                {
+                    context->liveStart[i] = context->loopStart[loop];
+                    changed = 1;
+                }
+                if (context->liveEnd[i] < context->loopEnd[loop])
+                {
+                    context->liveEnd[i] = context->loopEnd[loop];
+                    changed = 1;
+                }
+            }
+        }
+    }
+
+    // Sort all used variables by the start of their live interval
+    symbolTableEntry** order = (symbolTableEntry**)
+                               malloc(sizeof(symbolTableEntry*) * (symbols + 1));
+    int count = 0;
+    symbol = context->symbolTable;
+    while (symbol != 0)
+    {
+        if (context->liveStart[symbol->index] >= 0)
+        {
+            order[count++] = symbol;
+        }
+        symbol = symbol->next;
+    }
+    qsort(order, count, sizeof(symbolTableEntry*), compareLiveStart);
+
+    // Variable currently owning each register (-1 if the register is free)
+    int integerOwner[11];
+    int realOwner[14];
+    for (i = 0; i < integerRegisterCount; i++)
+    {
+        integerOwner[i] = -1;
+    }
+    for (i = 0; i < realRegisterCount; i++)
+    {
+        realOwner[i] = -1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        int current = order[i]->index;
+        int* owner = (order[i]->type == REAL) ? realOwner : integerOwner;
+        int registers = (order[i]->type == REAL) ? realRegisterCount
+                                                 : integerRegisterCount;
+
+        // Release the registers of all expired intervals
+        int reg;
+        int freeRegister = -1;
+        int furthest = -1;
+        for (reg = 0; reg < registers; reg++)
+        {
+            if ((owner[reg] >= 0)
+                && (context->liveEnd[owner[reg]] < context->liveStart[current]))
+            {
+                owner[reg] = -1;
+            }
+            if ((owner[reg] < 0) && (freeRegister < 0))
+            {
+                freeRegister = reg;
+            }
+            else if ((owner[reg] >= 0) && ((furthest < 0)
+                     || (context->liveEnd[owner[reg]]
+                         > context->liveEnd[owner[furthest]])))
+            {
+                furthest = reg;
+            }
+        }
+
+        if (freeRegister >= 0)
+        {
+            owner[freeRegister] = current;
+            context->assignedRegister[current] = freeRegister;
+        }
+        else if (context->liveEnd[owner[furthest]] > context->liveEnd[current])
+        {
+            // Spill the interval which ends last
+            context->assignedRegister[owner[furthest]] = -1;
+            owner[furthest] = current;
+            context->assignedRegister[current] = furthest;
+        }
+    }
+
+    symbol = context->symbolTable;
+    while (symbol != 0)
+    {
+        int reg = context->assignedRegister[symbol->index];
+        if (reg >= 0)
+        {
+            context->assemblyOperand[symbol->index] = (symbol->type == REAL)
+                                             ? realRegisters[reg]
+                                             : integerRegisters[reg];
+        }
+        else
+        {
+            context->assemblyOperand[symbol->index] =
+                (char*)malloc(sizeof(char) * (strlen(symbol->name) + 10));
+            sprintf(context->assemblyOperand[symbol->index], "v_%s(%%rip)",
+                    symbol->name);
+        }
+
+        if (debug && (context->liveStart[symbol->index] >= 0))
+        {
+            printf("Register allocation: %s -> %s\n", symbol->name,
+                   context->assemblyOperand[symbol->index]);
+        }
+        symbol = symbol->next;
+    }
+
+    free(order);
+}
+
+/**
+ * This numbers all code entries of a code list (including nested code lists)
+ * and determines the live interval of every variable used and the range of
+ * every loop.<BR>
+ * Variables which are read before they are written, or which are first
+ * written within a nested code list (which might not be executed), are
+ * marked within liveAtEntry.
+ * @param iterator The first code entry of the list.
+ * @param position Number of the next code entry (updated).
+ * @param nested   <code>1</code> for the code list of an IF/WHILE statement.
+ */
+void computeLiveIntervals(codeEntry* iterator, int* position, int nested)
+{
+    compilationContext* context = compilation;
+
+    int marker = -1;
+
+    while (iterator != 0)
+    {
+        int current = (*position)++;
+
+        // Only assignments write their target, the target of an
+        // increment/decrement or of a fused comparison is read as well
+        markLiveAtEntry(iterator->operand1);
+        markLiveAtEntry(iterator->operand2);
+        if (nested || (iterator->op == OP_IF) || (iterator->op == OP_IF_COMPARE)
+            || (iterator->op == OP_WHILE) || (iterator->op == OP_WHILE_COMPARE)
+            || (iterator->op == OP_DO_WHILE)
+            || (iterator->op == OP_DO_WHILE_COMPARE)
+            || (iterator->op == OP_INCREMENT) || (iterator->op == OP_DECREMENT)
+            || (iterator->op == OP_EXIT))
+        {
+            markLiveAtEntry(iterator->target);
+        }
+
+        extendLiveInterval(iterator->target, current);
+        extendLiveInterval(iterator->operand1, current);
+        extendLiveInterval(iterator->operand2, current);
+
+        if (iterator->op == OP_MARKER_WHILE)
+        {
+            marker = current;
+        }
+
+        computeLiveIntervals(iterator->sub_1, position, 1);
+        computeLiveIntervals(iterator->sub_2, position, 1);
+
+        int start = -1;
+        if ((iterator->op == OP_WHILE) || (iterator->op == OP_WHILE_COMPARE))
+        {
+            // The condition part is calculated again after every iteration
+            start = (marker >= 0) ? marker : current;
+        }
+        else if ((iterator->op == OP_DO_WHILE)
+                 || (iterator->op == OP_DO_WHILE_COMPARE))
+        {
+            start = current;
+        }
+
+        if (start >= 0)
+        {
+            context->loopStart = (int*)realloc(context->loopStart,
+                                     sizeof(int) * (context->loopCount + 1));
+            context->loopEnd = (int*)realloc(context->loopEnd,
+                                   sizeof(int) * (context->loopCount + 1));
+            context->loopStart[context->loopCount] = start;
+            context->loopEnd[context->loopCount] = *position - 1;
+            context->loopCount++;
+        }
+
+        iterator = iterator->next;
+    }
+}
+
+/**
+ * This marks a variable within liveAtEntry if it has not been used before.
+ * @param variable The variable (may be <code>null</code>).
+ */
+void markLiveAtEntry(symbolTableEntry* variable)
+{
+    if ((variable != 0) && (compilation->liveStart[variable->index] < 0))
+    {
+        compilation->liveAtEntry[variable->index] = 1;
+    }
+}
+
+/**
+ * This extends the live interval of a variable to contain a position.
+ * @param variable The variable (may be <code>null</code>).
+ * @param position The position within the code.
+ */
+void extendLiveInterval(symbolTableEntry* variable, int position)
+{
+    if (variable == 0)
+    {
+        return;
+    }
+
+    if (compilation->liveStart[variable->index] < 0)
+    {
+        compilation->liveStart[variable->index] = position;
+    }
+    compilation->liveEnd[variable->index] = position;
+}
+
+/**
+ * Determines the assembly operand for a variable.
+ * @param variable The variable.
+ * @return The register (e.g. <code>%ebx</code> or <code>%xmm2</code>) or the
+ *         memory location (e.g. <code>v_A(%rip)</code>) of the variable.
+ */
+char* getAssemblyOperand(symbolTableEntry* variable)
+{
+    return compilation->assemblyOperand[variable->index];
+}
+
+/**
+ * This writes a code list (including nested code lists) as assembly.
+ * @param f        Reference to the file for storing the assembly.
+ * @param iterator The first code entry of the list.
+ */
+void printAssemblyList(FILE *f, codeEntry* iterator)
+{
+    int marker = -1;
+
+    while (iterator != 0)
+    {
+        printAssemblyEntry(f, iterator, &marker);
+        iterator = iterator->next;
+    }
+}
+
+/**
+ * This writes a single code entry (including nested sub-code) as assembly.
+ * @param f        Reference to the file for storing the assembly.
+ * @param iterator The code entry.
+ * @param marker   Label of the last WHILE marker within the current code
+ *                 list. This is updated for OP_MARKER_WHILE entries and used as
+ *                 jump target to evaluate the condition of a WHILE loop again.
+ */
+void printAssemblyEntry(FILE *f, codeEntry* iterator, int* marker)
+{
+    char* target = (iterator->target != 0)
+                   ? getAssemblyOperand(iterator->target) : 0;
+    char* operand1 = (iterator->operand1 != 0)
+                     ? getAssemblyOperand(iterator->operand1) : 0;
+    char* operand2 = (iterator->operand2 != 0)
+                     ? getAssemblyOperand(iterator->operand2) : 0;
+    int labelElse;
+    int labelEnd;
+    int labelStart;
+
+    switch (iterator->op)
+    {
+        /* Numeric Comparison Operators */
+        case OP_EQUAL:
+        case OP_NOT_EQUAL:
+        case OP_LESS_OR_EQUAL:
+        case OP_GREATER_OR_EQUAL:
+        case OP_GREATER:
+        case OP_LESS:
+            printAssemblyComparison(f, iterator->op, iterator->operand1,
+                                    iterator->operand2);
+            fprintf(f, "    movl %%eax, %s\n", target);
+            break;
+
+        /* Logical Comparison Operators */
+        case OP_AND:
+        case OP_OR:
+            fprintf(f, "    movl %s, %%eax\n", operand1);
+            fprintf(f, "    testl %%eax, %%eax\n");
+            fprintf(f, "    setne %%al\n");
+            fprintf(f, "    movl %s, %%ecx\n", operand2);
+            fprintf(f, "    testl %%ecx, %%ecx\n");
+            fprintf(f, "    setne %%cl\n");
+            fprintf(f, "    %s %%cl, %%al\n",
+                    (iterator->op == OP_AND) ? "andb" : "orb");
+            fprintf(f, "    movzbl %%al, %%eax\n");
+            fprintf(f, "    movl %%eax, %s\n", target);
+            break;
+
+        case OP_NOT:
+            fprintf(f, "    movl %s, %%eax\n", operand1);
+            fprintf(f, "    testl %%eax, %%eax\n");
+            fprintf(f, "    sete %%al\n");
+            fprintf(f, "    movzbl %%al, %%eax\n");
+            fprintf(f, "    movl %%eax, %s\n", target);
+            break;
+
+        /* Control Flow */
+        case OP_IF:
+        case OP_IF_COMPARE:
+            labelElse = ++compilation->assemblyLabel;
+            printAssemblyCondition(f, iterator, 0, labelElse);
+            printAssemblyList(f, iterator->sub_1);
+            if (iterator->sub_2 != 0)
+            {
+                labelEnd = ++compilation->assemblyLabel;
+                fprintf(f, "    jmp .L%d\n", labelEnd);
+                fprintf(f, ".L%d:\n", labelElse);
+                printAssemblyList(f, iterator->sub_2);
+                fprintf(f, ".L%d:\n", labelEnd);
+            }
+            else
+            {
+                fprintf(f, ".L%d:\n", labelElse);
+            }
+            break;
+
+        case OP_WHILE:
+        case OP_WHILE_COMPARE:
+            // The condition part starts at the last marker
+            if (*marker >= 0)
+            {
+                labelStart = *marker;
+            }
+            else
+            {
+                labelStart = ++compilation->assemblyLabel;
+                fprintf(f, ".L%d:\n", labelStart);
+            }
+            labelEnd = ++compilation->assemblyLabel;
+            printAssemblyCondition(f, iterator, 0, labelEnd);
+            printAssemblyList(f, iterator->sub_1);
+            fprintf(f, "    jmp .L%d\n", labelStart);
+            fprintf(f, ".L%d:\n", labelEnd);
+            break;
+
+        case OP_DO_WHILE:
+        case OP_DO_WHILE_COMPARE:
+            labelStart = ++compilation->assemblyLabel;
+            fprintf(f, ".L%d:\n", labelStart);
+            printAssemblyList(f, iterator->sub_1);
+            printAssemblyCondition(f, iterator, 1, labelStart);
+            break;
+
+        case OP_MARKER_WHILE:
+            *marker = ++compilation->assemblyLabel;
+            fprintf(f, ".L%d:\n", *marker);
+            break;
+
+        case OP_EXIT:
+            // RETURN does not stop the execution (same as in the interpreter)
+            if (iterator->operand1->type == REAL)
+            {
+                fprintf(f, "    movsd %s, %%xmm0\n", operand1);
+                fprintf(f, "    movsd %%xmm0, mathdh_result(%%rip)\n");
+            }
+            else
+            {
+                fprintf(f, "    movl %s, %%eax\n", operand1);
+                fprintf(f, "    movl %%eax, mathdh_result(%%rip)\n");
+            }
+            fprintf(f, "    movl $%d, mathdh_result_type(%%rip)\n",
+                    iterator->operand1->type + 1);
+            break;
+
+        /* Mathematical Operators */
+        case OP_PLUS:
+        case OP_MINUS:
+        case OP_MULTIPLY:
+        case OP_DIVIDE:
+        case OP_MODULO:
+            if ((iterator->operand1->type != REAL)
+                && (iterator->operand2->type != REAL))
+            {
+                fprintf(f, "    movl %s, %%eax\n", operand1);
+                if ((iterator->op == OP_DIVIDE) || (iterator->op == OP_MODULO))
+                {
+                    fprintf(f, "    cltd\n");
+                    fprintf(f, "    idivl %s\n", operand2);
+                }
+                else
+                {
+                    fprintf(f, "    %s %s, %%eax\n",
+                            (iterator->op == OP_PLUS) ? "addl" :
+                            (iterator->op == OP_MINUS) ? "subl" : "imull",
+                            operand2);
+                }
+                fprintf(f, "    movl %s, %s\n",
+                        (iterator->op == OP_MODULO) ? "%edx" : "%eax", target);
+            }
+            else
+            {
+                printAssemblyLoadReal(f, iterator->operand1, "%xmm0");
+                printAssemblyLoadReal(f, iterator->operand2, "%xmm1");
+                fprintf(f, "    %s %%xmm1, %%xmm0\n",
+                        (iterator->op == OP_PLUS) ? "addsd" :
+                        (iterator->op == OP_MINUS) ? "subsd" :
+                        (iterator->op == OP_MULTIPLY) ? "mulsd" : "divsd");
+                fprintf(f, "    movsd %%xmm0, %s\n", target);
+            }
+            break;
+
+        case OP_INCREMENT:
+            fprintf(f, "    addl $1, %s\n", target);
+            break;
+
+        case OP_DECREMENT:
+            fprintf(f, "    subl $1, %s\n", target);
+            break;
+
+        /* Assignment */
+        case OP_ASSIGN:
+            if ((iterator->operand1->type == REAL)
+                || (iterator->target->type == REAL))
+            {
+                printAssemblyLoadReal(f, iterator->operand1, "%xmm0");
+                fprintf(f, "    movsd %%xmm0, %s\n", target);
+            }
+            else
+            {
+                fprintf(f, "    movl %s, %%eax\n", operand1);
+                fprintf(f, "    movl %%eax, %s\n", target);
+            }
+            break;
+
+        /* Constants */
+        case OP_INT_CONSTANT:
+            fprintf(f, "    movl $%d, %s\n", iterator->integer, target);
+            break;
+
+        case OP_FLOAT_CONSTANT:
+        {
+            // Load the bit pattern of the double value
+            double value = iterator->real;
+            long long bits;
+            memcpy(&bits, &value, sizeof(bits));
+            fprintf(f, "    movabsq $%lld, %%rax    # %.2f\n", bits, value);
+            fprintf(f, "    movq %%rax, %s\n", target);
+            break;
+        }
+
+        case OP_BOOL_CONSTANT:
+            fprintf(f, "    movl $%d, %s\n", iterator->boolean, target);
+            break;
+
+        /* Place holder for if/else/while */
+        case OP_NOP:
+            break;
+
+        default:
+            fprintf(f, "    # ERROR: Unexpected operation: %u\n", iterator->op);
+    }
+}
+
+/**
+ * This writes the assembly to load a numeric variable into an SSE register as
+ * double value (integer values are converted).
+ * @param f        Reference to the file for storing the assembly.
+ * @param variable The variable to be loaded.
+ * @param xmm      Name of the SSE register (e.g. <code>%xmm0</code>).
+ */
+void printAssemblyLoadReal(FILE *f, symbolTableEntry* variable, char* xmm)
+{
+    if (variable->type == REAL)
+    {
+        fprintf(f, "    movsd %s, %s\n", getAssemblyOperand(variable), xmm);
+    }
+    else
+    {
+        fprintf(f, "    cvtsi2sdl %s, %s\n", getAssemblyOperand(variable), xmm);
+    }
+}
+
+/**
+ * This writes the assembly for a numeric comparison. The result
+ * (<code>0</code> or <code>1</code>) is stored in register <code>eax</code>.
+ * @param f        Reference to the file for storing the assembly.
+ * @param op       The comparison (OP_EQUAL, OP_NOT_EQUAL, OP_LESS_OR_EQUAL,
+ *                 OP_GREATER_OR_EQUAL, OP_GREATER, OP_LESS).
+ * @param operand1 1st operand.
+ * @param operand2 2nd operand.
+ */
+void printAssemblyComparison(FILE *f, operation op, symbolTableEntry* operand1,
+                             symbolTableEntry* operand2)
+{
+    if ((operand1->type != REAL) && (operand2->type != REAL))
+    {
+        fprintf(f, "    movl %s, %%eax\n", getAssemblyOperand(operand1));
+        fprintf(f, "    cmpl %s, %%eax\n", getAssemblyOperand(operand2));
+        fprintf(f, "    set%s %%al\n", getConditionCode(op, 0));
+    }
+    else
+    {
+        printAssemblyLoadReal(f, operand1, "%xmm0");
+        printAssemblyLoadReal(f, operand2, "%xmm1");
+
+        // Unordered values (NaN) set the parity flag and compare as unequal
+        switch (op)
+        {
+            case OP_EQUAL:
+                fprintf(f, "    ucomisd %%xmm1, %%xmm0\n");
+                fprintf(f, "    sete %%al\n");
+                fprintf(f, "    setnp %%cl\n");
+                fprintf(f, "    andb %%cl, %%al\n");
+                break;
+            case OP_NOT_EQUAL:
+                fprintf(f, "    ucomisd %%xmm1, %%xmm0\n");
+                fprintf(f, "    setne %%al\n");
+                fprintf(f, "    setp %%cl\n");
+                fprintf(f, "    orb %%cl, %%al\n");
+                break;
+            case OP_GREATER:
+            case OP_GREATER_OR_EQUAL:
+                fprintf(f, "    ucomisd %%xmm1, %%xmm0\n");
+                fprintf(f, "    %s %%al\n",
+                        (op == OP_GREATER) ? "seta" : "setae");
+                break;
+            default:
+                fprintf(f, "    ucomisd %%xmm0, %%xmm1\n");
+                fprintf(f, "    %s %%al\n", (op == OP_LESS) ? "seta" : "setae");
+                break;
+        }
+    }
+    fprintf(f, "    movzbl %%al, %%eax\n");
+}
+
+/**
+ * This writes the assembly for the condition of an IF/WHILE/DO WHILE
+ * statement (including a fused increment/decrement) followed by a conditional
+ * jump.
+ * @param f        Reference to the file for storing the assembly.
+ * @param iterator The IF/WHILE/DO WHILE code entry.
+ * @param jumpIf   <code>1</code> to jump if the condition is fulfilled,
+ *                 <code>0</code> to jump if it is not fulfilled.
+ * @param label    Number of the label to jump to.
+ */
+void printAssemblyCondition(FILE *f, codeEntry* iterator, int jumpIf,
+                            int label)
+{
+    if ((iterator->op != OP_IF_COMPARE) && (iterator->op != OP_WHILE_COMPARE)
+        && (iterator->op != OP_DO_WHILE_COMPARE))
+    {
+        fprintf(f, "    cmpl $0, %s\n", getAssemblyOperand(iterator->operand1));
+        fprintf(f, "    %s .L%d\n", jumpIf ? "jne" : "je", label);
+        return;
+    }
+
+    if (iterator->step == OP_INCREMENT)
+    {
+        fprintf(f, "    addl $1, %s\n", getAssemblyOperand(iterator->target));
+    }
+    else if (iterator->step == OP_DECREMENT)
+    {
+        fprintf(f, "    subl $1, %s\n", getAssemblyOperand(iterator->target));
+    }
+
+    // Integer comparisons jump on the flags directly
+    if ((iterator->operand1->type != REAL) && (iterator->operand2->type != REAL))
+    {
+        fprintf(f, "    movl %s, %%eax\n",
+                getAssemblyOperand(iterator->operand1));
+        fprintf(f, "    cmpl %s, %%eax\n",
+                getAssemblyOperand(iterator->operand2));
+        fprintf(f, "    j%s .L%d\n", getConditionCode(iterator->compare,
+                                                     !jumpIf), label);
+        return;
+    }
+
+    printAssemblyComparison(f, iterator->compare, iterator->operand1,
+                            iterator->operand2);
+    fprintf(f, "    testl %%eax, %%eax\n");
+    fprintf(f, "    %s .L%d\n", jumpIf ? "jne" : "je", label);
+}
+
+/**
+ * Determines the condition code suffix (e.g. for <code>setCC</code> and
+ * <code>jCC</code>) of a signed integer comparison.
+ * @param op     The comparison.
+ * @param negate <code>1</code> to get the condition code of the negated
+ *               comparison.
+ * @return The condition code (e.g. <code>le</code>).
+ */
+char* getConditionCode(operation op, int negate)
+{
+    switch (op)
+    {
+        case OP_EQUAL:
+            return negate ? "ne" : "e";
+        case OP_NOT_EQUAL:
+            return negate ? "e" : "ne";
+        case OP_LESS_OR_EQUAL:
+            return negate ? "g" : "le";
+        case OP_GREATER_OR_EQUAL:
+            return negate ? "l" : "ge";
+        case OP_GREATER:
+            return negate ? "le" : "g";
+        case OP_LESS:
+            return negate ? "ge" : "l";
+        default:
+            return "mp";
+    }
+}
+
+/**
+ * This writes the runtime functions which print the program result and exit
+ * the program.
+ * @param f Reference to the file for storing the assembly.
+ */
+void printAssemblyRuntime(FILE *f)
+{
+    // Print "PROGRAM RESULT = " followed by the value (same format as the
+    // interpreter) and exit with the value as exit status (in ebx)
+    fprintf(f, "mathdh_exit:\n");
+    fprintf(f, "    leaq mathdh_prefix(%%rip), %%rsi\n");
+    fprintf(f, "    movl $18, %%edx\n");
+    fprintf(f, "    call mathdh_write\n");
+    fprintf(f, "    xorl %%ebx, %%ebx\n");
+    fprintf(f, "    cmpl $%d, mathdh_result_type(%%rip)\n", INTEGER + 1);
+    fprintf(f, "    je mathdh_exit_integer\n");
+    fprintf(f, "    cmpl $%d, mathdh_result_type(%%rip)\n", REAL + 1);
+    fprintf(f, "    je mathdh_exit_real\n");
+    fprintf(f, "    cmpl $%d, mathdh_result_type(%%rip)\n", BOOLEAN + 1);
+    fprintf(f, "    je mathdh_exit_boolean\n");
+    fprintf(f, "    jmp mathdh_exit_end\n");
+
+    fprintf(f, "mathdh_exit_integer:\n");
+    fprintf(f, "    movslq mathdh_result(%%rip), %%rax\n");
+    fprintf(f, "    movl %%eax, %%ebx\n");
+    fprintf(f, "    testq %%rax, %%rax\n");
+    fprintf(f, "    jns 1f\n");
+    fprintf(f, "    negq %%rax\n");
+    fprintf(f, "    pushq %%rax\n");
+    fprintf(f, "    leaq mathdh_minus(%%rip), %%rsi\n");
+    fprintf(f, "    movl $1, %%edx\n");
+    fprintf(f, "    call mathdh_write\n");
+    fprintf(f, "    popq %%rax\n");
+    fprintf(f, "1:  call mathdh_print_number\n");
+    fprintf(f, "    jmp mathdh_exit_end\n");
+
+    // REAL values are rounded to two decimal places (round half to even on
+    // the value multiplied by 100). Values from 2^52 on have no fraction and
+    // are printed by mathdh_print_large.
+    fprintf(f, "mathdh_exit_real:\n");
+    fprintf(f, "    movsd mathdh_result(%%rip), %%xmm0\n");
+    fprintf(f, "    cvttsd2si %%xmm0, %%ebx\n");
+    fprintf(f, "    movq %%xmm0, %%rax\n");
+    fprintf(f, "    btrq $63, %%rax\n");
+    fprintf(f, "    jnc 2f\n");
+    fprintf(f, "    movq %%rax, %%xmm0\n");
+    fprintf(f, "    leaq mathdh_minus(%%rip), %%rsi\n");
+    fprintf(f, "    movl $1, %%edx\n");
+    fprintf(f, "    call mathdh_write\n");
+    fprintf(f, "2:  movq %%xmm0, %%rax\n");
+    fprintf(f, "    movabsq $0x7FF0000000000000, %%rcx\n");
+    fprintf(f, "    cmpq %%rcx, %%rax\n");
+    fprintf(f, "    jb 4f\n");
+    fprintf(f, "    leaq mathdh_infinity(%%rip), %%rsi\n");
+    fprintf(f, "    je 5f\n");
+    fprintf(f, "    leaq mathdh_nan(%%rip), %%rsi\n");
+    fprintf(f, "5:  movl $3, %%edx\n");
+    fprintf(f, "    call mathdh_write\n");
+    fprintf(f, "    jmp mathdh_exit_end\n");
+    fprintf(f, "4:  movabsq $0x4330000000000000, %%rcx\n");
+    fprintf(f, "    cmpq %%rcx, %%rax\n");
+    fprintf(f, "    jb 6f\n");
+    fprintf(f, "    call mathdh_print_large\n");
+    fprintf(f, "    leaq mathdh_zero_fraction(%%rip), %%rsi\n");
+    fprintf(f, "    movl $3, %%edx\n");
+    fprintf(f, "    call mathdh_write\n");
+    fprintf(f, "    jmp mathdh_exit_end\n");
+    fprintf(f, "6:  movabsq $0x4059000000000000, %%rax\n");
+    fprintf(f, "    movq %%rax, %%xmm1\n");
+    fprintf(f, "    mulsd %%xmm1, %%xmm0\n");
+    fprintf(f, "    cvtsd2si %%xmm0, %%rax\n");
+    fprintf(f, "    movl $100, %%ecx\n");
+    fprintf(f, "    xorl %%edx, %%edx\n");
+    fprintf(f, "    divq %%rcx\n");
+    fprintf(f, "    pushq %%rdx\n");
+    fprintf(f, "    call mathdh_print_number\n");
+    fprintf(f, "    popq %%rax\n");
+    fprintf(f, "    movl $10, %%ecx\n");
+    fprintf(f, "    xorl %%edx, %%edx\n");
+    fprintf(f, "    divq %%rcx\n");
+    fprintf(f, "    movb $46, mathdh_buffer(%%rip)\n");
+    fprintf(f, "    addb $48, %%al\n");
+    fprintf(f, "    movb %%al, mathdh_buffer+1(%%rip)\n");
+    fprintf(f, "    addb $48, %%dl\n");
+    fprintf(f, "    movb %%dl, mathdh_buffer+2(%%rip)\n");
+    fprintf(f, "    leaq mathdh_buffer(%%rip), %%rsi\n");
+    fprintf(f, "    movl $3, %%edx\n");
+    fprintf(f, "    call mathdh_write\n");
+    fprintf(f, "    jmp mathdh_exit_end\n");
+
+    fprintf(f, "mathdh_exit_boolean:\n");
+    fprintf(f, "    movl mathdh_result(%%rip), %%ebx\n");
+    fprintf(f, "    leaq mathdh_false(%%rip), %%rsi\n");
+    fprintf(f, "    movl $5, %%edx\n");
+    fprintf(f, "    testl %%ebx, %%ebx\n");
+    fprintf(f, "    jz 3f\n");
+    fprintf(f, "    leaq mathdh_true(%%rip), %%rsi\n");
+    fprintf(f, "    movl $4, %%edx\n");
+    fprintf(f, "3:  call mathdh_write\n");
+
+    fprintf(f, "mathdh_exit_end:\n");
+    fprintf(f, "    leaq mathdh_newline(%%rip), %%rsi\n");
+    fprintf(f, "    movl $1, %%edx\n");
+    fprintf(f, "    call mathdh_write\n");
+    fprintf(f, "    movl $60, %%eax\n");
+    fprintf(f, "    movl %%ebx, %%edi\n");
+    fprintf(f, "    syscall\n\n");
+
+    // write(1, rsi, rdx)
+    fprintf(f, "mathdh_write:\n");
+    fprintf(f, "    movl $1, %%eax\n");
+    fprintf(f, "    movl $1, %%edi\n");
+    fprintf(f, "    syscall\n");
+    fprintf(f, "    ret\n\n");
+
+    // Print the unsigned number in rax
+    fprintf(f, "mathdh_print_number:\n");
+    fprintf(f, "    leaq mathdh_buffer+32(%%rip), %%rsi\n");
+    fprintf(f, "    movl $10, %%ecx\n");
+    fprintf(f, "1:  xorl %%edx, %%edx\n");
+    fprintf(f, "    divq %%rcx\n");
+    fprintf(f, "    addb $48, %%dl\n");
+    fprintf(f, "    decq %%rsi\n");
+    fprintf(f, "    movb %%dl, (%%rsi)\n");
+    fprintf(f, "    testq %%rax, %%rax\n");
+    fprintf(f, "    jnz 1b\n");
+    fprintf(f, "    leaq mathdh_buffer+32(%%rip), %%rdx\n");
+    fprintf(f, "    subq %%rsi, %%rdx\n");
+    fprintf(f, "    jmp mathdh_write\n");
+
+    // Print the positive double value (at least 2^52) with the bit pattern in
+    // rax: the mantissa is shifted into a 1152 bit number (36 limbs of 32 bit)
+    // which is divided by 10 for every digit
+    fprintf(f, "\nmathdh_print_large:\n");
+    fprintf(f, "    movq %%rax, %%rcx\n");
+    fprintf(f, "    shrq $52, %%rcx\n");
+    fprintf(f, "    subl $1075, %%ecx\n");
+    fprintf(f, "    movabsq $0xFFFFFFFFFFFFF, %%rdx\n");
+    fprintf(f, "    andq %%rdx, %%rax\n");
+    fprintf(f, "    btsq $52, %%rax\n");
+    fprintf(f, "    leaq mathdh_number(%%rip), %%rdi\n");
+    fprintf(f, "    movl %%ecx, %%esi\n");
+    fprintf(f, "    shrl $5, %%esi\n");
+    fprintf(f, "    andl $31, %%ecx\n");
+    fprintf(f, "    xorl %%edx, %%edx\n");
+    fprintf(f, "    shldq %%cl, %%rax, %%rdx\n");
+    fprintf(f, "    shlq %%cl, %%rax\n");
+    fprintf(f, "    movl %%eax, (%%rdi,%%rsi,4)\n");
+    fprintf(f, "    shrq $32, %%rax\n");
+    fprintf(f, "    movl %%eax, 4(%%rdi,%%rsi,4)\n");
+    fprintf(f, "    movl %%edx, 8(%%rdi,%%rsi,4)\n");
+    fprintf(f, "    leaq mathdh_digits+320(%%rip), %%r8\n");
+    fprintf(f, "    movl $10, %%ecx\n");
+    fprintf(f, "1:  movl $35, %%esi\n");
+    fprintf(f, "    xorl %%edx, %%edx\n");
+    fprintf(f, "    xorl %%r9d, %%r9d\n");
+    fprintf(f, "2:  movl (%%rdi,%%rsi,4), %%eax\n");
+    fprintf(f, "    shlq $32, %%rdx\n");
+    fprintf(f, "    orq %%rdx, %%rax\n");
+    fprintf(f, "    xorl %%edx, %%edx\n");
+    fprintf(f, "    divq %%rcx\n");
+    fprintf(f, "    movl %%eax, (%%rdi,%%rsi,4)\n");
+    fprintf(f, "    orl %%eax, %%r9d\n");
+    fprintf(f, "    decl %%esi\n");
+    fprintf(f, "    jns 2b\n");
+    fprintf(f, "    addb $48, %%dl\n");
+    fprintf(f, "    decq %%r8\n");
+    fprintf(f, "    movb %%dl, (%%r8)\n");
+    fprintf(f, "    testl %%r9d, %%r9d\n");
+    fprintf(f, "    jnz 1b\n");
+    fprintf(f, "    movq %%r8, %%rsi\n");
+    fprintf(f, "    leaq mathdh_digits+320(%%rip), %%rdx\n");
+    fprintf(f, "    subq %%r8, %%rdx\n");
+    fprintf(f, "    jmp mathdh_write\n");
+
+    fprintf(f, "\n    .section .rodata\n");
+    fprintf(f, "mathdh_zero_fraction:\n    .ascii \".00\"\n");
+    fprintf(f, "mathdh_prefix:\n    .ascii \"\\nPROGRAM RESULT = \"\n");
+    fprintf(f, "mathdh_minus:\n    .ascii \"-\"\n");
+    fprintf(f, "mathdh_newline:\n    .ascii \"\\n\"\n");
+    fprintf(f, "mathdh_true:\n    .ascii \"true\"\n");
+    fprintf(f, "mathdh_infinity:\n    .ascii \"inf\"\n");
+    fprintf(f, "mathdh_nan:\n    .ascii \"nan\"\n");
+    fprintf(f, "mathdh_false:\n    .ascii \"false\"\n");
+}
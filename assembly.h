@@ -0,0 +1,159 @@
+/**
+ * @file assembly.h
+ * @brief This defines all functions for translating the intermediate code
+ *        into x86-64 assembly (GNU assembler, AT&T syntax) and for creating an
+ *        executable from it.
+ */
+
+#include "generator.h"
+#include "symboltable.h"
+#include "compiler.h"
+#include <stdio.h>
+
+#ifndef ASSEMBLY_H_
+#define ASSEMBLY_H_
+
+/**
+ * This writes the current intermediate code as x86-64 assembly into a file
+ * called <code>2_intermediate.s</code>.<BR>
+ * Variables are kept in registers as assigned by allocateRegisters (general
+ * purpose registers for INTEGER and BOOLEAN, SSE registers for REAL), all
+ * other variables are stored in memory. The program does not depend on the C
+ * library: it prints the result of the RETURN statement like the interpreter
+ * and exits with it as exit status by system calls.
+ */
+void printAssembly();
+
+/**
+ * This assembles and links the file <code>2_intermediate.s</code> (see
+ * printAssembly) into an executable by calling <code>as</code> and
+ * <code>ld</code>.
+ * @param executable File name of the executable to be created.
+ * @return <code>1</code> if the executable has been created.<BR>
+ *         <code>0</code> if the assembler or linker failed.
+ */
+int assembleProgram(char* executable);
+
+/**
+ * Compares the live intervals of two variables by their start position (for
+ * <code>qsort</code>).
+ * @param first  Pointer to the 1st variable.
+ * @param second Pointer to the 2nd variable.
+ * @return Negative, zero or positive value if the 1st interval starts before,
+ *         together with or after the 2nd one.
+ */
+int compareLiveStart(const void* first, const void* second);
+
+/**
+ * This assigns registers to all variables by linear scan register
+ * allocation.<BR>
+ * The live interval of a variable reaches from its first to its last use
+ * within the code (numbered in the order of the code list including nested
+ * code lists). Intervals which overlap a loop are extended to the whole loop.
+ * Variables which do not get a register are stored in memory.
+ */
+void allocateRegisters();
+
+/**
+ * This numbers all code entries of a code list (including nested code lists)
+ * and determines the live interval of every variable used and the range of
+ * every loop.<BR>
+ * Variables which are read before they are written, or which are first
+ * written within a nested code list (which might not be executed), are
+ * marked within liveAtEntry.
+ * @param iterator The first code entry of the list.
+ * @param position Number of the next code entry (updated).
+ * @param nested   <code>1</code> for the code list of an IF/WHILE statement.
+ */
+void computeLiveIntervals(codeEntry* iterator, int* position, int nested);
+
+/**
+ * This marks a variable within liveAtEntry if it has not been used before.
+ * @param variable The variable (may be <code>null</code>).
+ */
+void markLiveAtEntry(symbolTableEntry* variable);
+
+/**
+ * This extends the live interval of a variable to contain a position.
+ * @param variable The variable (may be <code>null</code>).
+ * @param position The position within the code.
+ */
+void extendLiveInterval(symbolTableEntry* variable, int position);
+
+/**
+ * Determines the assembly operand for a variable.
+ * @param variable The variable.
+ * @return The register (e.g. <code>%ebx</code> or <code>%xmm2</code>) or the
+ *         memory location (e.g. <code>v_A(%rip)</code>) of the variable.
+ */
+char* getAssemblyOperand(symbolTableEntry* variable);
+
+/**
+ * This writes a code list (including nested code lists) as assembly.
+ * @param f        Reference to the file for storing the assembly.
+ * @param iterator The first code entry of the list.
+ */
+void printAssemblyList(FILE *f, codeEntry* iterator);
+
+/**
+ * This writes a single code entry (including nested sub-code) as assembly.
+ * @param f        Reference to the file for storing the assembly.
+ * @param iterator The code entry.
+ * @param marker   Label of the last WHILE marker within the current code
+ *                 list. This is updated for OP_MARKER_WHILE entries and used as
+ *                 jump target to evaluate the condition of a WHILE loop again.
+ */
+void printAssemblyEntry(FILE *f, codeEntry* iterator, int* marker);
+
+/**
+ * This writes the assembly to load a numeric variable into an SSE register as
+ * double value (integer values are converted).
+ * @param f        Reference to the file for storing the assembly.
+ * @param variable The variable to be loaded.
+ * @param xmm      Name of the SSE register (e.g. <code>%xmm0</code>).
+ */
+void printAssemblyLoadReal(FILE *f, symbolTableEntry* variable, char* xmm);
+
+/**
+ * This writes the assembly for a numeric comparison. The result
+ * (<code>0</code> or <code>1</code>) is stored in register <code>eax</code>.
+ * @param f        Reference to the file for storing the assembly.
+ * @param op       The comparison (OP_EQUAL, OP_NOT_EQUAL, OP_LESS_OR_EQUAL,
+ *                 OP_GREATER_OR_EQUAL, OP_GREATER, OP_LESS).
+ * @param operand1 1st operand.
+ * @param operand2 2nd operand.
+ */
+void printAssemblyComparison(FILE *f, operation op, symbolTableEntry* operand1,
+                             symbolTableEntry* operand2);
+
+/**
+ * This writes the assembly for the condition of an IF/WHILE/DO WHILE
+ * statement (including a fused increment/decrement) followed by a conditional
+ * jump.
+ * @param f        Reference to the file for storing the assembly.
+ * @param iterator The IF/WHILE/DO WHILE code entry.
+ * @param jumpIf   <code>1</code> to jump if the condition is fulfilled,
+ *                 <code>0</code> to jump if it is not fulfilled.
+ * @param label    Number of the label to jump to.
+ */
+void printAssemblyCondition(FILE *f, codeEntry* iterator, int jumpIf,
+                            int label);
+
+/**
+ * Determines the condition code suffix (e.g. for <code>setCC</code> and
+ * <code>jCC</code>) of a signed integer comparison.
+ * @param op     The comparison.
+ * @param negate <code>1</code> to get the condition code of the negated
+ *               comparison.
+ * @return The condition code (e.g. <code>le</code>).
+ */
+char* getConditionCode(operation op, int negate);
+
+/**
+ * This writes the runtime functions which print the program result and exit
+ * the program.
+ * @param f Reference to the file for storing the assembly.
+ */
+void printAssemblyRuntime(FILE *f);
+
+#endif /*ASSEMBLY_H_*/
@@ -0,0 +1,295 @@
+/**
+ * @file batch.c
+ * @brief This contains all function implementations for the batch mode: a
+ *        list of programs is compiled and executed by a pool of threads within
+ *        one process.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "batch.h"
+#include "optimizer.h"
+#include "profiler.h"
+
+/**
+ * Variable to enable/disable the optimizer.<BR>
+ * [defined in file compiler.c]
+ */
+extern int optimize;
+
+/**
+ * Variable to enable/disable the execution.<BR>
+ * [defined in file compiler.c]
+ */
+extern int execute;
+
+/**
+ * Maximum number of instructions executed by a program.<BR>
+ * [defined in file compiler.c]
+ */
+extern long instructionBudget;
+
+/**
+ * Maximum number of instructions for executing the program at compile time.
+ * <BR>
+ * [defined in file compiler.c]
+ */
+extern long evaluationBudget;
+
+/**
+ * Maximum execution time of a program in seconds.<BR>
+ * [defined in file compiler.c]
+ */
+extern double timeBudget;
+
+/**
+ * This compiles and executes a list of programs by a pool of threads and
+ * prints the result of every program and the throughput to STDOUT.<BR>
+ * Every program uses its own compilation context. The programs are executed
+ * as program images, so neither a trace nor a variable table is written.
+ * @param files   Names of the source files.
+ * @param count   Number of source files.
+ * @param threads Number of threads (<code>0</code> uses one thread per
+ *                processor).
+ * @return <code>0</code> if all programs have been compiled,
+ *         <code>1</code> otherwise.
+ */
+int runBatch(char** files, int count, int threads)
+{
+    if (threads <= 0)
+    {
+#ifndef _WIN32
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        if (threads <= 0)
+        {
+            threads = 4;
+        }
+    }
+    if (threads > count)
+    {
+        threads = (count > 0) ? count : 1;
+    }
+
+    batchQueue queue;
+    queue.jobs = (batchJob*)calloc(count + 1, sizeof(batchJob));
+    queue.count = count;
+    queue.next = 0;
+    pthread_mutex_init(&queue.lock, 0);
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        queue.jobs[i].fileName = files[i];
+    }
+
+    double start = getProfileTime();
+    pthread_t* workers = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    int started = 0;
+    for (i = 0; i < threads; i++)
+    {
+        if (pthread_create(&workers[started], 0, runBatchWorker, &queue) == 0)
+        {
+            started++;
+        }
+    }
+    // Without any thread the programs are compiled by the calling thread
+    if (started == 0)
+    {
+        runBatchWorker(&queue);
+    }
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], 0);
+    }
+    double elapsed = getProfileTime() - start;
+
+    printBatchReport(&queue, (started > 0) ? started : 1, elapsed);
+
+    int result = 0;
+    for (i = 0; i < count; i++)
+    {
+        if ((queue.jobs[i].status != BATCH_COMPILED)
+            && (queue.jobs[i].status != BATCH_EXECUTED))
+        {
+            result = 1;
+        }
+    }
+
+    pthread_mutex_destroy(&queue.lock);
+    free(workers);
+    free(queue.jobs);
+    return result;
+}
+
+/**
+ * This is the main function of a thread of the batch: programs are taken from
+ * the queue and compiled until the queue is empty.
+ * @param queue The batchQueue.
+ * @return <code>null</code>.
+ */
+void* runBatchWorker(void* queue)
+{
+    batchQueue* jobs = (batchQueue*)queue;
+    while (1)
+    {
+        pthread_mutex_lock(&jobs->lock);
+        int index = jobs->next;
+        if (index < jobs->count)
+        {
+            jobs->next++;
+        }
+        pthread_mutex_unlock(&jobs->lock);
+
+        if (index >= jobs->count)
+        {
+            return 0;
+        }
+        compileBatchJob(&jobs->jobs[index]);
+    }
+}
+
+/**
+ * This compiles and executes a single program of the batch.
+ * @param job The program (updated with the results).
+ */
+void compileBatchJob(batchJob* job)
+{
+    FILE *input = fopen(job->fileName, "r");
+    if (input == 0)
+    {
+        job->status = BATCH_UNREADABLE;
+        return;
+    }
+
+    double start = getProfileTime();
+    compilationContext* context = createCompilationContext();
+    // Errors of concurrent compilations are part of the report
+    context->quiet = 1;
+    int result = parseProgram(context, input);
+    job->size = ftell(input);
+    job->lines = context->inputLineNumber;
+    fclose(input);
+
+    if (result != 0)
+    {
+        job->compileTime = getProfileTime() - start;
+        job->status = BATCH_FAILED;
+        if (context->errors != 0)
+        {
+            snprintf(job->error, sizeof(job->error), "%s",
+                     context->errors->message);
+        }
+        freeCompilationContext(context);
+        return;
+    }
+
+    if (optimize)
+    {
+        optimizeCode();
+    }
+    if (evaluationBudget)
+    {
+        evaluateProgram(evaluationBudget);
+    }
+    programImage* image = createProgramImage();
+    job->instructions = image->header->instructionCount;
+    job->compileTime = getProfileTime() - start;
+    job->status = BATCH_COMPILED;
+
+    if (execute)
+    {
+        start = getProfileTime();
+        imageState* state = createImageState(image);
+        setImageBudget(state, instructionBudget, timeBudget);
+        state->guarded = 1;
+        executeProgramImage(state);
+        storeImageResult(state);
+        job->runTime = getProfileTime() - start;
+        strcpy(job->result, context->programResult);
+        job->status = BATCH_EXECUTED;
+        if (state->exceeded)
+        {
+            describeBudgetStop(state->exceeded,
+                               getImageSourceLine(image, state->exceededAt),
+                               job->error);
+            job->status = BATCH_STOPPED;
+        }
+        freeImageState(state);
+    }
+
+    freeProgramImage(image);
+    freeCompilationContext(context);
+}
+
+/**
+ * This prints the result of every program and the throughput of the batch to
+ * STDOUT.
+ * @param queue   The finished batch.
+ * @param threads Number of threads.
+ * @param elapsed Duration of the batch in seconds.
+ */
+void printBatchReport(batchQueue* queue, int threads, double elapsed)
+{
+    int compiled = 0;
+    long lines = 0;
+    long size = 0;
+    double compileTime = 0;
+    double runTime = 0;
+
+    printf("== BATCH ==\n");
+    int i;
+    for (i = 0; i < queue->count; i++)
+    {
+        batchJob* job = &queue->jobs[i];
+        switch (job->status)
+        {
+            case BATCH_COMPILED:
+            case BATCH_EXECUTED:
+            case BATCH_STOPPED:
+                printf("%s: compiled (%u instructions, %.3f ms)",
+                       job->fileName, job->instructions,
+                       job->compileTime * 1000);
+                if (job->status == BATCH_EXECUTED)
+                {
+                    printf(", executed (%.3f ms), PROGRAM RESULT = %s",
+                           job->runTime * 1000, job->result);
+                }
+                else if (job->status == BATCH_STOPPED)
+                {
+                    printf(", stopped (%.3f ms): %s", job->runTime * 1000,
+                           job->error);
+                }
+                printf("\n");
+                compiled++;
+                break;
+            case BATCH_FAILED:
+                printf("%s: compilation failed (line %d): %s\n", job->fileName,
+                       job->lines, job->error);
+                break;
+            default:
+                printf("%s: cannot be read\n", job->fileName);
+        }
+        lines += job->lines;
+        size += job->size;
+        compileTime += job->compileTime;
+        runTime += job->runTime;
+    }
+
+    printf("== BATCH ==\n");
+    printf("Files:      %d (%d compiled, %d failed)\n", queue->count, compiled,
+           queue->count - compiled);
+    printf("Threads:    %d\n", threads);
+    printf("Time:       %.3f ms (compile %.3f ms, run %.3f ms in all "
+           "threads)\n", elapsed * 1000, compileTime * 1000, runTime * 1000);
+    if (elapsed > 0)
+    {
+        printf("Throughput: %.1f files/s, %.0f lines/s, %.1f KB/s\n",
+               queue->count / elapsed, lines / elapsed,
+               size / elapsed / 1024);
+    }
+    printf("== BATCH ==\n");
+}
@@ -0,0 +1,158 @@
+/**
+ * @file batch.h
+ * @brief This defines all data structures and functions for the batch mode:
+ *        a list of programs is compiled and executed by a pool of threads
+ *        within one process.
+ */
+
+#include "context.h"
+#include <stdio.h>
+#include <pthread.h>
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+/**
+ * Type definition to simplify usage of the enumeration.
+ */
+typedef enum e_batchStatus batchStatus;
+
+/**
+ * This enumeration contains the states of a program within the batch.
+ */
+enum e_batchStatus
+{
+    BATCH_WAITING,
+    BATCH_COMPILED,
+    BATCH_EXECUTED,
+    BATCH_STOPPED,
+    BATCH_UNREADABLE,
+    BATCH_FAILED
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_batchJob batchJob;
+
+/**
+ * This structure defines a single program of the batch and its results.
+ */
+struct s_batchJob
+{
+    /**
+     * Name of the source file.
+     */
+    char* fileName;
+
+    /**
+     * State of the program.
+     */
+    batchStatus status;
+
+    /**
+     * Size of the source code in bytes.
+     */
+    long size;
+
+    /**
+     * Number of source code lines.
+     */
+    int lines;
+
+    /**
+     * Number of instructions of the compiled program (see programImage).
+     */
+    unsigned int instructions;
+
+    /**
+     * Duration of the compilation in seconds.
+     */
+    double compileTime;
+
+    /**
+     * Duration of the execution in seconds.
+     */
+    double runTime;
+
+    /**
+     * Value of the RETURN statement (see programResult).
+     */
+    char result[200];
+
+    /**
+     * First error message of a failed compilation (see reportError) or the
+     * reason for stopping the execution (see describeBudgetStop).
+     */
+    char error[200];
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_batchQueue batchQueue;
+
+/**
+ * This structure defines the programs shared by all threads of the batch.
+ */
+struct s_batchQueue
+{
+    /**
+     * All programs of the batch.
+     */
+    batchJob* jobs;
+
+    /**
+     * Number of programs within jobs.
+     */
+    int count;
+
+    /**
+     * Index of the next program which has not been taken by a thread.
+     */
+    int next;
+
+    /**
+     * Lock for taking programs from the queue.
+     */
+    pthread_mutex_t lock;
+};
+
+/**
+ * This compiles and executes a list of programs by a pool of threads and
+ * prints the result of every program and the throughput to STDOUT.<BR>
+ * Every program uses its own compilation context. The programs are executed
+ * as program images, so neither a trace nor a variable table is written.
+ * @param files   Names of the source files.
+ * @param count   Number of source files.
+ * @param threads Number of threads (<code>0</code> uses one thread per
+ *                processor).
+ * @return <code>0</code> if all programs have been compiled,
+ *         <code>1</code> otherwise.
+ */
+int runBatch(char** files, int count, int threads);
+
+/**
+ * This is the main function of a thread of the batch: programs are taken from
+ * the queue and compiled until the queue is empty.
+ * @param queue The batchQueue.
+ * @return <code>null</code>.
+ */
+void* runBatchWorker(void* queue);
+
+/**
+ * This compiles and executes a single program of the batch.
+ * @param job The program (updated with the results).
+ */
+void compileBatchJob(batchJob* job);
+
+/**
+ * This prints the result of every program and the throughput of the batch to
+ * STDOUT.
+ * @param queue   The finished batch.
+ * @param threads Number of threads.
+ * @param elapsed Duration of the batch in seconds.
+ */
+void printBatchReport(batchQueue* queue, int threads, double elapsed);
+
+#endif /*BATCH_H_*/
@@ -0,0 +1,111 @@
+#!/bin/bash
+# Runs the compiler end-to-end on generated workloads (see Benchmark/) and
+# reports compile time, execution time and interpreted instructions per second.
+#
+# Usage: bash benchmark.sh [-r REPEATS] [-o CSV] [COMPILER OPTIONS]
+#
+#   -r REPEATS  number of runs per workload (default: 5)
+#   -o CSV      additionally write the measurements of every run to CSV
+#
+# Remaining options are passed to the compiler (e.g. -O).
+# Requires a compiler built by build.sh.
+
+REPEATS=5
+CSV=""
+OPTIONS=()
+while [ $# -gt 0 ]
+do
+    case "$1" in
+        -r) REPEATS=$2; shift ;;
+        -o) CSV=$(realpath -m "$2"); shift ;;
+        *) OPTIONS+=("$1") ;;
+    esac
+    shift
+done
+
+ROOT_DIR=$(cd "$(dirname "$0")" && pwd)
+COMPILER=${ROOT_DIR}/bin/compiler
+if [ ! -x "${COMPILER}" ]
+then
+    echo "Compiler not found, run build.sh first" >&2
+    exit 1
+fi
+
+# Workload kind, size and iterations (see Benchmark/generate.sh)
+WORKLOADS=(
+    "nested 3 20"
+    "nested 6 5"
+    "chain 100 200"
+    "branchy 50 200"
+    "declarations 1000"
+)
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+# Prints median, minimum and standard deviation of the values on STDIN
+summarize()
+{
+    sort -g | awk '{ v[NR] = $1; sum += $1; sq += $1 * $1 }
+        END {
+            mean = sum / NR
+            var = sq / NR - mean * mean
+            median = (NR % 2) ? v[(NR + 1) / 2] : (v[NR / 2] + v[NR / 2 + 1]) / 2
+            printf "%.3f %.3f %.3f", median, v[1], sqrt(var > 0 ? var : 0)
+        }'
+}
+
+if [ -n "${CSV}" ]
+then
+    echo "workload,run,compile_ms,execute_ms,total_ms,instructions" > "${CSV}"
+fi
+
+echo "Benchmark (${REPEATS} runs per workload, options: ${OPTIONS[*]:-none})"
+printf "%-20s %12s %22s %22s %10s %12s\n" "Workload" "Instructions" \
+       "Compile [ms] med/min" "Execute [ms] med/min" "Total [ms]" "Instr/s"
+
+for workload in "${WORKLOADS[@]}"
+do
+    name=${workload// /-}
+    bash "${ROOT_DIR}/Benchmark/generate.sh" ${workload} > "${WORK_DIR}/${name}.math"
+
+    rm -f "${WORK_DIR}/runs"
+    for ((run = 1; run <= REPEATS; run++))
+    do
+        start=$(date +%s%N)
+        (cd "${WORK_DIR}" && "${COMPILER}" --stats "${OPTIONS[@]}" < "${name}.math" > stats 2>&1)
+        result=$?
+        end=$(date +%s%N)
+        if [ ${result} -ne 0 ]
+        then
+            echo "${name}: compiler failed" >&2
+            exit 1
+        fi
+
+        # Compile time covers parsing (incl. code generation) and optimization
+        awk -v total=$(( (end - start) / 1000 )) '
+            /^ Total/ { phases = 1 }
+            !phases && ($1 == "yyparse" || $1 == "optimizeCode") { compile += $2 }
+            !phases && $1 == "runCode" { execute = $2 }
+            /Executed instructions:/ { instructions = $3 }
+            END { printf "%.3f %.3f %.3f %d\n", compile, execute, total / 1000, instructions }
+            ' "${WORK_DIR}/stats" >> "${WORK_DIR}/runs"
+    done
+
+    if [ -n "${CSV}" ]
+    then
+        awk -v name="${name}" '{ printf "%s,%d,%s,%s,%s,%s\n", name, NR, $1, $2, $3, $4 }' \
+            "${WORK_DIR}/runs" >> "${CSV}"
+    fi
+
+    instructions=$(awk 'NR == 1 { print $4 }' "${WORK_DIR}/runs")
+    read compileMedian compileMin compileDev < <(awk '{ print $1 }' "${WORK_DIR}/runs" | summarize)
+    read executeMedian executeMin executeDev < <(awk '{ print $2 }' "${WORK_DIR}/runs" | summarize)
+    read totalMedian totalMin totalDev < <(awk '{ print $3 }' "${WORK_DIR}/runs" | summarize)
+    rate=$(awk -v n="${instructions}" -v t="${executeMedian}" \
+           'BEGIN { printf "%.0f", (t > 0) ? n / (t / 1000) : 0 }')
+
+    printf "%-20s %12s %22s %22s %10s %12s\n" "${name}" "${instructions}" \
+           "${compileMedian}/${compileMin} ±${compileDev}" \
+           "${executeMedian}/${executeMin} ±${executeDev}" "${totalMedian}" "${rate}"
+done
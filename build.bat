@@ -45,8 +45,80 @@ echo Step 5e - Compile interpreter.c
 gcc -g -c interpreter.c -o bin\interpreter.o
 IF %ERRORLEVEL% GEQ 1 goto :error
 
-echo Step 6  - Link compile result
-gcc -g -o bin\compiler.exe bin\compiler.o bin\symboltable.o bin\generator.o bin\optimizer.o bin\interpreter.o bin\compiler_y.o bin\lex.yy.o -lm -lfl
+echo Step 5f - Compile profiler.c
+gcc -g -c profiler.c -o bin\profiler.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5g - Compile statistics.c
+gcc -g -c statistics.c -o bin\statistics.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5h - Compile jit.c
+gcc -g -c jit.c -o bin\jit.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5i - Compile assembly.c
+gcc -g -c assembly.c -o bin\assembly.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5j - Compile hotloop.c
+gcc -g -c hotloop.c -o bin\hotloop.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5k - Compile perfmap.c
+gcc -g -c perfmap.c -o bin\perfmap.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5l - Compile image.c
+gcc -g -c image.c -o bin\image.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5m - Compile cache.c
+gcc -g -c cache.c -o bin\cache.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5n - Compile context.c
+gcc -g -c context.c -o bin\context.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5o - Compile batch.c
+gcc -g -c batch.c -o bin\batch.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5p - Compile mathdh.c
+gcc -g -c mathdh.c -o bin\mathdh.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5q - Compile server.c
+gcc -g -c server.c -o bin\server.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5r - Compile input.c
+gcc -g -c input.c -o bin\input.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5s - Compile lanes.c
+gcc -g -c lanes.c -o bin\lanes.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5t - Compile scheduler.c
+gcc -g -c scheduler.c -o bin\scheduler.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5u - Compile checkpoint.c
+gcc -g -c checkpoint.c -o bin\checkpoint.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 5v - Compile main.c
+gcc -g -c main.c -o bin\main.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 6  - Create library libmathdh.a
+ar rcs bin\libmathdh.a bin\compiler.o bin\symboltable.o bin\generator.o bin\optimizer.o bin\interpreter.o bin\profiler.o bin\statistics.o bin\jit.o bin\assembly.o bin\hotloop.o bin\perfmap.o bin\image.o bin\cache.o bin\context.o bin\batch.o bin\mathdh.o bin\server.o bin\input.o bin\lanes.o bin\scheduler.o bin\checkpoint.o bin\compiler_y.o bin\lex.yy.o
+IF %ERRORLEVEL% GEQ 1 goto :error
+
+echo Step 7  - Link compile result
+gcc -g -o bin\compiler.exe bin\main.o bin\libmathdh.a -lm -lfl -lpthread
 IF %ERRORLEVEL% GEQ 1 goto :error
 
 goto :eof
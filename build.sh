@@ -32,5 +32,59 @@ gcc -g -c optimizer.c -o bin/optimizer.o || { exit 1; }
 echo "Step 5e Interpeter.o"
 gcc -g -c interpreter.c -o bin/interpreter.o || { exit 1; }
 
-echo "Step 6 Link result"
-gcc -g -o bin/compiler bin/compiler.o bin/symboltable.o bin/generator.o bin/optimizer.o bin/interpreter.o bin/compiler_y.o bin/lex.yy.o -lm -lfl || { exit 1; }
+echo "Step 5f Profiler.o"
+gcc -g -c profiler.c -o bin/profiler.o || { exit 1; }
+
+echo "Step 5g Statistics.o"
+gcc -g -c statistics.c -o bin/statistics.o || { exit 1; }
+
+echo "Step 5h Jit.o"
+gcc -g -c jit.c -o bin/jit.o || { exit 1; }
+
+echo "Step 5i Assembly.o"
+gcc -g -c assembly.c -o bin/assembly.o || { exit 1; }
+
+echo "Step 5j Hotloop.o"
+gcc -g -c hotloop.c -o bin/hotloop.o || { exit 1; }
+
+echo "Step 5k Perfmap.o"
+gcc -g -c perfmap.c -o bin/perfmap.o || { exit 1; }
+
+echo "Step 5l Image.o"
+gcc -g -c image.c -o bin/image.o || { exit 1; }
+
+echo "Step 5m Cache.o"
+gcc -g -c cache.c -o bin/cache.o || { exit 1; }
+
+echo "Step 5n Context.o"
+gcc -g -c context.c -o bin/context.o || { exit 1; }
+
+echo "Step 5o Batch.o"
+gcc -g -c batch.c -o bin/batch.o || { exit 1; }
+
+echo "Step 5p Mathdh.o"
+gcc -g -c mathdh.c -o bin/mathdh.o || { exit 1; }
+
+echo "Step 5q Server.o"
+gcc -g -c server.c -o bin/server.o || { exit 1; }
+
+echo "Step 5r Input.o"
+gcc -g -c input.c -o bin/input.o || { exit 1; }
+
+echo "Step 5s Lanes.o"
+gcc -g -c lanes.c -o bin/lanes.o || { exit 1; }
+
+echo "Step 5t Scheduler.o"
+gcc -g -c scheduler.c -o bin/scheduler.o || { exit 1; }
+
+echo "Step 5u Checkpoint.o"
+gcc -g -c checkpoint.c -o bin/checkpoint.o || { exit 1; }
+
+echo "Step 5v Main.o"
+gcc -g -c main.c -o bin/main.o || { exit 1; }
+
+echo "Step 6 Library libmathdh.a"
+ar rcs bin/libmathdh.a bin/compiler.o bin/symboltable.o bin/generator.o bin/optimizer.o bin/interpreter.o bin/profiler.o bin/statistics.o bin/jit.o bin/assembly.o bin/hotloop.o bin/perfmap.o bin/image.o bin/cache.o bin/context.o bin/batch.o bin/mathdh.o bin/server.o bin/input.o bin/lanes.o bin/scheduler.o bin/checkpoint.o bin/compiler_y.o bin/lex.yy.o || { exit 1; }
+
+echo "Step 7 Link result"
+gcc -g -o bin/compiler bin/main.o bin/libmathdh.a -lm -lfl -ldl -lpthread || { exit 1; }
@@ -0,0 +1,351 @@
+/**
+ * @file cache.c
+ * @brief This contains all function implementations for the compilation
+ *        cache: compiled programs are stored as program images within a cache
+ *        directory, keyed by a hash of the source code, the compiler version
+ *        and the optimization flags.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "cache.h"
+#include "hotloop.h"
+
+/**
+ * Variable to enable/disable debug mode.<BR>
+ * [defined in file compiler.c]
+ */
+extern int debug;
+
+/**
+ * Variable to enable/disable the optimizer.<BR>
+ * [defined in file compiler.c]
+ */
+extern int optimize;
+
+/**
+ * Maximum size of all program images within the cache in bytes.<BR>
+ * [defined in file compiler.c]
+ */
+extern long cacheLimit;
+
+/**
+ * Maximum number of instructions executed by a program.<BR>
+ * [defined in file compiler.c]
+ */
+extern long instructionBudget;
+
+/**
+ * Maximum number of instructions for executing the program at compile time.
+ * <BR>
+ * [defined in file compiler.c]
+ */
+extern long evaluationBudget;
+
+/**
+ * Determines the directory of the compilation cache (environment variable
+ * <code>MATHDH_CACHE</code>, default: <code>.mathdh-cache</code>). The
+ * directory is created if it does not exist.
+ * @return The directory.
+ */
+char* getCacheDirectory()
+{
+    char* directory = getenv("MATHDH_CACHE");
+    if ((directory == 0) || (*directory == 0))
+    {
+        directory = ".mathdh-cache";
+    }
+#ifndef _WIN32
+    mkdir(directory, 0755);
+#else
+    mkdir(directory);
+#endif
+    return directory;
+}
+
+/**
+ * Determines the path of the cached program image for a source code.<BR>
+ * The file name contains a hash of the source code, the compiler version
+ * (including the build time), the optimization flag and the budget of the
+ * evaluation at compile time (which depends on the instruction budget).
+ * @param source The complete source code.
+ * @return The path (to be freed by the caller).
+ */
+char* getCachePath(char* source)
+{
+    char* key = (char*)malloc(strlen(source) + 200);
+    sprintf(key, "MathDH %s (%s %s), image %d, optimize %d, evaluate %ld/%ld"
+                 "\n%s", COMPILER_VERSION, __DATE__, __TIME__, IMAGE_VERSION,
+            optimize ? 1 : 0, evaluationBudget,
+            evaluationBudget ? instructionBudget : 0, source);
+
+    char* directory = getCacheDirectory();
+    char* path = (char*)malloc(strlen(directory) + 40);
+    sprintf(path, "%s/program-%016llx.img", directory, hashText(key));
+    free(key);
+    return path;
+}
+
+/**
+ * This loads a program image from the cache and counts the cache hit or miss.
+ * <BR>
+ * The modification time of the image is updated on a hit, as the eviction
+ * removes the least recently used images first. Invalid images are removed.
+ * @param path The path determined by getCachePath.
+ * @return The loaded image.<BR>
+ *         <code>null</code> if the program is not cached.
+ */
+programImage* lookupCache(char* path)
+{
+    programImage* image = 0;
+    struct stat status;
+    if (stat(path, &status) == 0)
+    {
+        image = loadProgramImage(path);
+        if (image == 0)
+        {
+            remove(path);
+        }
+        else
+        {
+            utime(path, 0);
+        }
+    }
+
+    updateCacheStatistics((image != 0) ? 1 : 0, (image != 0) ? 0 : 1, 0, 0);
+    if (debug)
+    {
+        printf("Compilation cache %s: %s\n", (image != 0) ? "hit" : "miss",
+               path);
+    }
+    return image;
+}
+
+/**
+ * This stores the current intermediate code as program image within the
+ * cache and evicts old images afterwards (see evictCache).<BR>
+ * The image is written to a temporary file first, so concurrent compiler
+ * runs never read an incomplete image.
+ * @param path The path determined by getCachePath.
+ * @return <code>1</code> if the image has been stored.<BR>
+ *         <code>0</code> otherwise.
+ */
+int storeCache(char* path)
+{
+    char* temporary = (char*)malloc(strlen(path) + 20);
+    sprintf(temporary, "%s.%d", path, (int)getpid());
+    int result = writeProgramImage(temporary);
+    if (result)
+    {
+        // An existing image of another process is replaced
+        remove(path);
+        result = (rename(temporary, path) == 0);
+    }
+    if (!result)
+    {
+        remove(temporary);
+    }
+    free(temporary);
+
+    int evictions = evictCache(cacheLimit, path);
+    if (evictions > 0)
+    {
+        updateCacheStatistics(0, 0, evictions, 0);
+    }
+    return result;
+}
+
+/**
+ * This removes the least recently used program images until the total size
+ * of all images within the cache directory does not exceed the limit.
+ * @param limit Maximum size of the cache in bytes.
+ * @param keep  Path of an image which is not removed (the image just stored).
+ * @return Number of removed images.
+ */
+int evictCache(long limit, char* keep)
+{
+    char* directory = getCacheDirectory();
+    DIR* dir = opendir(directory);
+    if (dir == 0)
+    {
+        return 0;
+    }
+
+    int count = 0;
+    int capacity = 64;
+    long total = 0;
+    cacheFile* files = (cacheFile*)malloc(capacity * sizeof(cacheFile));
+    struct dirent* file;
+    while ((file = readdir(dir)) != 0)
+    {
+        int length = strlen(file->d_name);
+        if ((strncmp(file->d_name, "program-", 8) != 0) || (length < 4)
+            || (strcmp(file->d_name + length - 4, ".img") != 0))
+        {
+            continue;
+        }
+
+        char* path = (char*)malloc(strlen(directory) + length + 2);
+        sprintf(path, "%s/%s", directory, file->d_name);
+        struct stat status;
+        if (stat(path, &status) != 0)
+        {
+            free(path);
+            continue;
+        }
+        if (count == capacity)
+        {
+            capacity *= 2;
+            files = (cacheFile*)realloc(files, capacity * sizeof(cacheFile));
+        }
+        files[count].path = path;
+        files[count].size = status.st_size;
+        files[count].used = status.st_mtime;
+        total += status.st_size;
+        count++;
+    }
+    closedir(dir);
+
+    int evictions = 0;
+    int i;
+    qsort(files, count, sizeof(cacheFile), compareCacheFiles);
+    for (i = 0; i < count; i++)
+    {
+        if ((total > limit) && (strcmp(files[i].path, keep) != 0)
+            && (remove(files[i].path) == 0))
+        {
+            total -= files[i].size;
+            evictions++;
+            if (debug)
+            {
+                printf("Compilation cache: evicted %s\n", files[i].path);
+            }
+        }
+        free(files[i].path);
+    }
+    free(files);
+    return evictions;
+}
+
+/**
+ * Compares two cached images by the time of their last use (for
+ * <code>qsort</code>).
+ * @param first  Pointer to the 1st image.
+ * @param second Pointer to the 2nd image.
+ * @return Negative, zero or positive value if the 1st image has been used
+ *         before, at the same time or after the 2nd one.
+ */
+int compareCacheFiles(const void* first, const void* second)
+{
+    long a = ((cacheFile*)first)->used;
+    long b = ((cacheFile*)second)->used;
+    return (a > b) - (a < b);
+}
+
+/**
+ * This adds to the statistics of the cache, which are stored in the file
+ * <code>statistics</code> within the cache directory. The file is locked
+ * while it is updated.
+ * @param hits      Number of additional cache hits.
+ * @param misses    Number of additional cache misses.
+ * @param evictions Number of additional evicted images.
+ * @param values    Receives the updated hits, misses and evictions (may be
+ *                  <code>null</code>).
+ */
+void updateCacheStatistics(long hits, long misses, long evictions,
+                           long* values)
+{
+    char* directory = getCacheDirectory();
+    char* path = (char*)malloc(strlen(directory) + 20);
+    sprintf(path, "%s/statistics", directory);
+
+    long counts[3] = {0, 0, 0};
+    FILE *f = fopen(path, "r+");
+    if (f == 0)
+    {
+        f = fopen(path, "w+");
+    }
+    free(path);
+    if (f == 0)
+    {
+        return;
+    }
+#ifndef _WIN32
+    lockf(fileno(f), F_LOCK, 0);
+#endif
+    if (fscanf(f, "hits %ld\nmisses %ld\nevictions %ld", &counts[0],
+               &counts[1], &counts[2]) != 3)
+    {
+        counts[0] = counts[1] = counts[2] = 0;
+    }
+    counts[0] += hits;
+    counts[1] += misses;
+    counts[2] += evictions;
+    rewind(f);
+    fprintf(f, "hits %ld\nmisses %ld\nevictions %ld\n", counts[0], counts[1],
+            counts[2]);
+    fflush(f);
+#ifndef _WIN32
+    rewind(f);
+    lockf(fileno(f), F_ULOCK, 0);
+#endif
+    fclose(f);
+
+    if (values != 0)
+    {
+        memcpy(values, counts, sizeof(counts));
+    }
+}
+
+/**
+ * This prints the statistics of the cache (hits, misses, evictions, number
+ * and size of the cached images) to STDOUT.
+ */
+void printCacheStatistics()
+{
+    long counts[3];
+    updateCacheStatistics(0, 0, 0, counts);
+
+    int images = 0;
+    long size = 0;
+    char* directory = getCacheDirectory();
+    DIR* dir = opendir(directory);
+    struct dirent* file;
+    while ((dir != 0) && ((file = readdir(dir)) != 0))
+    {
+        if (strncmp(file->d_name, "program-", 8) != 0)
+        {
+            continue;
+        }
+        char* path = (char*)malloc(strlen(directory)
+                                   + strlen(file->d_name) + 2);
+        sprintf(path, "%s/%s", directory, file->d_name);
+        struct stat status;
+        if (stat(path, &status) == 0)
+        {
+            images++;
+            size += status.st_size;
+        }
+        free(path);
+    }
+    if (dir != 0)
+    {
+        closedir(dir);
+    }
+
+    long lookups = counts[0] + counts[1];
+    printf("== COMPILATION CACHE ==\n");
+    printf("Directory: %s\n", directory);
+    printf("Hits:      %ld (%.1f%%)\n", counts[0],
+           (lookups > 0) ? 100.0 * counts[0] / lookups : 0.0);
+    printf("Misses:    %ld\n", counts[1]);
+    printf("Evictions: %ld\n", counts[2]);
+    printf("Images:    %d (%ld of %ld bytes)\n", images, size, cacheLimit);
+    printf("== COMPILATION CACHE ==\n");
+}
@@ -0,0 +1,120 @@
+/**
+ * @file cache.h
+ * @brief This defines all data structures and functions for the compilation
+ *        cache: compiled programs are stored as program images within a cache
+ *        directory, keyed by a hash of the source code, the compiler version
+ *        and the optimization flags.
+ */
+
+#include "image.h"
+#include "compiler.h"
+#include <stdio.h>
+
+#ifndef CACHE_H_
+#define CACHE_H_
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_cacheFile cacheFile;
+
+/**
+ * This structure defines a program image found within the cache directory
+ * (used for the eviction).
+ */
+struct s_cacheFile
+{
+    /**
+     * Path of the file.
+     */
+    char* path;
+
+    /**
+     * Size of the file in bytes.
+     */
+    long size;
+
+    /**
+     * Time of the last use (modification time of the file).
+     */
+    long used;
+};
+
+/**
+ * Determines the directory of the compilation cache (environment variable
+ * <code>MATHDH_CACHE</code>, default: <code>.mathdh-cache</code>). The
+ * directory is created if it does not exist.
+ * @return The directory.
+ */
+char* getCacheDirectory();
+
+/**
+ * Determines the path of the cached program image for a source code.<BR>
+ * The file name contains a hash of the source code, the compiler version
+ * (including the build time) and the optimization flag.
+ * @param source The complete source code.
+ * @return The path (to be freed by the caller).
+ */
+char* getCachePath(char* source);
+
+/**
+ * This loads a program image from the cache and counts the cache hit or miss.
+ * <BR>
+ * The modification time of the image is updated on a hit, as the eviction
+ * removes the least recently used images first. Invalid images are removed.
+ * @param path The path determined by getCachePath.
+ * @return The loaded image.<BR>
+ *         <code>null</code> if the program is not cached.
+ */
+programImage* lookupCache(char* path);
+
+/**
+ * This stores the current intermediate code as program image within the
+ * cache and evicts old images afterwards (see evictCache).<BR>
+ * The image is written to a temporary file first, so concurrent compiler
+ * runs never read an incomplete image.
+ * @param path The path determined by getCachePath.
+ * @return <code>1</code> if the image has been stored.<BR>
+ *         <code>0</code> otherwise.
+ */
+int storeCache(char* path);
+
+/**
+ * This removes the least recently used program images until the total size
+ * of all images within the cache directory does not exceed the limit.
+ * @param limit Maximum size of the cache in bytes.
+ * @param keep  Path of an image which is not removed (the image just stored).
+ * @return Number of removed images.
+ */
+int evictCache(long limit, char* keep);
+
+/**
+ * Compares two cached images by the time of their last use (for
+ * <code>qsort</code>).
+ * @param first  Pointer to the 1st image.
+ * @param second Pointer to the 2nd image.
+ * @return Negative, zero or positive value if the 1st image has been used
+ *         before, at the same time or after the 2nd one.
+ */
+int compareCacheFiles(const void* first, const void* second);
+
+/**
+ * This adds to the statistics of the cache, which are stored in the file
+ * <code>statistics</code> within the cache directory. The file is locked
+ * while it is updated.
+ * @param hits      Number of additional cache hits.
+ * @param misses    Number of additional cache misses.
+ * @param evictions Number of additional evicted images.
+ * @param values    Receives the updated hits, misses and evictions (may be
+ *                  <code>null</code>).
+ */
+void updateCacheStatistics(long hits, long misses, long evictions,
+                           long* values);
+
+/**
+ * This prints the statistics of the cache (hits, misses, evictions, number
+ * and size of the cached images) to STDOUT.
+ */
+void printCacheStatistics();
+
+#endif /*CACHE_H_*/
@@ -0,0 +1,283 @@
+/**
+ * @file checkpoint.c
+ * @brief This contains all function implementations for checkpoints of long
+ *        running executions (see checkpoint.h for the file format).
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "checkpoint.h"
+#include "profiler.h"
+
+/**
+ * Maximum number of instructions executed by a program.<BR>
+ * [defined in file compiler.c]
+ */
+extern long instructionBudget;
+
+/**
+ * Maximum execution time of a program in seconds.<BR>
+ * [defined in file compiler.c]
+ */
+extern double timeBudget;
+
+/**
+ * This is set by requestCheckpoint: <code>1</code> requests a checkpoint,
+ * <code>2</code> a checkpoint and the end of the execution.
+ */
+volatile sig_atomic_t checkpointRequested = 0;
+
+/**
+ * This executes a program image like runProgramImage, but writes checkpoints
+ * of the execution: periodically, on SIGUSR1 and on SIGINT/SIGTERM (which
+ * also end the execution).
+ * @param image          The image to be executed.
+ * @param checkpointFile Name of the checkpoint file (<code>null</code> to
+ *                       write no checkpoints).
+ * @param resumeFile     Name of the checkpoint file to resume the execution
+ *                       from (<code>null</code> to start the program).
+ * @param interval       Number of seconds between two periodic checkpoints.
+ * @return <code>1</code> if the program has finished.<BR>
+ *         <code>0</code> if the checkpoint to resume from cannot be read or
+ *         the execution has been interrupted.
+ */
+int runCheckpointedImage(programImage* image, char* checkpointFile,
+                         char* resumeFile, double interval)
+{
+    imageState* state = createImageState(image);
+    if ((resumeFile != 0) && !readCheckpoint(state, resumeFile))
+    {
+        freeImageState(state);
+        return 0;
+    }
+    // A resumed execution gets the complete time limit again, the
+    // instructions executed before the checkpoint count for the budget
+    setImageBudget(state, instructionBudget, timeBudget);
+
+#ifndef _WIN32
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    if (checkpointFile != 0)
+    {
+        action.sa_handler = requestCheckpoint;
+        sigaction(SIGUSR1, &action, 0);
+        sigaction(SIGINT, &action, 0);
+        sigaction(SIGTERM, &action, 0);
+    }
+#endif
+
+    int interrupted = 0;
+    double next = getProfileTime() + interval;
+    while (!executeProgramImageSlice(state, CHECKPOINT_QUANTUM))
+    {
+        if ((checkpointFile == 0)
+            || (!checkpointRequested && (getProfileTime() < next)))
+        {
+            continue;
+        }
+
+        // A failed checkpoint is reported, but does not end the execution
+        interrupted = (checkpointRequested == 2);
+        checkpointRequested = 0;
+        writeCheckpoint(state, checkpointFile);
+        next = getProfileTime() + interval;
+        if (interrupted)
+        {
+            fprintf(stderr, "Execution interrupted, checkpoint written to "
+                            "%s\n", checkpointFile);
+            break;
+        }
+    }
+
+#ifndef _WIN32
+    if (checkpointFile != 0)
+    {
+        action.sa_handler = SIG_DFL;
+        sigaction(SIGUSR1, &action, 0);
+        sigaction(SIGINT, &action, 0);
+        sigaction(SIGTERM, &action, 0);
+    }
+#endif
+
+    if (!interrupted)
+    {
+        finishProgramImage(state);
+    }
+    freeImageState(state);
+    return !interrupted;
+}
+
+/**
+ * This is the signal handler of runCheckpointedImage: SIGUSR1 requests a
+ * checkpoint, SIGINT and SIGTERM request a checkpoint and the end of the
+ * execution.
+ * @param signal The received signal.
+ */
+void requestCheckpoint(int signal)
+{
+#ifndef _WIN32
+    if (signal == SIGUSR1)
+    {
+        if (checkpointRequested == 0)
+        {
+            checkpointRequested = 1;
+        }
+        return;
+    }
+#endif
+    checkpointRequested = 2;
+}
+
+/**
+ * This writes the execution state of a program image into a checkpoint file.
+ * <BR>
+ * The file is replaced atomically, so an interrupted write keeps the previous
+ * checkpoint.
+ * @param state    The execution state (between two slices).
+ * @param fileName Name of the checkpoint file.
+ * @return <code>1</code> if the checkpoint has been written.<BR>
+ *         <code>0</code> otherwise.
+ */
+int writeCheckpoint(imageState* state, char* fileName)
+{
+    char* temporary = (char*)malloc(strlen(fileName) + 5);
+    sprintf(temporary, "%s.tmp", fileName);
+    FILE *f = fopen(temporary, "wb");
+    if (f == 0)
+    {
+        fprintf(stderr, "Error while creating the checkpoint %s\n",
+                temporary);
+        free(temporary);
+        return 0;
+    }
+
+    int count = state->image->header->symbolCount;
+    checkpointHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CHECKPOINT_MAGIC;
+    header.version = CHECKPOINT_VERSION;
+    header.program = hashProgramImage(state->image);
+    header.symbolCount = count;
+    header.pc = state->pc;
+    header.segment = state->segment;
+    header.counter = state->counter;
+    header.resultType = state->resultType;
+    header.executed = state->executed;
+    header.result = state->result;
+
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(state->values - 1, sizeof(imageValue), count + 1, f);
+    fwrite(state->sequence, sizeof(int), count + 1, f);
+    int result = (fflush(f) == 0) && (ferror(f) == 0);
+#ifndef _WIN32
+    // The checkpoint needs to survive a restart of the machine
+    result &= (fsync(fileno(f)) == 0);
+#endif
+    result &= (fclose(f) == 0);
+
+#ifdef _WIN32
+    remove(fileName);
+#endif
+    if (!result || (rename(temporary, fileName) != 0))
+    {
+        fprintf(stderr, "Error while writing the checkpoint %s\n", fileName);
+        remove(temporary);
+        result = 0;
+    }
+    free(temporary);
+    return result;
+}
+
+/**
+ * This restores the execution state of a program image from a checkpoint
+ * file.
+ * @param state    The new execution state of the same program image.
+ * @param fileName Name of the checkpoint file.
+ * @return <code>1</code> if the state has been restored.<BR>
+ *         <code>0</code> if the file cannot be read or belongs to another
+ *         program (the reason is printed to STDERR).
+ */
+int readCheckpoint(imageState* state, char* fileName)
+{
+    FILE *f = fopen(fileName, "rb");
+    if (f == 0)
+    {
+        fprintf(stderr, "Error while opening the checkpoint %s\n", fileName);
+        return 0;
+    }
+
+    int count = state->image->header->symbolCount;
+    checkpointHeader header;
+    int valid = (fread(&header, sizeof(header), 1, f) == 1)
+                && (header.magic == CHECKPOINT_MAGIC)
+                && (header.version == CHECKPOINT_VERSION)
+                && (header.symbolCount == (unsigned int)count)
+                && (fread(state->values - 1, sizeof(imageValue), count + 1,
+                          f) == (size_t)(count + 1))
+                && (fread(state->sequence, sizeof(int), count + 1, f)
+                    == (size_t)(count + 1))
+                && (fgetc(f) == EOF);
+    fclose(f);
+    if (!valid)
+    {
+        fprintf(stderr, "Invalid checkpoint %s\n", fileName);
+        resetImageState(state);
+        return 0;
+    }
+    if (header.program != hashProgramImage(state->image))
+    {
+        fprintf(stderr, "The checkpoint %s belongs to another program\n",
+                fileName);
+        resetImageState(state);
+        return 0;
+    }
+
+    // The write order is used as index when the variable table is created
+    valid = (header.pc <= state->image->header->instructionCount)
+            && (header.segment <= header.pc) && (header.counter >= 0)
+            && (header.counter <= count) && (header.resultType >= 0)
+            && (header.resultType <= BOOLEAN + 1) && (header.executed >= 0);
+    int i;
+    for (i = 0; valid && (i < count); i++)
+    {
+        valid = (state->sequence[i] >= 0)
+                && (state->sequence[i] <= header.counter);
+    }
+    if (!valid)
+    {
+        fprintf(stderr, "Invalid checkpoint %s\n", fileName);
+        resetImageState(state);
+        return 0;
+    }
+
+    state->pc = header.pc;
+    state->segment = header.segment;
+    state->counter = header.counter;
+    state->resultType = header.resultType;
+    state->executed = header.executed;
+    state->result = header.result;
+    return 1;
+}
+
+/**
+ * Calculates a hash of all bytes of a program image (FNV-1a, as hashText).
+ * @param image The program image.
+ * @return The hash.
+ */
+unsigned long long hashProgramImage(programImage* image)
+{
+    unsigned char* memory = (unsigned char*)image->memory;
+    unsigned long long hash = 14695981039346656037ULL;
+    unsigned int i;
+    for (i = 0; i < image->header->size; i++)
+    {
+        hash ^= memory[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
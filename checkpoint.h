@@ -0,0 +1,162 @@
+/**
+ * @file checkpoint.h
+ * @brief This defines all data structures and functions for checkpoints of
+ *        long running executions: the complete execution state of a program
+ *        image (position, variable values, write order and program result)
+ *        is written into a compact binary file, from which the execution can
+ *        be resumed later with identical results.<BR>
+ *        A checkpoint file starts with a checkpointHeader, followed by the
+ *        values of all variables (imageValue, the scratch value first) and
+ *        the sequence numbers of their first writes (int, with an unused
+ *        last entry), both as stored by imageState.
+ */
+
+#include "image.h"
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+/**
+ * Magic number of a checkpoint file ("MDHC" in little endian).
+ */
+#define CHECKPOINT_MAGIC 0x4348444D
+
+/**
+ * Version of the checkpoint file format.
+ */
+#define CHECKPOINT_VERSION 1
+
+/**
+ * Default number of seconds between two periodic checkpoints.
+ */
+#define CHECKPOINT_INTERVAL 60
+
+/**
+ * Number of instructions executed between two checks for a requested
+ * checkpoint.
+ */
+#define CHECKPOINT_QUANTUM 1000000
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_checkpointHeader checkpointHeader;
+
+/**
+ * This structure defines the header of a checkpoint file.
+ */
+struct s_checkpointHeader
+{
+    /**
+     * Magic number (CHECKPOINT_MAGIC).
+     */
+    unsigned int magic;
+
+    /**
+     * Version of the format (CHECKPOINT_VERSION).
+     */
+    unsigned int version;
+
+    /**
+     * Hash of the executed program image (see hashProgramImage).
+     */
+    unsigned long long program;
+
+    /**
+     * Number of variables of the program image.
+     */
+    unsigned int symbolCount;
+
+    /**
+     * Index of the next instruction (see imageState).
+     */
+    unsigned int pc;
+
+    /**
+     * Index of the first instruction executed since the last jump.
+     */
+    unsigned int segment;
+
+    /**
+     * Number of written variables.
+     */
+    int counter;
+
+    /**
+     * Data type of the program result increased by one (<code>0</code> if
+     * there is no result).
+     */
+    int resultType;
+
+    /**
+     * Unused (keeps the following fields aligned).
+     */
+    unsigned int reserved;
+
+    /**
+     * Number of executed instructions.
+     */
+    long long executed;
+
+    /**
+     * Value of the program result.
+     */
+    imageValue result;
+};
+
+/**
+ * This executes a program image like runProgramImage, but writes checkpoints
+ * of the execution: periodically, on SIGUSR1 and on SIGINT/SIGTERM (which
+ * also end the execution).
+ * @param image          The image to be executed.
+ * @param checkpointFile Name of the checkpoint file (<code>null</code> to
+ *                       write no checkpoints).
+ * @param resumeFile     Name of the checkpoint file to resume the execution
+ *                       from (<code>null</code> to start the program).
+ * @param interval       Number of seconds between two periodic checkpoints.
+ * @return <code>1</code> if the program has finished.<BR>
+ *         <code>0</code> if the checkpoint to resume from cannot be read or
+ *         the execution has been interrupted.
+ */
+int runCheckpointedImage(programImage* image, char* checkpointFile,
+                         char* resumeFile, double interval);
+
+/**
+ * This is the signal handler of runCheckpointedImage: SIGUSR1 requests a
+ * checkpoint, SIGINT and SIGTERM request a checkpoint and the end of the
+ * execution.
+ * @param signal The received signal.
+ */
+void requestCheckpoint(int signal);
+
+/**
+ * This writes the execution state of a program image into a checkpoint file.
+ * <BR>
+ * The file is replaced atomically, so an interrupted write keeps the previous
+ * checkpoint.
+ * @param state    The execution state (between two slices).
+ * @param fileName Name of the checkpoint file.
+ * @return <code>1</code> if the checkpoint has been written.<BR>
+ *         <code>0</code> otherwise.
+ */
+int writeCheckpoint(imageState* state, char* fileName);
+
+/**
+ * This restores the execution state of a program image from a checkpoint
+ * file.
+ * @param state    The new execution state of the same program image.
+ * @param fileName Name of the checkpoint file.
+ * @return <code>1</code> if the state has been restored.<BR>
+ *         <code>0</code> if the file cannot be read or belongs to another
+ *         program (the reason is printed to STDERR).
+ */
+int readCheckpoint(imageState* state, char* fileName);
+
+/**
+ * Calculates a hash of all bytes of a program image (FNV-1a, as hashText).
+ * @param image The program image.
+ * @return The hash.
+ */
+unsigned long long hashProgramImage(programImage* image);
+
+#endif /*CHECKPOINT_H_*/
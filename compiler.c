@@ -10,12 +10,19 @@
 #include <string.h>
 #include "compiler.h"
 #include "symboltable.h"
-
-/**
- * Variable to track current line number.<BR>
- * [defined in file compiler.l]
- */
-extern int inputLineNumber;
+#include "generator.h"
+#include "optimizer.h"
+#include "interpreter.h"
+#include "profiler.h"
+#include "statistics.h"
+#include "jit.h"
+#include "assembly.h"
+#include "hotloop.h"
+#include "perfmap.h"
+#include "image.h"
+#include "cache.h"
+#include "batch.h"
+#include "context.h"
 
 /**
  * Variable to enable/disable debug mode<BR>
@@ -24,25 +31,173 @@ extern int inputLineNumber;
 int debug = 0;
 
 /**
- * Main application entry point.<BR>
- * Uses input from STDIN and forwards it to the scanner for processing.
+ * Variable to enable/disable the optimizer.<BR>
+ * Set to a value unequal to <code>0</code> to run all optimization passes on
+ * the intermediate code before it is printed and executed.
+ */
+int optimize = 0;
+
+/**
+ * Variable to enable/disable profiling mode.<BR>
+ * Set to a value unequal to <code>0</code> to collect execution counts and
+ * times for every intermediate code entry and write them to the files
+ * <code>5_profile</code> and <code>5_profile.folded</code>.
+ */
+int profile = 0;
+
+/**
+ * Variable to enable/disable the execution of the program.<BR>
+ * Set to <code>0</code> to only compile the program. The symbol table and the
+ * intermediate code are written, but the code is not executed.
+ */
+int execute = 1;
+
+/**
+ * Variable to enable/disable native code execution.<BR>
+ * Set to a value unequal to <code>0</code> to translate the intermediate code
+ * into x86-64 machine code and execute it instead of interpreting it. The
+ * interpreter is used if the code cannot be translated or profiling mode is
+ * enabled.
+ */
+int jit = 0;
+
+/**
+ * Variable to enable/disable the C backend.<BR>
+ * Set to a value unequal to <code>0</code> to write the intermediate code as
+ * C program into the file <code>2_intermediate.c</code>.
+ */
+int cBackend = 0;
+
+/**
+ * File name of the native executable to be created by the system C compiler
+ * from the C backend output.<BR>
+ * This is set to <code>null</code> if no executable shall be created.
+ */
+char* executable = 0;
+
+/**
+ * Variable to enable/disable the assembly backend.<BR>
+ * Set to a value unequal to <code>0</code> to write the intermediate code as
+ * x86-64 assembly into the file <code>2_intermediate.s</code>.
+ */
+int assemblyBackend = 0;
+
+/**
+ * File name of the native executable to be created by <code>as</code> and
+ * <code>ld</code> from the assembly backend output.<BR>
+ * This is set to <code>null</code> if no executable shall be created.
+ */
+char* assemblyExecutable = 0;
+
+/**
+ * File name of the program image to be written from the intermediate code.
+ * <BR>
+ * This is set to <code>null</code> if no image shall be written.
+ */
+char* imageFile = 0;
+
+/**
+ * File name of the program image to be executed instead of compiling the
+ * source code from STDIN.<BR>
+ * This is set to <code>null</code> to compile the source code.
+ */
+char* programFile = 0;
+
+/**
+ * Variable to enable/disable the compilation cache.<BR>
+ * Set to a value unequal to <code>0</code> to execute cached program images
+ * instead of compiling the same source code again (see lookupCache).
+ */
+int cache = 0;
+
+/**
+ * Maximum size of all program images within the compilation cache in bytes.
+ */
+long cacheLimit = 16 * 1024 * 1024;
+
+/**
+ * Number of loop iterations after which the interpreter executes a loop as
+ * native code (see runHotLoop).<BR>
+ * Set to <code>0</code> to interpret all loops.
  */
-int main(void)
+long hotLoopThreshold = 0;
+
+/**
+ * Maximum number of instructions executed by a program.<BR>
+ * The budget is checked at the end of every loop iteration, the execution
+ * stops at the first loop which exceeds it. Set to <code>0</code> for no
+ * limit.
+ */
+long instructionBudget = 0;
+
+/**
+ * Maximum execution time of a program in seconds (checked like
+ * instructionBudget).<BR>
+ * Set to <code>0</code> for no limit.
+ */
+double timeBudget = 0;
+
+/**
+ * Maximum number of instructions for executing the program at compile time
+ * (see evaluateProgram).<BR>
+ * Set to <code>0</code> to disable the evaluation at compile time.
+ */
+long evaluationBudget = 0;
+
+/**
+ * Variable to select the output for the perf profiler.<BR>
+ * <code>0</code> disables the output, <code>1</code> names all native code
+ * generated at runtime within <code>/tmp/perf-PID.map</code> and
+ * <code>2</code> additionally writes <code>/tmp/jit-PID.dump</code> (jitdump
+ * format).
+ */
+int perfMap = 0;
+
+/**
+ * Variable to select the statistics output.<BR>
+ * <code>0</code> disables the statistics, <code>1</code> prints the duration
+ * and the hardware performance counters of all compiler phases, the table
+ * sizes and the peak memory usage to STDOUT and <code>2</code> writes the
+ * phases into the file <code>6_trace.json</code> (Chrome trace event format).
+ */
+int statistics = 0;
+
+/**
+ * This reads the complete content of a file into memory.
+ * @param input The file to be read.
+ * @return The content of the file as null-terminated string.
+ */
+char* readInput(FILE *input)
 {
-    yyparse();
-    printSymbolTable();
-    return 0;
+    int size = 4096;
+    int length = 0;
+    char* buffer = (char*)malloc(size);
+    
+    int count;
+    while ((count = fread(buffer + length, 1, size - length - 1, input)) > 0)
+    {
+        length += count;
+        if (length == size - 1)
+        {
+            size *= 2;
+            buffer = (char*)realloc(buffer, size);
+        }
+    }
+    buffer[length] = 0;
+    
+    return buffer;
 }
 
 /**
  * This function is called by the parser if an error has been detected while
  * parsing the input data (e.g. syntax error).
- * @param str The error message to be printed.
+ * @param context The compilation context.
+ * @param str     The error message to be printed.
  */
-void yyerror(const char* str)
+void yyerror(compilationContext* context, const char* str)
 {
-    fprintf(stderr, "Error while parsing input file (Line: %d): %s\n",\
-            inputLineNumber, str);
+    reportError("Error while parsing input file (Line: %d): %s\n",
+                context->inputLineNumber, str);
 }
 
 dataType getType(symbolTableEntry *firstEntry, symbolTableEntry *secondEntry) {
@@ -76,8 +231,6 @@ int hasTypeConflict(dataType firstEntry, dataType secondEntry){
         return 1;
       }
       break;
-
-      return 0;
     }
-
+    return 0;
 }
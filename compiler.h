@@ -12,9 +12,34 @@
 #define COMPILER_H_
 
 /**
- * Reference to standard C function to prevent compiler warnings.
+ * Version of the compiler.<BR>
+ * This is part of the key of cached programs (see getCachePath).
+ */
+#define COMPILER_VERSION "1.1"
+
+/**
+ * Reason for stopping an execution: the instruction budget has been used up
+ * (see instructionBudget).
+ */
+#define BUDGET_INSTRUCTIONS 1
+
+/**
+ * Reason for stopping an execution: the time limit has been reached (see
+ * timeBudget).
+ */
+#define BUDGET_TIME 2
+
+/**
+ * Reason for stopping an execution: an INTEGER division by zero or overflow
+ * (only detected by guarded executions, see imageState).
+ */
+#define BUDGET_FAULT 3
+
+/**
+ * Number of instructions after which the clock is read again for the time
+ * limit.
  */
-extern int yyparse();
+#define BUDGET_CLOCK_INTERVAL 100000
 
 /**
  * Reference to standard C function to prevent compiler warnings.
@@ -22,11 +47,11 @@ extern int yyparse();
 extern char *strdup(const char *s);
 
 /**
- * This function is called by the parser if an error has been detected while
- * parsing the input data (e.g. syntax error).
- * @param str The error message to be printed.
+ * This reads the complete content of a file into memory.
+ * @param input The file to be read.
+ * @return The content of the file as null-terminated string.
  */
-void yyerror(const char* str);
+char* readInput(FILE *input);
 
 char* helperVariableCounter();
 
@@ -5,18 +5,38 @@
 #include "../symboltable.h"
 #include "../generator.h"
 #include "../interpreter.h"
+#include "../input.h"
 #include <stdio.h>
+#include <stdlib.h>
 
 int main(int argc, char **argv);
-void yyerror(const char* message);
-// Variable to track current line number  [defined in compiler.l]
-extern int inputLineNumber;
+
+// Statement lists are right recursive, so the parser stack grows with the
+// number of statements. Allow large programs instead of the default 10000.
+#define YYMAXDEPTH 100000000
 
 %}
 //Bison declarations
 
 %error-verbose
 
+// The parser is reentrant: all state is kept in the compilation context,
+// which also contains the reentrant scanner
+%define api.pure full
+%parse-param {compilationContext* context}
+%lex-param {compilationContext* context}
+
+%code requires
+{
+#include "../context.h"
+}
+
+%code
+{
+// Reads the next token from the scanner of the context  [defined in compiler.l]
+int yylex(YYSTYPE* value, compilationContext* context);
+}
+
 // Define all tokens used in the scanner
 %union {
   char* character;
@@ -36,10 +56,18 @@ extern int inputLineNumber;
 %token INTVAL FLOATVAL BOOLVAL VAR
 %token IF THEN ELSE WHILE DO END
 %token OBR CBR
+%token INPUT
 
 %type <character> VAR
-%type <daType> TYPE BR
-%type <tableEntry> NUM E DEC
+%type <integer> INTVAL
+%type <floating> FLOATVAL
+%type <boolval> BOOLVAL
+%type <daType> TYPE
+%type <tableEntry> NUM E DEC IN BR
+
+// Names which are not consumed by a rule are freed if the parser is aborted
+// (names stored within the symbol table are owned by the symbol table)
+%destructor { free($$); } <character>
 
 %left AND OR
 %right NOT INCREASE DECREASE
@@ -51,36 +79,47 @@ extern int inputLineNumber;
 
 %%    // grammar rules
 
-S:  VAR SET E SEPERATE S
+S:  VAR SET E SEPERATE
   {
     if (! getEntryFromSymbolTable($1))
     {
-        fprintf(stderr, "%s does not exist. Line: %d\n", $1, inputLineNumber);
+        reportError("%s does not exist. Line: %d\n", $1, context->inputLineNumber);
         YYABORT;
     }else if(hasTypeConflict(getEntryFromSymbolTable($1)->type, $3->type)){
-      fprintf(stderr, "%s has type conflict. Line: %d\n", $1, inputLineNumber);
+      reportError("%s has type conflict. Line: %d\n", $1, context->inputLineNumber);
       YYABORT;
     }
+    if (!createCodeAssignment(getEntryFromSymbolTable($1), $3, context->inputLineNumber)) YYABORT;
+  } S
+  {
+    // The name stays on the stack until the statement list has been parsed
+    // (see %destructor)
+    free($1);
   }
-  | INCREASE E SEPERATE S {if($2->type!=INTEGER){fprintf(stderr, "Can only increment integer values. Line: %d\n", inputLineNumber);YYABORT;}}
-  | DECREASE E SEPERATE S {if($2->type!=INTEGER){fprintf(stderr, "Can only decrement integer values. Line: %d\n", inputLineNumber);YYABORT;}}
+  | INCREASE E SEPERATE {if($2->type!=INTEGER){reportError("Can only increment integer values. Line: %d\n", context->inputLineNumber);YYABORT;} if(!createCodeIncrement($2, OP_INCREMENT, context->inputLineNumber)) YYABORT;} S
+  | DECREASE E SEPERATE {if($2->type!=INTEGER){reportError("Can only decrement integer values. Line: %d\n", context->inputLineNumber);YYABORT;} if(!createCodeIncrement($2, OP_DECREMENT, context->inputLineNumber)) YYABORT;} S
   | DEC SEPERATE S
-  | IF BR THEN S EL END SEPERATE S
+  | IN SEPERATE S
+  | IF BR
   {
-    if($2!=BOOLEAN){
-    fprintf(stderr, "Boolean expected at if statement. Line: %d\n", inputLineNumber);
+    if($2->type!=BOOLEAN){
+    reportError("Boolean expected at if statement. Line: %d\n", context->inputLineNumber);
     YYABORT;}
+    if(!createCodeIf($2, context->inputLineNumber)) YYABORT;
   }
-  | WHILE BR DO S END SEPERATE S
+  THEN S EL END {if(!createCodeEnd(context->inputLineNumber)) YYABORT;} SEPERATE S
+  | WHILE {if(!createMarkerWhile(context->inputLineNumber)) YYABORT;} BR
   {
-    if($2!=BOOLEAN){
-    fprintf(stderr, "Boolean expected at while statement. Line: %d\n", inputLineNumber);
+    if($3->type!=BOOLEAN){
+    reportError("Boolean expected at while statement. Line: %d\n", context->inputLineNumber);
     YYABORT;}
+    if(!createCodeWhile($3, context->inputLineNumber)) YYABORT;
   }
+  DO S END {if(!createCodeEnd(context->inputLineNumber)) YYABORT;} SEPERATE S
   | EN
   |;
 
-EL: ELSE S
+EL: ELSE {if(!createCodeElse(context->inputLineNumber)) YYABORT;} S
   |;
 
 E:  E BIG E
@@ -88,66 +127,79 @@ E:  E BIG E
       if ($1->type == BOOLEAN || $3->type == BOOLEAN)
       {
           if ($1->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for comparison. Line: %d\n", $1->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for comparison. Line: %d\n", $1->name, context->inputLineNumber);
           if ($3->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for comparison. Line: %d\n", $3->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for comparison. Line: %d\n", $3->name, context->inputLineNumber);
           YYABORT;
       }
-      $$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);
+      $$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+      if (!createCodeNumericComparison($$, OP_GREATER, $1, $3, context->inputLineNumber)) YYABORT;
   }
   | E BIGEQ E
   {
 		if ($1->type == BOOLEAN || $3->type == BOOLEAN)
 		{
 			if ($1->type == BOOLEAN)
-				fprintf(stderr, "%s is of type boolean. Must be number for comparison. Line: %d\n", $1->name, inputLineNumber);
+				reportError("%s is of type boolean. Must be number for comparison. Line: %d\n", $1->name, context->inputLineNumber);
 			if ($3->type == BOOLEAN)
-				fprintf(stderr, "%s is of type boolean. Must be number for comparison. Line: %d\n", $3->name, inputLineNumber);
+				reportError("%s is of type boolean. Must be number for comparison. Line: %d\n", $3->name, context->inputLineNumber);
 			YYABORT;
 		}
-		$$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);
+		$$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+		if (!createCodeNumericComparison($$, OP_GREATER_OR_EQUAL, $1, $3, context->inputLineNumber)) YYABORT;
 	}
   | E SMALL E
   {
 		if ($1->type == BOOLEAN || $3->type == BOOLEAN)
 		{
 			if ($1->type == BOOLEAN)
-				fprintf(stderr, "%s is of type boolean. Must be number for comparison. Line: %d\n", $1->name, inputLineNumber);
+				reportError("%s is of type boolean. Must be number for comparison. Line: %d\n", $1->name, context->inputLineNumber);
 			if ($3->type == BOOLEAN)
-				fprintf(stderr, "%s is of type boolean. Must be number for comparison. Line: %d\n", $3->name, inputLineNumber);
+				reportError("%s is of type boolean. Must be number for comparison. Line: %d\n", $3->name, context->inputLineNumber);
 			YYABORT;
 		}
-		$$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);
+		$$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+		if (!createCodeNumericComparison($$, OP_LESS, $1, $3, context->inputLineNumber)) YYABORT;
 	}
   | E SMALLEQ E
   {
 		if ($1->type == BOOLEAN || $3->type == BOOLEAN)
 		{
 			if ($1->type == BOOLEAN)
-				fprintf(stderr, "%s is of type boolean. Must be number for comparison. Line: %d\n", $1->name, inputLineNumber);
+				reportError("%s is of type boolean. Must be number for comparison. Line: %d\n", $1->name, context->inputLineNumber);
 			if ($3->type == BOOLEAN)
-				fprintf(stderr, "%s is of type boolean. Must be number for comparison. Line: %d\n", $3->name, inputLineNumber);
+				reportError("%s is of type boolean. Must be number for comparison. Line: %d\n", $3->name, context->inputLineNumber);
 			YYABORT;
 		}
-		$$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);
+		$$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+		if (!createCodeNumericComparison($$, OP_LESS_OR_EQUAL, $1, $3, context->inputLineNumber)) YYABORT;
 	}
-  | E EQ E { $$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);}
-  | E NOTEQ E { $$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);}
+  | E EQ E
+  {
+      $$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+      if (!createCodeNumericComparison($$, OP_EQUAL, $1, $3, context->inputLineNumber)) YYABORT;
+  }
+  | E NOTEQ E
+  {
+      $$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+      if (!createCodeNumericComparison($$, OP_NOT_EQUAL, $1, $3, context->inputLineNumber)) YYABORT;
+  }
   | E AND E
   {
       if (! ($1->type == BOOLEAN) || ! ($3->type == BOOLEAN))
       {
           if ($1->type == REAL)
-              fprintf(stderr, "%s is of type float. Must be boolean. Line: %d\n", $1->name, inputLineNumber);
+              reportError("%s is of type float. Must be boolean. Line: %d\n", $1->name, context->inputLineNumber);
           if ($3->type == REAL)
-              fprintf(stderr, "%s is of type float. Must be boolean. Line: %d\n", $3->name, inputLineNumber);
+              reportError("%s is of type float. Must be boolean. Line: %d\n", $3->name, context->inputLineNumber);
           if ($1->type == INTEGER)
-              fprintf(stderr, "%s is of type integer. Must be boolean. Line: %d\n", $1->name, inputLineNumber);
+              reportError("%s is of type integer. Must be boolean. Line: %d\n", $1->name, context->inputLineNumber);
           if ($3->type == INTEGER)
-              fprintf(stderr, "%s is of type float. Must be boolean. Line: %d\n", $3->name, inputLineNumber);
+              reportError("%s is of type float. Must be boolean. Line: %d\n", $3->name, context->inputLineNumber);
           YYABORT;
       }
-      $$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);
+      $$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+      if (!createCodeLogicalCombination($$, OP_AND, $1, $3, context->inputLineNumber)) YYABORT;
   }
 
   | E OR E
@@ -155,114 +207,127 @@ E:  E BIG E
       if (! ($1->type == BOOLEAN) || ! ($3->type == BOOLEAN))
       {
           if ($1->type == REAL)
-              fprintf(stderr, "%s is of type float. Must be boolean. Line: %d\n", $1->name, inputLineNumber);
+              reportError("%s is of type float. Must be boolean. Line: %d\n", $1->name, context->inputLineNumber);
           if ($3->type == REAL)
-              fprintf(stderr, "%s is of type float. Must be boolean. Line: %d\n", $3->name, inputLineNumber);
+              reportError("%s is of type float. Must be boolean. Line: %d\n", $3->name, context->inputLineNumber);
           if ($1->type == INTEGER)
-              fprintf(stderr, "%s is of type integer. Must be boolean. Line: %d\n", $1->name, inputLineNumber);
+              reportError("%s is of type integer. Must be boolean. Line: %d\n", $1->name, context->inputLineNumber);
           if ($3->type == INTEGER)
-              fprintf(stderr, "%s is of type float. Must be boolean. Line: %d\n", $3->name, inputLineNumber);
+              reportError("%s is of type float. Must be boolean. Line: %d\n", $3->name, context->inputLineNumber);
           YYABORT;
       }
-      $$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);
+      $$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+      if (!createCodeLogicalCombination($$, OP_OR, $1, $3, context->inputLineNumber)) YYABORT;
   }
   | NOT E
   {
       if ( $2->type != BOOLEAN)
       {
           if ($2->type == REAL)
-              fprintf(stderr, "%s is of type float. Must be boolean. Line: %d\n", $2->name, inputLineNumber);
+              reportError("%s is of type float. Must be boolean. Line: %d\n", $2->name, context->inputLineNumber);
           if ($2->type == INTEGER)
-              fprintf(stderr, "%s is of type integer. Must be boolean. Line: %d\n", $2->name, inputLineNumber);
+              reportError("%s is of type integer. Must be boolean. Line: %d\n", $2->name, context->inputLineNumber);
           YYABORT;
       }
-      $$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);
+      $$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+      if (!createCodeLogicalCombination($$, OP_NOT, $2, 0, context->inputLineNumber)) YYABORT;
   }
   | E PLUS E
   {
 		if ($1->type == BOOLEAN || $3->type == BOOLEAN)
 		{
 			if ($1->type == BOOLEAN)
-				fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, inputLineNumber);
+				reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, context->inputLineNumber);
 			if ($3->type == BOOLEAN)
-				fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, inputLineNumber);
+				reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, context->inputLineNumber);
 			YYABORT;
 		}
-		$$ = addEntryToSymbolTable(getName(), getType($1, $3), inputLineNumber);
+		$$ = addEntryToSymbolTable(getName(), getType($1, $3), context->inputLineNumber);
+		if (!createCodeMathematicalOperation($$, OP_PLUS, $1, $3, context->inputLineNumber)) YYABORT;
 	}
   | E MINUS E
   {
       if ($1->type == BOOLEAN || $3->type == BOOLEAN)
       {
           if ($1->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, context->inputLineNumber);
           if ($3->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, context->inputLineNumber);
           YYABORT;
       }
-      $$ = addEntryToSymbolTable(getName(), getType($1, $3), inputLineNumber);
+      $$ = addEntryToSymbolTable(getName(), getType($1, $3), context->inputLineNumber);
+      if (!createCodeMathematicalOperation($$, OP_MINUS, $1, $3, context->inputLineNumber)) YYABORT;
   }
   | E TIMES E
   {
       if ($1->type == BOOLEAN || $3->type == BOOLEAN)
       {
           if ($1->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, context->inputLineNumber);
           if ($3->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, context->inputLineNumber);
           YYABORT;
       }
-      $$ = addEntryToSymbolTable(getName(), getType($1, $3), inputLineNumber);
+      $$ = addEntryToSymbolTable(getName(), getType($1, $3), context->inputLineNumber);
+      if (!createCodeMathematicalOperation($$, OP_MULTIPLY, $1, $3, context->inputLineNumber)) YYABORT;
   }
   | E DIV E
   {
       if ($1->type == BOOLEAN || $3->type == BOOLEAN)
       {
           if ($1->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, context->inputLineNumber);
           if ($3->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, context->inputLineNumber);
           YYABORT;
       }
-      $$ = addEntryToSymbolTable(getName(), getType($1, $3), inputLineNumber);
+      $$ = addEntryToSymbolTable(getName(), getType($1, $3), context->inputLineNumber);
+      if (!createCodeMathematicalOperation($$, OP_DIVIDE, $1, $3, context->inputLineNumber)) YYABORT;
   }
   | E MOD E
   {
       if ($1->type == BOOLEAN || $3->type == BOOLEAN)
       {
           if ($1->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $1->name, context->inputLineNumber);
 
           if ($3->type == BOOLEAN)
-              fprintf(stderr, "%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, inputLineNumber);
+              reportError("%s is of type boolean. Must be number for calculation. Line: %d\n", $3->name, context->inputLineNumber);
           YYABORT;
       }
-      $$ = addEntryToSymbolTable(getName(), getType($1, $3), inputLineNumber);
+      $$ = addEntryToSymbolTable(getName(), getType($1, $3), context->inputLineNumber);
+      if (!createCodeMathematicalOperation($$, OP_MODULO, $1, $3, context->inputLineNumber)) YYABORT;
   }
   | NUM {$$ = $1;}
   | VAR
   {
       if (! getEntryFromSymbolTable($1))
       {
-          fprintf(stderr, "%s does not exist. Line: %d\n", $1, inputLineNumber);
+          reportError("%s does not exist. Line: %d\n", $1, context->inputLineNumber);
+          free($1);
           YYABORT;
       } else $$ = (getEntryFromSymbolTable($1));
+      free($1);
   }
   | INCREASE E
   { if($2->type!=INTEGER){
-    fprintf(stderr, "Can only increment integer values. Line: %d\n", inputLineNumber);YYABORT;}
+    reportError("Can only increment integer values. Line: %d\n", context->inputLineNumber);YYABORT;}
     else{
-    $$ = $2++;
+    $$ = $2;
+    if (!createCodeIncrement($2, OP_INCREMENT, context->inputLineNumber)) YYABORT;
   }
   }
   | DECREASE E
   {
     if($2->type!=INTEGER){
-      fprintf(stderr, "Can only decrement integer values. Line: %d\n", inputLineNumber);YYABORT;}
-      else{$$ = $2--;}
+      reportError("Can only decrement integer values. Line: %d\n", context->inputLineNumber);YYABORT;}
+      else{
+      $$ = $2;
+      if (!createCodeIncrement($2, OP_DECREMENT, context->inputLineNumber)) YYABORT;
+    }
   };
 
-BR: OBR E Z CBR {$$=$2->type;};
+BR: OBR E Z CBR {$$=$2;};
 
 Z: BR
   |;
@@ -271,60 +336,111 @@ DEC: TYPE VAR
   {
       if (getEntryFromSymbolTable($2))
       {
-          fprintf(stderr, "%s already exists. Line: %d\n", $2, inputLineNumber);
+          reportError("%s already exists. Line: %d\n", $2, context->inputLineNumber);
+          free($2);
           YYABORT;
-      } else $$ = addEntryToSymbolTable($2, $1, inputLineNumber);
+      } else $$ = addEntryToSymbolTable($2, $1, context->inputLineNumber);
   }
   | TYPE VAR SET E
   {
     if (getEntryFromSymbolTable($2))
     {
-        fprintf(stderr, "%s already exists. Line: %d\n", $2, inputLineNumber);
+        reportError("%s already exists. Line: %d\n", $2, context->inputLineNumber);
+        free($2);
         YYABORT;
     } else if(hasTypeConflict($1,$4->type)){
-      fprintf(stderr, "%s has type conflict. Line: %d\n", $2, inputLineNumber);
+      reportError("%s has type conflict. Line: %d\n", $2, context->inputLineNumber);
+      free($2);
       YYABORT;
     }
-    else $$ = addEntryToSymbolTable($2, $1, inputLineNumber);
+    else
+    {
+      $$ = addEntryToSymbolTable($2, $1, context->inputLineNumber);
+      if (!createCodeAssignment($$, $4, context->inputLineNumber)) YYABORT;
+    }
   }
   | DEC COM VAR
   {
     if (getEntryFromSymbolTable($3))
     {
-        fprintf(stderr, "%s already exists. Line: %d\n", $3, inputLineNumber);
+        reportError("%s already exists. Line: %d\n", $3, context->inputLineNumber);
+        free($3);
         YYABORT;
-    } else $$ = addEntryToSymbolTable($3, $1->type, inputLineNumber);
+    } else $$ = addEntryToSymbolTable($3, $1->type, context->inputLineNumber);
   }
   | DEC COM VAR SET E
   {
     if (getEntryFromSymbolTable($3))
     {
-        fprintf(stderr, "%s already exists. Line: %d\n", $3, inputLineNumber);
+        reportError("%s already exists. Line: %d\n", $3, context->inputLineNumber);
+        free($3);
         YYABORT;
     } else if(hasTypeConflict($1->type, $5->type)){
-      fprintf(stderr, "%s has type conflict. Line: %d\n", $3, inputLineNumber);
+      reportError("%s has type conflict. Line: %d\n", $3, context->inputLineNumber);
+      free($3);
       YYABORT;
     }
-    else $$ = addEntryToSymbolTable($3, $1->type, inputLineNumber);
+    else
+    {
+      $$ = addEntryToSymbolTable($3, $1->type, context->inputLineNumber);
+      if (!createCodeAssignment($$, $5, context->inputLineNumber)) YYABORT;
+    }
+  };
+
+IN: INPUT TYPE VAR
+  {
+      $$ = declareInput($3, $2, $2, 0, context->inputLineNumber);
+      if (!$$) YYABORT;
+  }
+  | INPUT TYPE VAR SET INTVAL
+  {
+      $$ = declareInput($3, $2, INTEGER, $5, context->inputLineNumber);
+      if (!$$) YYABORT;
+  }
+  | INPUT TYPE VAR SET FLOATVAL
+  {
+      $$ = declareInput($3, $2, REAL, $5, context->inputLineNumber);
+      if (!$$) YYABORT;
+  }
+  | INPUT TYPE VAR SET BOOLVAL
+  {
+      $$ = declareInput($3, $2, BOOLEAN, $5, context->inputLineNumber);
+      if (!$$) YYABORT;
   };
 
 TYPE: INT {$$ = INTEGER;}
   | FLOAT {$$ = REAL;}
   | BOOL {$$ = BOOLEAN;};
 
-NUM: INTVAL {$$ = addEntryToSymbolTable(getName(), INTEGER, inputLineNumber);}
-  | FLOATVAL {$$ = addEntryToSymbolTable(getName(), REAL, inputLineNumber);}
-  | BOOLVAL {$$ = addEntryToSymbolTable(getName(), BOOLEAN, inputLineNumber);};
+NUM: INTVAL
+  {
+      $$ = addEntryToSymbolTable(getName(), INTEGER, context->inputLineNumber);
+      if (!createCodeIntConst($$, $1, context->inputLineNumber)) YYABORT;
+  }
+  | FLOATVAL
+  {
+      $$ = addEntryToSymbolTable(getName(), REAL, context->inputLineNumber);
+      if (!createCodeFloatConst($$, $1, context->inputLineNumber)) YYABORT;
+  }
+  | BOOLVAL
+  {
+      $$ = addEntryToSymbolTable(getName(), BOOLEAN, context->inputLineNumber);
+      if (!createCodeBoolConst($$, $1, context->inputLineNumber)) YYABORT;
+  };
 
 EN: EXIT SEPERATE
   | EXIT VAR SEPERATE
   {
       if (! getEntryFromSymbolTable($2))
       {
-          fprintf(stderr, "%s does not exist. Line: %d\n", $2, inputLineNumber);
+          reportError("%s does not exist. Line: %d\n", $2, context->inputLineNumber);
+          free($2);
           YYABORT;
       }
+      int created = createCodeExit(getEntryFromSymbolTable($2), context->inputLineNumber);
+      free($2);
+      if (!created) YYABORT;
   }
-  | EXIT BR SEPERATE;
+  | EXIT BR SEPERATE {if (!createCodeExit($2, context->inputLineNumber)) YYABORT;};
 
 %%
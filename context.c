@@ -0,0 +1,204 @@
+/**
+ * @file context.c
+ * @brief This contains all function implementations for the compilation
+ *        context, which holds the complete state of a single compilation.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+#include "context.h"
+
+/**
+ * The compilation context of the current thread.<BR>
+ * This is set by the creator of a context before the compiler functions are
+ * called (see useCompilationContext).
+ */
+__thread compilationContext* compilation = 0;
+
+/**
+ * This creates an empty compilation context.
+ * @return The new context.
+ */
+compilationContext* createCompilationContext()
+{
+    compilationContext* context = (compilationContext*)
+                                  calloc(1, sizeof(compilationContext));
+    context->inputLineNumber = 1;
+    return context;
+}
+
+/**
+ * This selects the compilation context of the current thread.
+ * @param context The context to be used (may be <code>null</code>).
+ */
+void useCompilationContext(compilationContext* context)
+{
+    compilation = context;
+}
+
+/**
+ * This frees a compilation context including the symbol table, the
+ * intermediate code, the variable table and all buffers of the backends.<BR>
+ * If the context is the context of the current thread, the thread has no
+ * context afterwards.
+ * @param context The context created by createCompilationContext.
+ */
+void freeCompilationContext(compilationContext* context)
+{
+    // Register operands point to constant strings, memory operands have been
+    // allocated (see allocateRegisters)
+    symbolTableEntry* symbol = context->symbolTable;
+    while (symbol != 0)
+    {
+        if ((context->assemblyOperand != 0)
+            && (context->assignedRegister[symbol->index] < 0))
+        {
+            free(context->assemblyOperand[symbol->index]);
+        }
+        symbolTableEntry* next = symbol->next;
+        free(symbol->name);
+        free(symbol);
+        symbol = next;
+    }
+
+    freeCodeList(context->codeList);
+
+    codePrintEntry* printEntry = context->printCodeList;
+    while (printEntry != 0)
+    {
+        codePrintEntry* next = printEntry->next;
+        free(printEntry->code);
+        free(printEntry);
+        printEntry = next;
+    }
+
+    compilationError* error = context->errors;
+    while (error != 0)
+    {
+        compilationError* next = error->next;
+        free(error->message);
+        free(error);
+        error = next;
+    }
+
+    inputAssignment* assignment = context->inputAssignments;
+    while (assignment != 0)
+    {
+        inputAssignment* next = assignment->next;
+        free(assignment->name);
+        free(assignment);
+        assignment = next;
+    }
+
+    inputVariable* input = context->inputVariables;
+    while (input != 0)
+    {
+        inputVariable* next = input->next;
+        free(input);
+        input = next;
+    }
+
+    variableTableEntry* variable = context->variableTable;
+    while (variable != 0)
+    {
+        variableTableEntry* next = variable->next;
+        free(variable);
+        variable = next;
+    }
+
+    hotLoop* loop = context->hotLoopList;
+    while (loop != 0)
+    {
+        hotLoop* next = loop->next;
+#ifndef _WIN32
+        if (loop->library != 0)
+        {
+            dlclose(loop->library);
+        }
+#endif
+        free(loop->symbols);
+        free(loop);
+        loop = next;
+    }
+
+    free(context->imageCode);
+    free(context->imageConstants);
+    free(context->imageLines);
+    free(context->liveStart);
+    free(context->liveEnd);
+    free(context->liveAtEntry);
+    free(context->assignedRegister);
+    free(context->assemblyOperand);
+    free(context->loopStart);
+    free(context->loopEnd);
+
+    if (compilation == context)
+    {
+        compilation = 0;
+    }
+    free(context);
+}
+
+/**
+ * This frees a code list including all nested code lists.
+ * @param list The first entry of the code list.
+ */
+void freeCodeList(codeEntry* list)
+{
+    while (list != 0)
+    {
+        codeEntry* next = list->next;
+        freeCodeList(list->sub_1);
+        freeCodeList(list->sub_2);
+        free(list);
+        list = next;
+    }
+}
+
+/**
+ * This records an error within the compilation context of the current thread
+ * and prints it to STDERR (unless the context is quiet).
+ * @param format The error message (<code>printf</code> format).
+ */
+void reportError(const char* format, ...)
+{
+    char message[1000];
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(message, sizeof(message), format, arguments);
+    va_end(arguments);
+
+    compilationContext* context = compilation;
+    if ((context == 0) || !context->quiet)
+    {
+        fprintf(stderr, "%s", message);
+    }
+    if (context == 0)
+    {
+        return;
+    }
+
+    // The message is stored without the line break
+    int length = strlen(message);
+    while ((length > 0) && (message[length - 1] == '\n'))
+    {
+        message[--length] = 0;
+    }
+    compilationError* error = (compilationError*)
+                              malloc(sizeof(compilationError));
+    error->line = context->inputLineNumber;
+    error->message = strdup(message);
+    error->next = 0;
+
+    compilationError** last = &context->errors;
+    while (*last != 0)
+    {
+        last = &(*last)->next;
+    }
+    *last = error;
+}
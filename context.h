@@ -0,0 +1,432 @@
+/**
+ * @file context.h
+ * @brief This defines the compilation context, which holds the complete state
+ *        of a single compilation (scanner, symbol table, intermediate code,
+ *        execution and backends), so that several programs can be compiled
+ *        and executed at the same time within one process.
+ */
+
+#include "generator.h"
+#include "symboltable.h"
+#include "interpreter.h"
+#include "image.h"
+#include "hotloop.h"
+#include "input.h"
+#include "compiler.h"
+#include <stdio.h>
+
+#ifndef CONTEXT_H_
+#define CONTEXT_H_
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_compilationError compilationError;
+
+/**
+ * This structure defines an error detected while compiling a program.
+ */
+struct s_compilationError
+{
+    /**
+     * Line of the input where the error has been detected.
+     */
+    int line;
+
+    /**
+     * The error message.
+     */
+    char* message;
+
+    /**
+     * Pointer to the next error.
+     */
+    compilationError* next;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_compilationContext compilationContext;
+
+/**
+ * This structure contains the state of a single compilation.<BR>
+ * The parser and the scanner receive the context as parameter, all other
+ * modules use the context of the current thread (see compilation).
+ */
+struct s_compilationContext
+{
+    /**
+     * The reentrant scanner (<code>yyscan_t</code>, <code>null</code> if no
+     * input is being parsed).
+     */
+    void* scanner;
+
+    /**
+     * Variable to track current line number of the input.
+     */
+    int inputLineNumber;
+
+    /**
+     * Pointer to the first error of the compilation (see reportError).
+     */
+    compilationError* errors;
+
+    /**
+     * Set to a value unequal to <code>0</code> to collect errors without
+     * printing them to STDERR.
+     */
+    int quiet;
+
+    /**
+     * Pointer to the first entry of the symbol table.<BR>
+     * This variable is automatically initialized when adding the first entry.
+     */
+    symbolTableEntry* symbolTable;
+
+    /**
+     * Number of the next helper variable (see getName).
+     */
+    int helperCounter;
+
+    /**
+     * Number of symbol table additions and searches.
+     */
+    long symbolTableCalls;
+
+    /**
+     * Number of symbol table entries walked through by additions and
+     * searches (shows the growth of the symbol table operations).
+     */
+    long symbolTableSteps;
+
+    /**
+     * Pointer to the first entry of the code list.<BR>
+     * This variable is automatically initialized when adding the first entry.
+     */
+    codeEntry* codeList;
+
+    /**
+     * Pointer to the last entry of the code list.<BR>
+     * This is used to prevent walking through the whole list whenever adding a
+     * new entry and to consider the nesting for if/while structures.
+     */
+    codeEntry* currentCodeEntry;
+
+    /**
+     * Pointer to the current nesting context (for if/while).<BR>
+     * This is set to <code>null</code> if the current code is not part of any
+     * nested structure.
+     */
+    codeEntry* currentContext;
+
+    /**
+     * This variable holds the current line number for the intermediate code.
+     * <BR>
+     * Line numbers are required within intermediate code to determine target
+     * locations for GOTO statements which are generated for if/while
+     * structures.
+     */
+    int codeLineNumber;
+
+    /**
+     * Number of created and appended code entries.
+     */
+    long codeGenerationCalls;
+
+    /**
+     * Pointer to the first entry of the code list for printing.<BR>
+     * This variable is automatically initialized when adding the first entry.
+     * <BR>
+     * All intermediate code entries are first added to this list and only
+     * written to the target file after complete parsing. This is to evaluate
+     * all required back-patching for GOTO statements.
+     */
+    codePrintEntry* printCodeList;
+
+    /**
+     * Pointer to the last entry of the code list for printing.<BR>
+     * This is used to prevent walking through the whole list whenever adding a
+     * new entry.
+     */
+    codePrintEntry* currentPrintCodeList;
+
+    /**
+     * Line number for the previous WHILE line marker.<BR>
+     * Markers are required for WHILE loops as the condition part might have to
+     * be recalculated for every loop in case any variable contained has been
+     * changed within the loop body.
+     * @see createMarkerWhile
+     */
+    int lastWhileMarkerCodeLine;
+
+    /**
+     * Variable to enable/disable the recording of first writes in the C
+     * backend.<BR>
+     * Set to a value unequal to <code>0</code> to write code which stores a
+     * sequence number (<code>sequence[index]</code>, incremented by
+     * <code>*counter</code>) whenever a variable is written for the first
+     * time. This is used to keep the order of the variable table for loops
+     * executed as native code.
+     */
+    int cWriteTracking;
+
+    /**
+     * This is set to <code>1</code> once the intermediate code has been
+     * optimized (see optimizeCode).
+     */
+    int optimized;
+
+    /**
+     * Pointer to the first value given for an input (see addInputAssignment).
+     */
+    inputAssignment* inputAssignments;
+
+    /**
+     * Pointer to the first declared input (see declareInput).
+     */
+    inputVariable* inputVariables;
+
+    /**
+     * Pointer to the first entry of the variable table.<BR>
+     * This variable is automatically initialized when adding the first entry.
+     */
+    variableTableEntry* variableTable;
+
+    /**
+     * Reference to the previous WHILE line marker.<BR>
+     * Markers are required for WHILE loops as the condition part might have to
+     * be recalculated for every loop in case any variable contained has been
+     * changed within the loop body.
+     */
+    codeEntry* lastWhileMarker;
+
+    /**
+     * This variable holds the value of the RETURN statement after program
+     * execution has been completed.<BR>
+     * The value is converted to a string based on its data type.
+     */
+    char programResult[200];
+
+    /**
+     * This variable counts the number of executed code entries (dispatches of
+     * runCodeEntry) during program execution.
+     */
+    long executedInstructions;
+
+    /**
+     * Value of executedInstructions at which the next loop iteration checks
+     * the limits of the execution (see checkLoopBudget).
+     */
+    long budgetLimit;
+
+    /**
+     * Time (see getProfileTime) at which the execution is stopped
+     * (<code>0</code> for no time limit).
+     */
+    double deadline;
+
+    /**
+     * Reason for stopping the execution before the end of the program
+     * (BUDGET_INSTRUCTIONS or BUDGET_TIME, <code>0</code> if the execution
+     * has not been stopped).
+     */
+    int budgetExceeded;
+
+    /**
+     * Source line of the loop which exceeded the limit.
+     */
+    int budgetLine;
+
+    /**
+     * Accumulated execution time of nested sub-code of the code entry which is
+     * currently profiled.
+     */
+    double profileChildTime;
+
+    /**
+     * Pointer to the first translated loop.<BR>
+     * Every loop is translated only once, also if the translation failed.
+     */
+    hotLoop* hotLoopList;
+
+    /**
+     * Instructions of the program image while it is created.
+     */
+    imageInstruction* imageCode;
+
+    /**
+     * Number of instructions within imageCode.
+     */
+    int imageCodeCount;
+
+    /**
+     * Allocated number of entries within imageCode.
+     */
+    int imageCodeCapacity;
+
+    /**
+     * Constant pool of the program image while it is created.
+     */
+    imageValue* imageConstants;
+
+    /**
+     * Number of constants within imageConstants.
+     */
+    int imageConstantCount;
+
+    /**
+     * Allocated number of entries within imageConstants.
+     */
+    int imageConstantCapacity;
+
+    /**
+     * Source line table of the program image while it is created.
+     */
+    imageLine* imageLines;
+
+    /**
+     * Number of entries within imageLines.
+     */
+    int imageLineCount;
+
+    /**
+     * Allocated number of entries within imageLines.
+     */
+    int imageLineCapacity;
+
+    /**
+     * First position of the live interval per variable (indexed by
+     * symbolTableEntry.index).<BR>
+     * This is <code>-1</code> for variables which are not used by the code.
+     */
+    int* liveStart;
+
+    /**
+     * Last position of the live interval per variable (indexed by
+     * symbolTableEntry.index).
+     */
+    int* liveEnd;
+
+    /**
+     * Set to <code>1</code> per variable (indexed by symbolTableEntry.index)
+     * which may be read before its first write. Its live interval starts at
+     * program entry, where its register is cleared.
+     */
+    int* liveAtEntry;
+
+    /**
+     * Assigned register per variable (indexed by symbolTableEntry.index).<BR>
+     * This is the index within integerRegisters or realRegisters or
+     * <code>-1</code> for variables stored in memory.
+     */
+    int* assignedRegister;
+
+    /**
+     * Assembly operand per variable (indexed by symbolTableEntry.index).
+     * @see getAssemblyOperand
+     */
+    char** assemblyOperand;
+
+    /**
+     * First position (WHILE marker or DO WHILE entry) of every loop.
+     */
+    int* loopStart;
+
+    /**
+     * Last position (last entry of the loop body) of every loop.
+     */
+    int* loopEnd;
+
+    /**
+     * Number of loops within loopStart/loopEnd.
+     */
+    int loopCount;
+
+    /**
+     * Number of the last label created within the assembly.
+     */
+    int assemblyLabel;
+};
+
+/**
+ * The compilation context of the current thread.<BR>
+ * This is set by the creator of a context before the compiler functions are
+ * called (see useCompilationContext).<BR>
+ * [defined in file context.c]
+ */
+extern __thread compilationContext* compilation;
+
+/**
+ * This creates an empty compilation context.
+ * @return The new context.
+ */
+compilationContext* createCompilationContext();
+
+/**
+ * This selects the compilation context of the current thread.
+ * @param context The context to be used (may be <code>null</code>).
+ */
+void useCompilationContext(compilationContext* context);
+
+/**
+ * This frees a compilation context including the symbol table, the
+ * intermediate code, the variable table and all buffers of the backends.<BR>
+ * If the context is the context of the current thread, the thread has no
+ * context afterwards.
+ * @param context The context created by createCompilationContext.
+ */
+void freeCompilationContext(compilationContext* context);
+
+/**
+ * This frees a code list including all nested code lists.
+ * @param list The first entry of the code list.
+ */
+void freeCodeList(codeEntry* list);
+
+/**
+ * This records an error within the compilation context of the current thread
+ * and prints it to STDERR (unless the context is quiet).
+ * @param format The error message (<code>printf</code> format).
+ */
+void reportError(const char* format, ...);
+
+/**
+ * This parses a program and generates its intermediate code within a
+ * compilation context.<BR>
+ * The context is used as context of the current thread.
+ * [defined in file compiler.l]
+ * @param context The compilation context.
+ * @param input   The source code of the program.
+ * @return <code>0</code> on success, <code>1</code> otherwise (see
+ *         <code>yyparse</code>).
+ */
+int parseProgram(compilationContext* context, FILE *input);
+
+/**
+ * This parses a program given as string and generates its intermediate code
+ * within a compilation context (see parseProgram).<BR>
+ * [defined in file compiler.l]
+ * @param context The compilation context.
+ * @param source  The source code of the program.
+ * @return <code>0</code> on success, <code>1</code> otherwise.
+ */
+int parseProgramText(compilationContext* context, const char* source);
+
+/**
+ * The reentrant parser.<BR>
+ * [defined in file compiler.tab.c]
+ * @param context The compilation context (including the scanner).
+ * @return <code>0</code> on success, <code>1</code> otherwise.
+ */
+int yyparse(compilationContext* context);
+
+/**
+ * This function is called by the parser if an error has been detected while
+ * parsing the input data (e.g. syntax error).
+ * @param context The compilation context.
+ * @param str     The error message to be printed.
+ */
+void yyerror(compilationContext* context, const char* str);
+
+#endif /*CONTEXT_H_*/
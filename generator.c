@@ -12,58 +12,7 @@
 #include "generator.h"
 #include "symboltable.h"
 #include "compiler.h"
-
-/**
- * Pointer to the first entry of the code list.<BR>
- * This variable is automatically initialized when adding the first entry.
- */
-codeEntry* codeList = 0;
-
-/**
- * Pointer to the last entry of the code list.<BR>
- * This is used to prevent walking through the whole list whenever adding a new
- * entry and to consider the nesting for if/while structures.
- */
-codeEntry* currentCodeEntry = 0;
-
-/**
- * Pointer to the current nesting context (for if/while).<BR>
- * This is set to <code>null</code> if the current code is not part of any
- * nested structure.
- */
-codeEntry* currentContext = 0;
-
-/**
- * This variable holds the current line number for the intermediate code.<BR>
- * Line numbers are required within intermediate code to determine target
- * locations for GOTO statements which are generated for if/while structures.
- */
-int codeLineNumber;
-
-/**
- * Pointer to the first entry of the code list for printing.<BR>
- * This variable is automatically initialized when adding the first entry.<BR>
- * All intermediate code entries are first added to this list and only written
- * to the target file after complete parsing. This is to evaluate all required
- * back-patching for GOTO statements.
- */
-codePrintEntry* printCodeList = 0;
-
-/**
- * Pointer to the last entry of the code list for printing.<BR>
- * This is used to prevent walking through the whole list whenever adding a new
- * entry.
- */
-codePrintEntry* currentPrintCodeList = 0;
-
-/**
- * Line number for the previous WHILE line marker.<BR>
- * Markers are required for WHILE loops as the condition part might have to be
- * recalculated for every loop in case any variable contained has been changed
- * within the loop body.
- * @see createMarkerWhile
- */
-int lastWhileMarkerCodeLine = 0;
+#include "context.h"
 
 /**
  * This appends a code entry to the program flow.
@@ -72,17 +21,19 @@ int lastWhileMarkerCodeLine = 0;
 void appendCodeEntry(codeEntry* newCodeEntry)
 {
     // Assign as new start for 1st entry
-    if (!codeList)
+    if (!compilation->codeList)
     {
-        codeList = newCodeEntry;
-        currentCodeEntry = newCodeEntry;
+        compilation->codeList = newCodeEntry;
+        compilation->currentCodeEntry = newCodeEntry;
     }
     // Add at the end otherwise
     else
     {
-        currentCodeEntry->next = newCodeEntry;
-        currentCodeEntry = newCodeEntry;
+        compilation->currentCodeEntry->next = newCodeEntry;
+        compilation->currentCodeEntry = newCodeEntry;
     }
+
+    compilation->codeGenerationCalls++;
 }
 
 /**
@@ -121,11 +72,37 @@ codeEntry* createCodeEntry(int sourceLine, operation op,
     newCodeEntry->operand2 = operand2;
     newCodeEntry->integer = integer;
     newCodeEntry->real = real;
-    newCodeEntry->parent = currentContext;
+    newCodeEntry->boolean = boolean;
+    newCodeEntry->compare = OP_NOP;
+    newCodeEntry->step = OP_NOP;
+    newCodeEntry->profileHits = 0;
+    newCodeEntry->profileTime = 0;
+    newCodeEntry->profileSelfTime = 0;
+    newCodeEntry->loopIterations = 0;
+    newCodeEntry->parent = compilation->currentContext;
     newCodeEntry->sub_1 = 0;
     newCodeEntry->sub_2 = 0;
     newCodeEntry->next = 0;
 
+    compilation->codeGenerationCalls++;
+    return newCodeEntry;
+}
+
+/**
+ * This creates a copy of a code entry.<BR>
+ * Note: Nested sub-code is not copied and the copy is not added to the program
+ *       flow.
+ * @param original The code entry to be copied.
+ * @return The new code entry.
+ */
+codeEntry* copyCodeEntry(codeEntry* original)
+{
+    codeEntry* newCodeEntry = (codeEntry*) malloc(sizeof(codeEntry));
+    memcpy(newCodeEntry, original, sizeof(codeEntry));
+    newCodeEntry->sub_1 = 0;
+    newCodeEntry->sub_2 = 0;
+    newCodeEntry->next = 0;
+    
     return newCodeEntry;
 }
 
@@ -156,48 +133,48 @@ int createCodeNumericComparison(symbolTableEntry* target, operation op,
     if ((op != OP_EQUAL) && (op != OP_NOT_EQUAL) && (op != OP_LESS_OR_EQUAL) &&
         (op != OP_GREATER_OR_EQUAL) && (op != OP_GREATER) && (op != OP_LESS))
     {
-        fprintf(stderr, "Unexpected numeric comparison: %d. Expected OP_EQUAL, "
-                        "OP_NOT_EQUAL, OP_LESS_OR_EQUAL, OP_GREATER_OR_EQUAL, "
-                        "OP_GREATER or OP_LESS. (Line: %d)\n", op, sourceLine);
+        reportError("Unexpected numeric comparison: %d. Expected OP_EQUAL, "
+                    "OP_NOT_EQUAL, OP_LESS_OR_EQUAL, OP_GREATER_OR_EQUAL, "
+                    "OP_GREATER or OP_LESS. (Line: %d)\n", op, sourceLine);
         return 0;
     }
     if (!target)
     {
-        fprintf(stderr, "No target has been given for numeric comparison. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No target has been given for numeric comparison. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (target->type != BOOLEAN)
     {
-        fprintf(stderr, "Expected data type BOOLEAN for numeric comparison. "
-                        "Got: %s. (Line: %d)\n", getTypeName(target->type),
-                        sourceLine);
+        reportError("Expected data type BOOLEAN for numeric comparison. "
+                    "Got: %s. (Line: %d)\n", getTypeName(target->type),
+                    sourceLine);
         return 0;
     }    
     if (!operand1)
     {
-        fprintf(stderr, "Operand 1 missing for numeric comparison. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("Operand 1 missing for numeric comparison. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if ((operand1->type != INTEGER) && (operand1->type != REAL))
     {
-        fprintf(stderr, "Operand 1 requires numeric data type for numeric "
-                        "comparison. Got: %s. (Line: %d)\n",
-                        getTypeName(operand1->type), sourceLine);
+        reportError("Operand 1 requires numeric data type for numeric "
+                    "comparison. Got: %s. (Line: %d)\n",
+                    getTypeName(operand1->type), sourceLine);
         return 0;
     }
     if (!operand2)
     {
-        fprintf(stderr, "Operand 2 missing for numeric comparison. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("Operand 2 missing for numeric comparison. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if ((operand2->type != INTEGER) && (operand2->type != REAL))
     {
-        fprintf(stderr, "Operand 2 requires numeric data type for numeric "
-                        "comparison. Got: %s. (Line: %d)\n",
-                        getTypeName(operand2->type), sourceLine);
+        reportError("Operand 2 requires numeric data type for numeric "
+                    "comparison. Got: %s. (Line: %d)\n",
+                    getTypeName(operand2->type), sourceLine);
         return 0;
     }
     
@@ -234,53 +211,53 @@ int createCodeLogicalCombination(symbolTableEntry* target, operation op,
 {
     if ((op != OP_AND) && (op != OP_OR) && (op != OP_NOT))
     {
-        fprintf(stderr, "Unexpected logical combination: %d. Expected OP_AND, "
-                        "OP_OR or OP_NOT. (Line: %d)\n", op, sourceLine);
+        reportError("Unexpected logical combination: %d. Expected OP_AND, "
+                    "OP_OR or OP_NOT. (Line: %d)\n", op, sourceLine);
         return 0;
     }
     if (!target)
     {
-        fprintf(stderr, "No target has been given for logical combination. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No target has been given for logical combination. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (target->type != BOOLEAN)
     {
-        fprintf(stderr, "Expected data type BOOLEAN for logical combination. "
-                        "Got: %s. (Line: %d)\n", getTypeName(target->type),
-                        sourceLine);
+        reportError("Expected data type BOOLEAN for logical combination. "
+                    "Got: %s. (Line: %d)\n", getTypeName(target->type),
+                    sourceLine);
         return 0;
     }
     if (!operand1)
     {
-        fprintf(stderr, "Operand 1 missing for logical combination. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("Operand 1 missing for logical combination. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (operand1->type != BOOLEAN)
     {
-        fprintf(stderr, "Operand 1 requires data type BOOLEAN for logical "
-                        "combination. Got: %s. (Line: %d)\n",
-                        getTypeName(operand1->type), sourceLine);
+        reportError("Operand 1 requires data type BOOLEAN for logical "
+                    "combination. Got: %s. (Line: %d)\n",
+                    getTypeName(operand1->type), sourceLine);
         return 0;
     }
     if ((op != OP_NOT) && !operand2)
     {
-        fprintf(stderr, "Operand 2 missing for logical combination. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("Operand 2 missing for logical combination. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if ((op == OP_NOT) && operand2)
     {
-        fprintf(stderr, "Operand 2 expected null for operation OP_NOT. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("Operand 2 expected null for operation OP_NOT. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if ((op != OP_NOT) && (operand2->type != BOOLEAN))
     {
-        fprintf(stderr, "Operand 2 requires data type BOOLEAN for logical "
-                        "combination. Got: %s. (Line: %d)\n",
-                        getTypeName(operand2->type), sourceLine);
+        reportError("Operand 2 requires data type BOOLEAN for logical "
+                    "combination. Got: %s. (Line: %d)\n",
+                    getTypeName(operand2->type), sourceLine);
         return 0;
     }
     
@@ -304,15 +281,15 @@ int createCodeIf(symbolTableEntry* condition, int sourceLine)
 {
     if (!condition)
     {
-        fprintf(stderr, "No condition has been given for WHILE loop. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No condition has been given for WHILE loop. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (condition->type != BOOLEAN)
     {
-        fprintf(stderr, "Expected data type BOOLEAN for loop condition. "
-                        "Got: %s. (Line: %d)\n", getTypeName(condition->type),
-                        sourceLine);
+        reportError("Expected data type BOOLEAN for loop condition. "
+                    "Got: %s. (Line: %d)\n", getTypeName(condition->type),
+                    sourceLine);
         return 0;
     }
     
@@ -320,13 +297,13 @@ int createCodeIf(symbolTableEntry* condition, int sourceLine)
     codeEntry* entry = createCodeEntry(sourceLine, OP_IF, 0, condition,
                                        0, 0, 0, 0);
     appendCodeEntry(entry);
-    currentContext = entry;
+    compilation->currentContext = entry;
     
     // Create a nested context for all IF statements
     codeEntry* ifEntry = createCodeEntry(sourceLine, OP_NOP, 0, 0, 0, 0, 0, 0);
     ifEntry->parent = entry;
     entry->sub_1 = ifEntry;
-    currentCodeEntry = ifEntry;
+    compilation->currentCodeEntry = ifEntry;
     
     return 1;
 }
@@ -343,35 +320,35 @@ int createCodeIf(symbolTableEntry* condition, int sourceLine)
  */
 int createCodeElse(int sourceLine)
 {
-    if (!currentContext)
+    if (!compilation->currentContext)
     {
-        fprintf(stderr, "Failed to create intermediate code for ELSE statement."
-                        " No nested structure is open. (Line: %d)\n",
-                        sourceLine);
+        reportError("Failed to create intermediate code for ELSE statement."
+                    " No nested structure is open. (Line: %d)\n",
+                    sourceLine);
         return 0;
     }
-    if (currentContext->op != OP_IF)
+    if (compilation->currentContext->op != OP_IF)
     {
-        fprintf(stderr, "Failed to create intermediate code for ELSE statement."
-                        " Not contained in an IF statement. (Line: %d)\n",
-                        sourceLine);
+        reportError("Failed to create intermediate code for ELSE statement."
+                    " Not contained in an IF statement. (Line: %d)\n",
+                    sourceLine);
         return 0;
     }
-    if (currentContext->sub_2)
+    if (compilation->currentContext->sub_2)
     {
-        fprintf(stderr, "Failed to create intermediate code for ELSE statement."
-                        " IF statement already contains an ELSE flow. "
-                        "(Line: %d)\n",
-                        sourceLine);
+        reportError("Failed to create intermediate code for ELSE statement."
+                    " IF statement already contains an ELSE flow. "
+                    "(Line: %d)\n",
+                    sourceLine);
         return 0;
     }
     
     // Create a new entry for the ELSE flow
     codeEntry* elseEntry = createCodeEntry(sourceLine, OP_NOP, 0, 0, 0, 0, 0,
                                            0);
-    elseEntry->parent = currentContext;
-    currentContext->sub_2 = elseEntry;
-    currentCodeEntry = elseEntry;
+    elseEntry->parent = compilation->currentContext;
+    compilation->currentContext->sub_2 = elseEntry;
+    compilation->currentCodeEntry = elseEntry;
     
     return 1;
 }
@@ -393,21 +370,21 @@ int createCodeWhile(symbolTableEntry* condition, int sourceLine)
 {
     if (!condition)
     {
-        fprintf(stderr, "No condition has been given for WHILE loop. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No condition has been given for WHILE loop. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (condition->type != BOOLEAN)
     {
-        fprintf(stderr, "Expected data type BOOLEAN for loop condition. "
-                        "Got: %s. (Line: %d)\n", getTypeName(condition->type),
-                        sourceLine);
+        reportError("Expected data type BOOLEAN for loop condition. "
+                    "Got: %s. (Line: %d)\n", getTypeName(condition->type),
+                    sourceLine);
         return 0;
     }
-    if (lastWhileMarkerCodeLine == 0)
+    if (compilation->lastWhileMarkerCodeLine == 0)
     {
-        fprintf(stderr, "Failed to create WHILE loop. No marker has been "
-                        "defined. (Line: %d)\n", sourceLine);
+        reportError("Failed to create WHILE loop. No marker has been "
+                    "defined. (Line: %d)\n", sourceLine);
         return 0;
     }
     
@@ -415,17 +392,17 @@ int createCodeWhile(symbolTableEntry* condition, int sourceLine)
     codeEntry* entry = createCodeEntry(sourceLine, OP_WHILE, 0, condition,
                                        0, 0, 0, 0);
     appendCodeEntry(entry);
-    currentContext = entry;
+    compilation->currentContext = entry;
     
     // Create a nested context for all loop statements
     codeEntry* whileEntry = createCodeEntry(sourceLine, OP_NOP, 0, 0, 0, 0, 0,
                                             0);
     whileEntry->parent = entry;
     entry->sub_1 = whileEntry;
-    currentCodeEntry = whileEntry;
+    compilation->currentCodeEntry = whileEntry;
     
     // Reset code marker
-    lastWhileMarkerCodeLine = 0;
+    compilation->lastWhileMarkerCodeLine = 0;
     
     return 1;
 }
@@ -445,15 +422,15 @@ int createCodeWhile(symbolTableEntry* condition, int sourceLine)
  */
 int createMarkerWhile(int sourceLine)
 {
-    if (lastWhileMarkerCodeLine > 0)
+    if (compilation->lastWhileMarkerCodeLine > 0)
     {
-        fprintf(stderr, "Failed to create WHILE marker. There is already an "
-                        "open marker from definition in line %d. (Line: %d)\n",
-                        lastWhileMarkerCodeLine, sourceLine);
+        reportError("Failed to create WHILE marker. There is already an "
+                    "open marker from definition in line %d. (Line: %d)\n",
+                    compilation->lastWhileMarkerCodeLine, sourceLine);
         return 0;
     }
     
-    lastWhileMarkerCodeLine = sourceLine;
+    compilation->lastWhileMarkerCodeLine = sourceLine;
     codeEntry* entry = createCodeEntry(sourceLine, OP_MARKER_WHILE,
                                        0, 0, 0, 0, 0, 0);
     appendCodeEntry(entry);
@@ -472,16 +449,16 @@ int createMarkerWhile(int sourceLine)
  */
 int createCodeEnd(int sourceLine)
 {
-    if (!currentContext)
+    if (!compilation->currentContext)
     {
-        fprintf(stderr, "Failed to create intermediate code for END statement. "
-                        "No nested structure is open. (Line: %d)\n",
-                        sourceLine);
+        reportError("Failed to create intermediate code for END statement. "
+                    "No nested structure is open. (Line: %d)\n",
+                    sourceLine);
         return 0;
     }
     
-    currentCodeEntry = currentContext;
-    currentContext = currentContext->parent;
+    compilation->currentCodeEntry = compilation->currentContext;
+    compilation->currentContext = compilation->currentContext->parent;
     return 1;
 }
 
@@ -499,22 +476,22 @@ int createCodeExit(symbolTableEntry* result, int sourceLine)
 {
     if (!result)
     {
-        fprintf(stderr, "No result has been given for program exit. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No result has been given for program exit. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
-    if (currentContext)
+    if (compilation->currentContext)
     {
-        fprintf(stderr, "Failed to create program exit. There is a nested "
-                        "structure which has not been closed yet. (Line: %d)\n",
-                        sourceLine);
+        reportError("Failed to create program exit. There is a nested "
+                    "structure which has not been closed yet. (Line: %d)\n",
+                    sourceLine);
         return 0;
     }
-    if (lastWhileMarkerCodeLine > 0)
+    if (compilation->lastWhileMarkerCodeLine > 0)
     {
-        fprintf(stderr, "Failed to create program exit. There is an open WHILE "
-                        "marker from definition in line %d. (Line: %d)\n",
-                        lastWhileMarkerCodeLine, sourceLine);
+        reportError("Failed to create program exit. There is an open WHILE "
+                    "marker from definition in line %d. (Line: %d)\n",
+                    compilation->lastWhileMarkerCodeLine, sourceLine);
         return 0;
     }
     
@@ -556,55 +533,55 @@ int createCodeMathematicalOperation(symbolTableEntry* target, operation op,
     if ((op != OP_PLUS) && (op != OP_MINUS) && (op != OP_MULTIPLY) &&
         (op != OP_DIVIDE) && (op != OP_MODULO))
     {
-        fprintf(stderr, "Unexpected mathematical operation: %d. Expected "
-                        "OP_PLUS, OP_MINUS, OP_MULTIPLY, OP_DIVIDE or OP_MODULO"
-                        ". (Line: %d)\n", op, sourceLine);
+        reportError("Unexpected mathematical operation: %d. Expected "
+                    "OP_PLUS, OP_MINUS, OP_MULTIPLY, OP_DIVIDE or OP_MODULO"
+                    ". (Line: %d)\n", op, sourceLine);
         return 0;
     }
     if (!target)
     {
-        fprintf(stderr, "No target has been given for mathematical operation. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No target has been given for mathematical operation. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (!operand1)
     {
-        fprintf(stderr, "Operand 1 missing for mathematical operation. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("Operand 1 missing for mathematical operation. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if ((operand1->type != INTEGER) && (operand1->type != REAL))
     {
-        fprintf(stderr, "Operand 1 requires numeric data type for mathematical "
-                        "operation. Got: %s. (Line: %d)\n",
-                        getTypeName(operand1->type), sourceLine);
+        reportError("Operand 1 requires numeric data type for mathematical "
+                    "operation. Got: %s. (Line: %d)\n",
+                    getTypeName(operand1->type), sourceLine);
         return 0;
     }
     if ((op == OP_MODULO) && (operand1->type != INTEGER))
     {
-        fprintf(stderr, "Operand 1 requires INTEGER data type for modulo "
-                        "operation. Got: %s. (Line: %d)\n",
-                        getTypeName(operand1->type), sourceLine);
+        reportError("Operand 1 requires INTEGER data type for modulo "
+                    "operation. Got: %s. (Line: %d)\n",
+                    getTypeName(operand1->type), sourceLine);
         return 0;
     }
     if (!operand2)
     {
-        fprintf(stderr, "Operand 2 missing for mathematical operation. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("Operand 2 missing for mathematical operation. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if ((operand2->type != INTEGER) && (operand2->type != REAL))
     {
-        fprintf(stderr, "Operand 2 requires numeric data type for mathematical "
-                        "operation. Got: %s. (Line: %d)\n",
-                        getTypeName(operand2->type), sourceLine);
+        reportError("Operand 2 requires numeric data type for mathematical "
+                    "operation. Got: %s. (Line: %d)\n",
+                    getTypeName(operand2->type), sourceLine);
         return 0;
     }
     if ((op == OP_MODULO) && (operand2->type != INTEGER))
     {
-        fprintf(stderr, "Operand 2 requires INTEGER data type for modulo "
-                        "operation. Got: %s. (Line: %d)\n",
-                        getTypeName(operand2->type), sourceLine);
+        reportError("Operand 2 requires INTEGER data type for modulo "
+                    "operation. Got: %s. (Line: %d)\n",
+                    getTypeName(operand2->type), sourceLine);
         return 0;
     }
     
@@ -617,9 +594,9 @@ int createCodeMathematicalOperation(symbolTableEntry* target, operation op,
     if ((target->type != resultType) &&
         (target->type != REAL || resultType != INTEGER))
     {
-        fprintf(stderr, "Result variable has incompatible data type. Got: "
-                        "%s + %s. (Line: %d)\n", getTypeName(target->type), 
-                        getTypeName(resultType), sourceLine);
+        reportError("Result variable has incompatible data type. Got: "
+                    "%s + %s. (Line: %d)\n", getTypeName(target->type), 
+                    getTypeName(resultType), sourceLine);
         return 0;
     }
     
@@ -648,21 +625,21 @@ int createCodeIncrement(symbolTableEntry* target, operation op, int sourceLine)
 {
     if ((op != OP_INCREMENT) && (op != OP_DECREMENT))
     {
-        fprintf(stderr, "Unexpected increment operation: %d. Expected "
-                        "OP_INCREMENT or OP_DECREMENT. (Line: %d)\n", op,
-                        sourceLine);
+        reportError("Unexpected increment operation: %d. Expected "
+                    "OP_INCREMENT or OP_DECREMENT. (Line: %d)\n", op,
+                    sourceLine);
         return 0;
     }
     if (!target)
     {
-        fprintf(stderr, "No target has been given for increment. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No target has been given for increment. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (target->type != INTEGER)
     {
-        fprintf(stderr, "Expected data type INTEGER for increment. Got: %s. "
-                        "(Line: %d)\n", getTypeName(target->type), sourceLine);
+        reportError("Expected data type INTEGER for increment. Got: %s. "
+                    "(Line: %d)\n", getTypeName(target->type), sourceLine);
         return 0;
     }
     
@@ -691,22 +668,22 @@ int createCodeAssignment(symbolTableEntry* target, symbolTableEntry* source,
 {
     if (!target)
     {
-        fprintf(stderr, "No target has been given for assignment."
-                        "(Line: %d)\n", sourceLine);
+        reportError("No target has been given for assignment."
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (!source)
     {
-        fprintf(stderr, "No source has been given for assignment."
-                        "(Line: %d)\n", sourceLine);
+        reportError("No source has been given for assignment."
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if ((target->type != source->type) &&
         (target->type != REAL || source->type != INTEGER))
     {
-        fprintf(stderr, "Expected compatible data types for assignment. Got: "
-                        "%s + %s. (Line: %d)\n", getTypeName(target->type),
-                        getTypeName(source->type), sourceLine);
+        reportError("Expected compatible data types for assignment. Got: "
+                    "%s + %s. (Line: %d)\n", getTypeName(target->type),
+                    getTypeName(source->type), sourceLine);
         return 0;
     }
     
@@ -733,14 +710,14 @@ int createCodeIntConst(symbolTableEntry* target, int value, int sourceLine)
 {
     if (!target)
     {
-        fprintf(stderr, "No target has been given for int constant. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No target has been given for int constant. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (target->type != INTEGER)
     {
-        fprintf(stderr, "Expected data type INTEGER for int constant. Got: %s. "
-                        "(Line: %d)\n", getTypeName(target->type), sourceLine);
+        reportError("Expected data type INTEGER for int constant. Got: %s. "
+                    "(Line: %d)\n", getTypeName(target->type), sourceLine);
         return 0;
     }
    
@@ -767,14 +744,14 @@ int createCodeFloatConst(symbolTableEntry* target, float value, int sourceLine)
 {
     if (!target)
     {
-        fprintf(stderr, "No target has been given for float constant. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No target has been given for float constant. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (target->type != REAL)
     {
-        fprintf(stderr, "Expected data type REAL for float constant. Got: %s. "
-                        "(Line: %d).", getTypeName(target->type), sourceLine);
+        reportError("Expected data type REAL for float constant. Got: %s. "
+                    "(Line: %d).", getTypeName(target->type), sourceLine);
         return 0;
     }
     
@@ -801,15 +778,15 @@ int createCodeBoolConst(symbolTableEntry* target, int value, int sourceLine)
 {
     if (!target)
     {
-        fprintf(stderr, "No target has been given for boolean constant. "
-                        "(Line: %d)\n", sourceLine);
+        reportError("No target has been given for boolean constant. "
+                    "(Line: %d)\n", sourceLine);
         return 0;
     }
     if (target->type != BOOLEAN)
     {
-        fprintf(stderr, "Expected data type BOOLEAN for boolean constant. "
-                        "Got: %s. (Line: %d).", getTypeName(target->type),
-                        sourceLine);
+        reportError("Expected data type BOOLEAN for boolean constant. "
+                    "Got: %s. (Line: %d).", getTypeName(target->type),
+                    sourceLine);
         return 0;
     }
     
@@ -826,9 +803,9 @@ int createCodeBoolConst(symbolTableEntry* target, int value, int sourceLine)
 void printCode()
 {
     // Create the intermediate code (including backtracking)
-    codeEntry* iterator = codeList;
-    codeLineNumber = 0;
-    lastWhileMarkerCodeLine = 0;
+    codeEntry* iterator = compilation->codeList;
+    compilation->codeLineNumber = 0;
+    compilation->lastWhileMarkerCodeLine = 0;
     
     while (iterator != 0)
     {
@@ -839,7 +816,7 @@ void printCode()
     // Print the code to file
     FILE *f = fopen("2_intermediate", "w");
     fprintf(f, "== INTERMEDIATE CODE ==\n");
-    codePrintEntry* iterator2 = printCodeList;
+    codePrintEntry* iterator2 = compilation->printCodeList;
     while (iterator2 != 0)
     {
         if (strlen(iterator2->code) < 8)
@@ -877,21 +854,21 @@ codePrintEntry* appendPrintCodeEntry(char* code, int sourceLine)
     codePrintEntry* codeEntry =
         (codePrintEntry*) malloc(sizeof(codePrintEntry));
     codeEntry->code = code;
-    codeEntry->lineNumber = ++codeLineNumber;
+    codeEntry->lineNumber = ++compilation->codeLineNumber;
     codeEntry->sourceLine = sourceLine;
     codeEntry->next = 0;
     
     // Assign as new start for 1st entry
-    if (!printCodeList)
+    if (!compilation->printCodeList)
     {
-        printCodeList = codeEntry;
-        currentPrintCodeList = codeEntry;
+        compilation->printCodeList = codeEntry;
+        compilation->currentPrintCodeList = codeEntry;
     }
     // Add at the end otherwise
     else
     {
-        currentPrintCodeList->next = codeEntry;
-        currentPrintCodeList = codeEntry;
+        compilation->currentPrintCodeList->next = codeEntry;
+        compilation->currentPrintCodeList = codeEntry;
     }
     
     return codeEntry;
@@ -905,12 +882,15 @@ codePrintEntry* appendPrintCodeEntry(char* code, int sourceLine)
  */
 void printCodeEntry(codeEntry* iterator)
 {
+    compilationContext* context = compilation;
+    
     char* codeSnippet = (char*)malloc(sizeof(char) * 100);
-    int startLineNumber = codeLineNumber + 1;
+    char condition[100];
+    int startLineNumber = context->codeLineNumber + 1;
     codeEntry* iterator2 = 0;
     
     // Copy the while marker to support nested while calls
-    int lastWhileMarkerCodeLineLocal = lastWhileMarkerCodeLine;
+    int lastWhileMarkerCodeLineLocal = context->lastWhileMarkerCodeLine;
     
     switch (iterator->op)
     {
@@ -963,14 +943,16 @@ void printCodeEntry(codeEntry* iterator)
         
         /* Control Flow */
         case OP_IF:
+        case OP_IF_COMPARE:
             // begin:  if true goto start
             //         goto end
             // start:  code body
             // end:
             if (iterator->sub_2 == 0)
             {
-                sprintf(codeSnippet, "IF %s GOTO %d", iterator->operand1->name,
-                        startLineNumber + 2);
+                snprintf(codeSnippet, 100, "IF %s GOTO %d",
+                         getConditionName(iterator, condition, 100),
+                         startLineNumber + 2);
                 appendPrintCodeEntry(codeSnippet, iterator->sourceLine);
                 
                 codeSnippet = (char*)malloc(sizeof(char) * 100);
@@ -989,7 +971,8 @@ void printCodeEntry(codeEntry* iterator)
                 
                 // Backpatch the GOTO target for the false part
                 // to the line after the if body
-                sprintf(entryFalse->code, "GOTO %d", codeLineNumber + 1);
+                sprintf(entryFalse->code, "GOTO %d",
+                        context->codeLineNumber + 1);
             }
             // begin:  if true goto start
             //         goto else
@@ -999,8 +982,9 @@ void printCodeEntry(codeEntry* iterator)
             // end:
             else
             {
-                sprintf(codeSnippet, "IF %s GOTO %d", iterator->operand1->name,
-                        startLineNumber + 2);
+                snprintf(codeSnippet, 100, "IF %s GOTO %d",
+                         getConditionName(iterator, condition, 100),
+                         startLineNumber + 2);
                 appendPrintCodeEntry(codeSnippet, iterator->sourceLine);
                 
                 codeSnippet = (char*)malloc(sizeof(char) * 100);
@@ -1024,7 +1008,8 @@ void printCodeEntry(codeEntry* iterator)
                 
                 // Backpatch the GOTO target for the false part
                 // to the line after the if body
-                sprintf(entryFalse->code, "GOTO %d", codeLineNumber + 1);
+                sprintf(entryFalse->code, "GOTO %d",
+                        context->codeLineNumber + 1);
                 
                 // Print all sub code for else
                 iterator2 = iterator->sub_2;
@@ -1037,20 +1022,22 @@ void printCodeEntry(codeEntry* iterator)
                 
                 // Backpatch the GOTO target for the if part
                 // to the line after the else body
-                sprintf(entryEnd->code, "GOTO %d", codeLineNumber + 1);
+                sprintf(entryEnd->code, "GOTO %d", context->codeLineNumber + 1);
             }
             
             // Ignore the general handling below
             return;
         
         case OP_WHILE:
+        case OP_WHILE_COMPARE:
             // begin:  if true goto start
             //         goto end
             // start:  code body
             //         goto begin
             // end:
-            sprintf(codeSnippet, "IF %s GOTO %d", iterator->operand1->name,
-                    startLineNumber + 2);
+            snprintf(codeSnippet, 100, "IF %s GOTO %d",
+                     getConditionName(iterator, condition, 100),
+                     startLineNumber + 2);
             appendPrintCodeEntry(codeSnippet, iterator->sourceLine);
 
             codeSnippet = (char*)malloc(sizeof(char) * 100);
@@ -1073,14 +1060,35 @@ void printCodeEntry(codeEntry* iterator)
 
             // Backpatch the GOTO target for the false part
             // to the line after the while body
-            sprintf(entryFalse->code, "GOTO %d", codeLineNumber + 1);
+            sprintf(entryFalse->code, "GOTO %d", context->codeLineNumber + 1);
+
+            // Ignore the general handling below
+            return;
+
+        case OP_DO_WHILE:
+        case OP_DO_WHILE_COMPARE:
+            // start:  code body
+            //         code for condition
+            //         if true goto start
+            iterator2 = iterator->sub_1;
+
+            while (iterator2 != 0)
+            {
+                printCodeEntry(iterator2);
+                iterator2 = iterator2->next;
+            }
+
+            snprintf(codeSnippet, 100, "IF %s GOTO %d",
+                     getConditionName(iterator, condition, 100),
+                     startLineNumber);
+            appendPrintCodeEntry(codeSnippet, iterator->sourceLine);
 
             // Ignore the general handling below
             return;
 
         case OP_MARKER_WHILE:
             // Remember current position
-            lastWhileMarkerCodeLine = codeLineNumber + 1;
+            context->lastWhileMarkerCodeLine = context->codeLineNumber + 1;
 
             // Ignore the general handling below
             return;
@@ -1158,6 +1166,520 @@ void printCodeEntry(codeEntry* iterator)
     appendPrintCodeEntry(codeSnippet, iterator->sourceLine);
 }
 
+/**
+ * This writes the current intermediate code as equivalent C program into a
+ * file called <code>2_intermediate.c</code>.<BR>
+ * Every symbol table entry becomes a local variable (<code>int</code> for
+ * INTEGER and BOOLEAN, <code>double</code> for REAL) and the IF/WHILE
+ * structures are written as structured C statements. The program prints the
+ * result of the RETURN statement like the interpreter and returns it as exit
+ * status.
+ */
+void printCCode()
+{
+    FILE *f = fopen("2_intermediate.c", "w");
+    fprintf(f, "/* Generated by the MathDH compiler */\n");
+    fprintf(f, "#include <stdio.h>\n\n");
+    fprintf(f, "int main()\n{\n");
+    
+    // Variables are prefixed to avoid conflicts with C keywords
+    symbolTableEntry* symbol = compilation->symbolTable;
+    while (symbol != 0)
+    {
+        if (symbol->type == REAL)
+        {
+            fprintf(f, "    double v_%s = 0.0;\n", symbol->name);
+        }
+        else
+        {
+            fprintf(f, "    int v_%s = 0;\n", symbol->name);
+        }
+        symbol = symbol->next;
+    }
+    fprintf(f, "    char result[200] = \"\";\n");
+    fprintf(f, "    int status = 0;\n\n");
+    
+    printCCodeList(f, compilation->codeList, "    ");
+    
+    fprintf(f, "\n    printf(\"\\nPROGRAM RESULT = %%s\\n\", result);\n");
+    fprintf(f, "    return status;\n}\n");
+    fclose(f);
+}
+
+/**
+ * This quotes a text for the shell of system(): the text is enclosed in
+ * single quotes and every single quote within the text is replaced by
+ * <code>'\''</code>.
+ * @param text The text to be quoted (e.g. a file name).
+ * @return The quoted text (to be freed by the caller).
+ */
+char* quoteShellText(char* text)
+{
+    // Every character may become four characters
+    char* quoted = (char*)malloc(strlen(text) * 4 + 3);
+    char* position = quoted;
+    *position++ = '\'';
+    while (*text != 0)
+    {
+        if (*text == '\'')
+        {
+            strcpy(position, "'\\''");
+            position += 4;
+        }
+        else
+        {
+            *position++ = *text;
+        }
+        text++;
+    }
+    strcpy(position, "'");
+    return quoted;
+}
+
+/**
+ * This compiles the file <code>2_intermediate.c</code> (see printCCode) into
+ * an executable by calling the system C compiler.<BR>
+ * The compiler is taken from the environment variable <code>CC</code>
+ * (default: <code>cc</code>).
+ * @param executable File name of the executable to be created.
+ * @return <code>1</code> if the executable has been created.<BR>
+ *         <code>0</code> if the C compiler failed.
+ */
+int compileCCode(char* executable)
+{
+    char* compiler = getenv("CC");
+    if ((compiler == 0) || (*compiler == 0))
+    {
+        compiler = "cc";
+    }
+    
+    // Integer overflow needs to wrap around as in the interpreter
+    char* quoted = quoteShellText(executable);
+    char* command = (char*)malloc(strlen(compiler) + strlen(quoted) + 100);
+    sprintf(command, "%s -O2 -fwrapv -o %s 2_intermediate.c", compiler,
+            quoted);
+    int status = system(command);
+    free(command);
+    free(quoted);
+    
+    if (status != 0)
+    {
+        reportError("Error while compiling 2_intermediate.c into %s\n",
+            executable);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * This writes a code list (including nested code lists) as C statements.<BR>
+ * The condition part of a WHILE loop (from the WHILE marker up to the WHILE
+ * entry) is evaluated at the beginning of every iteration.
+ * @param f        Reference to the file for storing the C code.
+ * @param iterator The first code entry of the list.
+ * @param indent   Current indentation.
+ */
+void printCCodeList(FILE *f, codeEntry* iterator, char* indent)
+{
+    char* sub_indent = (char*)malloc(sizeof(char) * (strlen(indent) + 5));
+    sprintf(sub_indent, "%s    ", indent);
+    
+    while (iterator != 0)
+    {
+        if (iterator->op == OP_MARKER_WHILE)
+        {
+            // Find the WHILE entry which belongs to the marker
+            codeEntry* loop = iterator->next;
+            while ((loop != 0) && (loop->op != OP_WHILE)
+                   && (loop->op != OP_WHILE_COMPARE)
+                   && (loop->op != OP_MARKER_WHILE) && (loop->op != OP_IF)
+                   && (loop->op != OP_IF_COMPARE) && (loop->op != OP_DO_WHILE)
+                   && (loop->op != OP_DO_WHILE_COMPARE))
+            {
+                loop = loop->next;
+            }
+            
+            if ((loop != 0)
+                && ((loop->op == OP_WHILE) || (loop->op == OP_WHILE_COMPARE)))
+            {
+                fprintf(f, "%swhile (1)\n%s{\n", indent, indent);
+                codeEntry* condition = iterator->next;
+                while (condition != loop)
+                {
+                    printCCodeEntry(f, condition, sub_indent);
+                    condition = condition->next;
+                }
+                fprintf(f, "%sif (!", sub_indent);
+                printCCondition(f, loop);
+                fprintf(f, ")\n%s{\n%s    break;\n%s}\n", sub_indent,
+                        sub_indent, sub_indent);
+                printCCodeList(f, loop->sub_1, sub_indent);
+                fprintf(f, "%s}\n", indent);
+                iterator = loop;
+            }
+        }
+        else
+        {
+            printCCodeEntry(f, iterator, indent);
+        }
+        iterator = iterator->next;
+    }
+    
+    free(sub_indent);
+}
+
+/**
+ * This writes a single code entry (including nested sub-code) as C statement.
+ * @param f        Reference to the file for storing the C code.
+ * @param iterator The code entry.
+ * @param indent   Current indentation.
+ */
+void printCCodeEntry(FILE *f, codeEntry* iterator, char* indent)
+{
+    char* sub_indent = "";
+    
+    switch (iterator->op)
+    {
+        /* Numeric Comparison Operators */
+        case OP_EQUAL:
+        case OP_NOT_EQUAL:
+        case OP_LESS_OR_EQUAL:
+        case OP_GREATER_OR_EQUAL:
+        case OP_GREATER:
+        case OP_LESS:
+            // The interpreter does not compare BOOLEAN values
+            if ((iterator->operand1->type == BOOLEAN)
+                || (iterator->operand2->type == BOOLEAN))
+            {
+                fprintf(f, "%s/* %s: BOOLEAN comparison not evaluated */\n",
+                        indent, iterator->target->name);
+                break;
+            }
+            fprintf(f, "%sv_%s = v_%s %s v_%s;\n", indent,
+                    iterator->target->name, iterator->operand1->name,
+                    getComparisonSymbol(iterator->op), iterator->operand2->name);
+            break;
+        
+        /* Logical Comparison Operators */
+        case OP_AND:
+            fprintf(f, "%sv_%s = v_%s && v_%s;\n", indent, iterator->target->name,
+                    iterator->operand1->name, iterator->operand2->name);
+            break;
+        
+        case OP_OR:
+            fprintf(f, "%sv_%s = v_%s || v_%s;\n", indent, iterator->target->name,
+                    iterator->operand1->name, iterator->operand2->name);
+            break;
+        
+        case OP_NOT:
+            fprintf(f, "%sv_%s = !v_%s;\n", indent, iterator->target->name,
+                    iterator->operand1->name);
+            break;
+        
+        /* Control Flow */
+        case OP_IF:
+        case OP_IF_COMPARE:
+            fprintf(f, "%sif (", indent);
+            printCCondition(f, iterator);
+            fprintf(f, ")\n%s{\n", indent);
+            sub_indent = (char*)malloc(sizeof(char) * (strlen(indent) + 5));
+            sprintf(sub_indent, "%s    ", indent);
+            printCCodeList(f, iterator->sub_1, sub_indent);
+            fprintf(f, "%s}\n", indent);
+            if (iterator->sub_2 != 0)
+            {
+                fprintf(f, "%selse\n%s{\n", indent, indent);
+                printCCodeList(f, iterator->sub_2, sub_indent);
+                fprintf(f, "%s}\n", indent);
+            }
+            free(sub_indent);
+            break;
+        
+        case OP_WHILE:
+        case OP_WHILE_COMPARE:
+            // WHILE without marker (no condition part to be recalculated)
+            fprintf(f, "%swhile (", indent);
+            printCCondition(f, iterator);
+            fprintf(f, ")\n%s{\n", indent);
+            sub_indent = (char*)malloc(sizeof(char) * (strlen(indent) + 5));
+            sprintf(sub_indent, "%s    ", indent);
+            printCCodeList(f, iterator->sub_1, sub_indent);
+            fprintf(f, "%s}\n", indent);
+            free(sub_indent);
+            break;
+        
+        case OP_DO_WHILE:
+        case OP_DO_WHILE_COMPARE:
+            fprintf(f, "%sdo\n%s{\n", indent, indent);
+            sub_indent = (char*)malloc(sizeof(char) * (strlen(indent) + 5));
+            sprintf(sub_indent, "%s    ", indent);
+            printCCodeList(f, iterator->sub_1, sub_indent);
+            fprintf(f, "%s}\n%swhile (", indent, indent);
+            printCCondition(f, iterator);
+            fprintf(f, ");\n");
+            free(sub_indent);
+            break;
+        
+        case OP_EXIT:
+            // RETURN does not stop the execution (same as in the interpreter)
+            switch (iterator->operand1->type)
+            {
+                case INTEGER:
+                    fprintf(f, "%ssprintf(result, \"%%d\", v_%s);\n", indent,
+                            iterator->operand1->name);
+                    break;
+                case REAL:
+                    fprintf(f, "%ssprintf(result, \"%%.2f\", v_%s);\n", indent,
+                            iterator->operand1->name);
+                    break;
+                case BOOLEAN:
+                    fprintf(f, "%ssprintf(result, \"%%s\", v_%s ? \"true\" "
+                            ": \"false\");\n", indent, iterator->operand1->name);
+                    break;
+            }
+            fprintf(f, "%sstatus = (int)v_%s;\n", indent,
+                    iterator->operand1->name);
+            break;
+        
+        /* Mathematical Operators */
+        case OP_PLUS:
+        case OP_MINUS:
+        case OP_MULTIPLY:
+        case OP_DIVIDE:
+        case OP_MODULO:
+            fprintf(f, "%sv_%s = v_%s %s v_%s;\n", indent, iterator->target->name,
+                    iterator->operand1->name,
+                    (iterator->op == OP_PLUS) ? "+" :
+                    (iterator->op == OP_MINUS) ? "-" :
+                    (iterator->op == OP_MULTIPLY) ? "*" :
+                    (iterator->op == OP_DIVIDE) ? "/" : "%",
+                    iterator->operand2->name);
+            break;
+        
+        case OP_INCREMENT:
+            fprintf(f, "%s++v_%s;\n", indent, iterator->target->name);
+            break;
+        
+        case OP_DECREMENT:
+            fprintf(f, "%s--v_%s;\n", indent, iterator->target->name);
+            break;
+        
+        /* Assignment */
+        case OP_ASSIGN:
+            fprintf(f, "%sv_%s = v_%s;\n", indent, iterator->target->name,
+                    iterator->operand1->name);
+            break;
+        
+        /* Constants */
+        case OP_INT_CONSTANT:
+            fprintf(f, "%sv_%s = %d;\n", indent, iterator->target->name,
+                    iterator->integer);
+            break;
+        
+        case OP_FLOAT_CONSTANT:
+            // Hexadecimal notation keeps the exact value of the constant
+            fprintf(f, "%sv_%s = %a; /* %.2f */\n", indent,
+                    iterator->target->name, (double)iterator->real,
+                    iterator->real);
+            break;
+        
+        case OP_BOOL_CONSTANT:
+            fprintf(f, "%sv_%s = %d;\n", indent, iterator->target->name,
+                    iterator->boolean);
+            break;
+        
+        /* Place holder for if/else/while */
+        case OP_NOP:
+        case OP_MARKER_WHILE:
+            break;
+        
+        default:
+            fprintf(f, "%s/* ERROR: Unexpected operation: %u */\n", indent,
+                    iterator->op);
+    }
+    
+    // Control flow does not create the target variable
+    if (compilation->cWriteTracking && (iterator->target != 0)
+        && (iterator->op != OP_IF) && (iterator->op != OP_IF_COMPARE)
+        && (iterator->op != OP_WHILE) && (iterator->op != OP_WHILE_COMPARE)
+        && (iterator->op != OP_DO_WHILE)
+        && (iterator->op != OP_DO_WHILE_COMPARE))
+    {
+        fprintf(f, "%sif (!sequence[%d])\n%s{\n%s    sequence[%d] = ++*counter;"
+                "\n%s}\n", indent, iterator->target->index, indent, indent,
+                iterator->target->index, indent);
+    }
+}
+
+/**
+ * This writes the condition of an IF/WHILE statement as C expression.<BR>
+ * A fused increment/decrement is written as comma expression in front of the
+ * comparison.
+ * @param f        Reference to the file for storing the C code.
+ * @param iterator The IF/WHILE code entry.
+ */
+void printCCondition(FILE *f, codeEntry* iterator)
+{
+    if ((iterator->op != OP_IF_COMPARE) && (iterator->op != OP_WHILE_COMPARE)
+        && (iterator->op != OP_DO_WHILE_COMPARE))
+    {
+        fprintf(f, "v_%s", iterator->operand1->name);
+        return;
+    }
+    
+    fprintf(f, "(");
+    if (iterator->step == OP_INCREMENT)
+    {
+        fprintf(f, "++v_%s, ", iterator->target->name);
+    }
+    else if (iterator->step == OP_DECREMENT)
+    {
+        fprintf(f, "--v_%s, ", iterator->target->name);
+    }
+    fprintf(f, "v_%s %s v_%s)", iterator->operand1->name,
+            getComparisonSymbol(iterator->compare), iterator->operand2->name);
+}
+
+/**
+ * Determines the display name of an operation.
+ * @param op The operation.
+ * @return String representation of the operation.<BR>
+ *         This is the name of the corresponding enum value.<BR>
+ *         If an invalid value is given, the text <code>-UNKNOWN-</code> will be
+ *         returned.
+ */
+char* getOperationName(operation op)
+{
+    switch (op)
+    {
+        case OP_EQUAL:
+            return "OP_EQUAL";
+        case OP_NOT_EQUAL:
+            return "OP_NOT_EQUAL";
+        case OP_LESS_OR_EQUAL:
+            return "OP_LESS_OR_EQUAL";
+        case OP_GREATER_OR_EQUAL:
+            return "OP_GREATER_OR_EQUAL";
+        case OP_GREATER:
+            return "OP_GREATER";
+        case OP_LESS:
+            return "OP_LESS";
+        case OP_AND:
+            return "OP_AND";
+        case OP_OR:
+            return "OP_OR";
+        case OP_NOT:
+            return "OP_NOT";
+        case OP_IF:
+            return "OP_IF";
+        case OP_WHILE:
+            return "OP_WHILE";
+        case OP_MARKER_WHILE:
+            return "OP_MARKER_WHILE";
+        case OP_IF_COMPARE:
+            return "OP_IF_COMPARE";
+        case OP_WHILE_COMPARE:
+            return "OP_WHILE_COMPARE";
+        case OP_DO_WHILE:
+            return "OP_DO_WHILE";
+        case OP_DO_WHILE_COMPARE:
+            return "OP_DO_WHILE_COMPARE";
+        case OP_EXIT:
+            return "OP_EXIT";
+        case OP_PLUS:
+            return "OP_PLUS";
+        case OP_MINUS:
+            return "OP_MINUS";
+        case OP_MULTIPLY:
+            return "OP_MULTIPLY";
+        case OP_DIVIDE:
+            return "OP_DIVIDE";
+        case OP_MODULO:
+            return "OP_MODULO";
+        case OP_INCREMENT:
+            return "OP_INCREMENT";
+        case OP_DECREMENT:
+            return "OP_DECREMENT";
+        case OP_ASSIGN:
+            return "OP_ASSIGN";
+        case OP_INT_CONSTANT:
+            return "OP_INT_CONSTANT";
+        case OP_FLOAT_CONSTANT:
+            return "OP_FLOAT_CONSTANT";
+        case OP_BOOL_CONSTANT:
+            return "OP_BOOL_CONSTANT";
+        case OP_NOP:
+            return "OP_NOP";
+        default:
+            return "-UNKNOWN-";
+    }
+}
+
+/**
+ * Determines the display name of a numeric comparison.
+ * @param op The comparison operation.
+ * @return String representation of the comparison (e.g. <code>&lt;=</code>).
+ *         <BR>If no numeric comparison is given, the text <code>?</code> will
+ *         be returned.
+ */
+char* getComparisonSymbol(operation op)
+{
+    switch (op)
+    {
+        case OP_EQUAL:
+            return "==";
+        case OP_NOT_EQUAL:
+            return "!=";
+        case OP_LESS_OR_EQUAL:
+            return "<=";
+        case OP_GREATER_OR_EQUAL:
+            return ">=";
+        case OP_GREATER:
+            return ">";
+        case OP_LESS:
+            return "<";
+        default:
+            return "?";
+    }
+}
+
+/**
+ * Determines the display name of the condition of an IF/WHILE statement.
+ * @param iterator The IF/WHILE code entry.
+ * @param buffer   Buffer for a fused comparison (owned by the caller).
+ * @param size     Size of the buffer (longer names are truncated).
+ * @return String representation of the condition.<BR>
+ *         This is the name of the BOOLEAN condition variable or the fused
+ *         comparison for compare-and-branch superinstructions
+ *         (e.g. <code>++A &lt; B</code>) written into the buffer.
+ */
+char* getConditionName(codeEntry* iterator, char* buffer, int size)
+{
+    if ((iterator->op != OP_IF_COMPARE) && (iterator->op != OP_WHILE_COMPARE)
+        && (iterator->op != OP_DO_WHILE_COMPARE))
+    {
+        return iterator->operand1->name;
+    }
+    
+    // Show a fused increment/decrement as prefix of the changed operand
+    char* step = (iterator->step == OP_INCREMENT) ? "++" : "--";
+    char* step1 = "";
+    char* step2 = "";
+    if (iterator->step != OP_NOP && iterator->target == iterator->operand1)
+    {
+        step1 = step;
+    }
+    else if (iterator->step != OP_NOP)
+    {
+        step2 = step;
+    }
+    
+    snprintf(buffer, size, "%s%s %s %s%s", step1, iterator->operand1->name,
+             getComparisonSymbol(iterator->compare), step2,
+             iterator->operand2->name);
+    return buffer;
+}
+
 /**
  * Determines the display value of a boolean variable.
  * @param value boolean value
@@ -85,6 +85,37 @@ enum e_operation
      * changed within the loop body.
      */
     OP_MARKER_WHILE,
+    
+    /**
+     * Control flow superinstruction: IF (OP1 COMPARE OP2)<BR>
+     * The numeric comparison is fused into the IF statement, so no BOOLEAN
+     * temporary needs to be written. An increment/decrement of one of the
+     * operands may be fused in front of the comparison (see field step).
+     */
+    OP_IF_COMPARE,
+    
+    /**
+     * Control flow superinstruction: WHILE (OP1 COMPARE OP2)<BR>
+     * The numeric comparison is fused into the WHILE loop, so no BOOLEAN
+     * temporary needs to be written. An increment/decrement of one of the
+     * operands may be fused in front of the comparison (see field step).
+     */
+    OP_WHILE_COMPARE,
+    
+    /**
+     * Control flow: DO ... WHILE (bottom-tested loop)<BR>
+     * The nested code ends with the calculation of the condition, which is
+     * checked after every loop. This is created by the optimizer when rotating
+     * WHILE loops, so no marker is required.
+     */
+    OP_DO_WHILE,
+    
+    /**
+     * Control flow superinstruction: DO ... WHILE (OP1 COMPARE OP2)<BR>
+     * Bottom-tested loop with a fused numeric comparison (see
+     * OP_WHILE_COMPARE).
+     */
+    OP_DO_WHILE_COMPARE,
      
     /**
      * Control flow: RETURN TARGET
@@ -206,6 +237,23 @@ struct a_codeEntry
      */
     int boolean;
     
+    /**
+     * Numeric comparison of a compare-and-branch superinstruction (if
+     * applicable).<BR>
+     * This is one of the values: OP_EQUAL, OP_NOT_EQUAL, OP_LESS_OR_EQUAL,
+     * OP_GREATER_OR_EQUAL, OP_GREATER, OP_LESS.
+     */
+    operation compare;
+    
+    /**
+     * Increment/decrement which is fused in front of the comparison of a
+     * compare-and-branch superinstruction (if applicable).<BR>
+     * This is one of the values: OP_INCREMENT, OP_DECREMENT. The variable to be
+     * changed is stored in field target.<BR>
+     * This is set to OP_NOP if no increment/decrement has been fused.
+     */
+    operation step;
+    
     /**
      * Pointer to a nested list of sub-code.<BR>
      * This is set for if/while statements.
@@ -218,6 +266,32 @@ struct a_codeEntry
      */
     codeEntry* sub_2;
     
+    /**
+     * Number of executions of this entry.<BR>
+     * Note: This is only collected in profiling mode.
+     */
+    long profileHits;
+    
+    /**
+     * Accumulated execution time of this entry in seconds (including nested
+     * sub-code).<BR>
+     * Note: This is only collected in profiling mode.
+     */
+    double profileTime;
+    
+    /**
+     * Accumulated execution time of this entry in seconds (excluding nested
+     * sub-code).<BR>
+     * Note: This is only collected in profiling mode.
+     */
+    double profileSelfTime;
+    
+    /**
+     * Number of executed iterations of a WHILE/DO WHILE entry.<BR>
+     * Note: This is only collected if hot loops are executed as native code.
+     */
+    long loopIterations;
+    
     /**
      * Pointer to the parent intermediate code entry.<BR>
      * This is set for nested structures (if/else/while).
@@ -300,6 +374,15 @@ codeEntry* createCodeEntry(int sourceLine, operation op,
                            symbolTableEntry* operand2, int integer, float real,
                            int boolean);
 
+/**
+ * This creates a copy of a code entry.<BR>
+ * Note: Nested sub-code is not copied and the copy is not added to the program
+ *       flow.
+ * @param original The code entry to be copied.
+ * @return The new code entry.
+ */
+codeEntry* copyCodeEntry(codeEntry* original);
+
 /**
  * This creates the intermediate code for numeric comparisons.
  * @param target     The symbol table entry into which the result shall be
@@ -559,6 +642,95 @@ codePrintEntry* appendPrintCodeEntry(char* code, int sourceLine);
  */
 void printCodeEntry(codeEntry* iterator);
 
+/**
+ * This writes the current intermediate code as equivalent C program into a
+ * file called <code>2_intermediate.c</code>.<BR>
+ * Every symbol table entry becomes a local variable (<code>int</code> for
+ * INTEGER and BOOLEAN, <code>double</code> for REAL) and the IF/WHILE
+ * structures are written as structured C statements. The program prints the
+ * result of the RETURN statement like the interpreter and returns it as exit
+ * status.
+ */
+void printCCode();
+
+/**
+ * This quotes a text for the shell of system(): the text is enclosed in
+ * single quotes and every single quote within the text is replaced by
+ * <code>'\''</code>.
+ * @param text The text to be quoted (e.g. a file name).
+ * @return The quoted text (to be freed by the caller).
+ */
+char* quoteShellText(char* text);
+
+/**
+ * This compiles the file <code>2_intermediate.c</code> (see printCCode) into
+ * an executable by calling the system C compiler.<BR>
+ * The compiler is taken from the environment variable <code>CC</code>
+ * (default: <code>cc</code>).
+ * @param executable File name of the executable to be created.
+ * @return <code>1</code> if the executable has been created.<BR>
+ *         <code>0</code> if the C compiler failed.
+ */
+int compileCCode(char* executable);
+
+/**
+ * This writes a code list (including nested code lists) as C statements.<BR>
+ * The condition part of a WHILE loop (from the WHILE marker up to the WHILE
+ * entry) is evaluated at the beginning of every iteration.
+ * @param f        Reference to the file for storing the C code.
+ * @param iterator The first code entry of the list.
+ * @param indent   Current indentation.
+ */
+void printCCodeList(FILE *f, codeEntry* iterator, char* indent);
+
+/**
+ * This writes a single code entry (including nested sub-code) as C statement.
+ * @param f        Reference to the file for storing the C code.
+ * @param iterator The code entry.
+ * @param indent   Current indentation.
+ */
+void printCCodeEntry(FILE *f, codeEntry* iterator, char* indent);
+
+/**
+ * This writes the condition of an IF/WHILE statement as C expression.<BR>
+ * A fused increment/decrement is written as comma expression in front of the
+ * comparison.
+ * @param f        Reference to the file for storing the C code.
+ * @param iterator The IF/WHILE code entry.
+ */
+void printCCondition(FILE *f, codeEntry* iterator);
+
+/**
+ * Determines the display name of an operation.
+ * @param op The operation.
+ * @return String representation of the operation.<BR>
+ *         This is the name of the corresponding enum value.<BR>
+ *         If an invalid value is given, the text <code>-UNKNOWN-</code> will be
+ *         returned.
+ */
+char* getOperationName(operation op);
+
+/**
+ * Determines the display name of a numeric comparison.
+ * @param op The comparison operation.
+ * @return String representation of the comparison (e.g. <code>&lt;=</code>).
+ *         <BR>If no numeric comparison is given, the text <code>?</code> will
+ *         be returned.
+ */
+char* getComparisonSymbol(operation op);
+
+/**
+ * Determines the display name of the condition of an IF/WHILE statement.
+ * @param iterator The IF/WHILE code entry.
+ * @param buffer   Buffer for a fused comparison (owned by the caller).
+ * @param size     Size of the buffer (longer names are truncated).
+ * @return String representation of the condition.<BR>
+ *         This is the name of the BOOLEAN condition variable or the fused
+ *         comparison for compare-and-branch superinstructions
+ *         (e.g. <code>++A &lt; B</code>) written into the buffer.
+ */
+char* getConditionName(codeEntry* iterator, char* buffer, int size);
+
 /**
  * Determines the display value of a boolean variable.
  * @param value boolean value
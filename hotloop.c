@@ -0,0 +1,369 @@
+/**
+ * @file hotloop.c
+ * @brief This contains all function implementations for executing frequently
+ *        iterated loops as native code (compiled by the system C compiler at
+ *        runtime).
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <link.h>
+#include <unistd.h>
+#endif
+#include "hotloop.h"
+#include "interpreter.h"
+#include "perfmap.h"
+#include "cache.h"
+#include "context.h"
+
+/**
+ * Variable to enable/disable debug mode.<BR>
+ * [defined in file compiler.c]
+ */
+extern int debug;
+
+/**
+ * Number of loop iterations after which a loop is executed as native code.<BR>
+ * [defined in file compiler.c]
+ */
+extern long hotLoopThreshold;
+
+/**
+ * Variable to select the output for the perf profiler.<BR>
+ * [defined in file compiler.c]
+ */
+extern int perfMap;
+
+/**
+ * This continues a loop as native code once it has been iterated often
+ * enough (see hotLoopThreshold).<BR>
+ * It is called by the interpreter right before the condition of the loop is
+ * evaluated for the next iteration. On the first call the loop is translated
+ * into C, compiled into a shared object within the cache directory and
+ * loaded.
+ * @param loop   The WHILE/DO WHILE code entry.
+ * @param marker The WHILE marker in front of the condition part of a WHILE
+ *               loop (<code>null</code> for DO WHILE loops).
+ * @param f      Reference to the file for storing the execution output.
+ * @param indent Current indentation within the execution output.
+ * @return <code>1</code> if the loop has been completed as native code.<BR>
+ *         <code>0</code> if the loop needs to be interpreted further.
+ */
+int runHotLoop(codeEntry* loop, codeEntry* marker, FILE *f, char* indent)
+{
+    if (loop->loopIterations < hotLoopThreshold)
+    {
+        return 0;
+    }
+
+    hotLoop* entry = compilation->hotLoopList;
+    while ((entry != 0) && (entry->loop != loop))
+    {
+        entry = entry->next;
+    }
+    if (entry == 0)
+    {
+        entry = compileHotLoop(loop, marker);
+        entry->next = compilation->hotLoopList;
+        compilation->hotLoopList = entry;
+    }
+    if (entry->function == 0)
+    {
+        return 0;
+    }
+
+    int symbols = 0;
+    symbolTableEntry* symbol = compilation->symbolTable;
+    while (symbol != 0)
+    {
+        symbols++;
+        symbol = symbol->next;
+    }
+
+    // Variables which are not yet part of the variable table are kept in
+    // scratch slots until the loop has finished
+    void** slots = (void**)malloc(sizeof(void*) * (entry->symbolCount + 1));
+    double* scratch = (double*)calloc(entry->symbolCount + 1, sizeof(double));
+    int* sequence = (int*)calloc(symbols + 1, sizeof(int));
+    int counter = 0;
+    int i;
+    for (i = 0; i < entry->symbolCount; i++)
+    {
+        variableTableEntry* value =
+            getEntryFromVariableTable(entry->symbols[i]);
+        slots[i] = (value != 0) ? (void*)&value->value : (void*)&scratch[i];
+    }
+
+    fprintf(f, "%s[%s loop of line %d continued as native code after %ld "
+            "iterations]\n", indent,
+            (marker != 0) ? "WHILE" : "DO WHILE", loop->sourceLine,
+            loop->loopIterations);
+
+    entry->function(slots, sequence, &counter, compilation->programResult);
+
+    // Create the new variables in the order of their first write
+    int* order = (int*)calloc(counter + 1, sizeof(int));
+    for (i = 0; i < entry->symbolCount; i++)
+    {
+        int position = sequence[entry->symbols[i]->index];
+        if ((position > 0) && (slots[i] == (void*)&scratch[i]))
+        {
+            order[position - 1] = i + 1;
+        }
+    }
+    for (i = 0; i < counter; i++)
+    {
+        if (order[i] > 0)
+        {
+            variableTableEntry* value =
+                addEntryToVariableTable(entry->symbols[order[i] - 1]);
+            memcpy(&value->value, &scratch[order[i] - 1], sizeof(double));
+        }
+    }
+
+    free(order);
+    free(sequence);
+    free(scratch);
+    free(slots);
+    return 1;
+}
+
+/**
+ * This translates a loop into a shared object and loads it.<BR>
+ * The shared object is named by a hash of the generated C code, so programs
+ * with the same loop reuse the compiled code within the cache directory
+ * (environment variable <code>MATHDH_CACHE</code>, default:
+ * <code>.mathdh-cache</code>).
+ * @param loop   The WHILE/DO WHILE code entry.
+ * @param marker The WHILE marker in front of the condition part of a WHILE
+ *               loop (<code>null</code> for DO WHILE loops).
+ * @return The translated loop.<BR>
+ *         Its function is <code>null</code> if the translation failed.
+ */
+hotLoop* compileHotLoop(codeEntry* loop, codeEntry* marker)
+{
+    hotLoop* entry = (hotLoop*)calloc(1, sizeof(hotLoop));
+    entry->loop = loop;
+
+    int symbols = 0;
+    symbolTableEntry* symbol = compilation->symbolTable;
+    while (symbol != 0)
+    {
+        symbols++;
+        symbol = symbol->next;
+    }
+    entry->symbols = (symbolTableEntry**)
+                     malloc(sizeof(symbolTableEntry*) * (symbols + 1));
+
+    char* seen = (char*)calloc(symbols + 1, 1);
+    addLoopSymbol(loop->target, entry, seen);
+    addLoopSymbol(loop->operand1, entry, seen);
+    addLoopSymbol(loop->operand2, entry, seen);
+    collectLoopSymbols(loop->sub_1, 0, entry, seen);
+    if (marker != 0)
+    {
+        collectLoopSymbols(marker->next, loop, entry, seen);
+    }
+    free(seen);
+
+#ifdef _WIN32
+    fprintf(stderr, "Native loops are not supported on this platform, "
+                    "using the interpreter\n");
+    return entry;
+#else
+    // Generate the C code: the loop continues with the condition, followed
+    // by the loop body and the condition part of a WHILE loop
+    char* source = 0;
+    size_t size = 0;
+    FILE *c = open_memstream(&source, &size);
+    fprintf(c, "/* Generated by the MathDH compiler */\n");
+    fprintf(c, "#include <stdio.h>\n\n");
+    // The function is named by the source code line for profilers
+    char function[40];
+    sprintf(function, "mathdh_loop_%d", loop->sourceLine);
+    fprintf(c, "void %s(void** slots, int* sequence, int* counter, "
+               "char* result)\n{\n", function);
+    int i;
+    for (i = 0; i < entry->symbolCount; i++)
+    {
+        fprintf(c, "    %s v_%s = *(%s*)slots[%d];\n",
+                (entry->symbols[i]->type == REAL) ? "double" : "int",
+                entry->symbols[i]->name,
+                (entry->symbols[i]->type == REAL) ? "double" : "int", i);
+    }
+    fprintf(c, "    int status = 0;\n\n    while (");
+    printCCondition(c, loop);
+    fprintf(c, ")\n    {\n");
+    compilation->cWriteTracking = 1;
+    printCCodeList(c, loop->sub_1, "        ");
+    if (marker != 0)
+    {
+        codeEntry* iterator = marker->next;
+        while (iterator != loop)
+        {
+            printCCodeEntry(c, iterator, "        ");
+            iterator = iterator->next;
+        }
+    }
+    compilation->cWriteTracking = 0;
+    fprintf(c, "    }\n    (void)status;\n\n");
+    for (i = 0; i < entry->symbolCount; i++)
+    {
+        fprintf(c, "    *(%s*)slots[%d] = v_%s;\n",
+                (entry->symbols[i]->type == REAL) ? "double" : "int", i,
+                entry->symbols[i]->name);
+    }
+    fprintf(c, "}\n");
+    fclose(c);
+
+    char* directory = getCacheDirectory();
+
+    char* compiler = getenv("CC");
+    if ((compiler == 0) || (*compiler == 0))
+    {
+        compiler = "cc";
+    }
+
+    char* path = (char*)malloc(strlen(directory) + 100);
+    char* command = (char*)malloc(strlen(directory) * 8 + strlen(compiler)
+                                  + 400);
+    unsigned long long hash = hashText(source);
+    sprintf(path, "%s/loop-%016llx.so", directory, hash);
+
+    // Compile into a temporary file first as other processes may use the
+    // same cache directory
+    if (access(path, R_OK) != 0)
+    {
+        sprintf(command, "%s/loop-%016llx.c", directory, hash);
+        FILE *out = fopen(command, "w");
+        if (out != 0)
+        {
+            fputs(source, out);
+            fclose(out);
+        }
+
+        // The cache directory is taken from the environment
+        char* file = (char*)malloc(strlen(directory) + 100);
+        sprintf(file, "%s.%d", path, (int)getpid());
+        char* quotedLibrary = quoteShellText(file);
+        sprintf(file, "%s/loop-%016llx.c", directory, hash);
+        char* quotedSource = quoteShellText(file);
+        free(file);
+        sprintf(command, "%s -O2 -fwrapv -shared -fPIC -o %s %s", compiler,
+                quotedLibrary, quotedSource);
+        free(quotedLibrary);
+        free(quotedSource);
+        if ((out == 0) || (system(command) != 0))
+        {
+            fprintf(stderr, "Error while compiling the loop of line %d, "
+                            "using the interpreter\n", loop->sourceLine);
+            free(source);
+            free(path);
+            free(command);
+            return entry;
+        }
+        sprintf(command, "%s.%d", path, (int)getpid());
+        rename(command, path);
+    }
+
+    entry->library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (entry->library != 0)
+    {
+        entry->function = (hotLoopFunction)dlsym(entry->library, function);
+    }
+    if (entry->function == 0)
+    {
+        fprintf(stderr, "Error while loading the loop of line %d (%s), "
+                        "using the interpreter\n", loop->sourceLine,
+                (entry->library == 0) ? dlerror() : "symbol missing");
+    }
+    else
+    {
+        if (debug)
+        {
+            printf("Loop of line %d executed as native code: %s\n",
+                   loop->sourceLine, path);
+        }
+#ifdef __GLIBC__
+        // The size of the function is taken from the ELF symbol table
+        Dl_info info;
+        ElfW(Sym)* elfSymbol = 0;
+        if (perfMap && dladdr1((void*)entry->function, &info,
+                               (void**)&elfSymbol, RTLD_DL_SYMENT)
+            && (elfSymbol != 0))
+        {
+            char name[400];
+            sprintf(name, "mathdh:%s:%d [hot loop]", getProgramName(),
+                    loop->sourceLine);
+            writePerfMapEntry((void*)entry->function, elfSymbol->st_size,
+                              name);
+        }
+#endif
+    }
+
+    free(source);
+    free(path);
+    free(command);
+    return entry;
+#endif
+}
+
+/**
+ * This collects all variables used by a code list (including nested code
+ * lists) up to a given entry.
+ * @param iterator The first code entry of the list.
+ * @param end      The first code entry which is not part of the range
+ *                 (<code>null</code> for the complete list).
+ * @param entry    The hot loop receiving the variables.
+ * @param seen     One flag per symbol whether it is already collected.
+ */
+void collectLoopSymbols(codeEntry* iterator, codeEntry* end, hotLoop* entry,
+                        char* seen)
+{
+    while ((iterator != 0) && (iterator != end))
+    {
+        addLoopSymbol(iterator->target, entry, seen);
+        addLoopSymbol(iterator->operand1, entry, seen);
+        addLoopSymbol(iterator->operand2, entry, seen);
+        collectLoopSymbols(iterator->sub_1, 0, entry, seen);
+        collectLoopSymbols(iterator->sub_2, 0, entry, seen);
+        iterator = iterator->next;
+    }
+}
+
+/**
+ * This adds a variable to the variables used within a loop.
+ * @param variable The variable (may be <code>null</code>).
+ * @param entry    The hot loop receiving the variable.
+ * @param seen     One flag per symbol whether it is already collected.
+ */
+void addLoopSymbol(symbolTableEntry* variable, hotLoop* entry, char* seen)
+{
+    if ((variable == 0) || seen[variable->index])
+    {
+        return;
+    }
+
+    seen[variable->index] = 1;
+    entry->symbols[entry->symbolCount++] = variable;
+}
+
+/**
+ * Calculates the 64 bit FNV-1a hash of a text.
+ * @param text The null-terminated text.
+ * @return The hash value.
+ */
+unsigned long long hashText(char* text)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    while (*text)
+    {
+        hash ^= (unsigned char)*text++;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
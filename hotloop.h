@@ -0,0 +1,131 @@
+/**
+ * @file hotloop.h
+ * @brief This defines all data structures and functions for executing
+ *        frequently iterated loops as native code (compiled by the system C
+ *        compiler at runtime).
+ */
+
+#include "generator.h"
+#include "symboltable.h"
+#include "compiler.h"
+#include <stdio.h>
+
+#ifndef HOTLOOP_H_
+#define HOTLOOP_H_
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_hotLoop hotLoop;
+
+/**
+ * Type definition of the function generated for a loop.<BR>
+ * The function continues the loop with the values referenced by
+ * <code>slots</code> (one per variable used within the loop, see
+ * hotLoop.symbols) and writes the values back afterwards.
+ * <code>sequence</code> and <code>counter</code> record the first writes of
+ * variables (see cWriteTracking), <code>result</code> receives the result of
+ * a RETURN statement.
+ */
+typedef void (*hotLoopFunction)(void** slots, int* sequence, int* counter,
+                                char* result);
+
+/**
+ * This structure defines a loop which has been translated into native code.
+ */
+struct s_hotLoop
+{
+    /**
+     * The WHILE/DO WHILE code entry of the loop.
+     */
+    codeEntry* loop;
+
+    /**
+     * Variables used within the loop (in the order of the slots passed to the
+     * generated function).
+     */
+    symbolTableEntry** symbols;
+
+    /**
+     * Number of entries within symbols.
+     */
+    int symbolCount;
+
+    /**
+     * Handle of the loaded shared object.<BR>
+     * This is <code>null</code> if the loop could not be translated.
+     */
+    void* library;
+
+    /**
+     * The generated function.<BR>
+     * This is <code>null</code> if the loop could not be translated. The loop
+     * is interpreted in this case.
+     */
+    hotLoopFunction function;
+
+    /**
+     * Pointer to the following hot loop.
+     */
+    hotLoop* next;
+};
+
+/**
+ * This continues a loop as native code once it has been iterated often
+ * enough (see hotLoopThreshold).<BR>
+ * It is called by the interpreter right before the condition of the loop is
+ * evaluated for the next iteration. On the first call the loop is translated
+ * into C, compiled into a shared object within the cache directory and
+ * loaded.
+ * @param loop   The WHILE/DO WHILE code entry.
+ * @param marker The WHILE marker in front of the condition part of a WHILE
+ *               loop (<code>null</code> for DO WHILE loops).
+ * @param f      Reference to the file for storing the execution output.
+ * @param indent Current indentation within the execution output.
+ * @return <code>1</code> if the loop has been completed as native code.<BR>
+ *         <code>0</code> if the loop needs to be interpreted further.
+ */
+int runHotLoop(codeEntry* loop, codeEntry* marker, FILE *f, char* indent);
+
+/**
+ * This translates a loop into a shared object and loads it.<BR>
+ * The shared object is named by a hash of the generated C code, so programs
+ * with the same loop reuse the compiled code within the cache directory
+ * (environment variable <code>MATHDH_CACHE</code>, default:
+ * <code>.mathdh-cache</code>).
+ * @param loop   The WHILE/DO WHILE code entry.
+ * @param marker The WHILE marker in front of the condition part of a WHILE
+ *               loop (<code>null</code> for DO WHILE loops).
+ * @return The translated loop.<BR>
+ *         Its function is <code>null</code> if the translation failed.
+ */
+hotLoop* compileHotLoop(codeEntry* loop, codeEntry* marker);
+
+/**
+ * This collects all variables used by a code list (including nested code
+ * lists) up to a given entry.
+ * @param iterator The first code entry of the list.
+ * @param end      The first code entry which is not part of the range
+ *                 (<code>null</code> for the complete list).
+ * @param entry    The hot loop receiving the variables.
+ * @param seen     One flag per symbol whether it is already collected.
+ */
+void collectLoopSymbols(codeEntry* iterator, codeEntry* end, hotLoop* entry,
+                        char* seen);
+
+/**
+ * This adds a variable to the variables used within a loop.
+ * @param variable The variable (may be <code>null</code>).
+ * @param entry    The hot loop receiving the variable.
+ * @param seen     One flag per symbol whether it is already collected.
+ */
+void addLoopSymbol(symbolTableEntry* variable, hotLoop* entry, char* seen);
+
+/**
+ * Calculates the 64 bit FNV-1a hash of a text.
+ * @param text The null-terminated text.
+ * @return The hash value.
+ */
+unsigned long long hashText(char* text);
+
+#endif /*HOTLOOP_H_*/
@@ -0,0 +1,1386 @@
+/**
+ * @file image.c
+ * @brief This contains all function implementations for the binary program
+ *        image: a compiled program which can be written to a file, mapped into
+ *        memory and executed without parsing the source code again.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "image.h"
+#include "interpreter.h"
+#include "context.h"
+#include "profiler.h"
+
+/**
+ * Variable to enable/disable debug mode.<BR>
+ * [defined in file compiler.c]
+ */
+extern int debug;
+
+/**
+ * Maximum number of instructions executed by a program.<BR>
+ * [defined in file compiler.c]
+ */
+extern long instructionBudget;
+
+/**
+ * Maximum execution time of a program in seconds.<BR>
+ * [defined in file compiler.c]
+ */
+extern double timeBudget;
+
+/**
+ * This writes the current intermediate code as program image into a file.
+ * @param fileName Name of the file to be created.
+ * @return <code>1</code> if the image has been written.<BR>
+ *         <code>0</code> if the file cannot be written.
+ */
+int writeProgramImage(char* fileName)
+{
+    FILE *f = fopen(fileName, "wb");
+    if (f == 0)
+    {
+        fprintf(stderr, "Error while creating the program image %s\n",
+                fileName);
+        return 0;
+    }
+
+    programImage* image = createProgramImage();
+    fwrite(image->memory, 1, image->header->size, f);
+    int result = (ferror(f) == 0);
+    result &= (fclose(f) == 0);
+    if (!result)
+    {
+        fprintf(stderr, "Error while writing the program image %s\n",
+                fileName);
+    }
+    else if (debug)
+    {
+        printf("Program image %s: %u instructions, %u constants, %u symbols, "
+               "%u bytes\n", fileName, image->header->instructionCount,
+               image->header->constantCount, image->header->symbolCount,
+               image->header->size);
+    }
+
+    freeProgramImage(image);
+    return result;
+}
+
+/**
+ * This creates a program image of the current intermediate code in memory.
+ * @return The image (to be freed by freeProgramImage).
+ */
+programImage* createProgramImage()
+{
+    compilationContext* context = compilation;
+    context->imageCodeCount = 0;
+    context->imageConstantCount = 0;
+    context->imageLineCount = 0;
+    appendImageList(context->codeList);
+
+    int symbolCount = 0;
+    int stringSize = 0;
+    symbolTableEntry* symbol = context->symbolTable;
+    while (symbol != 0)
+    {
+        symbolCount++;
+        stringSize += strlen(symbol->name) + 1;
+        symbol = symbol->next;
+    }
+
+    // All sections are aligned to 8 bytes
+    imageHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = IMAGE_MAGIC;
+    header.version = IMAGE_VERSION;
+    header.flags = compilation->optimized ? IMAGE_OPTIMIZED : 0;
+    header.instructionOffset = (sizeof(imageHeader) + 7) & ~7;
+    header.instructionCount = context->imageCodeCount;
+    header.constantOffset = (header.instructionOffset
+                             + context->imageCodeCount
+                               * sizeof(imageInstruction) + 7) & ~7;
+    header.constantCount = context->imageConstantCount;
+    header.symbolOffset = header.constantOffset
+                          + context->imageConstantCount * sizeof(imageValue);
+    header.symbolCount = symbolCount;
+    header.lineOffset = header.symbolOffset + symbolCount * sizeof(imageSymbol);
+    header.lineCount = context->imageLineCount;
+    header.stringOffset = header.lineOffset
+                          + context->imageLineCount * sizeof(imageLine);
+    header.stringSize = stringSize;
+    header.size = header.stringOffset + stringSize;
+
+    // The padding between the sections stays zero
+    char* memory = (char*)calloc(header.size + 1, 1);
+    memcpy(memory, &header, sizeof(header));
+    memcpy(memory + header.instructionOffset, context->imageCode,
+           context->imageCodeCount * sizeof(imageInstruction));
+    memcpy(memory + header.constantOffset, context->imageConstants,
+           context->imageConstantCount * sizeof(imageValue));
+    memcpy(memory + header.lineOffset, context->imageLines,
+           context->imageLineCount * sizeof(imageLine));
+
+    // Symbols are stored in the order of their index
+    imageSymbol* symbols = (imageSymbol*)(memory + header.symbolOffset);
+    char* strings = memory + header.stringOffset;
+    int position = 0;
+    symbol = context->symbolTable;
+    while (symbol != 0)
+    {
+        symbols[symbol->index].name = position;
+        symbols[symbol->index].type = symbol->type;
+        strcpy(strings + position, symbol->name);
+        position += strlen(symbol->name) + 1;
+        symbol = symbol->next;
+    }
+
+    return openProgramImage(memory, 0);
+}
+
+/**
+ * This appends the instructions for a code list (including nested code
+ * lists) to the program image buffer.
+ * @param list The first entry of the code list.
+ */
+void appendImageList(codeEntry* list)
+{
+    compilationContext* context = compilation;
+
+    // The condition part of a WHILE loop starts at the last marker
+    int marker = -1;
+    int start;
+    int jump;
+    int jumpEnd;
+
+    while (list != 0)
+    {
+        switch (list->op)
+        {
+            case OP_MARKER_WHILE:
+                marker = context->imageCodeCount;
+                break;
+
+            case OP_NOP:
+                break;
+
+            case OP_IF:
+            case OP_IF_COMPARE:
+                jump = appendImageBranch(list, IMG_BRANCH_FALSE);
+                appendImageList(list->sub_1);
+                if (list->sub_2 != 0)
+                {
+                    jumpEnd = appendImageInstruction(list, IMG_JUMP, 0, 0, 0);
+                    context->imageCode[jump].jump = context->imageCodeCount;
+                    appendImageList(list->sub_2);
+                    context->imageCode[jumpEnd].jump = context->imageCodeCount;
+                }
+                else
+                {
+                    context->imageCode[jump].jump = context->imageCodeCount;
+                }
+                break;
+
+            case OP_WHILE:
+            case OP_WHILE_COMPARE:
+                start = (marker >= 0) ? marker : context->imageCodeCount;
+                jump = appendImageBranch(list, IMG_BRANCH_FALSE);
+                appendImageList(list->sub_1);
+                jumpEnd = appendImageInstruction(list, IMG_JUMP, 0, 0, 0);
+                context->imageCode[jumpEnd].jump = start;
+                context->imageCode[jump].jump = context->imageCodeCount;
+                break;
+
+            case OP_DO_WHILE:
+            case OP_DO_WHILE_COMPARE:
+                start = context->imageCodeCount;
+                appendImageList(list->sub_1);
+                jump = appendImageBranch(list, IMG_BRANCH_TRUE);
+                context->imageCode[jump].jump = start;
+                break;
+
+            case OP_EXIT:
+                appendImageInstruction(list, IMG_EXIT, 0, list->operand1, 0);
+                break;
+
+            case OP_INCREMENT:
+                appendImageInstruction(list, IMG_INCREMENT, list->target, 0,
+                                       0);
+                break;
+
+            case OP_DECREMENT:
+                appendImageInstruction(list, IMG_DECREMENT, list->target, 0,
+                                       0);
+                break;
+
+            case OP_ASSIGN:
+                appendImageInstruction(list, IMG_ASSIGN, list->target,
+                                       list->operand1, 0);
+                break;
+
+            case OP_INT_CONSTANT:
+            case OP_FLOAT_CONSTANT:
+            case OP_BOOL_CONSTANT:
+            {
+                imageValue value;
+                memset(&value, 0, sizeof(value));
+                if (list->op == OP_FLOAT_CONSTANT)
+                {
+                    value.floatValue = list->real;
+                }
+                else
+                {
+                    value.intValue = (list->op == OP_INT_CONSTANT)
+                                     ? list->integer : list->boolean;
+                }
+                // The constant of an input is its default value
+                int input = getInputNumber(list->target);
+                jump = appendImageInstruction(list, (input >= 0) ? IMG_INPUT
+                                                                 : IMG_CONSTANT,
+                                              list->target, 0, 0);
+                context->imageCode[jump].operand1 = appendImageConstant(value);
+                if (input >= 0)
+                {
+                    context->imageCode[jump].operand2 = input;
+                }
+                break;
+            }
+
+            default:
+                // Comparisons, logical and mathematical operations
+                appendImageInstruction(list, getImageOperation(list->op),
+                                       list->target, list->operand1,
+                                       list->operand2);
+        }
+        list = list->next;
+    }
+}
+
+/**
+ * This appends a single instruction to the program image buffer.
+ * @param entry    The code entry the instruction belongs to (source line).
+ * @param op       The operation.
+ * @param target   The target variable (may be <code>null</code>).
+ * @param operand1 The 1st operand (may be <code>null</code>).
+ * @param operand2 The 2nd operand (may be <code>null</code>).
+ * @return Index of the new instruction.
+ */
+int appendImageInstruction(codeEntry* entry, imageOperation op,
+                           symbolTableEntry* target,
+                           symbolTableEntry* operand1,
+                           symbolTableEntry* operand2)
+{
+    compilationContext* context = compilation;
+
+    if (context->imageCodeCount == context->imageCodeCapacity)
+    {
+        context->imageCodeCapacity = (context->imageCodeCapacity == 0)
+                                     ? 256 : context->imageCodeCapacity * 2;
+        context->imageCode = (imageInstruction*)realloc(context->imageCode,
+                             context->imageCodeCapacity
+                             * sizeof(imageInstruction));
+    }
+
+    int index = context->imageCodeCount;
+    imageInstruction* instruction = &context->imageCode[index];
+    memset(instruction, 0, sizeof(imageInstruction));
+    instruction->op = op;
+    instruction->target = (target != 0) ? target->index : -1;
+    instruction->operand1 = (operand1 != 0) ? operand1->index : -1;
+    instruction->operand2 = (operand2 != 0) ? operand2->index : -1;
+    instruction->jump = -1;
+
+    // A new line table entry is only required if the line changes
+    if ((context->imageLineCount == 0)
+        || (context->imageLines[context->imageLineCount - 1].line
+            != (unsigned int)entry->sourceLine))
+    {
+        if (context->imageLineCount == context->imageLineCapacity)
+        {
+            context->imageLineCapacity = (context->imageLineCapacity == 0)
+                                         ? 64 : context->imageLineCapacity * 2;
+            context->imageLines = (imageLine*)realloc(context->imageLines,
+                                  context->imageLineCapacity
+                                  * sizeof(imageLine));
+        }
+        imageLine* line = &context->imageLines[context->imageLineCount++];
+        line->instruction = index;
+        line->line = entry->sourceLine;
+    }
+
+    context->imageCodeCount++;
+    return index;
+}
+
+/**
+ * This appends the instruction for the condition of an IF/WHILE/DO WHILE
+ * statement (including a fused increment/decrement) to the program image
+ * buffer. The jump target needs to be set afterwards.
+ * @param entry The IF/WHILE/DO WHILE code entry.
+ * @param op    IMG_BRANCH_FALSE or IMG_BRANCH_TRUE.
+ * @return Index of the new instruction.
+ */
+int appendImageBranch(codeEntry* entry, imageOperation op)
+{
+    compilationContext* context = compilation;
+
+    if ((entry->op != OP_IF_COMPARE) && (entry->op != OP_WHILE_COMPARE)
+        && (entry->op != OP_DO_WHILE_COMPARE))
+    {
+        return appendImageInstruction(entry, op, 0, entry->operand1, 0);
+    }
+
+    int step = (entry->step == OP_INCREMENT) ? IMG_INCREMENT
+             : (entry->step == OP_DECREMENT) ? IMG_DECREMENT : 0;
+    int index = appendImageInstruction(entry, op,
+                                       (step != 0) ? entry->target : 0,
+                                       entry->operand1, entry->operand2);
+    context->imageCode[index].compare = getImageOperation(entry->compare);
+    context->imageCode[index].step = step;
+    return index;
+}
+
+/**
+ * This appends a value to the constant pool of the program image buffer.
+ * @param value The constant value.
+ * @return Index of the constant.
+ */
+int appendImageConstant(imageValue value)
+{
+    compilationContext* context = compilation;
+
+    if (context->imageConstantCount == context->imageConstantCapacity)
+    {
+        context->imageConstantCapacity = (context->imageConstantCapacity == 0)
+                                         ? 64
+                                         : context->imageConstantCapacity * 2;
+        context->imageConstants = (imageValue*)realloc(context->imageConstants,
+                                  context->imageConstantCapacity
+                                  * sizeof(imageValue));
+    }
+    context->imageConstants[context->imageConstantCount] = value;
+    return context->imageConstantCount++;
+}
+
+/**
+ * Determines the program image operation of a comparison or mathematical
+ * operation of the intermediate code.
+ * @param op The operation of the intermediate code.
+ * @return The program image operation.<BR>
+ *         <code>0</code> if there is no corresponding operation.
+ */
+imageOperation getImageOperation(operation op)
+{
+    switch (op)
+    {
+        case OP_EQUAL:
+            return IMG_EQUAL;
+        case OP_NOT_EQUAL:
+            return IMG_NOT_EQUAL;
+        case OP_LESS_OR_EQUAL:
+            return IMG_LESS_OR_EQUAL;
+        case OP_GREATER_OR_EQUAL:
+            return IMG_GREATER_OR_EQUAL;
+        case OP_GREATER:
+            return IMG_GREATER;
+        case OP_LESS:
+            return IMG_LESS;
+        case OP_AND:
+            return IMG_AND;
+        case OP_OR:
+            return IMG_OR;
+        case OP_NOT:
+            return IMG_NOT;
+        case OP_PLUS:
+            return IMG_PLUS;
+        case OP_MINUS:
+            return IMG_MINUS;
+        case OP_MULTIPLY:
+            return IMG_MULTIPLY;
+        case OP_DIVIDE:
+            return IMG_DIVIDE;
+        case OP_MODULO:
+            return IMG_MODULO;
+        default:
+            return (imageOperation)0;
+    }
+}
+
+/**
+ * This maps a program image file into memory and verifies it.
+ * @param fileName Name of the image file.
+ * @return The loaded image.<BR>
+ *         <code>null</code> if the file cannot be read or is no valid image.
+ */
+programImage* loadProgramImage(char* fileName)
+{
+    void* memory = 0;
+    unsigned long size = 0;
+
+#ifndef _WIN32
+    int file = open(fileName, O_RDONLY);
+    struct stat status;
+    if ((file < 0) || (fstat(file, &status) != 0))
+    {
+        fprintf(stderr, "Error while opening the program image %s\n",
+                fileName);
+        if (file >= 0)
+        {
+            close(file);
+        }
+        return 0;
+    }
+    size = status.st_size;
+    if (size > 0)
+    {
+        memory = mmap(0, size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    close(file);
+    if ((memory == 0) || (memory == MAP_FAILED))
+    {
+        fprintf(stderr, "Error while mapping the program image %s\n",
+                fileName);
+        return 0;
+    }
+#else
+    // Without mmap the image is read into memory
+    FILE *f = fopen(fileName, "rb");
+    if (f == 0)
+    {
+        fprintf(stderr, "Error while opening the program image %s\n",
+                fileName);
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    memory = malloc(size + 1);
+    size = fread(memory, 1, size, f);
+    fclose(f);
+#endif
+
+    if (!verifyProgramImage(memory, size))
+    {
+        fprintf(stderr, "Invalid program image %s\n", fileName);
+#ifndef _WIN32
+        munmap(memory, size);
+#else
+        free(memory);
+#endif
+        return 0;
+    }
+
+#ifndef _WIN32
+    programImage* image = openProgramImage(memory, 1);
+#else
+    programImage* image = openProgramImage(memory, 0);
+#endif
+
+    if (debug)
+    {
+        printf("Program image %s: %u instructions, %u constants, %u symbols "
+               "(%s)\n", fileName, image->header->instructionCount,
+               image->header->constantCount, image->header->symbolCount,
+               (image->header->flags & IMAGE_OPTIMIZED) ? "optimized"
+                                                        : "not optimized");
+    }
+    return image;
+}
+
+/**
+ * This creates the data structures for a verified program image in memory.
+ * @param memory Start of the image.
+ * @param mapped <code>1</code> if the memory is a mapping of the image file,
+ *               <code>0</code> if it has been allocated by
+ *               <code>malloc</code>.
+ * @return The image (to be freed by freeProgramImage).
+ */
+programImage* openProgramImage(void* memory, int mapped)
+{
+    programImage* image = (programImage*)malloc(sizeof(programImage));
+    image->memory = memory;
+    image->mapped = mapped;
+    image->header = (imageHeader*)memory;
+    image->instructions = (imageInstruction*)((char*)memory
+                          + image->header->instructionOffset);
+    image->constants = (imageValue*)((char*)memory
+                       + image->header->constantOffset);
+    image->lines = (imageLine*)((char*)memory + image->header->lineOffset);
+
+    // The names stay within the string table of the image
+    imageSymbol* symbols = (imageSymbol*)((char*)memory
+                           + image->header->symbolOffset);
+    char* strings = (char*)memory + image->header->stringOffset;
+    int count = image->header->symbolCount;
+    image->symbols = (symbolTableEntry*)calloc(count + 1,
+                                               sizeof(symbolTableEntry));
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        image->symbols[i].name = strings + symbols[i].name;
+        image->symbols[i].type = (dataType)symbols[i].type;
+        image->symbols[i].index = i;
+        image->symbols[i].next = (i + 1 < count) ? &image->symbols[i + 1] : 0;
+    }
+    return image;
+}
+
+/**
+ * This verifies the structure of a program image before it is executed: all
+ * sections need to be located within the image, all instructions need to be
+ * known and to reference existing variables, constants and instructions, and
+ * the data types of the operands need to fit the operation.
+ * @param memory Start of the image.
+ * @param size   Size of the image in bytes.
+ * @return <code>1</code> if the image is valid.<BR>
+ *         <code>0</code> otherwise (the reason is printed to STDERR).
+ */
+int verifyProgramImage(void* memory, unsigned long size)
+{
+    imageHeader* header = (imageHeader*)memory;
+    if ((size < sizeof(imageHeader)) || (header->magic != IMAGE_MAGIC))
+    {
+        fprintf(stderr, "Program image: no program image\n");
+        return 0;
+    }
+    if (header->version != IMAGE_VERSION)
+    {
+        fprintf(stderr, "Program image: unsupported version %u (expected "
+                        "%d)\n", header->version, IMAGE_VERSION);
+        return 0;
+    }
+
+    // Sections need to be aligned and located within the image (64 bit
+    // arithmetic prevents overflows)
+    if ((header->size != size)
+        || (header->instructionOffset % 8) || (header->constantOffset % 8)
+        || (header->symbolOffset % 4) || (header->lineOffset % 4)
+        || ((unsigned long long)header->instructionOffset
+            + (unsigned long long)header->instructionCount
+              * sizeof(imageInstruction) > size)
+        || ((unsigned long long)header->constantOffset
+            + (unsigned long long)header->constantCount
+              * sizeof(imageValue) > size)
+        || ((unsigned long long)header->symbolOffset
+            + (unsigned long long)header->symbolCount
+              * sizeof(imageSymbol) > size)
+        || ((unsigned long long)header->lineOffset
+            + (unsigned long long)header->lineCount
+              * sizeof(imageLine) > size)
+        || ((unsigned long long)header->stringOffset
+            + header->stringSize > size)
+        || (header->symbolCount > 0x7FFFFFFF)
+        || (header->instructionCount > 0x7FFFFFFF))
+    {
+        fprintf(stderr, "Program image: invalid section\n");
+        return 0;
+    }
+
+    char* strings = (char*)memory + header->stringOffset;
+    imageSymbol* symbols = (imageSymbol*)((char*)memory
+                           + header->symbolOffset);
+    unsigned int i;
+    if ((header->stringSize > 0) && (strings[header->stringSize - 1] != 0))
+    {
+        fprintf(stderr, "Program image: invalid string table\n");
+        return 0;
+    }
+    for (i = 0; i < header->symbolCount; i++)
+    {
+        if ((symbols[i].name >= header->stringSize)
+            || ((symbols[i].type != INTEGER) && (symbols[i].type != REAL)
+                && (symbols[i].type != BOOLEAN)))
+        {
+            fprintf(stderr, "Program image: invalid symbol %u\n", i);
+            return 0;
+        }
+    }
+
+    imageLine* lines = (imageLine*)((char*)memory + header->lineOffset);
+    for (i = 0; i < header->lineCount; i++)
+    {
+        if ((lines[i].instruction >= header->instructionCount)
+            || ((i > 0) && (lines[i].instruction
+                            <= lines[i - 1].instruction)))
+        {
+            fprintf(stderr, "Program image: invalid line table entry %u\n", i);
+            return 0;
+        }
+    }
+
+    imageInstruction* instructions = (imageInstruction*)((char*)memory
+                                     + header->instructionOffset);
+    for (i = 0; i < header->instructionCount; i++)
+    {
+        if (!verifyImageInstruction(header, symbols, &instructions[i]))
+        {
+            fprintf(stderr, "Program image: invalid instruction %u\n", i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * This verifies a single instruction of a program image.
+ * @param header      Header of the image.
+ * @param symbols     Symbols of the image.
+ * @param instruction The instruction.
+ * @return <code>1</code> if the instruction is valid.<BR>
+ *         <code>0</code> otherwise.
+ */
+int verifyImageInstruction(imageHeader* header, imageSymbol* symbols,
+                           imageInstruction* instruction)
+{
+    int count = header->symbolCount;
+    int target = instruction->target;
+    int operand1 = instruction->operand1;
+    int operand2 = instruction->operand2;
+
+    // Data types of the used variables (-1 if unused, -2 if invalid)
+    int types[3];
+    int values[3];
+    values[0] = target;
+    values[1] = operand1;
+    values[2] = operand2;
+    int i;
+    for (i = 0; i < 3; i++)
+    {
+        types[i] = (values[i] == -1) ? -1
+                 : ((values[i] >= 0) && (values[i] < count))
+                   ? (int)symbols[values[i]].type : -2;
+    }
+    if ((instruction->op != IMG_CONSTANT) && (instruction->op != IMG_INPUT))
+    {
+        if ((types[0] == -2) || (types[1] == -2) || (types[2] == -2))
+        {
+            return 0;
+        }
+    }
+
+    switch (instruction->op)
+    {
+        case IMG_EQUAL:
+        case IMG_NOT_EQUAL:
+        case IMG_LESS_OR_EQUAL:
+        case IMG_GREATER_OR_EQUAL:
+        case IMG_GREATER:
+        case IMG_LESS:
+            return (types[0] == BOOLEAN) && (types[1] >= 0)
+                   && (types[2] >= 0);
+
+        case IMG_AND:
+        case IMG_OR:
+            return (types[0] == BOOLEAN) && (types[1] == BOOLEAN)
+                   && (types[2] == BOOLEAN);
+
+        case IMG_NOT:
+            return (types[0] == BOOLEAN) && (types[1] == BOOLEAN)
+                   && (types[2] == -1);
+
+        case IMG_PLUS:
+        case IMG_MINUS:
+        case IMG_MULTIPLY:
+        case IMG_DIVIDE:
+            return (types[0] >= 0) && (types[0] != BOOLEAN)
+                   && (types[1] >= 0) && (types[1] != BOOLEAN)
+                   && (types[2] >= 0) && (types[2] != BOOLEAN);
+
+        case IMG_MODULO:
+            return (types[0] == INTEGER) && (types[1] == INTEGER)
+                   && (types[2] == INTEGER);
+
+        case IMG_INCREMENT:
+        case IMG_DECREMENT:
+            return (types[0] == INTEGER) && (types[1] == -1)
+                   && (types[2] == -1);
+
+        case IMG_ASSIGN:
+            return (types[0] >= 0) && (types[1] >= 0) && (types[2] == -1)
+                   && ((types[0] == types[1])
+                       || ((types[0] == REAL) && (types[1] == INTEGER)));
+
+        case IMG_CONSTANT:
+            return (types[0] >= 0) && (operand1 >= 0)
+                   && ((unsigned int)operand1 < header->constantCount)
+                   && (operand2 == -1);
+
+        // The input number is limited by the number of variables
+        case IMG_INPUT:
+            return (types[0] >= 0) && (operand1 >= 0)
+                   && ((unsigned int)operand1 < header->constantCount)
+                   && (operand2 >= 0) && (operand2 < count);
+
+        case IMG_EXIT:
+            return (types[0] == -1) && (types[1] >= 0) && (types[2] == -1);
+
+        case IMG_JUMP:
+            return (instruction->jump >= 0)
+                   && ((unsigned int)instruction->jump
+                       <= header->instructionCount);
+
+        case IMG_BRANCH_FALSE:
+        case IMG_BRANCH_TRUE:
+            if ((instruction->jump < 0)
+                || ((unsigned int)instruction->jump
+                    > header->instructionCount))
+            {
+                return 0;
+            }
+            if (instruction->compare == 0)
+            {
+                return (instruction->step == 0) && (types[0] == -1)
+                       && (types[1] == BOOLEAN) && (types[2] == -1);
+            }
+            if ((instruction->compare > IMG_LESS)
+                || (types[1] < 0) || (types[1] == BOOLEAN)
+                || (types[2] < 0) || (types[2] == BOOLEAN))
+            {
+                return 0;
+            }
+            if (instruction->step == 0)
+            {
+                return types[0] == -1;
+            }
+            return ((instruction->step == IMG_INCREMENT)
+                    || (instruction->step == IMG_DECREMENT))
+                   && (types[0] == INTEGER);
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * This unmaps or frees a program image and frees all data structures.
+ * @param image The image created by loadProgramImage or createProgramImage.
+ */
+void freeProgramImage(programImage* image)
+{
+#ifndef _WIN32
+    if (image->mapped)
+    {
+        munmap(image->memory, image->header->size);
+    }
+    else
+#endif
+    {
+        free(image->memory);
+    }
+    free(image->symbols);
+    free(image);
+}
+
+/**
+ * This creates the initial execution state of a program image (no variable
+ * written, execution starts with the first instruction).
+ * @param image The image to be executed.
+ * @return The new execution state.
+ */
+imageState* createImageState(programImage* image)
+{
+    int count = image->header->symbolCount;
+    imageState* state = (imageState*)calloc(1, sizeof(imageState));
+    state->image = image;
+    // Unused operands (index -1) refer to an additional scratch value
+    state->values = (imageValue*)calloc(count + 1, sizeof(imageValue)) + 1;
+    state->sequence = (int*)calloc(count + 1, sizeof(int));
+    return state;
+}
+
+/**
+ * This frees an execution state.
+ * @param state The execution state created by createImageState.
+ */
+void freeImageState(imageState* state)
+{
+    free(state->values - 1);
+    free(state->sequence);
+    free(state);
+}
+
+/**
+ * This resets an execution state, so that the program can be executed again.
+ * <BR>
+ * The values of the inputs are kept.
+ * @param state The execution state.
+ */
+void resetImageState(imageState* state)
+{
+    int count = state->image->header->symbolCount;
+    memset(state->values - 1, 0, sizeof(imageValue) * (count + 1));
+    memset(state->sequence, 0, sizeof(int) * (count + 1));
+    state->counter = 0;
+    state->pc = 0;
+    state->resultType = 0;
+    state->executed = 0;
+    state->segment = 0;
+    state->exceeded = 0;
+}
+
+/**
+ * This records the first write of a variable (see imageState.sequence).
+ * @param state    The execution state.
+ * @param variable Symbol index of the written variable.
+ */
+void markImageVariable(imageState* state, int variable)
+{
+    if (state->sequence[variable] == 0)
+    {
+        state->sequence[variable] = ++state->counter;
+    }
+}
+
+/**
+ * This executes the instructions of a program image until the end of the
+ * program.
+ * @param state The execution state (updated).
+ */
+void executeProgramImage(imageState* state)
+{
+    executeProgramImageSlice(state, -1);
+}
+
+/**
+ * This continues the execution of a program image for a limited number of
+ * instructions, so that several programs can share a thread.<BR>
+ * The limit is only checked at backward jumps, so a slice may execute up to
+ * the length of the program more instructions.
+ * @param state   The execution state (updated).
+ * @param quantum Number of instructions (<code>-1</code> for no limit).
+ * @return <code>1</code> if the program has finished or exceeded its budget
+ *         (see exceeded).<BR>
+ *         <code>0</code> if it needs to be continued.
+ */
+int executeProgramImageSlice(imageState* state, long quantum)
+{
+    if (state->exceeded)
+    {
+        return 1;
+    }
+    state->sliceEnd = (quantum < 0) ? LONG_MAX : state->executed + quantum;
+    updateImageLimit(state);
+    imageInstruction* instructions = state->image->instructions;
+    symbolTableEntry* symbols = state->image->symbols;
+    imageValue* values = state->values;
+    unsigned int count = state->image->header->instructionCount;
+
+    while (state->pc < count)
+    {
+        imageInstruction* instruction = &instructions[state->pc++];
+        imageValue* target = &values[instruction->target];
+        imageValue* operand1 = &values[instruction->operand1];
+        imageValue* operand2 = &values[instruction->operand2];
+        dataType type1 = (instruction->operand1 >= 0)
+                         ? symbols[instruction->operand1].type : INTEGER;
+        dataType type2 = (instruction->operand2 >= 0)
+                         ? symbols[instruction->operand2].type : INTEGER;
+
+        switch (instruction->op)
+        {
+            case IMG_EQUAL:
+            case IMG_NOT_EQUAL:
+            case IMG_LESS_OR_EQUAL:
+            case IMG_GREATER_OR_EQUAL:
+            case IMG_GREATER:
+            case IMG_LESS:
+            {
+                // BOOLEAN values are not compared (as by the interpreter)
+                markImageVariable(state, instruction->target);
+                if ((type1 == BOOLEAN) || (type2 == BOOLEAN))
+                {
+                    break;
+                }
+                // Integers are represented exactly as double values
+                double a = (type1 == INTEGER) ? operand1->intValue
+                                              : operand1->floatValue;
+                double b = (type2 == INTEGER) ? operand2->intValue
+                                              : operand2->floatValue;
+                switch (instruction->op)
+                {
+                    case IMG_EQUAL:
+                        target->intValue = (a == b);
+                        break;
+                    case IMG_NOT_EQUAL:
+                        target->intValue = (a != b);
+                        break;
+                    case IMG_LESS_OR_EQUAL:
+                        target->intValue = (a <= b);
+                        break;
+                    case IMG_GREATER_OR_EQUAL:
+                        target->intValue = (a >= b);
+                        break;
+                    case IMG_GREATER:
+                        target->intValue = (a > b);
+                        break;
+                    default:
+                        target->intValue = (a < b);
+                        break;
+                }
+                break;
+            }
+
+            case IMG_AND:
+                target->intValue = operand1->intValue && operand2->intValue;
+                markImageVariable(state, instruction->target);
+                break;
+
+            case IMG_OR:
+                target->intValue = operand1->intValue || operand2->intValue;
+                markImageVariable(state, instruction->target);
+                break;
+
+            case IMG_NOT:
+                target->intValue = !operand1->intValue;
+                markImageVariable(state, instruction->target);
+                break;
+
+            case IMG_PLUS:
+            case IMG_MINUS:
+            case IMG_MULTIPLY:
+            case IMG_DIVIDE:
+            case IMG_MODULO:
+                markImageVariable(state, instruction->target);
+                if ((type1 == INTEGER) && (type2 == INTEGER))
+                {
+                    int a = operand1->intValue;
+                    int b = operand2->intValue;
+                    switch (instruction->op)
+                    {
+                        case IMG_PLUS:
+                            target->intValue = a + b;
+                            break;
+                        case IMG_MINUS:
+                            target->intValue = a - b;
+                            break;
+                        case IMG_MULTIPLY:
+                            target->intValue = a * b;
+                            break;
+                        default:
+                            if (state->guarded
+                                && ((b == 0) || ((b == -1) && (a == INT_MIN))))
+                            {
+                                state->exceeded = BUDGET_FAULT;
+                                state->exceededAt = state->pc - 1;
+                                return 1;
+                            }
+                            target->intValue = (instruction->op == IMG_DIVIDE)
+                                               ? a / b : a % b;
+                            break;
+                    }
+                }
+                else
+                {
+                    double a = (type1 == INTEGER) ? operand1->intValue
+                                                  : operand1->floatValue;
+                    double b = (type2 == INTEGER) ? operand2->intValue
+                                                  : operand2->floatValue;
+                    switch (instruction->op)
+                    {
+                        case IMG_PLUS:
+                            target->floatValue = a + b;
+                            break;
+                        case IMG_MINUS:
+                            target->floatValue = a - b;
+                            break;
+                        case IMG_MULTIPLY:
+                            target->floatValue = a * b;
+                            break;
+                        default:
+                            target->floatValue = a / b;
+                            break;
+                    }
+                }
+                break;
+
+            case IMG_INCREMENT:
+                target->intValue++;
+                markImageVariable(state, instruction->target);
+                break;
+
+            case IMG_DECREMENT:
+                target->intValue--;
+                markImageVariable(state, instruction->target);
+                break;
+
+            case IMG_ASSIGN:
+                if ((type1 == INTEGER)
+                    && (symbols[instruction->target].type == REAL))
+                {
+                    target->floatValue = operand1->intValue;
+                }
+                else
+                {
+                    *target = *operand1;
+                }
+                markImageVariable(state, instruction->target);
+                break;
+
+            case IMG_CONSTANT:
+                *target = state->image->constants[instruction->operand1];
+                markImageVariable(state, instruction->target);
+                break;
+
+            case IMG_INPUT:
+                *target = (state->inputs != 0)
+                          ? state->inputs[instruction->operand2]
+                          : state->image->constants[instruction->operand1];
+                markImageVariable(state, instruction->target);
+                break;
+
+            case IMG_EXIT:
+                state->resultType = type1 + 1;
+                state->result = *operand1;
+                break;
+
+            case IMG_JUMP:
+                if (jumpProgramImage(state, instruction))
+                {
+                    return state->exceeded != 0;
+                }
+                break;
+
+            case IMG_BRANCH_FALSE:
+                if (!evaluateImageCondition(state, instruction)
+                    && jumpProgramImage(state, instruction))
+                {
+                    return state->exceeded != 0;
+                }
+                break;
+
+            case IMG_BRANCH_TRUE:
+                if (evaluateImageCondition(state, instruction)
+                    && jumpProgramImage(state, instruction))
+                {
+                    return state->exceeded != 0;
+                }
+                break;
+        }
+    }
+
+    if (state->segment < count)
+    {
+        state->executed += count - state->segment;
+        state->segment = count;
+    }
+    return 1;
+}
+
+/**
+ * This executes a jump of a program image and counts the instructions since
+ * the last jump.
+ * @param state       The execution state.
+ * @param instruction The jump or branch instruction.
+ * @return <code>1</code> if the jump leads backwards and the slice has ended
+ *         or the budget has been exceeded.<BR>
+ *         <code>0</code> otherwise.
+ */
+int jumpProgramImage(imageState* state, imageInstruction* instruction)
+{
+    // Every instruction from the last jump target up to this jump has been
+    // executed exactly once
+    unsigned int index = state->pc - 1;
+    state->executed += state->pc - state->segment;
+    state->pc = instruction->jump;
+    state->segment = state->pc;
+
+    // Programs without backward jumps end after a bounded number of
+    // instructions, so they are never interrupted
+    return ((unsigned int)instruction->jump < index)
+           && (state->executed >= state->limit)
+           && checkImageBudget(state, index);
+}
+
+/**
+ * This limits the execution of a program image.<BR>
+ * Like the slices, the limits are only checked at backward jumps.
+ * @param state        The execution state.
+ * @param instructions Maximum number of executed instructions
+ *                     (<code>0</code> for no limit).
+ * @param seconds      Maximum execution time starting now (<code>0</code>
+ *                     for no limit).
+ */
+void setImageBudget(imageState* state, long instructions, double seconds)
+{
+    state->budget = (instructions > 0) ? instructions : 0;
+    state->deadline = (seconds > 0) ? getProfileTime() + seconds : 0;
+}
+
+/**
+ * This checks the end of the slice and the budget of an execution at a
+ * backward jump once executed has reached limit.
+ * @param state The execution state.
+ * @param jump  Index of the backward jump.
+ * @return <code>1</code> if the execution needs to return.<BR>
+ *         <code>0</code> otherwise.
+ */
+int checkImageBudget(imageState* state, unsigned int jump)
+{
+    if ((state->budget > 0) && (state->executed >= state->budget))
+    {
+        state->exceeded = BUDGET_INSTRUCTIONS;
+    }
+    else if ((state->deadline > 0) && (getProfileTime() >= state->deadline))
+    {
+        state->exceeded = BUDGET_TIME;
+    }
+    else if (state->executed >= state->sliceEnd)
+    {
+        return 1;
+    }
+    else
+    {
+        updateImageLimit(state);
+        return 0;
+    }
+    state->exceededAt = jump;
+    return 1;
+}
+
+/**
+ * This determines the value of executed at which the next backward jump
+ * checks the end of the slice and the budget (see limit).
+ * @param state The execution state.
+ */
+void updateImageLimit(imageState* state)
+{
+    long limit = state->sliceEnd;
+    if ((state->budget > 0) && (state->budget < limit))
+    {
+        limit = state->budget;
+    }
+    if ((state->deadline > 0)
+        && (state->executed + BUDGET_CLOCK_INTERVAL < limit))
+    {
+        limit = state->executed + BUDGET_CLOCK_INTERVAL;
+    }
+    state->limit = limit;
+}
+
+/**
+ * This evaluates the condition of a branch instruction including a fused
+ * increment/decrement.
+ * @param state       The execution state.
+ * @param instruction The branch instruction.
+ * @return <code>1</code> if the condition is fulfilled.<BR>
+ *         <code>0</code> otherwise.
+ */
+int evaluateImageCondition(imageState* state, imageInstruction* instruction)
+{
+    imageValue* values = state->values;
+    if (instruction->compare == 0)
+    {
+        return values[instruction->operand1].intValue;
+    }
+
+    if (instruction->step == IMG_INCREMENT)
+    {
+        values[instruction->target].intValue++;
+        markImageVariable(state, instruction->target);
+    }
+    else if (instruction->step == IMG_DECREMENT)
+    {
+        values[instruction->target].intValue--;
+        markImageVariable(state, instruction->target);
+    }
+
+    symbolTableEntry* symbols = state->image->symbols;
+    imageValue* operand1 = &values[instruction->operand1];
+    imageValue* operand2 = &values[instruction->operand2];
+    double a = (symbols[instruction->operand1].type == INTEGER)
+               ? operand1->intValue : operand1->floatValue;
+    double b = (symbols[instruction->operand2].type == INTEGER)
+               ? operand2->intValue : operand2->floatValue;
+
+    switch (instruction->compare)
+    {
+        case IMG_EQUAL:
+            return a == b;
+        case IMG_NOT_EQUAL:
+            return a != b;
+        case IMG_LESS_OR_EQUAL:
+            return a <= b;
+        case IMG_GREATER_OR_EQUAL:
+            return a >= b;
+        case IMG_GREATER:
+            return a > b;
+        default:
+            return a < b;
+    }
+}
+
+/**
+ * This executes a program image like the interpreter: the variable table at
+ * program exit is written to file <code>4_variabletable</code> and the return
+ * value of the program is printed on screen. The file
+ * <code>3_execution</code> contains no trace.
+ * @param image The image to be executed.
+ */
+void runProgramImage(programImage* image)
+{
+    imageState* state = createImageState(image);
+    setImageBudget(state, instructionBudget, timeBudget);
+    executeProgramImage(state);
+    finishProgramImage(state);
+    freeImageState(state);
+}
+
+/**
+ * This writes the output of a finished execution like the interpreter: the
+ * variable table, the program result and <code>3_execution</code> (without
+ * trace, but with the reason if the execution has been stopped).
+ * @param state The finished execution state.
+ */
+void finishProgramImage(imageState* state)
+{
+    programImage* image = state->image;
+    storeImageResult(state);
+
+    FILE *f = fopen("3_execution", "w");
+    fprintf(f, "== CODE EXECUTION ==\n");
+    fprintf(f, "Executed from program image (%u instructions), no trace "
+               "available\n", image->header->instructionCount);
+    fprintf(f, "== CODE EXECUTION ==\n");
+    if (state->exceeded)
+    {
+        // Reported like a stop of the interpreter (see runCode)
+        char message[200];
+        compilation->budgetExceeded = state->exceeded;
+        compilation->budgetLine = getImageSourceLine(image,
+                                                     state->exceededAt);
+        describeBudgetStop(state->exceeded, compilation->budgetLine, message);
+        fprintf(f, "Execution stopped: %s\n", message);
+        fprintf(stderr, "Execution stopped: %s\n", message);
+    }
+    fclose(f);
+
+    printVariableTable();
+
+    printf("\nPROGRAM RESULT = %s\n", compilation->programResult);
+}
+
+/**
+ * This adds all variables written by an execution to the variable table (in
+ * the order of their first write) and stores the program result in
+ * programResult.
+ * @param state The finished execution state.
+ */
+void storeImageResult(imageState* state)
+{
+    int count = state->image->header->symbolCount;
+    int* order = (int*)calloc(state->counter + 1, sizeof(int));
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        if (state->sequence[i] > 0)
+        {
+            order[state->sequence[i] - 1] = i;
+        }
+    }
+    for (i = 0; i < state->counter; i++)
+    {
+        symbolTableEntry* variable = &state->image->symbols[order[i]];
+        variableTableEntry* entry = addEntryToVariableTable(variable);
+        if (variable->type == REAL)
+        {
+            entry->value.floatValue = state->values[order[i]].floatValue;
+        }
+        else
+        {
+            entry->value.intValue = state->values[order[i]].intValue;
+        }
+    }
+    free(order);
+
+    formatImageResult(state, compilation->programResult);
+}
+
+/**
+ * This converts the program result of a finished execution into a string
+ * (see programResult).
+ * @param state  The finished execution state.
+ * @param result Receives the result (empty if there is no result).
+ */
+void formatImageResult(imageState* state, char* result)
+{
+    // The data type of the result is stored increased by one (0 = no result)
+    *result = 0;
+    if (state->resultType == INTEGER + 1)
+    {
+        sprintf(result, "%d", state->result.intValue);
+    }
+    else if (state->resultType == REAL + 1)
+    {
+        snprintf(result, 200, "%.2f", state->result.floatValue);
+    }
+    else if (state->resultType == BOOLEAN + 1)
+    {
+        sprintf(result, "%s", getBooleanValue(state->result.intValue));
+    }
+}
+
+/**
+ * Determines the inputs of a program image (see IMG_INPUT).
+ * @param image    The program image.
+ * @param symbols  Receives the symbol index of every input (indexed by input
+ *                 number, at least <code>symbolCount</code> entries).
+ * @param defaults Receives the default value of every input (at least
+ *                 <code>symbolCount</code> entries).
+ * @return The number of inputs.
+ */
+int getImageInputs(programImage* image, int* symbols, imageValue* defaults)
+{
+    int count = 0;
+    unsigned int i;
+    for (i = 0; i < image->header->instructionCount; i++)
+    {
+        imageInstruction* instruction = &image->instructions[i];
+        if (instruction->op == IMG_INPUT)
+        {
+            symbols[instruction->operand2] = instruction->target;
+            defaults[instruction->operand2] =
+                image->constants[instruction->operand1];
+            if (instruction->operand2 >= count)
+            {
+                count = instruction->operand2 + 1;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * Determines the source code line of an instruction by the source line table.
+ * @param image       The program image.
+ * @param instruction Index of the instruction.
+ * @return The source code line (<code>0</code> if unknown).
+ */
+int getImageSourceLine(programImage* image, unsigned int instruction)
+{
+    // Binary search for the last entry starting at or before the instruction
+    int low = 0;
+    int high = (int)image->header->lineCount - 1;
+    int line = 0;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        if (image->lines[middle].instruction <= instruction)
+        {
+            line = image->lines[middle].line;
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return line;
+}
@@ -0,0 +1,761 @@
+/**
+ * @file image.h
+ * @brief This defines all data structures and functions for the binary
+ *        program image: a compiled program which can be written to a file,
+ *        mapped into memory and executed without parsing the source code
+ *        again.
+ */
+
+#include "generator.h"
+#include "symboltable.h"
+#include "compiler.h"
+#include <stdio.h>
+
+#ifndef IMAGE_H_
+#define IMAGE_H_
+
+/**
+ * Magic number at the start of every program image (<code>"MDHI"</code>).
+ */
+#define IMAGE_MAGIC 0x4948444D
+
+/**
+ * Version of the program image format.<BR>
+ * This needs to be increased on every change of the format (including the
+ * values of imageOperation).
+ */
+#define IMAGE_VERSION 1
+
+/**
+ * Flag of imageHeader.flags: the intermediate code has been optimized.
+ */
+#define IMAGE_OPTIMIZED 1
+
+/**
+ * Type definition to simplify usage of the enumeration.
+ */
+typedef enum e_imageOperation imageOperation;
+
+/**
+ * This enumeration contains all instructions of a program image.<BR>
+ * Nested structures of the intermediate code are translated into jumps. The
+ * values are part of the file format.
+ */
+enum e_imageOperation
+{
+    /**
+     * Numeric comparison: TARGET := OP1 == OP2
+     */
+    IMG_EQUAL = 1,
+
+    /**
+     * Numeric comparison: TARGET := OP1 != OP2
+     */
+    IMG_NOT_EQUAL,
+
+    /**
+     * Numeric comparison: TARGET := OP1 <= OP2
+     */
+    IMG_LESS_OR_EQUAL,
+
+    /**
+     * Numeric comparison: TARGET := OP1 >= OP2
+     */
+    IMG_GREATER_OR_EQUAL,
+
+    /**
+     * Numeric comparison: TARGET := OP1 > OP2
+     */
+    IMG_GREATER,
+
+    /**
+     * Numeric comparison: TARGET := OP1 < OP2
+     */
+    IMG_LESS,
+
+    /**
+     * Logical operation: TARGET := OP1 AND OP2
+     */
+    IMG_AND,
+
+    /**
+     * Logical operation: TARGET := OP1 OR OP2
+     */
+    IMG_OR,
+
+    /**
+     * Logical operation: TARGET := NOT OP1
+     */
+    IMG_NOT,
+
+    /**
+     * Mathematical operation: TARGET := OP1 + OP2
+     */
+    IMG_PLUS,
+
+    /**
+     * Mathematical operation: TARGET := OP1 - OP2
+     */
+    IMG_MINUS,
+
+    /**
+     * Mathematical operation: TARGET := OP1 * OP2
+     */
+    IMG_MULTIPLY,
+
+    /**
+     * Mathematical operation: TARGET := OP1 / OP2
+     */
+    IMG_DIVIDE,
+
+    /**
+     * Mathematical operation: TARGET := OP1 % OP2
+     */
+    IMG_MODULO,
+
+    /**
+     * Mathematical operation: TARGET := TARGET + 1
+     */
+    IMG_INCREMENT,
+
+    /**
+     * Mathematical operation: TARGET := TARGET - 1
+     */
+    IMG_DECREMENT,
+
+    /**
+     * Assignment: TARGET := OP1
+     */
+    IMG_ASSIGN,
+
+    /**
+     * Constant: TARGET := constant pool entry OP1
+     */
+    IMG_CONSTANT,
+
+    /**
+     * Program result: RETURN OP1
+     */
+    IMG_EXIT,
+
+    /**
+     * Jump to instruction JUMP.
+     */
+    IMG_JUMP,
+
+    /**
+     * Jump to instruction JUMP if the condition is not fulfilled.
+     */
+    IMG_BRANCH_FALSE,
+
+    /**
+     * Jump to instruction JUMP if the condition is fulfilled.
+     */
+    IMG_BRANCH_TRUE,
+
+    /**
+     * Input: TARGET := value of input OP2 (default: constant pool entry OP1)
+     */
+    IMG_INPUT
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_imageHeader imageHeader;
+
+/**
+ * This structure defines the header at the start of a program image.<BR>
+ * All sections are referenced by their offset from the start of the image, so
+ * the image can be mapped at any address. Values are stored in the byte order
+ * of the compiling machine (images of another byte order are rejected as the
+ * magic number does not match).
+ */
+struct s_imageHeader
+{
+    /**
+     * Magic number (IMAGE_MAGIC).
+     */
+    unsigned int magic;
+
+    /**
+     * Version of the format (IMAGE_VERSION).
+     */
+    unsigned int version;
+
+    /**
+     * Size of the complete image in bytes.
+     */
+    unsigned int size;
+
+    /**
+     * Flags (e.g. IMAGE_OPTIMIZED).
+     */
+    unsigned int flags;
+
+    /**
+     * Offset and number of the instructions (imageInstruction).
+     */
+    unsigned int instructionOffset;
+    unsigned int instructionCount;
+
+    /**
+     * Offset and number of the constants (8 bytes each, interpreted by the
+     * data type of the target variable).
+     */
+    unsigned int constantOffset;
+    unsigned int constantCount;
+
+    /**
+     * Offset and number of the symbols (imageSymbol).
+     */
+    unsigned int symbolOffset;
+    unsigned int symbolCount;
+
+    /**
+     * Offset and number of the source line table entries (imageLine).
+     */
+    unsigned int lineOffset;
+    unsigned int lineCount;
+
+    /**
+     * Offset and size in bytes of the string table (null-terminated names).
+     */
+    unsigned int stringOffset;
+    unsigned int stringSize;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_imageInstruction imageInstruction;
+
+/**
+ * This structure defines a single instruction of a program image.<BR>
+ * Variables are referenced by their symbol index, <code>-1</code> marks an
+ * unused operand.
+ */
+struct s_imageInstruction
+{
+    /**
+     * The operation (imageOperation).
+     */
+    unsigned char op;
+
+    /**
+     * Numeric comparison of a fused branch (IMG_EQUAL ... IMG_LESS).<BR>
+     * <code>0</code> if the branch tests the BOOLEAN variable OP1.
+     */
+    unsigned char compare;
+
+    /**
+     * Fused increment/decrement of TARGET in front of a branch (IMG_INCREMENT,
+     * IMG_DECREMENT or <code>0</code>).
+     */
+    unsigned char step;
+
+    /**
+     * Reserved (<code>0</code>).
+     */
+    unsigned char reserved;
+
+    /**
+     * Target variable.
+     */
+    int target;
+
+    /**
+     * 1st operand (variable or constant pool entry).
+     */
+    int operand1;
+
+    /**
+     * 2nd operand.
+     */
+    int operand2;
+
+    /**
+     * Jump target (instruction index) of jumps and branches.
+     */
+    int jump;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_imageSymbol imageSymbol;
+
+/**
+ * This structure defines a variable of a program image.
+ */
+struct s_imageSymbol
+{
+    /**
+     * Offset of the name within the string table.
+     */
+    unsigned int name;
+
+    /**
+     * Data type of the variable (dataType).
+     */
+    unsigned int type;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_imageLine imageLine;
+
+/**
+ * This structure defines an entry of the source line table.<BR>
+ * The entry applies to all instructions up to the following entry.
+ */
+struct s_imageLine
+{
+    /**
+     * Index of the first instruction.
+     */
+    unsigned int instruction;
+
+    /**
+     * Source code line of the instruction.
+     */
+    unsigned int line;
+};
+
+/**
+ * Type definition to simplify usage of the union.
+ */
+typedef union u_imageValue imageValue;
+
+/**
+ * This union keeps the value of a variable during the execution of a program
+ * image.
+ */
+union u_imageValue
+{
+    /**
+     * Integer (and boolean) value.
+     */
+    int intValue;
+
+    /**
+     * Float value.
+     */
+    double floatValue;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_programImage programImage;
+
+/**
+ * This structure defines a program image which has been loaded into memory.
+ */
+struct s_programImage
+{
+    /**
+     * Start of the image in memory.
+     */
+    void* memory;
+
+    /**
+     * <code>1</code> if memory is a mapping of the image file,
+     * <code>0</code> if it has been allocated.
+     */
+    int mapped;
+
+    /**
+     * Header of the image.
+     */
+    imageHeader* header;
+
+    /**
+     * Instructions of the image.
+     */
+    imageInstruction* instructions;
+
+    /**
+     * Constant pool of the image.
+     */
+    imageValue* constants;
+
+    /**
+     * Source line table of the image.
+     */
+    imageLine* lines;
+
+    /**
+     * Symbol table entries created for the variables of the image (used for
+     * the variable table).
+     */
+    symbolTableEntry* symbols;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_imageState imageState;
+
+/**
+ * This structure defines the execution state of a program image.
+ */
+struct s_imageState
+{
+    /**
+     * The executed image.
+     */
+    programImage* image;
+
+    /**
+     * Values of all variables (indexed by symbol index, index
+     * <code>-1</code> is a scratch value for unused operands).
+     */
+    imageValue* values;
+
+    /**
+     * Sequence number of the first write of every variable (<code>0</code> if
+     * the variable has not been written).
+     */
+    int* sequence;
+
+    /**
+     * Number of written variables.
+     */
+    int counter;
+
+    /**
+     * Index of the next instruction to be executed.
+     */
+    unsigned int pc;
+
+    /**
+     * Data type of the program result increased by one (<code>0</code> if
+     * there is no result).
+     */
+    int resultType;
+
+    /**
+     * Value of the program result.
+     */
+    imageValue result;
+
+    /**
+     * Values of the inputs (indexed by input number, <code>null</code> to use
+     * the default values).
+     */
+    imageValue* inputs;
+
+    /**
+     * Number of executed instructions. The instructions are only counted at
+     * jumps and at the end of the program (see jumpProgramImage).
+     */
+    long executed;
+
+    /**
+     * Index of the first instruction executed since the last jump.
+     */
+    unsigned int segment;
+
+    /**
+     * Value of executed at which the next backward jump checks the end of the
+     * slice and the budget (see checkImageBudget).
+     */
+    long limit;
+
+    /**
+     * Value of executed at which executeProgramImageSlice returns at the
+     * next backward jump.
+     */
+    long sliceEnd;
+
+    /**
+     * Maximum number of executed instructions (<code>0</code> for no limit).
+     */
+    long budget;
+
+    /**
+     * Time (see getProfileTime) at which the execution is stopped
+     * (<code>0</code> for no time limit).
+     */
+    double deadline;
+
+    /**
+     * Reason for stopping the execution before the end of the program
+     * (BUDGET_INSTRUCTIONS or BUDGET_TIME, <code>0</code> if the execution
+     * has not been stopped).
+     */
+    int exceeded;
+
+    /**
+     * Index of the instruction at which the execution has been stopped.
+     */
+    unsigned int exceededAt;
+
+    /**
+     * Set to <code>1</code> to stop the execution (BUDGET_FAULT) instead of
+     * raising SIGFPE at an INTEGER division by zero or overflow.
+     */
+    int guarded;
+};
+
+/**
+ * This writes the current intermediate code as program image into a file.
+ * @param fileName Name of the file to be created.
+ * @return <code>1</code> if the image has been written.<BR>
+ *         <code>0</code> if the file cannot be written.
+ */
+int writeProgramImage(char* fileName);
+
+/**
+ * This creates a program image of the current intermediate code in memory.
+ * @return The image (to be freed by freeProgramImage).
+ */
+programImage* createProgramImage();
+
+/**
+ * This appends the instructions for a code list (including nested code
+ * lists) to the program image buffer.
+ * @param list The first entry of the code list.
+ */
+void appendImageList(codeEntry* list);
+
+/**
+ * This appends a single instruction to the program image buffer.
+ * @param entry    The code entry the instruction belongs to (source line).
+ * @param op       The operation.
+ * @param target   The target variable (may be <code>null</code>).
+ * @param operand1 The 1st operand (may be <code>null</code>).
+ * @param operand2 The 2nd operand (may be <code>null</code>).
+ * @return Index of the new instruction.
+ */
+int appendImageInstruction(codeEntry* entry, imageOperation op,
+                           symbolTableEntry* target,
+                           symbolTableEntry* operand1,
+                           symbolTableEntry* operand2);
+
+/**
+ * This appends the instruction for the condition of an IF/WHILE/DO WHILE
+ * statement (including a fused increment/decrement) to the program image
+ * buffer. The jump target needs to be set afterwards.
+ * @param entry The IF/WHILE/DO WHILE code entry.
+ * @param op    IMG_BRANCH_FALSE or IMG_BRANCH_TRUE.
+ * @return Index of the new instruction.
+ */
+int appendImageBranch(codeEntry* entry, imageOperation op);
+
+/**
+ * This appends a value to the constant pool of the program image buffer.
+ * @param value The constant value.
+ * @return Index of the constant.
+ */
+int appendImageConstant(imageValue value);
+
+/**
+ * Determines the program image operation of a comparison or mathematical
+ * operation of the intermediate code.
+ * @param op The operation of the intermediate code.
+ * @return The program image operation.<BR>
+ *         <code>0</code> if there is no corresponding operation.
+ */
+imageOperation getImageOperation(operation op);
+
+/**
+ * This maps a program image file into memory and verifies it.
+ * @param fileName Name of the image file.
+ * @return The loaded image.<BR>
+ *         <code>null</code> if the file cannot be read or is no valid image.
+ */
+programImage* loadProgramImage(char* fileName);
+
+/**
+ * This creates the data structures for a verified program image in memory.
+ * @param memory Start of the image.
+ * @param mapped <code>1</code> if the memory is a mapping of the image file,
+ *               <code>0</code> if it has been allocated by
+ *               <code>malloc</code>.
+ * @return The image (to be freed by freeProgramImage).
+ */
+programImage* openProgramImage(void* memory, int mapped);
+
+/**
+ * This verifies the structure of a program image before it is executed: all
+ * sections need to be located within the image, all instructions need to be
+ * known and to reference existing variables, constants and instructions, and
+ * the data types of the operands need to fit the operation.
+ * @param memory Start of the image.
+ * @param size   Size of the image in bytes.
+ * @return <code>1</code> if the image is valid.<BR>
+ *         <code>0</code> otherwise (the reason is printed to STDERR).
+ */
+int verifyProgramImage(void* memory, unsigned long size);
+
+/**
+ * This verifies a single instruction of a program image.
+ * @param header      Header of the image.
+ * @param symbols     Symbols of the image.
+ * @param instruction The instruction.
+ * @return <code>1</code> if the instruction is valid.<BR>
+ *         <code>0</code> otherwise.
+ */
+int verifyImageInstruction(imageHeader* header, imageSymbol* symbols,
+                           imageInstruction* instruction);
+
+/**
+ * This unmaps or frees a program image and frees all data structures.
+ * @param image The image created by loadProgramImage or createProgramImage.
+ */
+void freeProgramImage(programImage* image);
+
+/**
+ * This creates the initial execution state of a program image (no variable
+ * written, execution starts with the first instruction).
+ * @param image The image to be executed.
+ * @return The new execution state.
+ */
+imageState* createImageState(programImage* image);
+
+/**
+ * This frees an execution state.
+ * @param state The execution state created by createImageState.
+ */
+void freeImageState(imageState* state);
+
+/**
+ * This resets an execution state, so that the program can be executed again.
+ * <BR>
+ * The values of the inputs are kept.
+ * @param state The execution state.
+ */
+void resetImageState(imageState* state);
+
+/**
+ * This records the first write of a variable (see imageState.sequence).
+ * @param state    The execution state.
+ * @param variable Symbol index of the written variable.
+ */
+void markImageVariable(imageState* state, int variable);
+
+/**
+ * This executes the instructions of a program image until the end of the
+ * program.
+ * @param state The execution state (updated).
+ */
+void executeProgramImage(imageState* state);
+
+/**
+ * This continues the execution of a program image for a limited number of
+ * instructions, so that several programs can share a thread.<BR>
+ * The limit is only checked at backward jumps, so a slice may execute up to
+ * the length of the program more instructions.
+ * @param state   The execution state (updated).
+ * @param quantum Number of instructions (<code>-1</code> for no limit).
+ * @return <code>1</code> if the program has finished or exceeded its budget
+ *         (see exceeded).<BR>
+ *         <code>0</code> if it needs to be continued.
+ */
+int executeProgramImageSlice(imageState* state, long quantum);
+
+/**
+ * This executes a jump of a program image and counts the instructions since
+ * the last jump.
+ * @param state       The execution state.
+ * @param instruction The jump or branch instruction.
+ * @return <code>1</code> if the jump leads backwards and the slice has ended
+ *         or the budget has been exceeded.<BR>
+ *         <code>0</code> otherwise.
+ */
+int jumpProgramImage(imageState* state, imageInstruction* instruction);
+
+/**
+ * This limits the execution of a program image.<BR>
+ * Like the slices, the limits are only checked at backward jumps.
+ * @param state        The execution state.
+ * @param instructions Maximum number of executed instructions
+ *                     (<code>0</code> for no limit).
+ * @param seconds      Maximum execution time starting now (<code>0</code>
+ *                     for no limit).
+ */
+void setImageBudget(imageState* state, long instructions, double seconds);
+
+/**
+ * This checks the end of the slice and the budget of an execution at a
+ * backward jump once executed has reached limit.
+ * @param state The execution state.
+ * @param jump  Index of the backward jump.
+ * @return <code>1</code> if the execution needs to return.<BR>
+ *         <code>0</code> otherwise.
+ */
+int checkImageBudget(imageState* state, unsigned int jump);
+
+/**
+ * This determines the value of executed at which the next backward jump
+ * checks the end of the slice and the budget (see limit).
+ * @param state The execution state.
+ */
+void updateImageLimit(imageState* state);
+
+/**
+ * This evaluates the condition of a branch instruction including a fused
+ * increment/decrement.
+ * @param state       The execution state.
+ * @param instruction The branch instruction.
+ * @return <code>1</code> if the condition is fulfilled.<BR>
+ *         <code>0</code> otherwise.
+ */
+int evaluateImageCondition(imageState* state, imageInstruction* instruction);
+
+/**
+ * This executes a program image like the interpreter: the variable table at
+ * program exit is written to file <code>4_variabletable</code> and the return
+ * value of the program is printed on screen. The file
+ * <code>3_execution</code> contains no trace.
+ * @param image The image to be executed.
+ */
+void runProgramImage(programImage* image);
+
+/**
+ * This writes the output of a finished execution like the interpreter: the
+ * variable table, the program result and <code>3_execution</code> (without
+ * trace, but with the reason if the execution has been stopped).
+ * @param state The finished execution state.
+ */
+void finishProgramImage(imageState* state);
+
+/**
+ * This adds all variables written by an execution to the variable table (in
+ * the order of their first write) and stores the program result in
+ * programResult.
+ * @param state The finished execution state.
+ */
+void storeImageResult(imageState* state);
+
+/**
+ * This converts the program result of a finished execution into a string
+ * (see programResult).
+ * @param state  The finished execution state.
+ * @param result Receives the result (empty if there is no result).
+ */
+void formatImageResult(imageState* state, char* result);
+
+/**
+ * Determines the inputs of a program image (see IMG_INPUT).
+ * @param image    The program image.
+ * @param symbols  Receives the symbol index of every input (indexed by input
+ *                 number, at least <code>symbolCount</code> entries).
+ * @param defaults Receives the default value of every input (at least
+ *                 <code>symbolCount</code> entries).
+ * @return The number of inputs.
+ */
+int getImageInputs(programImage* image, int* symbols, imageValue* defaults);
+
+/**
+ * Determines the source code line of an instruction by the source line table.
+ * @param image       The program image.
+ * @param instruction Index of the instruction.
+ * @return The source code line (<code>0</code> if unknown).
+ */
+int getImageSourceLine(programImage* image, unsigned int instruction);
+
+#endif /*IMAGE_H_*/
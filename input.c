@@ -0,0 +1,732 @@
+/**
+ * @file input.c
+ * @brief This contains all function implementations for the inputs of a
+ *        program and for parameter sweeps.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "input.h"
+#include "compiler.h"
+#include "generator.h"
+#include "profiler.h"
+#include "context.h"
+#include "interpreter.h"
+
+/**
+ * This adds a value for an input to the compilation context of the current
+ * thread. The value is used when the input is declared.
+ * @param assignment The assignment <code>NAME=VALUE</code>.
+ * @return <code>1</code> if the assignment has been added.<BR>
+ *         <code>0</code> if it has no <code>=</code>.
+ */
+int addInputAssignment(char* assignment)
+{
+    char* separator = strchr(assignment, '=');
+    if ((separator == 0) || (separator == assignment))
+    {
+        return 0;
+    }
+
+    // The name and the value share one allocation
+    inputAssignment* entry = (inputAssignment*)
+                             calloc(1, sizeof(inputAssignment));
+    entry->name = strdup(assignment);
+    entry->name[separator - assignment] = 0;
+    entry->value = entry->name + (separator - assignment) + 1;
+
+    inputAssignment** last = &compilation->inputAssignments;
+    while (*last != 0)
+    {
+        last = &(*last)->next;
+    }
+    *last = entry;
+    return 1;
+}
+
+/**
+ * This adds the values of the first row of a CSV file as input values (see
+ * addInputAssignment).
+ * @param fileName Name of the CSV file.
+ * @return <code>1</code> if the values have been added, <code>0</code>
+ *         otherwise (the reason is printed to STDERR).
+ */
+int addInputFile(char* fileName)
+{
+    sweepTable* table = readSweepTable(fileName);
+    if (table == 0)
+    {
+        return 0;
+    }
+    if (table->rows == 0)
+    {
+        fprintf(stderr, "%s contains no input values\n", fileName);
+        freeSweepTable(table);
+        return 0;
+    }
+
+    int i;
+    for (i = 0; i < table->columns; i++)
+    {
+        char* assignment = (char*)malloc(strlen(table->names[i])
+                                         + strlen(table->values[i]) + 2);
+        sprintf(assignment, "%s=%s", table->names[i], table->values[i]);
+        addInputAssignment(assignment);
+        free(assignment);
+    }
+    freeSweepTable(table);
+    return 1;
+}
+
+/**
+ * This declares an input. The value given by addInputAssignment or the
+ * default value is assigned to the new variable.
+ * @param name         Name of the input (taken over like by
+ *                     addEntryToSymbolTable).
+ * @param type         Data type of the input.
+ * @param defaultType  Data type of the default value.
+ * @param defaultValue The default value.
+ * @param sourceLine   Line number in the input file (for error messages).
+ * @return The new variable (<code>null</code> on errors).
+ */
+symbolTableEntry* declareInput(char* name, dataType type, dataType defaultType,
+                               double defaultValue, int sourceLine)
+{
+    if (getEntryFromSymbolTable(name))
+    {
+        reportError("%s already exists. Line: %d\n", name, sourceLine);
+        free(name);
+        return 0;
+    }
+    if (hasTypeConflict(type, defaultType))
+    {
+        reportError("%s has type conflict. Line: %d\n", name, sourceLine);
+        free(name);
+        return 0;
+    }
+
+    imageValue value;
+    memset(&value, 0, sizeof(value));
+    if (type == REAL)
+    {
+        value.floatValue = defaultValue;
+    }
+    else
+    {
+        value.intValue = (int)defaultValue;
+    }
+
+    inputAssignment* assignment;
+    for (assignment = compilation->inputAssignments; assignment != 0;
+         assignment = assignment->next)
+    {
+        if (strcmp(assignment->name, name) == 0)
+        {
+            assignment->used = 1;
+            if (!parseInputValue(assignment->value, type, &value))
+            {
+                reportError("Invalid value for input %s: %s. Line: %d\n",
+                            name, assignment->value, sourceLine);
+                free(name);
+                return 0;
+            }
+        }
+    }
+
+    symbolTableEntry* symbol = addEntryToSymbolTable(name, type, sourceLine);
+    inputVariable* input = (inputVariable*)calloc(1, sizeof(inputVariable));
+    input->symbol = symbol;
+    inputVariable** last = &compilation->inputVariables;
+    while (*last != 0)
+    {
+        last = &(*last)->next;
+    }
+    *last = input;
+
+    // The value is a constant for the interpreter and the backends, the
+    // program image executes it as IMG_INPUT
+    int created;
+    switch (type)
+    {
+        case INTEGER:
+            created = createCodeIntConst(symbol, value.intValue, sourceLine);
+            break;
+        case REAL:
+            created = createCodeFloatConst(symbol, value.floatValue,
+                                           sourceLine);
+            break;
+        default:
+            created = createCodeBoolConst(symbol, value.intValue, sourceLine);
+            break;
+    }
+    return created ? symbol : 0;
+}
+
+/**
+ * Determines the number of an input (its position within the declarations).
+ * @param symbol The variable.
+ * @return The number (<code>-1</code> if the variable is no input).
+ */
+int getInputNumber(symbolTableEntry* symbol)
+{
+    int number = 0;
+    inputVariable* input;
+    for (input = compilation->inputVariables; input != 0; input = input->next)
+    {
+        if (input->symbol == symbol)
+        {
+            return number;
+        }
+        number++;
+    }
+    return -1;
+}
+
+/**
+ * This checks that every value given by addInputAssignment belongs to a
+ * declared input.
+ * @return <code>1</code> if all values have been used, <code>0</code>
+ *         otherwise (the unknown inputs are reported as errors).
+ */
+int checkInputAssignments()
+{
+    int result = 1;
+    inputAssignment* assignment;
+    for (assignment = compilation->inputAssignments; assignment != 0;
+         assignment = assignment->next)
+    {
+        if (!assignment->used)
+        {
+            reportError("%s is not declared as input\n", assignment->name);
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/**
+ * This converts the text of an input value.
+ * @param text  The text (integer, float, <code>true</code> or
+ *              <code>false</code>).
+ * @param type  Data type of the input.
+ * @param value Receives the value.
+ * @return <code>1</code> if the text is a valid value, <code>0</code>
+ *         otherwise.
+ */
+int parseInputValue(char* text, dataType type, imageValue* value)
+{
+    char* end;
+    switch (type)
+    {
+        case INTEGER:
+            value->intValue = (int)strtol(text, &end, 10);
+            return (end != text) && (*end == 0);
+        case REAL:
+            // Like literals, inputs are substituted as single precision
+            // constants (see createCodeFloatConst)
+            value->floatValue = (float)strtod(text, &end);
+            return (end != text) && (*end == 0);
+        default:
+            if ((strcmp(text, "true") == 0) || (strcmp(text, "1") == 0))
+            {
+                value->intValue = 1;
+                return 1;
+            }
+            if ((strcmp(text, "false") == 0) || (strcmp(text, "0") == 0))
+            {
+                value->intValue = 0;
+                return 1;
+            }
+            return 0;
+    }
+}
+
+/**
+ * This reads a CSV file with input values. Empty lines are skipped and the
+ * values are trimmed.
+ * @param fileName Name of the file.
+ * @return The table (<code>null</code> if the file cannot be read or a line
+ *         has the wrong number of values; the reason is printed to STDERR).
+ */
+sweepTable* readSweepTable(char* fileName)
+{
+    FILE *input = fopen(fileName, "r");
+    if (input == 0)
+    {
+        fprintf(stderr, "Cannot read %s\n", fileName);
+        return 0;
+    }
+    char* content = readInput(input);
+    fclose(input);
+
+    sweepTable* table = (sweepTable*)calloc(1, sizeof(sweepTable));
+    int capacity = 0;
+    int lineNumber = 0;
+    char* line = content;
+    while (*line != 0)
+    {
+        char* next = line + strcspn(line, "\n");
+        if (*next != 0)
+        {
+            *next++ = 0;
+        }
+        lineNumber++;
+
+        // Split and trim the values in place
+        char* fields[1000];
+        int count = 0;
+        char* field = line;
+        while (count < 1000)
+        {
+            char* separator = field + strcspn(field, ",");
+            int last = (*separator == 0);
+            *separator = 0;
+            while (isspace((unsigned char)*field))
+            {
+                field++;
+            }
+            char* end = field + strlen(field);
+            while ((end > field) && isspace((unsigned char)end[-1]))
+            {
+                *--end = 0;
+            }
+            fields[count++] = field;
+            if (last)
+            {
+                break;
+            }
+            field = separator + 1;
+        }
+
+        if ((count == 1) && (*fields[0] == 0))
+        {
+            // Empty line
+        }
+        else if (table->names == 0)
+        {
+            table->columns = count;
+            table->names = (char**)malloc(sizeof(char*) * count);
+            int i;
+            for (i = 0; i < count; i++)
+            {
+                table->names[i] = strdup(fields[i]);
+            }
+        }
+        else if (count != table->columns)
+        {
+            fprintf(stderr, "%s, line %d: %d values expected, got %d\n",
+                    fileName, lineNumber, table->columns, count);
+            free(content);
+            freeSweepTable(table);
+            return 0;
+        }
+        else
+        {
+            if ((table->rows + 1) * count > capacity)
+            {
+                capacity = (capacity + count) * 2;
+                table->values = (char**)realloc(table->values,
+                                                sizeof(char*) * capacity);
+            }
+            int i;
+            for (i = 0; i < count; i++)
+            {
+                table->values[table->rows * count + i] = strdup(fields[i]);
+            }
+            table->rows++;
+        }
+        line = next;
+    }
+    free(content);
+
+    if (table->names == 0)
+    {
+        fprintf(stderr, "%s contains no input names\n", fileName);
+        freeSweepTable(table);
+        return 0;
+    }
+    return table;
+}
+
+/**
+ * This frees a table read by readSweepTable.
+ * @param table The table.
+ */
+void freeSweepTable(sweepTable* table)
+{
+    int i;
+    for (i = 0; i < table->columns; i++)
+    {
+        free(table->names[i]);
+    }
+    for (i = 0; i < table->rows * table->columns; i++)
+    {
+        free(table->values[i]);
+    }
+    free(table->names);
+    free(table->values);
+    free(table);
+}
+
+/**
+ * This executes the intermediate code of the current compilation context for
+ * every row of a CSV file by a pool of threads and writes the inputs and the
+ * program result of every row (in the order of the file) into the file
+ * <code>7_sweep.csv</code>. The throughput is printed to STDOUT.<BR>
+ * The program is compiled into a program image once. Every thread executes
+ * it with its own variable values, several rows at the same time in SIMD
+ * lanes. A row whose execution faults (INTEGER division by zero) gets the
+ * reason instead of a result.
+ * @param fileName Name of the CSV file.
+ * @param threads  Number of threads (<code>0</code> uses one thread per
+ *                 processor).
+ * @param lanes    Number of rows executed at the same time by a thread
+ *                 (between <code>1</code> and IMAGE_LANES).
+ * @return <code>0</code> on success, <code>1</code> otherwise.
+ */
+int runSweep(char* fileName, int threads, int lanes)
+{
+    sweepTable* table = readSweepTable(fileName);
+    if (table == 0)
+    {
+        return 1;
+    }
+
+    sweep run;
+    memset(&run, 0, sizeof(run));
+    run.image = createProgramImage();
+    run.table = table;
+    run.lanes = lanes;
+    int symbolCount = run.image->header->symbolCount;
+    int* symbols = (int*)malloc(sizeof(int) * (symbolCount + 1));
+    run.defaults = (imageValue*)calloc(symbolCount + 1, sizeof(imageValue));
+    int i;
+    for (i = 0; i <= symbolCount; i++)
+    {
+        symbols[i] = -1;
+    }
+    run.inputCount = getImageInputs(run.image, symbols, run.defaults);
+
+    // Every column needs to be an input, so the values can be converted now
+    int result = 0;
+    run.columns = (int*)malloc(sizeof(int) * table->columns);
+    run.values = (imageValue*)calloc(table->rows * table->columns + 1,
+                                     sizeof(imageValue));
+    int column;
+    for (column = 0; column < table->columns; column++)
+    {
+        run.columns[column] = -1;
+        for (i = 0; i < run.inputCount; i++)
+        {
+            if ((symbols[i] >= 0) &&
+                (strcmp(run.image->symbols[symbols[i]].name,
+                        table->names[column]) == 0))
+            {
+                run.columns[column] = i;
+            }
+        }
+        if (run.columns[column] < 0)
+        {
+            fprintf(stderr, "%s is not declared as input\n",
+                    table->names[column]);
+            result = 1;
+            continue;
+        }
+
+        dataType type = run.image->symbols[symbols[run.columns[column]]].type;
+        int row;
+        for (row = 0; row < table->rows; row++)
+        {
+            int index = row * table->columns + column;
+            if (!parseInputValue(table->values[index], type,
+                                 &run.values[index]))
+            {
+                fprintf(stderr, "%s, row %d: invalid value for input %s: %s\n",
+                        fileName, row + 1, table->names[column],
+                        table->values[index]);
+                result = 1;
+            }
+        }
+    }
+
+    if (result == 0)
+    {
+        if (threads <= 0)
+        {
+#ifndef _WIN32
+            threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+            if (threads <= 0)
+            {
+                threads = 4;
+            }
+        }
+        if (threads > table->rows)
+        {
+            threads = (table->rows > 0) ? table->rows : 1;
+        }
+
+        // Every thread starts with an equal share of the rows
+        run.threads = threads;
+        run.results = (char(*)[200])calloc(table->rows + 1, 200);
+        run.workers = (sweepWorker*)calloc(threads, sizeof(sweepWorker));
+        for (i = 0; i < threads; i++)
+        {
+            run.workers[i].owner = &run;
+            run.workers[i].next = (int)((long)table->rows * i / threads);
+            run.workers[i].end = (int)((long)table->rows * (i + 1) / threads);
+            pthread_mutex_init(&run.workers[i].lock, 0);
+        }
+
+        double start = getProfileTime();
+        pthread_t* handles = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+        int started = 0;
+        for (i = 0; i < threads; i++)
+        {
+            if (pthread_create(&handles[started], 0, runSweepWorker,
+                               &run.workers[i]) == 0)
+            {
+                started++;
+            }
+        }
+        // Without any thread the rows are stolen by the calling thread
+        if (started == 0)
+        {
+            runSweepWorker(&run.workers[0]);
+        }
+        for (i = 0; i < started; i++)
+        {
+            pthread_join(handles[i], 0);
+        }
+        double elapsed = getProfileTime() - start;
+
+        FILE *f = fopen("7_sweep.csv", "w");
+        for (column = 0; column < table->columns; column++)
+        {
+            fprintf(f, "%s,", table->names[column]);
+        }
+        fprintf(f, "result\n");
+        int row;
+        for (row = 0; row < table->rows; row++)
+        {
+            for (column = 0; column < table->columns; column++)
+            {
+                fprintf(f, "%s,", table->values[row * table->columns
+                                                + column]);
+            }
+            fprintf(f, "%s\n", run.results[row]);
+        }
+        fclose(f);
+
+        int stolen = 0;
+        long dispatches = 0;
+        long laneInstructions = 0;
+        for (i = 0; i < threads; i++)
+        {
+            stolen += run.workers[i].stolen;
+            dispatches += run.workers[i].dispatches;
+            laneInstructions += run.workers[i].laneInstructions;
+            pthread_mutex_destroy(&run.workers[i].lock);
+        }
+        printf("== SWEEP ==\n");
+        printf("Rows:       %d (%d inputs, %d columns)\n", table->rows,
+               run.inputCount, table->columns);
+        printf("Threads:    %d (%d rows stolen)\n", (started > 0) ? started : 1,
+               stolen);
+        if (dispatches > 0)
+        {
+            printf("Lanes:      %d (%s, %.1f%% utilization)\n", lanes,
+                   getLaneInstructionSet(),
+                   100.0 * laneInstructions / ((double)dispatches * lanes));
+        }
+        printf("Time:       %.3f ms\n", elapsed * 1000);
+        if (elapsed > 0)
+        {
+            printf("Throughput: %.1f rows/s\n", table->rows / elapsed);
+        }
+        printf("== SWEEP ==\n");
+
+        free(handles);
+        free(run.workers);
+        free(run.results);
+    }
+
+    free(symbols);
+    free(run.defaults);
+    free(run.columns);
+    free(run.values);
+    freeProgramImage(run.image);
+    freeSweepTable(table);
+    return result;
+}
+
+/**
+ * This is the main function of a thread of a sweep: rows are taken from the
+ * own range or stolen from other threads until all rows have been executed.
+ * @param worker The sweepWorker.
+ * @return <code>null</code>.
+ */
+void* runSweepWorker(void* worker)
+{
+    sweepWorker* self = (sweepWorker*)worker;
+    sweep* run = self->owner;
+    sweepTable* table = run->table;
+
+    // The variable values of the thread are reused for every row. The
+    // inputs of a lane are IMAGE_LANES entries apart.
+    imageState* state = 0;
+    laneState* lanes = 0;
+    int stride = 1;
+    imageValue* inputs = (imageValue*)malloc(sizeof(imageValue) * IMAGE_LANES
+                                             * (run->inputCount + 1));
+    if (run->lanes > 1)
+    {
+        lanes = createLaneState(run->image);
+        lanes->inputs = inputs;
+        stride = IMAGE_LANES;
+    }
+    else
+    {
+        state = createImageState(run->image);
+        state->inputs = inputs;
+        state->guarded = 1;
+    }
+
+    int first;
+    int count;
+    while ((count = takeSweepRows(self, run->lanes, &first)) > 0)
+    {
+        int lane;
+        for (lane = 0; lane < count; lane++)
+        {
+            int row = first + lane;
+            int i;
+            for (i = 0; i < run->inputCount; i++)
+            {
+                inputs[i * stride + lane] = run->defaults[i];
+            }
+            int column;
+            for (column = 0; column < table->columns; column++)
+            {
+                inputs[run->columns[column] * stride + lane] =
+                    run->values[row * table->columns + column];
+            }
+        }
+
+        if (lanes != 0)
+        {
+            resetLaneState(lanes, count);
+            executeImageLanes(lanes);
+            for (lane = 0; lane < count; lane++)
+            {
+                formatLaneResult(lanes, lane, run->results[first + lane]);
+                if (lanes->exceeded[lane])
+                {
+                    describeBudgetStop(lanes->exceeded[lane],
+                                       getImageSourceLine(run->image,
+                                           lanes->exceededAt[lane]),
+                                       run->results[first + lane]);
+                }
+            }
+        }
+        else
+        {
+            resetImageState(state);
+            executeProgramImage(state);
+            formatImageResult(state, run->results[first]);
+            if (state->exceeded)
+            {
+                // A faulting row is reported instead of its result
+                describeBudgetStop(state->exceeded,
+                                   getImageSourceLine(run->image,
+                                                      state->exceededAt),
+                                   run->results[first]);
+            }
+        }
+    }
+
+    if (lanes != 0)
+    {
+        self->dispatches = lanes->dispatches;
+        self->laneInstructions = lanes->laneInstructions;
+        freeLaneState(lanes);
+    }
+    else
+    {
+        freeImageState(state);
+    }
+    free(inputs);
+    return 0;
+}
+
+/**
+ * This takes the next rows of a thread of a sweep. If the thread has no rows
+ * left, the back half of the rows of another thread is stolen.
+ * @param worker The thread.
+ * @param count  Maximum number of rows.
+ * @param first  Receives the first of the consecutive rows.
+ * @return The number of rows (<code>0</code> if all rows have been taken).
+ */
+int takeSweepRows(sweepWorker* worker, int count, int* first)
+{
+    sweep* run = worker->owner;
+    while (1)
+    {
+        pthread_mutex_lock(&worker->lock);
+        if (worker->next < worker->end)
+        {
+            if (count > worker->end - worker->next)
+            {
+                count = worker->end - worker->next;
+            }
+            *first = worker->next;
+            worker->next += count;
+            pthread_mutex_unlock(&worker->lock);
+            return count;
+        }
+        pthread_mutex_unlock(&worker->lock);
+
+        // Steal from the thread with the most remaining rows
+        sweepWorker* victim = 0;
+        int remaining = 0;
+        int i;
+        for (i = 0; i < run->threads; i++)
+        {
+            sweepWorker* other = &run->workers[i];
+            pthread_mutex_lock(&other->lock);
+            if (other->end - other->next > remaining)
+            {
+                remaining = other->end - other->next;
+                victim = other;
+            }
+            pthread_mutex_unlock(&other->lock);
+        }
+        if (victim == 0)
+        {
+            return 0;
+        }
+
+        // The victim might have continued meanwhile, so the range is taken
+        // under its lock
+        pthread_mutex_lock(&victim->lock);
+        int start = victim->next + (victim->end - victim->next) / 2;
+        int end = victim->end;
+        victim->end = start;
+        pthread_mutex_unlock(&victim->lock);
+        if (start >= end)
+        {
+            continue;
+        }
+
+        pthread_mutex_lock(&worker->lock);
+        worker->next = start;
+        worker->end = end;
+        worker->stolen += end - start;
+        pthread_mutex_unlock(&worker->lock);
+    }
+}
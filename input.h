@@ -0,0 +1,323 @@
+/**
+ * @file input.h
+ * @brief This defines all data structures and functions for the inputs of a
+ *        program and for parameter sweeps.<BR>
+ *        An input is declared by <code>input TYPE NAME = DEFAULT;</code> (the
+ *        default is optional and needs to be a literal). Its value can be set
+ *        on the command line (<code>-i NAME=VALUE</code>) or by a CSV file
+ *        whose first line contains the names of the inputs. A sweep compiles
+ *        the program once and executes it for every line of the CSV file.
+ */
+
+#include "symboltable.h"
+#include "image.h"
+#include "lanes.h"
+#include <pthread.h>
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_inputAssignment inputAssignment;
+
+/**
+ * This structure defines a value given for an input (see addInputAssignment).
+ */
+struct s_inputAssignment
+{
+    /**
+     * Name of the input.
+     */
+    char* name;
+
+    /**
+     * The value as text.
+     */
+    char* value;
+
+    /**
+     * Set to <code>1</code> when the input has been declared.
+     */
+    int used;
+
+    /**
+     * Pointer to the next assignment.
+     */
+    inputAssignment* next;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_inputVariable inputVariable;
+
+/**
+ * This structure defines a declared input (see declareInput).
+ */
+struct s_inputVariable
+{
+    /**
+     * The variable.
+     */
+    symbolTableEntry* symbol;
+
+    /**
+     * Pointer to the next input (in the order of the declaration).
+     */
+    inputVariable* next;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_sweepTable sweepTable;
+
+/**
+ * This structure defines the content of a CSV file with input values.
+ */
+struct s_sweepTable
+{
+    /**
+     * Names of the columns (first line of the file).
+     */
+    char** names;
+
+    /**
+     * Number of columns.
+     */
+    int columns;
+
+    /**
+     * Values of all rows (<code>rows * columns</code> entries, row by row).
+     */
+    char** values;
+
+    /**
+     * Number of rows (without the line of the names).
+     */
+    int rows;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_sweep sweep;
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_sweepWorker sweepWorker;
+
+/**
+ * This structure defines a thread of a sweep and the rows it still has to
+ * execute.<BR>
+ * The thread takes rows from the front of its range (one row per lane). A
+ * thread without rows steals the back half of the range of another thread.
+ */
+struct s_sweepWorker
+{
+    /**
+     * The sweep.
+     */
+    sweep* owner;
+
+    /**
+     * Next row to be executed.
+     */
+    int next;
+
+    /**
+     * Row after the last row to be executed.
+     */
+    int end;
+
+    /**
+     * Number of rows stolen from other threads.
+     */
+    int stolen;
+
+    /**
+     * Number of instructions dispatched by executeImageLanes.
+     */
+    long dispatches;
+
+    /**
+     * Number of instructions executed by all lanes of executeImageLanes.
+     */
+    long laneInstructions;
+
+    /**
+     * Lock for next and end.
+     */
+    pthread_mutex_t lock;
+};
+
+/**
+ * This structure defines the state shared by all threads of a sweep.
+ */
+struct s_sweep
+{
+    /**
+     * The compiled program.
+     */
+    programImage* image;
+
+    /**
+     * The input values.
+     */
+    sweepTable* table;
+
+    /**
+     * Number of inputs of the image.
+     */
+    int inputCount;
+
+    /**
+     * Default values of the inputs (indexed by input number).
+     */
+    imageValue* defaults;
+
+    /**
+     * Input number for every column of the table.
+     */
+    int* columns;
+
+    /**
+     * Parsed input values (same layout as sweepTable.values).
+     */
+    imageValue* values;
+
+    /**
+     * Program result for every row.
+     */
+    char (*results)[200];
+
+    /**
+     * All threads of the sweep.
+     */
+    sweepWorker* workers;
+
+    /**
+     * Number of threads.
+     */
+    int threads;
+
+    /**
+     * Number of rows executed at the same time by a thread (see
+     * executeImageLanes, <code>1</code> uses executeProgramImage).
+     */
+    int lanes;
+};
+
+/**
+ * This adds a value for an input to the compilation context of the current
+ * thread. The value is used when the input is declared.
+ * @param assignment The assignment <code>NAME=VALUE</code>.
+ * @return <code>1</code> if the assignment has been added.<BR>
+ *         <code>0</code> if it has no <code>=</code>.
+ */
+int addInputAssignment(char* assignment);
+
+/**
+ * This adds the values of the first row of a CSV file as input values (see
+ * addInputAssignment).
+ * @param fileName Name of the CSV file.
+ * @return <code>1</code> if the values have been added, <code>0</code>
+ *         otherwise (the reason is printed to STDERR).
+ */
+int addInputFile(char* fileName);
+
+/**
+ * This declares an input. The value given by addInputAssignment or the
+ * default value is assigned to the new variable.
+ * @param name         Name of the input (taken over like by
+ *                     addEntryToSymbolTable).
+ * @param type         Data type of the input.
+ * @param defaultType  Data type of the default value.
+ * @param defaultValue The default value.
+ * @param sourceLine   Line number in the input file (for error messages).
+ * @return The new variable (<code>null</code> on errors).
+ */
+symbolTableEntry* declareInput(char* name, dataType type, dataType defaultType,
+                               double defaultValue, int sourceLine);
+
+/**
+ * Determines the number of an input (its position within the declarations).
+ * @param symbol The variable.
+ * @return The number (<code>-1</code> if the variable is no input).
+ */
+int getInputNumber(symbolTableEntry* symbol);
+
+/**
+ * This checks that every value given by addInputAssignment belongs to a
+ * declared input.
+ * @return <code>1</code> if all values have been used, <code>0</code>
+ *         otherwise (the unknown inputs are reported as errors).
+ */
+int checkInputAssignments();
+
+/**
+ * This converts the text of an input value.
+ * @param text  The text (integer, float, <code>true</code> or
+ *              <code>false</code>).
+ * @param type  Data type of the input.
+ * @param value Receives the value.
+ * @return <code>1</code> if the text is a valid value, <code>0</code>
+ *         otherwise.
+ */
+int parseInputValue(char* text, dataType type, imageValue* value);
+
+/**
+ * This reads a CSV file with input values. Empty lines are skipped and the
+ * values are trimmed.
+ * @param fileName Name of the file.
+ * @return The table (<code>null</code> if the file cannot be read or a line
+ *         has the wrong number of values; the reason is printed to STDERR).
+ */
+sweepTable* readSweepTable(char* fileName);
+
+/**
+ * This frees a table read by readSweepTable.
+ * @param table The table.
+ */
+void freeSweepTable(sweepTable* table);
+
+/**
+ * This executes the intermediate code of the current compilation context for
+ * every row of a CSV file by a pool of threads and writes the inputs and the
+ * program result of every row (in the order of the file) into the file
+ * <code>7_sweep.csv</code>. The throughput is printed to STDOUT.<BR>
+ * The program is compiled into a program image once. Every thread executes
+ * it with its own variable values, several rows at the same time in SIMD
+ * lanes. A row whose execution faults (INTEGER division by zero) gets the
+ * reason instead of a result.
+ * @param fileName Name of the CSV file.
+ * @param threads  Number of threads (<code>0</code> uses one thread per
+ *                 processor).
+ * @param lanes    Number of rows executed at the same time by a thread
+ *                 (between <code>1</code> and IMAGE_LANES).
+ * @return <code>0</code> on success, <code>1</code> otherwise.
+ */
+int runSweep(char* fileName, int threads, int lanes);
+
+/**
+ * This is the main function of a thread of a sweep: rows are taken from the
+ * own range or stolen from other threads until all rows have been executed.
+ * @param worker The sweepWorker.
+ * @return <code>null</code>.
+ */
+void* runSweepWorker(void* worker);
+
+/**
+ * This takes the next rows of a thread of a sweep. If the thread has no rows
+ * left, the back half of the rows of another thread is stolen.
+ * @param worker The thread.
+ * @param count  Maximum number of rows.
+ * @param first  Receives the first of the consecutive rows.
+ * @return The number of rows (<code>0</code> if all rows have been taken).
+ */
+int takeSweepRows(sweepWorker* worker, int count, int* first);
+
+#endif /*INPUT_H_*/
@@ -8,37 +8,38 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
 #include "interpreter.h"
 #include "generator.h"
 #include "symboltable.h"
 #include "compiler.h"
+#include "profiler.h"
+#include "hotloop.h"
+#include "context.h"
 
 /**
- * Pointer to the first entry of the code list.<BR>
- * [defined in generator.c]
+ * Variable to enable/disable profiling mode.<BR>
+ * [defined in file compiler.c]
  */
-extern codeEntry* codeList;
+extern int profile;
 
 /**
- * Pointer to the first entry of the variable table.<BR>
- * This variable is automatically initialized when adding the first entry.
+ * Number of loop iterations after which a loop is executed as native code.<BR>
+ * [defined in file compiler.c]
  */
-variableTableEntry* variableTable = 0;
+extern long hotLoopThreshold;
 
 /**
- * Reference to the previous WHILE line marker.<BR>
- * Markers are required for WHILE loops as the condition part might have to be
- * recalculated for every loop in case any variable contained has been changed
- * within the loop body.
+ * Maximum number of instructions executed by a program.<BR>
+ * [defined in file compiler.c]
  */
-codeEntry* lastWhileMarker = 0;
+extern long instructionBudget;
 
 /**
- * This variable holds the value of the RETURN statement after program execution
- * has been completed.<BR>
- * The value is converted to a string based on its data type.
+ * Maximum execution time of a program in seconds.<BR>
+ * [defined in file compiler.c]
  */
-char programResult[200];
+extern double timeBudget;
 
 /**
  * This adds a new entry to the variable table.
@@ -63,17 +64,18 @@ variableTableEntry* addEntryToVariableTable(symbolTableEntry* variable)
     variableTableEntry* newVartabEntry =
         (variableTableEntry*) malloc(sizeof(variableTableEntry));
     newVartabEntry->variable = variable;
+    memset(&newVartabEntry->value, 0, sizeof(newVartabEntry->value));
     newVartabEntry->next = 0;
     
     // Assign as new symbol table for 1st entry
-    if (!variableTable)
+    if (!compilation->variableTable)
     {
-        variableTable = newVartabEntry;
+        compilation->variableTable = newVartabEntry;
     }
     // Add at the end otherwise
     else
     {
-        variableTableEntry* iterator = variableTable;
+        variableTableEntry* iterator = compilation->variableTable;
         while (iterator->next)
         {
             iterator = iterator->next;
@@ -97,7 +99,7 @@ variableTableEntry* addEntryToVariableTable(symbolTableEntry* variable)
 variableTableEntry* getEntryFromVariableTable(symbolTableEntry* variable)
 {
     // Loop until all entries in the symbol table and check the name
-    variableTableEntry* iterator = variableTable;
+    variableTableEntry* iterator = compilation->variableTable;
     
     while ((iterator != 0) && (iterator->variable != variable))
     {
@@ -113,15 +115,22 @@ variableTableEntry* getEntryFromVariableTable(symbolTableEntry* variable)
  * The variable table at program exit is written to file
  * <code>4_variabletable</code>.<BR>
  * The return value of the program is stored in variable programResult and
- * printed on screen.
+ * printed on screen.<BR>
+ * The execution is stopped at the end of a loop iteration if it exceeds
+ * instructionBudget or timeBudget (see budgetExceeded).
  **/
 void runCode()
 {
-    codeEntry* iterator = codeList;
+    codeEntry* iterator = compilation->codeList;
     
     FILE *f = fopen("3_execution", "w");
     fprintf(f, "== CODE EXECUTION ==\n");
     
+    compilation->budgetExceeded = 0;
+    compilation->deadline = (timeBudget > 0) ? getProfileTime() + timeBudget
+                                             : 0;
+    updateLoopBudget();
+    
     while (iterator != 0)
     {
         runCodeEntry(iterator, f, "");
@@ -129,78 +138,129 @@ void runCode()
     }
     
     fprintf(f, "== CODE EXECUTION ==\n");
+    fprintf(f, "Executed instructions: %ld\n", compilation->executedInstructions);
+    if (compilation->budgetExceeded)
+    {
+        char message[200];
+        describeBudgetStop(compilation->budgetExceeded,
+                           compilation->budgetLine, message);
+        fprintf(f, "Execution stopped: %s\n", message);
+        fprintf(stderr, "Execution stopped: %s\n", message);
+    }
     fclose(f);
     
-    // Write variable state at end of program
-    f = fopen("4_variabletable", "w");
+    printVariableTable();
+    
+    printf("\nPROGRAM RESULT = %s\n", compilation->programResult);
+}
+
+/**
+ * This writes the variable table at program exit into a text file called
+ * <code>4_variabletable</code>.
+ **/
+void printVariableTable()
+{
+    FILE *f = fopen("4_variabletable", "w");
     fprintf(f, "== VARIABLE TABLE ==\n");
     fprintf(f, " Name\tType\tValue\n");
     
-    variableTableEntry* iterator2 = variableTable;
+    variableTableEntry* iterator = compilation->variableTable;
     
-    while (iterator2 != 0)
+    while (iterator != 0)
     {
-        switch (iterator2->variable->type)
+        switch (iterator->variable->type)
         {
             case INTEGER:
-                fprintf(f, " %s\tINTEGER\t%d\n", iterator2->variable->name,
-                        iterator2->value.intValue);
+                fprintf(f, " %s\tINTEGER\t%d\n", iterator->variable->name,
+                        iterator->value.intValue);
                 break;
             case REAL:
-                fprintf(f, " %s\tREAL\t%.2f\n", iterator2->variable->name,
-                        iterator2->value.floatValue);
+                fprintf(f, " %s\tREAL\t%.2f\n", iterator->variable->name,
+                        iterator->value.floatValue);
                 break;
             case BOOLEAN:
-                fprintf(f, " %s\tBOOLEAN\t%s\n", iterator2->variable->name,
-                        getBooleanValue(iterator2->value.boolValue));
+                fprintf(f, " %s\tBOOLEAN\t%s\n", iterator->variable->name,
+                        getBooleanValue(iterator->value.boolValue));
                 break;
             default:
                 fprintf(f, "-UNKNOWN-");
         }
-        iterator2 = iterator2->next;
+        iterator = iterator->next;
     }
     
     fprintf(f, "== VARIABLE TABLE ==\n");
     fclose(f);
-    
-    printf("\nPROGRAM RESULT = %s\n", programResult);
 }
 
 /**
  * This executes a single code statement (including nested sub-code).<BR>
+ * The execution is counted and, in profiling mode, measured.
  * @param iterator The code entry which shall be executed.
  * @param f        Reference to the file for storing the execution output.
  * @param indent   Current indentation to visualize nesting within the execution
  *                 output.
  */
 void runCodeEntry(codeEntry* iterator, FILE *f, char* indent)
+{
+    // A stopped execution unwinds without executing further statements
+    if (compilation->budgetExceeded)
+    {
+        return;
+    }
+    
+    compilation->executedInstructions++;
+    
+    if (profile)
+    {
+        profileCodeEntry(iterator, f, indent);
+    }
+    else
+    {
+        executeCodeEntry(iterator, f, indent);
+    }
+}
+
+/**
+ * This executes a single code statement (including nested sub-code).<BR>
+ * Note: Use runCodeEntry to execute code, this function does not count or
+ *       profile the execution.
+ * @param iterator The code entry which shall be executed.
+ * @param f        Reference to the file for storing the execution output.
+ * @param indent   Current indentation to visualize nesting within the execution
+ *                 output.
+ */
+void executeCodeEntry(codeEntry* iterator, FILE *f, char* indent)
 {
     codeEntry* iterator2 = 0;
     
     // Copy the while marker to support nested while calls
-    codeEntry* lastWhileMarkerLocal = lastWhileMarker;
+    codeEntry* lastWhileMarkerLocal = compilation->lastWhileMarker;
     
-    char* sub_indent = (char*)malloc(sizeof(char)*(strlen(indent)+2));
+    char* sub_indent = (char*)malloc(sizeof(char)*(strlen(indent)+3));
     sprintf(sub_indent, "%s  ", indent);
     
     // Read entries from variable table (if existing)
+    variableTableEntry unassigned;
+    memset(&unassigned, 0, sizeof(unassigned));
     variableTableEntry* val_target = 0;
     variableTableEntry* val_op1 = 0;
     variableTableEntry* val_op2 = 0;
-    if (iterator->target != 0)
-    {
-        val_target = getEntryFromVariableTable(iterator->target);
-    }
-    if (iterator->operand1 != 0)
-    {
-        val_op1 = getEntryFromVariableTable(iterator->operand1);
-    }
-    if (iterator->operand2 != 0)
+    readOperands(iterator, &val_target, &val_op1, &val_op2, &unassigned);
+
+    // The closed-form update of an induction variable (e.g. I := I + _H3)
+    // writes its own operand, which is displayed with its previous value
+    variableTableEntry previous;
+    if ((val_op1 != 0) && (val_op1 == val_target)
+        && ((iterator->op == OP_PLUS) || (iterator->op == OP_MINUS)
+            || (iterator->op == OP_MULTIPLY) || (iterator->op == OP_DIVIDE)
+            || (iterator->op == OP_MODULO)))
     {
-        val_op2 = getEntryFromVariableTable(iterator->operand2);
+        previous = *val_op1;
+        val_op1 = &previous;
     }
-    
-    if (iterator->op != OP_MARKER_WHILE && iterator->op != OP_NOP)
+
+    if (iterator->op != OP_MARKER_WHILE && iterator->op != OP_NOP &&
+        iterator->op != OP_DO_WHILE && iterator->op != OP_DO_WHILE_COMPARE)
     {
         fprintf(f, "%s", indent);
     }
@@ -438,8 +498,9 @@ void runCodeEntry(codeEntry* iterator, FILE *f, char* indent)
         
         /* Control Flow */
         case OP_IF:
-            fprintf(f, "IF %s := %s\n", iterator->operand1->name, getBooleanValue(val_op1->value.boolValue));
-            if (val_op1->value.boolValue)
+        case OP_IF_COMPARE:
+            fprintf(f, "IF ");
+            if (evaluateCondition(iterator, val_target, val_op1, val_op2, f))
             {
                 // Execute all sub code
                 iterator2 = iterator->sub_1;
@@ -464,9 +525,10 @@ void runCodeEntry(codeEntry* iterator, FILE *f, char* indent)
             break;
         
         case OP_WHILE:
-            fprintf(f, "WHILE %s := %s\n", iterator->operand1->name, getBooleanValue(val_op1->value.boolValue));
+        case OP_WHILE_COMPARE:
+            fprintf(f, "WHILE ");
             
-            while (val_op1->value.boolValue)
+            while (evaluateCondition(iterator, val_target, val_op1, val_op2, f))
             {
                 // Execute all sub code
                 iterator2 = iterator->sub_1;
@@ -485,13 +547,67 @@ void runCodeEntry(codeEntry* iterator, FILE *f, char* indent)
                     iterator2 = iterator2->next;
                 }
                 
-                fprintf(f, "%sWHILE %s := %s\n", indent, iterator->operand1->name, getBooleanValue(val_op1->value.boolValue));
+                if ((compilation->executedInstructions
+                     >= compilation->budgetLimit)
+                    && checkLoopBudget(iterator))
+                {
+                    break;
+                }
+                
+                // Continue frequently iterated loops as native code
+                if (hotLoopThreshold && !profile
+                    && (++iterator->loopIterations >= hotLoopThreshold)
+                    && runHotLoop(iterator, lastWhileMarkerLocal, f, indent))
+                {
+                    break;
+                }
+                
+                fprintf(f, "%sWHILE ", indent);
+            }
+            break;
+        
+        case OP_DO_WHILE:
+        case OP_DO_WHILE_COMPARE:
+            do
+            {
+                // Execute all sub code (including the condition)
+                iterator2 = iterator->sub_1;
+                
+                while (iterator2 != 0)
+                {
+                    runCodeEntry(iterator2, f, sub_indent);
+                    iterator2 = iterator2->next;
+                }
+                
+                // The condition might be calculated for the first time
+                if ((val_op1 == &unassigned) || (val_op2 == &unassigned))
+                {
+                    readOperands(iterator, &val_target, &val_op1, &val_op2,
+                                 &unassigned);
+                }
+                
+                if ((compilation->executedInstructions
+                     >= compilation->budgetLimit)
+                    && checkLoopBudget(iterator))
+                {
+                    break;
+                }
+                
+                if (hotLoopThreshold && !profile
+                    && (++iterator->loopIterations >= hotLoopThreshold)
+                    && runHotLoop(iterator, 0, f, indent))
+                {
+                    break;
+                }
+                
+                fprintf(f, "%sDO WHILE ", indent);
             }
+            while (evaluateCondition(iterator, val_target, val_op1, val_op2, f));
             break;
         
         case OP_MARKER_WHILE:
             // Remember current position
-            lastWhileMarker = iterator;
+            compilation->lastWhileMarker = iterator;
             break;
         
         case OP_EXIT:
@@ -500,15 +616,15 @@ void runCodeEntry(codeEntry* iterator, FILE *f, char* indent)
             {
                 case INTEGER:
                     fprintf(f, " := %d\n", val_op1->value.intValue);
-                    sprintf(programResult, "%d", val_op1->value.intValue);
+                    sprintf(compilation->programResult, "%d", val_op1->value.intValue);
                     break;
                 case REAL:
                     fprintf(f, " := %.2f\n", val_op1->value.floatValue);
-                    sprintf(programResult, "%.2f", val_op1->value.floatValue);
+                    sprintf(compilation->programResult, "%.2f", val_op1->value.floatValue);
                     break;
                 case BOOLEAN:
                     fprintf(f, " := %s\n", getBooleanValue(val_op1->value.boolValue));
-                    sprintf(programResult, "%s", getBooleanValue(val_op1->value.boolValue));
+                    sprintf(compilation->programResult, "%s", getBooleanValue(val_op1->value.boolValue));
                     break;
             }
             break;
@@ -645,6 +761,10 @@ void runCodeEntry(codeEntry* iterator, FILE *f, char* indent)
             break;
         
         case OP_INCREMENT:
+            if (val_target == 0)
+            {
+                val_target = addEntryToVariableTable(iterator->target);
+            }
             fprintf(f, "%s := %s + 1 := %d + 1 := %d", iterator->target->name,
                     iterator->target->name, val_target->value.intValue,
                     val_target->value.intValue + 1);
@@ -653,6 +773,10 @@ void runCodeEntry(codeEntry* iterator, FILE *f, char* indent)
             break;
         
         case OP_DECREMENT:
+            if (val_target == 0)
+            {
+                val_target = addEntryToVariableTable(iterator->target);
+            }
             fprintf(f, "%s := %s - 1 := %d - 1 := %d", iterator->target->name,
                     iterator->target->name, val_target->value.intValue,
                     val_target->value.intValue - 1);
@@ -734,9 +858,269 @@ void runCodeEntry(codeEntry* iterator, FILE *f, char* indent)
 
         /* Place holder for if/else/while */
         case OP_NOP:
-            return;
+            break;
 
         default:
             fprintf(f, "ERROR: Unexpected operation: %u",iterator->op);
     }
+
+    free(sub_indent);
+}
+
+/**
+ * This reads the variable table entries of the target and the operands of a
+ * code entry.<BR>
+ * Operands which have never been assigned are read as zero (like by the
+ * native code and the program image), so they refer to the entry
+ * <code>unassigned</code>. The variable of a fused increment/decrement is
+ * added to the variable table if necessary.
+ * @param iterator   The code entry.
+ * @param val_target Receives the entry of the target (<code>null</code> if
+ *                   not existing).
+ * @param val_op1    Receives the entry of the 1st operand.
+ * @param val_op2    Receives the entry of the 2nd operand.
+ * @param unassigned Zero entry for operands which have never been assigned.
+ */
+void readOperands(codeEntry* iterator, variableTableEntry** val_target,
+                  variableTableEntry** val_op1, variableTableEntry** val_op2,
+                  variableTableEntry* unassigned)
+{
+    *val_target = 0;
+    if (iterator->target != 0)
+    {
+        *val_target = getEntryFromVariableTable(iterator->target);
+        if ((*val_target == 0) && (iterator->step != OP_NOP))
+        {
+            *val_target = addEntryToVariableTable(iterator->target);
+        }
+    }
+    
+    *val_op1 = 0;
+    if (iterator->operand1 != 0)
+    {
+        *val_op1 = getEntryFromVariableTable(iterator->operand1);
+        if (*val_op1 == 0)
+        {
+            *val_op1 = unassigned;
+        }
+    }
+    *val_op2 = 0;
+    if (iterator->operand2 != 0)
+    {
+        *val_op2 = getEntryFromVariableTable(iterator->operand2);
+        if (*val_op2 == 0)
+        {
+            *val_op2 = unassigned;
+        }
+    }
+}
+
+/**
+ * This evaluates the condition of an IF/WHILE statement and writes it into the
+ * execution output.<BR>
+ * For compare-and-branch superinstructions the fused increment/decrement and
+ * the numeric comparison are executed directly without writing a BOOLEAN
+ * temporary.
+ * @param iterator   The IF/WHILE code entry.
+ * @param val_target Variable table entry of the fused increment/decrement (if
+ *                   applicable).
+ * @param val_op1    Variable table entry of the 1st operand.
+ * @param val_op2    Variable table entry of the 2nd operand (if applicable).
+ * @param f          Reference to the file for storing the execution output.
+ * @return <code>1</code> if the condition is fulfilled.<BR>
+ *         <code>0</code> otherwise.
+ */
+int evaluateCondition(codeEntry* iterator, variableTableEntry* val_target,
+                      variableTableEntry* val_op1, variableTableEntry* val_op2,
+                      FILE *f)
+{
+    if ((iterator->op != OP_IF_COMPARE) && (iterator->op != OP_WHILE_COMPARE)
+        && (iterator->op != OP_DO_WHILE_COMPARE))
+    {
+        fprintf(f, "%s := %s\n", iterator->operand1->name,
+                getBooleanValue(val_op1->value.boolValue));
+        return val_op1->value.boolValue;
+    }
+    
+    if (iterator->step == OP_INCREMENT)
+    {
+        val_target->value.intValue++;
+    }
+    else if (iterator->step == OP_DECREMENT)
+    {
+        val_target->value.intValue--;
+    }
+    
+    int result = compareValues(iterator->compare, val_op1,
+                               iterator->operand1->type, val_op2,
+                               iterator->operand2->type);
+    
+    char condition[100];
+    fprintf(f, "%s := ",
+            getConditionName(iterator, condition, sizeof(condition)));
+    if (iterator->operand1->type == INTEGER)
+    {
+        fprintf(f, "%d", val_op1->value.intValue);
+    }
+    else
+    {
+        fprintf(f, "%.2f", val_op1->value.floatValue);
+    }
+    fprintf(f, " %s ", getComparisonSymbol(iterator->compare));
+    if (iterator->operand2->type == INTEGER)
+    {
+        fprintf(f, "%d", val_op2->value.intValue);
+    }
+    else
+    {
+        fprintf(f, "%.2f", val_op2->value.floatValue);
+    }
+    fprintf(f, " := %s\n", getBooleanValue(result));
+    
+    return result;
+}
+
+/**
+ * This performs a numeric comparison of two variable values.
+ * @param op      The comparison to be performed.<BR>
+ *                This needs to be one of the values: OP_EQUAL, OP_NOT_EQUAL,
+ *                OP_LESS_OR_EQUAL, OP_GREATER_OR_EQUAL, OP_GREATER, OP_LESS.
+ * @param val_op1 Variable table entry of the 1st operand.
+ * @param type1   Data type of the 1st operand (INTEGER or REAL).
+ * @param val_op2 Variable table entry of the 2nd operand.
+ * @param type2   Data type of the 2nd operand (INTEGER or REAL).
+ * @return <code>1</code> if the comparison is fulfilled.<BR>
+ *         <code>0</code> otherwise.
+ */
+int compareValues(operation op, variableTableEntry* val_op1, dataType type1,
+                  variableTableEntry* val_op2, dataType type2)
+{
+    // Integer comparisons are the common case and need no conversion
+    if ((type1 == INTEGER) && (type2 == INTEGER))
+    {
+        int a = val_op1->value.intValue;
+        int b = val_op2->value.intValue;
+        switch (op)
+        {
+            case OP_EQUAL:
+                return a == b;
+            case OP_NOT_EQUAL:
+                return a != b;
+            case OP_LESS_OR_EQUAL:
+                return a <= b;
+            case OP_GREATER_OR_EQUAL:
+                return a >= b;
+            case OP_GREATER:
+                return a > b;
+            case OP_LESS:
+                return a < b;
+            default:
+                return 0;
+        }
+    }
+    
+    double a = (type1 == INTEGER) ? val_op1->value.intValue
+                                  : val_op1->value.floatValue;
+    double b = (type2 == INTEGER) ? val_op2->value.intValue
+                                  : val_op2->value.floatValue;
+    switch (op)
+    {
+        case OP_EQUAL:
+            return a == b;
+        case OP_NOT_EQUAL:
+            return a != b;
+        case OP_LESS_OR_EQUAL:
+            return a <= b;
+        case OP_GREATER_OR_EQUAL:
+            return a >= b;
+        case OP_GREATER:
+            return a > b;
+        case OP_LESS:
+            return a < b;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * This determines the value of executedInstructions at which the next loop
+ * iteration checks the limits of the execution (see budgetLimit): the
+ * instruction budget or, for the time limit, the next reading of the clock.
+ */
+void updateLoopBudget()
+{
+    long limit = LONG_MAX;
+    if (instructionBudget > 0)
+    {
+        limit = instructionBudget;
+    }
+    if ((compilation->deadline > 0)
+        && (compilation->executedInstructions + BUDGET_CLOCK_INTERVAL < limit))
+    {
+        limit = compilation->executedInstructions + BUDGET_CLOCK_INTERVAL;
+    }
+    compilation->budgetLimit = limit;
+}
+
+/**
+ * This checks the limits of the execution at the end of a loop iteration.
+ * <BR>
+ * It is only called once executedInstructions reaches budgetLimit, so loops
+ * without limits only pay for a single comparison per iteration.
+ * @param loop The WHILE/DO WHILE code entry.
+ * @return <code>1</code> if the execution has been stopped (the loop needs
+ *         to be left).<BR>
+ *         <code>0</code> otherwise.
+ */
+int checkLoopBudget(codeEntry* loop)
+{
+    // A nested loop has already stopped the execution
+    if (compilation->budgetExceeded)
+    {
+        return 1;
+    }
+    
+    if ((instructionBudget > 0)
+        && (compilation->executedInstructions >= instructionBudget))
+    {
+        compilation->budgetExceeded = BUDGET_INSTRUCTIONS;
+    }
+    else if ((compilation->deadline > 0)
+             && (getProfileTime() >= compilation->deadline))
+    {
+        compilation->budgetExceeded = BUDGET_TIME;
+    }
+    else
+    {
+        updateLoopBudget();
+        return 0;
+    }
+    compilation->budgetLine = loop->sourceLine;
+    return 1;
+}
+
+/**
+ * This describes why an execution has been stopped.
+ * @param reason BUDGET_INSTRUCTIONS, BUDGET_TIME or BUDGET_FAULT.
+ * @param line   Source line of the loop which exceeded the limit (of the
+ *               division for BUDGET_FAULT).
+ * @param text   Receives the description.
+ */
+void describeBudgetStop(int reason, int line, char* text)
+{
+    if (reason == BUDGET_INSTRUCTIONS)
+    {
+        sprintf(text, "instruction budget of %ld exceeded in loop at line %d",
+                instructionBudget, line);
+    }
+    else if (reason == BUDGET_FAULT)
+    {
+        sprintf(text, "INTEGER division by zero or overflow at line %d",
+                line);
+    }
+    else
+    {
+        sprintf(text, "time limit of %.3f s exceeded in loop at line %d",
+                timeBudget, line);
+    }
 }
@@ -86,12 +86,21 @@ variableTableEntry* getEntryFromVariableTable(symbolTableEntry* variable);
  * The variable table at program exit is written to file
  * <code>4_variabletable</code>.<BR>
  * The return value of the program is stored in variable programResult and
- * printed on screen.
+ * printed on screen.<BR>
+ * The execution is stopped at the end of a loop iteration if it exceeds
+ * instructionBudget or timeBudget (see budgetExceeded).
  **/
 void runCode();
 
+/**
+ * This writes the variable table at program exit into a text file called
+ * <code>4_variabletable</code>.
+ **/
+void printVariableTable();
+
 /**
  * This executes a single code statement (including nested sub-code).<BR>
+ * The execution is counted and, in profiling mode, measured.
  * @param iterator The code entry which shall be executed.
  * @param f        Reference to the file for storing the execution output.
  * @param indent   Current indentation to visualize nesting within the execution
@@ -99,4 +108,95 @@ void runCode();
  */
 void runCodeEntry(codeEntry* iterator, FILE *f, char* indent);
 
+/**
+ * This executes a single code statement (including nested sub-code).<BR>
+ * Note: Use runCodeEntry to execute code, this function does not count or
+ *       profile the execution.
+ * @param iterator The code entry which shall be executed.
+ * @param f        Reference to the file for storing the execution output.
+ * @param indent   Current indentation to visualize nesting within the execution
+ *                 output.
+ */
+void executeCodeEntry(codeEntry* iterator, FILE *f, char* indent);
+
+/**
+ * This reads the variable table entries of the target and the operands of a
+ * code entry.<BR>
+ * Operands which have never been assigned are read as zero (like by the
+ * native code and the program image), so they refer to the entry
+ * <code>unassigned</code>. The variable of a fused increment/decrement is
+ * added to the variable table if necessary.
+ * @param iterator   The code entry.
+ * @param val_target Receives the entry of the target (<code>null</code> if
+ *                   not existing).
+ * @param val_op1    Receives the entry of the 1st operand.
+ * @param val_op2    Receives the entry of the 2nd operand.
+ * @param unassigned Zero entry for operands which have never been assigned.
+ */
+void readOperands(codeEntry* iterator, variableTableEntry** val_target,
+                  variableTableEntry** val_op1, variableTableEntry** val_op2,
+                  variableTableEntry* unassigned);
+
+/**
+ * This evaluates the condition of an IF/WHILE statement and writes it into the
+ * execution output.<BR>
+ * For compare-and-branch superinstructions the fused increment/decrement and
+ * the numeric comparison are executed directly without writing a BOOLEAN
+ * temporary.
+ * @param iterator   The IF/WHILE code entry.
+ * @param val_target Variable table entry of the fused increment/decrement (if
+ *                   applicable).
+ * @param val_op1    Variable table entry of the 1st operand.
+ * @param val_op2    Variable table entry of the 2nd operand (if applicable).
+ * @param f          Reference to the file for storing the execution output.
+ * @return <code>1</code> if the condition is fulfilled.<BR>
+ *         <code>0</code> otherwise.
+ */
+int evaluateCondition(codeEntry* iterator, variableTableEntry* val_target,
+                      variableTableEntry* val_op1, variableTableEntry* val_op2,
+                      FILE *f);
+
+/**
+ * This performs a numeric comparison of two variable values.
+ * @param op      The comparison to be performed.<BR>
+ *                This needs to be one of the values: OP_EQUAL, OP_NOT_EQUAL,
+ *                OP_LESS_OR_EQUAL, OP_GREATER_OR_EQUAL, OP_GREATER, OP_LESS.
+ * @param val_op1 Variable table entry of the 1st operand.
+ * @param type1   Data type of the 1st operand (INTEGER or REAL).
+ * @param val_op2 Variable table entry of the 2nd operand.
+ * @param type2   Data type of the 2nd operand (INTEGER or REAL).
+ * @return <code>1</code> if the comparison is fulfilled.<BR>
+ *         <code>0</code> otherwise.
+ */
+int compareValues(operation op, variableTableEntry* val_op1, dataType type1,
+                  variableTableEntry* val_op2, dataType type2);
+
+/**
+ * This determines the value of executedInstructions at which the next loop
+ * iteration checks the limits of the execution (see budgetLimit): the
+ * instruction budget or, for the time limit, the next reading of the clock.
+ */
+void updateLoopBudget();
+
+/**
+ * This checks the limits of the execution at the end of a loop iteration.
+ * <BR>
+ * It is only called once executedInstructions reaches budgetLimit, so loops
+ * without limits only pay for a single comparison per iteration.
+ * @param loop The WHILE/DO WHILE code entry.
+ * @return <code>1</code> if the execution has been stopped (the loop needs
+ *         to be left).<BR>
+ *         <code>0</code> otherwise.
+ */
+int checkLoopBudget(codeEntry* loop);
+
+/**
+ * This describes why an execution has been stopped.
+ * @param reason BUDGET_INSTRUCTIONS, BUDGET_TIME or BUDGET_FAULT.
+ * @param line   Source line of the loop which exceeded the limit (of the
+ *               division for BUDGET_FAULT).
+ * @param text   Receives the description.
+ */
+void describeBudgetStop(int reason, int line, char* text);
+
 #endif /*INTERPRETER_H_*/
@@ -0,0 +1,914 @@
+/**
+ * @file jit.c
+ * @brief This contains all function implementations for translating the
+ *        intermediate code into x86-64 machine code and executing it.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#if defined(__x86_64__) && !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+#include "jit.h"
+#include "interpreter.h"
+#include "perfmap.h"
+#include "context.h"
+
+/**
+ * Variable to enable/disable debug mode.<BR>
+ * [defined in file compiler.c]
+ */
+extern int debug;
+
+/**
+ * Variable to select the output for the perf profiler.<BR>
+ * [defined in file compiler.c]
+ */
+extern int perfMap;
+
+/**
+ * This translates the intermediate code into machine code.
+ * @return The executable machine code.<BR>
+ *         <code>null</code> if the code cannot be translated (e.g. unsupported
+ *         platform or operation). The interpreter needs to be used in this
+ *         case.
+ */
+nativeCode* compileNativeCode()
+{
+#if !defined(__x86_64__) || defined(_WIN32)
+    // The generated code uses the System V calling convention
+    fprintf(stderr, "Native code is only supported on x86-64 (System V), "
+                    "using the interpreter\n");
+    return 0;
+#else
+
+    nativeCode* native = (nativeCode*)malloc(sizeof(nativeCode));
+    native->capacity = 4096;
+    native->length = 0;
+    native->code = (unsigned char*)malloc(native->capacity);
+    native->memory = 0;
+    native->symbols = 0;
+    native->regions = 0;
+    native->regionCount = 0;
+    native->regionCapacity = 0;
+    native->loopLine = 0;
+
+    symbolTableEntry* symbol = compilation->symbolTable;
+    while (symbol)
+    {
+        native->symbols++;
+        symbol = symbol->next;
+    }
+
+    // Prologue: push rbx; mov rbx, rdi
+    addCodeRegion(native, 0);
+    emitByte(native, 0x53);
+    emitByte(native, 0x48);
+    emitByte(native, 0x89);
+    emitByte(native, 0xFB);
+
+    if (!compileCodeList(native, compilation->codeList))
+    {
+        fprintf(stderr, "Intermediate code cannot be translated into native "
+                        "code, using the interpreter\n");
+        free(native->code);
+        free(native->regions);
+        free(native);
+        return 0;
+    }
+
+    // Epilogue: pop rbx; ret
+    addCodeRegion(native, 0);
+    emitByte(native, 0x5B);
+    emitByte(native, 0xC3);
+
+    // Write the code into memory first and make it executable afterwards
+    void* memory = mmap(0, native->length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        fprintf(stderr, "Error while allocating memory for native code, "
+                        "using the interpreter\n");
+        free(native->code);
+        free(native->regions);
+        free(native);
+        return 0;
+    }
+    memcpy(memory, native->code, native->length);
+    if (mprotect(memory, native->length, PROT_READ | PROT_EXEC) != 0)
+    {
+        fprintf(stderr, "Error while enabling execution of native code, "
+                        "using the interpreter\n");
+        munmap(memory, native->length);
+        free(native->code);
+        free(native->regions);
+        free(native);
+        return 0;
+    }
+    native->memory = memory;
+
+    if (perfMap)
+    {
+        announceCodeRegions(native);
+    }
+
+    if (debug)
+    {
+        printf("Native code: %d bytes for %d variables\n", native->length,
+               native->symbols);
+    }
+    return native;
+#endif
+}
+
+/**
+ * This executes the machine code and frees it afterwards.<BR>
+ * The variable table at program exit is written to file
+ * <code>4_variabletable</code> and the return value of the program is printed
+ * on screen, as done by the interpreter. The file <code>3_execution</code>
+ * contains no trace as the single steps are not recorded.
+ * @param native The machine code created by compileNativeCode.
+ */
+void runNativeCode(nativeCode* native)
+{
+    int symbols = native->symbols;
+    int resultOffset = 8 * symbols;
+    int resultTypeOffset = resultOffset + 8;
+    int sequenceOffset = resultOffset + 16;
+    char* frame = (char*)calloc(sequenceOffset + 4 * symbols, 1);
+
+    void (*program)(char*) = (void (*)(char*))native->memory;
+    program(frame);
+
+    // Fill the variable table in the order of the first assignment
+    symbolTableEntry** order = (symbolTableEntry**)
+                               calloc(symbols + 1, sizeof(symbolTableEntry*));
+    symbolTableEntry* symbol = compilation->symbolTable;
+    while (symbol)
+    {
+        int sequence;
+        memcpy(&sequence, frame + sequenceOffset + 4 * symbol->index,
+               sizeof(int));
+        if (sequence > 0)
+        {
+            order[sequence - 1] = symbol;
+        }
+        symbol = symbol->next;
+    }
+
+    int i;
+    for (i = 0; (i < symbols) && (order[i] != 0); i++)
+    {
+        symbolTableEntry* variable = order[i];
+        variableTableEntry* entry = addEntryToVariableTable(variable);
+        char* slot = frame + getSlotOffset(variable);
+        if (variable->type == REAL)
+        {
+            memcpy(&entry->value.floatValue, slot, sizeof(double));
+        }
+        else
+        {
+            memcpy(&entry->value.intValue, slot, sizeof(int));
+        }
+    }
+
+    // The data type of the result is stored increased by one (0 = no result)
+    int resultType;
+    memcpy(&resultType, frame + resultTypeOffset, sizeof(int));
+    if (resultType == INTEGER + 1)
+    {
+        int value;
+        memcpy(&value, frame + resultOffset, sizeof(int));
+        sprintf(compilation->programResult, "%d", value);
+    }
+    else if (resultType == REAL + 1)
+    {
+        double value;
+        memcpy(&value, frame + resultOffset, sizeof(double));
+        sprintf(compilation->programResult, "%.2f", value);
+    }
+    else if (resultType == BOOLEAN + 1)
+    {
+        int value;
+        memcpy(&value, frame + resultOffset, sizeof(int));
+        sprintf(compilation->programResult, "%s", getBooleanValue(value));
+    }
+
+    FILE *f = fopen("3_execution", "w");
+    fprintf(f, "== CODE EXECUTION ==\n");
+    fprintf(f, "Executed as native code (%d bytes), no trace available\n",
+            native->length);
+    fprintf(f, "== CODE EXECUTION ==\n");
+    fclose(f);
+
+    printVariableTable();
+
+    printf("\nPROGRAM RESULT = %s\n", compilation->programResult);
+
+#if defined(__x86_64__) && !defined(_WIN32)
+    munmap(native->memory, native->length);
+#endif
+    free(native->code);
+    free(native->regions);
+    free(native);
+    free(frame);
+    free(order);
+}
+
+/**
+ * This starts a new region of the machine code at the current offset, if the
+ * source code line or the enclosing loop differ from the previous region.
+ * @param native     The machine code.
+ * @param sourceLine Source code line of the following machine code.
+ */
+void addCodeRegion(nativeCode* native, int sourceLine)
+{
+    // Empty regions are replaced
+    if ((native->regionCount > 0)
+        && (native->regions[native->regionCount - 1].start == native->length))
+    {
+        native->regionCount--;
+    }
+    if (native->regionCount > 0)
+    {
+        codeRegion* last = &native->regions[native->regionCount - 1];
+        if ((last->sourceLine == sourceLine)
+            && (last->loopLine == native->loopLine))
+        {
+            return;
+        }
+    }
+
+    if (native->regionCount == native->regionCapacity)
+    {
+        native->regionCapacity = (native->regionCapacity == 0)
+                                 ? 64 : native->regionCapacity * 2;
+        native->regions = (codeRegion*)realloc(native->regions,
+                          native->regionCapacity * sizeof(codeRegion));
+    }
+    codeRegion* region = &native->regions[native->regionCount++];
+    region->start = native->length;
+    region->sourceLine = sourceLine;
+    region->loopLine = native->loopLine;
+}
+
+/**
+ * This announces all regions of the executable machine code to the perf
+ * profiler. Every region is named by the program, its source code line and
+ * the line of the enclosing loop.
+ * @param native The machine code.
+ */
+void announceCodeRegions(nativeCode* native)
+{
+    char name[400];
+    int i;
+    for (i = 0; i < native->regionCount; i++)
+    {
+        codeRegion* region = &native->regions[i];
+        int end = (i + 1 < native->regionCount)
+                  ? native->regions[i + 1].start : native->length;
+
+        if (region->sourceLine == 0)
+        {
+            sprintf(name, "mathdh:%s [entry/exit]", getProgramName());
+        }
+        else if (region->loopLine == 0)
+        {
+            sprintf(name, "mathdh:%s:%d", getProgramName(),
+                    region->sourceLine);
+        }
+        else
+        {
+            sprintf(name, "mathdh:%s:%d [loop of line %d]", getProgramName(),
+                    region->sourceLine, region->loopLine);
+        }
+        writePerfMapEntry((char*)native->memory + region->start,
+                          end - region->start, name);
+    }
+}
+
+/**
+ * This appends a single byte to the machine code.
+ * @param native The machine code.
+ * @param value  The byte to be added.
+ */
+void emitByte(nativeCode* native, int value)
+{
+    if (native->length == native->capacity)
+    {
+        native->capacity *= 2;
+        native->code = (unsigned char*)realloc(native->code, native->capacity);
+    }
+    native->code[native->length++] = (unsigned char)value;
+}
+
+/**
+ * This appends a 32 bit value (little endian) to the machine code.
+ * @param native The machine code.
+ * @param value  The value to be added.
+ */
+void emitInt32(nativeCode* native, int value)
+{
+    int i;
+    for (i = 0; i < 4; i++)
+    {
+        emitByte(native, (value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * This appends a 64 bit value (little endian) to the machine code.
+ * @param native The machine code.
+ * @param value  The value to be added.
+ */
+void emitInt64(nativeCode* native, long long value)
+{
+    int i;
+    for (i = 0; i < 8; i++)
+    {
+        emitByte(native, (int)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * This appends an instruction which accesses the variable frame
+ * (<code>[rbx + offset]</code>).
+ * @param native   The machine code.
+ * @param prefix   Prefix bytes and opcode of the instruction (up to 4 bytes,
+ *                 emitted from the most significant non-zero byte).
+ * @param reg      Register number or opcode extension for the ModRM byte.
+ * @param offset   Offset within the variable frame.
+ */
+void emitFrameAccess(nativeCode* native, int prefix, int reg, int offset)
+{
+    int shift;
+    for (shift = 24; shift > 0 && ((prefix >> shift) & 0xFF) == 0; shift -= 8)
+    {
+    }
+    for (; shift >= 0; shift -= 8)
+    {
+        emitByte(native, (prefix >> shift) & 0xFF);
+    }
+
+    // ModRM: 32 bit displacement, base register rbx
+    emitByte(native, 0x80 | (reg << 3) | 3);
+    emitInt32(native, offset);
+}
+
+/**
+ * Determines the offset of a variable within the variable frame.
+ * @param variable The variable.
+ * @return Offset in bytes.
+ */
+int getSlotOffset(symbolTableEntry* variable)
+{
+    return 8 * variable->index;
+}
+
+/**
+ * This appends the code to mark a variable as written. The first write of a
+ * variable stores the next sequence number, which keeps the variable table in
+ * the same order as created by the interpreter.
+ * @param native   The machine code.
+ * @param variable The variable which has been written.
+ */
+void emitDefined(nativeCode* native, symbolTableEntry* variable)
+{
+    int counter = 8 * native->symbols + 12;
+    int sequence = 8 * native->symbols + 16 + 4 * variable->index;
+
+    // cmp dword [sequence], 0; jne done
+    emitFrameAccess(native, 0x83, 7, sequence);
+    emitByte(native, 0);
+    emitByte(native, 0x75);
+    emitByte(native, 19);
+
+    // add dword [counter], 1; mov eax, [counter]; mov [sequence], eax
+    emitFrameAccess(native, 0x83, 0, counter);
+    emitByte(native, 1);
+    emitFrameAccess(native, 0x8B, 0, counter);
+    emitFrameAccess(native, 0x89, 0, sequence);
+}
+
+/**
+ * This appends the code to load a numeric variable into an SSE register as
+ * double value (integer values are converted).
+ * @param native   The machine code.
+ * @param xmm      Number of the SSE register (<code>0</code> or
+ *                 <code>1</code>).
+ * @param variable The variable to be loaded.
+ */
+void emitLoadReal(nativeCode* native, int xmm, symbolTableEntry* variable)
+{
+    if (variable->type == REAL)
+    {
+        // movsd xmm, [slot]
+        emitFrameAccess(native, 0xF20F10, xmm, getSlotOffset(variable));
+    }
+    else
+    {
+        // cvtsi2sd xmm, dword [slot]
+        emitFrameAccess(native, 0xF20F2A, xmm, getSlotOffset(variable));
+    }
+}
+
+/**
+ * This appends a (conditional) jump with a 32 bit displacement which needs to
+ * be patched afterwards.
+ * @param native    The machine code.
+ * @param condition Second opcode byte of the conditional jump
+ *                  (e.g. <code>0x84</code> for <code>je</code>) or
+ *                  <code>0</code> for an unconditional jump.
+ * @return Position of the displacement within the machine code.
+ * @see patchJump
+ */
+int emitJump(nativeCode* native, int condition)
+{
+    if (condition)
+    {
+        emitByte(native, 0x0F);
+        emitByte(native, condition);
+    }
+    else
+    {
+        emitByte(native, 0xE9);
+    }
+    int position = native->length;
+    emitInt32(native, 0);
+    return position;
+}
+
+/**
+ * This sets the target of a jump created by emitJump.
+ * @param native   The machine code.
+ * @param position Position of the displacement returned by emitJump.
+ * @param target   Position of the jump target within the machine code.
+ */
+void patchJump(nativeCode* native, int position, int target)
+{
+    int displacement = target - (position + 4);
+    memcpy(native->code + position, &displacement, sizeof(int));
+}
+
+/**
+ * This appends the code for a numeric comparison. The result
+ * (<code>0</code> or <code>1</code>) is stored in register <code>eax</code>.
+ * @param native   The machine code.
+ * @param op       The comparison (OP_EQUAL, OP_NOT_EQUAL, OP_LESS_OR_EQUAL,
+ *                 OP_GREATER_OR_EQUAL, OP_GREATER, OP_LESS).
+ * @param operand1 1st operand.
+ * @param operand2 2nd operand.
+ * @return <code>1</code> on success, <code>0</code> if the operation is not
+ *         supported.
+ */
+int compileComparison(nativeCode* native, operation op,
+                      symbolTableEntry* operand1, symbolTableEntry* operand2)
+{
+    // The interpreter does not compare BOOLEAN values
+    if ((operand1->type == BOOLEAN) || (operand2->type == BOOLEAN))
+    {
+        return 0;
+    }
+
+    if ((operand1->type == INTEGER) && (operand2->type == INTEGER))
+    {
+        // Integer comparison: mov eax, [op1]; cmp eax, [op2]
+        int setcc;
+        switch (op)
+        {
+            case OP_EQUAL:
+                setcc = 0x94;
+                break;
+            case OP_NOT_EQUAL:
+                setcc = 0x95;
+                break;
+            case OP_LESS_OR_EQUAL:
+                setcc = 0x9E;
+                break;
+            case OP_GREATER_OR_EQUAL:
+                setcc = 0x9D;
+                break;
+            case OP_GREATER:
+                setcc = 0x9F;
+                break;
+            case OP_LESS:
+                setcc = 0x9C;
+                break;
+            default:
+                return 0;
+        }
+        emitFrameAccess(native, 0x8B, 0, getSlotOffset(operand1));
+        emitFrameAccess(native, 0x3B, 0, getSlotOffset(operand2));
+        emitByte(native, 0x0F);
+        emitByte(native, setcc);
+        emitByte(native, 0xC0);
+    }
+    else
+    {
+        emitLoadReal(native, 0, operand1);
+        emitLoadReal(native, 1, operand2);
+
+        // ucomisd sets the parity flag for NaN (unordered), which needs to
+        // compare as unequal like in C
+        switch (op)
+        {
+            case OP_EQUAL:
+                // ucomisd xmm0, xmm1; sete al; setnp cl; and al, cl
+                emitInt32(native, 0xC12E0F66);
+                emitInt32(native, 0x0FC0940F);
+                emitInt32(native, 0xC820C19B);
+                break;
+            case OP_NOT_EQUAL:
+                // ucomisd xmm0, xmm1; setne al; setp cl; or al, cl
+                emitInt32(native, 0xC12E0F66);
+                emitInt32(native, 0x0FC0950F);
+                emitInt32(native, 0xC808C19A);
+                break;
+            case OP_GREATER:
+                // ucomisd xmm0, xmm1; seta al
+                emitInt32(native, 0xC12E0F66);
+                emitByte(native, 0x0F);
+                emitByte(native, 0x97);
+                emitByte(native, 0xC0);
+                break;
+            case OP_GREATER_OR_EQUAL:
+                // ucomisd xmm0, xmm1; setae al
+                emitInt32(native, 0xC12E0F66);
+                emitByte(native, 0x0F);
+                emitByte(native, 0x93);
+                emitByte(native, 0xC0);
+                break;
+            case OP_LESS:
+                // ucomisd xmm1, xmm0; seta al
+                emitInt32(native, 0xC82E0F66);
+                emitByte(native, 0x0F);
+                emitByte(native, 0x97);
+                emitByte(native, 0xC0);
+                break;
+            case OP_LESS_OR_EQUAL:
+                // ucomisd xmm1, xmm0; setae al
+                emitInt32(native, 0xC82E0F66);
+                emitByte(native, 0x0F);
+                emitByte(native, 0x93);
+                emitByte(native, 0xC0);
+                break;
+            default:
+                return 0;
+        }
+    }
+
+    // movzx eax, al
+    emitByte(native, 0x0F);
+    emitByte(native, 0xB6);
+    emitByte(native, 0xC0);
+    return 1;
+}
+
+/**
+ * This appends the code for the condition of an IF/WHILE/DO WHILE statement
+ * (including a fused increment/decrement). The result (<code>0</code> or
+ * <code>1</code>) is stored in register <code>eax</code>.
+ * @param native The machine code.
+ * @param entry  The IF/WHILE/DO WHILE code entry.
+ * @return <code>1</code> on success, <code>0</code> if the operation is not
+ *         supported.
+ */
+int compileCondition(nativeCode* native, codeEntry* entry)
+{
+    if ((entry->op != OP_IF_COMPARE) && (entry->op != OP_WHILE_COMPARE)
+        && (entry->op != OP_DO_WHILE_COMPARE))
+    {
+        // mov eax, [op1]
+        emitFrameAccess(native, 0x8B, 0, getSlotOffset(entry->operand1));
+        return 1;
+    }
+
+    if (entry->step == OP_INCREMENT)
+    {
+        // add dword [target], 1
+        emitFrameAccess(native, 0x83, 0, getSlotOffset(entry->target));
+        emitByte(native, 1);
+    }
+    else if (entry->step == OP_DECREMENT)
+    {
+        // sub dword [target], 1
+        emitFrameAccess(native, 0x83, 5, getSlotOffset(entry->target));
+        emitByte(native, 1);
+    }
+    if (entry->step != OP_NOP)
+    {
+        emitDefined(native, entry->target);
+    }
+
+    return compileComparison(native, entry->compare, entry->operand1,
+                             entry->operand2);
+}
+
+/**
+ * This appends the machine code for a code list (including nested code
+ * lists).
+ * @param native The machine code.
+ * @param list   The first entry of the code list.
+ * @return <code>1</code> on success, <code>0</code> if any operation is not
+ *         supported.
+ */
+int compileCodeList(nativeCode* native, codeEntry* list)
+{
+    int marker = -1;
+    while (list)
+    {
+        addCodeRegion(native, list->sourceLine);
+        if (!compileCodeEntry(native, list, &marker))
+        {
+            return 0;
+        }
+        list = list->next;
+    }
+    return 1;
+}
+
+/**
+ * This appends the machine code for a single code entry.
+ * @param native The machine code.
+ * @param entry  The code entry.
+ * @param marker Position of the last WHILE marker within the current code
+ *               list. This is updated for OP_MARKER_WHILE entries and used as
+ *               jump target to evaluate the condition of a WHILE loop again.
+ * @return <code>1</code> on success, <code>0</code> if the operation is not
+ *         supported.
+ */
+int compileCodeEntry(nativeCode* native, codeEntry* entry, int* marker)
+{
+    symbolTableEntry* target = entry->target;
+    symbolTableEntry* operand1 = entry->operand1;
+    symbolTableEntry* operand2 = entry->operand2;
+    int jump;
+    int jumpEnd;
+    int start;
+    int loopLine;
+
+    switch (entry->op)
+    {
+        /* Numeric Comparison Operators */
+        case OP_EQUAL:
+        case OP_NOT_EQUAL:
+        case OP_LESS_OR_EQUAL:
+        case OP_GREATER_OR_EQUAL:
+        case OP_GREATER:
+        case OP_LESS:
+            if (!compileComparison(native, entry->op, operand1, operand2))
+            {
+                return 0;
+            }
+            // mov [target], eax
+            emitFrameAccess(native, 0x89, 0, getSlotOffset(target));
+            break;
+
+        /* Logical Comparison Operators */
+        case OP_AND:
+        case OP_OR:
+            // mov eax, [op1]; test eax, eax; setne al
+            emitFrameAccess(native, 0x8B, 0, getSlotOffset(operand1));
+            emitInt32(native, 0x950FC085);
+            emitByte(native, 0xC0);
+            // mov ecx, [op2]; test ecx, ecx; setne cl
+            emitFrameAccess(native, 0x8B, 1, getSlotOffset(operand2));
+            emitInt32(native, 0x950FC985);
+            emitByte(native, 0xC1);
+            // and/or al, cl; movzx eax, al
+            emitByte(native, (entry->op == OP_AND) ? 0x20 : 0x08);
+            emitByte(native, 0xC8);
+            emitByte(native, 0x0F);
+            emitByte(native, 0xB6);
+            emitByte(native, 0xC0);
+            emitFrameAccess(native, 0x89, 0, getSlotOffset(target));
+            break;
+
+        case OP_NOT:
+            // mov eax, [op1]; test eax, eax; sete al; movzx eax, al
+            emitFrameAccess(native, 0x8B, 0, getSlotOffset(operand1));
+            emitInt32(native, 0x940FC085);
+            emitByte(native, 0xC0);
+            emitByte(native, 0x0F);
+            emitByte(native, 0xB6);
+            emitByte(native, 0xC0);
+            emitFrameAccess(native, 0x89, 0, getSlotOffset(target));
+            break;
+
+        /* Control Flow */
+        case OP_IF:
+        case OP_IF_COMPARE:
+            if (!compileCondition(native, entry))
+            {
+                return 0;
+            }
+            // test eax, eax; jz else/end
+            emitByte(native, 0x85);
+            emitByte(native, 0xC0);
+            jump = emitJump(native, 0x84);
+            if (!compileCodeList(native, entry->sub_1))
+            {
+                return 0;
+            }
+            if (entry->sub_2 != 0)
+            {
+                jumpEnd = emitJump(native, 0);
+                patchJump(native, jump, native->length);
+                if (!compileCodeList(native, entry->sub_2))
+                {
+                    return 0;
+                }
+                patchJump(native, jumpEnd, native->length);
+            }
+            else
+            {
+                patchJump(native, jump, native->length);
+            }
+            return 1;
+
+        case OP_WHILE:
+        case OP_WHILE_COMPARE:
+            // The condition part starts at the last marker
+            start = (*marker >= 0) ? *marker : native->length;
+            loopLine = native->loopLine;
+            native->loopLine = entry->sourceLine;
+            addCodeRegion(native, entry->sourceLine);
+            if (!compileCondition(native, entry))
+            {
+                return 0;
+            }
+            emitByte(native, 0x85);
+            emitByte(native, 0xC0);
+            jump = emitJump(native, 0x84);
+            if (!compileCodeList(native, entry->sub_1))
+            {
+                return 0;
+            }
+            addCodeRegion(native, entry->sourceLine);
+            patchJump(native, emitJump(native, 0), start);
+            patchJump(native, jump, native->length);
+            native->loopLine = loopLine;
+            return 1;
+
+        case OP_DO_WHILE:
+        case OP_DO_WHILE_COMPARE:
+            start = native->length;
+            loopLine = native->loopLine;
+            native->loopLine = entry->sourceLine;
+            if (!compileCodeList(native, entry->sub_1))
+            {
+                return 0;
+            }
+            addCodeRegion(native, entry->sourceLine);
+            if (!compileCondition(native, entry))
+            {
+                return 0;
+            }
+            // test eax, eax; jnz start
+            emitByte(native, 0x85);
+            emitByte(native, 0xC0);
+            patchJump(native, emitJump(native, 0x85), start);
+            native->loopLine = loopLine;
+            return 1;
+
+        case OP_MARKER_WHILE:
+            *marker = native->length;
+            return 1;
+
+        case OP_EXIT:
+            // mov rax, [op1]; mov [result], rax; mov dword [type], type + 1
+            emitFrameAccess(native, 0x488B, 0, getSlotOffset(operand1));
+            emitFrameAccess(native, 0x4889, 0, 8 * native->symbols);
+            emitFrameAccess(native, 0xC7, 0, 8 * native->symbols + 8);
+            emitInt32(native, operand1->type + 1);
+            return 1;
+
+        /* Mathematical Operators */
+        case OP_PLUS:
+        case OP_MINUS:
+        case OP_MULTIPLY:
+        case OP_DIVIDE:
+        case OP_MODULO:
+            if ((operand1->type == BOOLEAN) || (operand2->type == BOOLEAN))
+            {
+                return 0;
+            }
+            if ((operand1->type == INTEGER) && (operand2->type == INTEGER))
+            {
+                emitFrameAccess(native, 0x8B, 0, getSlotOffset(operand1));
+                switch (entry->op)
+                {
+                    case OP_PLUS:
+                        emitFrameAccess(native, 0x03, 0, getSlotOffset(operand2));
+                        break;
+                    case OP_MINUS:
+                        emitFrameAccess(native, 0x2B, 0, getSlotOffset(operand2));
+                        break;
+                    case OP_MULTIPLY:
+                        emitFrameAccess(native, 0x0FAF, 0, getSlotOffset(operand2));
+                        break;
+                    default:
+                        // cdq; idiv dword [op2]
+                        emitByte(native, 0x99);
+                        emitFrameAccess(native, 0xF7, 7, getSlotOffset(operand2));
+                        break;
+                }
+                // mov [target], eax (edx for the remainder)
+                emitFrameAccess(native, 0x89, (entry->op == OP_MODULO) ? 2 : 0,
+                                getSlotOffset(target));
+            }
+            else
+            {
+                if (entry->op == OP_MODULO)
+                {
+                    return 0;
+                }
+                emitLoadReal(native, 0, operand1);
+                emitLoadReal(native, 1, operand2);
+                emitByte(native, 0xF2);
+                emitByte(native, 0x0F);
+                switch (entry->op)
+                {
+                    case OP_PLUS:
+                        emitByte(native, 0x58);
+                        break;
+                    case OP_MINUS:
+                        emitByte(native, 0x5C);
+                        break;
+                    case OP_MULTIPLY:
+                        emitByte(native, 0x59);
+                        break;
+                    default:
+                        emitByte(native, 0x5E);
+                        break;
+                }
+                emitByte(native, 0xC1);
+                // movsd [target], xmm0
+                emitFrameAccess(native, 0xF20F11, 0, getSlotOffset(target));
+            }
+            break;
+
+        case OP_INCREMENT:
+            emitFrameAccess(native, 0x83, 0, getSlotOffset(target));
+            emitByte(native, 1);
+            break;
+
+        case OP_DECREMENT:
+            emitFrameAccess(native, 0x83, 5, getSlotOffset(target));
+            emitByte(native, 1);
+            break;
+
+        /* Assignment */
+        case OP_ASSIGN:
+            if (operand1->type == REAL)
+            {
+                // mov rax, [op1]; mov [target], rax
+                emitFrameAccess(native, 0x488B, 0, getSlotOffset(operand1));
+                emitFrameAccess(native, 0x4889, 0, getSlotOffset(target));
+            }
+            else if ((operand1->type == INTEGER) && (target->type == REAL))
+            {
+                emitLoadReal(native, 0, operand1);
+                emitFrameAccess(native, 0xF20F11, 0, getSlotOffset(target));
+            }
+            else
+            {
+                emitFrameAccess(native, 0x8B, 0, getSlotOffset(operand1));
+                emitFrameAccess(native, 0x89, 0, getSlotOffset(target));
+            }
+            break;
+
+        /* Constants */
+        case OP_INT_CONSTANT:
+        case OP_BOOL_CONSTANT:
+            // mov dword [target], value
+            emitFrameAccess(native, 0xC7, 0, getSlotOffset(target));
+            emitInt32(native, (entry->op == OP_INT_CONSTANT) ? entry->integer
+                                                             : entry->boolean);
+            break;
+
+        case OP_FLOAT_CONSTANT:
+        {
+            // mov rax, value; mov [target], rax
+            double value = entry->real;
+            long long bits;
+            memcpy(&bits, &value, sizeof(bits));
+            emitByte(native, 0x48);
+            emitByte(native, 0xB8);
+            emitInt64(native, bits);
+            emitFrameAccess(native, 0x4889, 0, getSlotOffset(target));
+            break;
+        }
+
+        /* Place holder for if/else/while */
+        case OP_NOP:
+            return 1;
+
+        default:
+            return 0;
+    }
+
+    emitDefined(native, target);
+    return 1;
+}
@@ -0,0 +1,273 @@
+/**
+ * @file jit.h
+ * @brief This defines all data structures and functions for translating the
+ *        intermediate code into x86-64 machine code and executing it.
+ */
+
+#include "generator.h"
+#include "symboltable.h"
+#include "compiler.h"
+#include <stdio.h>
+
+#ifndef JIT_H_
+#define JIT_H_
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_nativeCode nativeCode;
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_codeRegion codeRegion;
+
+/**
+ * This structure defines a part of the machine code which has been generated
+ * for a single source code line.<BR>
+ * The regions are announced to the perf profiler (see writePerfMapEntry).
+ */
+struct s_codeRegion
+{
+    /**
+     * Offset of the first byte of the region within the machine code.<BR>
+     * The region ends where the following region starts.
+     */
+    int start;
+
+    /**
+     * Source code line of the region (<code>0</code> for the prologue and
+     * epilogue).
+     */
+    int sourceLine;
+
+    /**
+     * Source code line of the innermost loop containing the region
+     * (<code>0</code> if it is not part of a loop).
+     */
+    int loopLine;
+};
+
+/**
+ * This structure defines a block of generated machine code.<BR>
+ * The generated code expects a pointer to the variable frame in register
+ * <code>rdi</code> and keeps it in <code>rbx</code>. The frame contains one
+ * 8 byte slot per symbol table entry (indexed by symbolTableEntry.index),
+ * followed by the slot for the program result, the data type of the program
+ * result (increased by one, <code>0</code> if there is no result), a counter
+ * of written variables and one 4 byte sequence number per symbol which is set
+ * when the variable is written for the first time (<code>0</code> if the
+ * variable has not been written).
+ */
+struct s_nativeCode
+{
+    /**
+     * Buffer for the machine code while it is generated.
+     */
+    unsigned char* code;
+
+    /**
+     * Number of bytes of generated machine code.
+     */
+    int length;
+
+    /**
+     * Allocated size of the code buffer.
+     */
+    int capacity;
+
+    /**
+     * Number of symbols (variable slots within the frame).
+     */
+    int symbols;
+
+    /**
+     * Executable copy of the machine code.<BR>
+     * This is set to <code>null</code> until the code has been generated
+     * completely.
+     */
+    void* memory;
+
+    /**
+     * Regions of the machine code (in the order of their offset).
+     */
+    codeRegion* regions;
+
+    /**
+     * Number of entries within regions.
+     */
+    int regionCount;
+
+    /**
+     * Allocated number of entries within regions.
+     */
+    int regionCapacity;
+
+    /**
+     * Source code line of the loop currently translated (<code>0</code>
+     * outside of loops).
+     */
+    int loopLine;
+};
+
+/**
+ * This translates the intermediate code into machine code.
+ * @return The executable machine code.<BR>
+ *         <code>null</code> if the code cannot be translated (e.g. unsupported
+ *         platform or operation). The interpreter needs to be used in this
+ *         case.
+ */
+nativeCode* compileNativeCode();
+
+/**
+ * This executes the machine code and frees it afterwards.<BR>
+ * The variable table at program exit is written to file
+ * <code>4_variabletable</code> and the return value of the program is printed
+ * on screen, as done by the interpreter. The file <code>3_execution</code>
+ * contains no trace as the single steps are not recorded.
+ * @param native The machine code created by compileNativeCode.
+ */
+void runNativeCode(nativeCode* native);
+
+/**
+ * This starts a new region of the machine code at the current offset, if the
+ * source code line or the enclosing loop differ from the previous region.
+ * @param native     The machine code.
+ * @param sourceLine Source code line of the following machine code.
+ */
+void addCodeRegion(nativeCode* native, int sourceLine);
+
+/**
+ * This announces all regions of the executable machine code to the perf
+ * profiler. Every region is named by the program, its source code line and
+ * the line of the enclosing loop.
+ * @param native The machine code.
+ */
+void announceCodeRegions(nativeCode* native);
+
+/**
+ * This appends a single byte to the machine code.
+ * @param native The machine code.
+ * @param value  The byte to be added.
+ */
+void emitByte(nativeCode* native, int value);
+
+/**
+ * This appends a 32 bit value (little endian) to the machine code.
+ * @param native The machine code.
+ * @param value  The value to be added.
+ */
+void emitInt32(nativeCode* native, int value);
+
+/**
+ * This appends a 64 bit value (little endian) to the machine code.
+ * @param native The machine code.
+ * @param value  The value to be added.
+ */
+void emitInt64(nativeCode* native, long long value);
+
+/**
+ * This appends an instruction which accesses the variable frame
+ * (<code>[rbx + offset]</code>).
+ * @param native   The machine code.
+ * @param prefix   Prefix bytes and opcode of the instruction (up to 4 bytes,
+ *                 emitted from the most significant non-zero byte).
+ * @param reg      Register number or opcode extension for the ModRM byte.
+ * @param offset   Offset within the variable frame.
+ */
+void emitFrameAccess(nativeCode* native, int prefix, int reg, int offset);
+
+/**
+ * Determines the offset of a variable within the variable frame.
+ * @param variable The variable.
+ * @return Offset in bytes.
+ */
+int getSlotOffset(symbolTableEntry* variable);
+
+/**
+ * This appends the code to mark a variable as written. The first write of a
+ * variable stores the next sequence number, which keeps the variable table in
+ * the same order as created by the interpreter.
+ * @param native   The machine code.
+ * @param variable The variable which has been written.
+ */
+void emitDefined(nativeCode* native, symbolTableEntry* variable);
+
+/**
+ * This appends the code to load a numeric variable into an SSE register as
+ * double value (integer values are converted).
+ * @param native   The machine code.
+ * @param xmm      Number of the SSE register (<code>0</code> or
+ *                 <code>1</code>).
+ * @param variable The variable to be loaded.
+ */
+void emitLoadReal(nativeCode* native, int xmm, symbolTableEntry* variable);
+
+/**
+ * This appends a (conditional) jump with a 32 bit displacement which needs to
+ * be patched afterwards.
+ * @param native    The machine code.
+ * @param condition Second opcode byte of the conditional jump
+ *                  (e.g. <code>0x84</code> for <code>je</code>) or
+ *                  <code>0</code> for an unconditional jump.
+ * @return Position of the displacement within the machine code.
+ * @see patchJump
+ */
+int emitJump(nativeCode* native, int condition);
+
+/**
+ * This sets the target of a jump created by emitJump.
+ * @param native   The machine code.
+ * @param position Position of the displacement returned by emitJump.
+ * @param target   Position of the jump target within the machine code.
+ */
+void patchJump(nativeCode* native, int position, int target);
+
+/**
+ * This appends the code for a numeric comparison. The result
+ * (<code>0</code> or <code>1</code>) is stored in register <code>eax</code>.
+ * @param native   The machine code.
+ * @param op       The comparison (OP_EQUAL, OP_NOT_EQUAL, OP_LESS_OR_EQUAL,
+ *                 OP_GREATER_OR_EQUAL, OP_GREATER, OP_LESS).
+ * @param operand1 1st operand.
+ * @param operand2 2nd operand.
+ * @return <code>1</code> on success, <code>0</code> if the operation is not
+ *         supported.
+ */
+int compileComparison(nativeCode* native, operation op,
+                      symbolTableEntry* operand1, symbolTableEntry* operand2);
+
+/**
+ * This appends the code for the condition of an IF/WHILE/DO WHILE statement
+ * (including a fused increment/decrement). The result (<code>0</code> or
+ * <code>1</code>) is stored in register <code>eax</code>.
+ * @param native The machine code.
+ * @param entry  The IF/WHILE/DO WHILE code entry.
+ * @return <code>1</code> on success, <code>0</code> if the operation is not
+ *         supported.
+ */
+int compileCondition(nativeCode* native, codeEntry* entry);
+
+/**
+ * This appends the machine code for a code list (including nested code
+ * lists).
+ * @param native The machine code.
+ * @param list   The first entry of the code list.
+ * @return <code>1</code> on success, <code>0</code> if any operation is not
+ *         supported.
+ */
+int compileCodeList(nativeCode* native, codeEntry* list);
+
+/**
+ * This appends the machine code for a single code entry.
+ * @param native The machine code.
+ * @param entry  The code entry.
+ * @param marker Position of the last WHILE marker within the current code
+ *               list. This is updated for OP_MARKER_WHILE entries and used as
+ *               jump target to evaluate the condition of a WHILE loop again.
+ * @return <code>1</code> on success, <code>0</code> if the operation is not
+ *         supported.
+ */
+int compileCodeEntry(nativeCode* native, codeEntry* entry, int* marker);
+
+#endif /*JIT_H_*/
@@ -0,0 +1,570 @@
+/**
+ * @file lanes.c
+ * @brief This contains all function implementations for executing a program
+ *        image in SIMD lanes.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "lanes.h"
+#include "symboltable.h"
+
+/**
+ * This creates an execution state for all lanes.
+ * @param image The program image to be executed.
+ * @return The new execution state.
+ */
+laneState* createLaneState(programImage* image)
+{
+    int count = image->header->symbolCount;
+    laneState* state = (laneState*)calloc(1, sizeof(laneState));
+    state->image = image;
+    // Unused operands (index -1) refer to an additional scratch value
+    state->ints = (laneInts*)calloc(count + 1, sizeof(laneInts)) + 1;
+    state->floats = (laneFloats*)calloc(count + 1, sizeof(laneFloats)) + 1;
+    resetLaneState(state, 0);
+    return state;
+}
+
+/**
+ * This frees an execution state.
+ * @param state The execution state created by createLaneState.
+ */
+void freeLaneState(laneState* state)
+{
+    free(state->ints - 1);
+    free(state->floats - 1);
+    free(state);
+}
+
+/**
+ * This resets an execution state, so that the program can be executed again.
+ * <BR>
+ * The values of the inputs and the counters are kept.
+ * @param state The execution state.
+ * @param lanes Number of used lanes (the first lanes are used).
+ */
+void resetLaneState(laneState* state, int lanes)
+{
+    int count = state->image->header->symbolCount;
+    memset(state->ints - 1, 0, sizeof(laneInts) * (count + 1));
+    memset(state->floats - 1, 0, sizeof(laneFloats) * (count + 1));
+    int lane;
+    for (lane = 0; lane < IMAGE_LANES; lane++)
+    {
+        // Unused lanes are finished from the start
+        state->pc[lane] = (lane < lanes)
+                          ? 0 : state->image->header->instructionCount;
+        state->resultType[lane] = 0;
+        state->exceeded[lane] = 0;
+    }
+}
+
+/**
+ * This executes the instructions of a program image in all used lanes until
+ * the end of the program. Every lane computes the same result as
+ * executeProgramImage (a lane dividing by zero is stopped like a guarded
+ * execution).
+ * @param state The execution state (updated).
+ */
+LANE_TARGETS void executeImageLanes(laneState* state)
+{
+    imageInstruction* instructions = state->image->instructions;
+    symbolTableEntry* symbols = state->image->symbols;
+    laneInts* ints = state->ints;
+    laneFloats* floats = state->floats;
+    unsigned int count = state->image->header->instructionCount;
+
+    while (1)
+    {
+        // The lanes at the lowest position are executed, all other lanes
+        // wait until the executed lanes reach the next waiting lane
+        unsigned int pc = count;
+        int lane;
+        for (lane = 0; lane < IMAGE_LANES; lane++)
+        {
+            if (state->pc[lane] < pc)
+            {
+                pc = state->pc[lane];
+            }
+        }
+        if (pc >= count)
+        {
+            break;
+        }
+
+        laneInts active;
+        unsigned int next = count;
+        int activeCount = 0;
+        for (lane = 0; lane < IMAGE_LANES; lane++)
+        {
+            active[lane] = -(state->pc[lane] == pc);
+            activeCount -= active[lane];
+            if ((state->pc[lane] != pc) && (state->pc[lane] < next))
+            {
+                next = state->pc[lane];
+            }
+        }
+        laneMask wide = __builtin_convertvector(active, laneMask);
+        int diverged = 0;
+
+        while ((pc < next) && !diverged)
+        {
+            imageInstruction* instruction = &instructions[pc++];
+            laneInts* target = &ints[instruction->target];
+            laneFloats* floatTarget = &floats[instruction->target];
+            dataType type1 = (instruction->operand1 >= 0)
+                             ? symbols[instruction->operand1].type : INTEGER;
+            dataType type2 = (instruction->operand2 >= 0)
+                             ? symbols[instruction->operand2].type : INTEGER;
+            state->dispatches++;
+            state->laneInstructions += activeCount;
+
+            switch (instruction->op)
+            {
+                case IMG_EQUAL:
+                case IMG_NOT_EQUAL:
+                case IMG_LESS_OR_EQUAL:
+                case IMG_GREATER_OR_EQUAL:
+                case IMG_GREATER:
+                case IMG_LESS:
+                {
+                    // BOOLEAN values are not compared (as by the interpreter)
+                    if ((type1 == BOOLEAN) || (type2 == BOOLEAN))
+                    {
+                        break;
+                    }
+                    laneInts result;
+                    if ((type1 == INTEGER) && (type2 == INTEGER))
+                    {
+                        laneInts a = ints[instruction->operand1];
+                        laneInts b = ints[instruction->operand2];
+                        switch (instruction->op)
+                        {
+                            case IMG_EQUAL:
+                                result = -(a == b);
+                                break;
+                            case IMG_NOT_EQUAL:
+                                result = -(a != b);
+                                break;
+                            case IMG_LESS_OR_EQUAL:
+                                result = -(a <= b);
+                                break;
+                            case IMG_GREATER_OR_EQUAL:
+                                result = -(a >= b);
+                                break;
+                            case IMG_GREATER:
+                                result = -(a > b);
+                                break;
+                            default:
+                                result = -(a < b);
+                                break;
+                        }
+                    }
+                    else
+                    {
+                        laneFloats a = (type1 == INTEGER)
+                            ? __builtin_convertvector(
+                                  ints[instruction->operand1], laneFloats)
+                            : floats[instruction->operand1];
+                        laneFloats b = (type2 == INTEGER)
+                            ? __builtin_convertvector(
+                                  ints[instruction->operand2], laneFloats)
+                            : floats[instruction->operand2];
+                        laneMask compared;
+                        switch (instruction->op)
+                        {
+                            case IMG_EQUAL:
+                                compared = (a == b);
+                                break;
+                            case IMG_NOT_EQUAL:
+                                compared = (a != b);
+                                break;
+                            case IMG_LESS_OR_EQUAL:
+                                compared = (a <= b);
+                                break;
+                            case IMG_GREATER_OR_EQUAL:
+                                compared = (a >= b);
+                                break;
+                            case IMG_GREATER:
+                                compared = (a > b);
+                                break;
+                            default:
+                                compared = (a < b);
+                                break;
+                        }
+                        result = -__builtin_convertvector(compared, laneInts);
+                    }
+                    *target = (active & result) | (~active & *target);
+                    break;
+                }
+
+                case IMG_AND:
+                {
+                    laneInts result = -((ints[instruction->operand1] != 0)
+                                        & (ints[instruction->operand2] != 0));
+                    *target = (active & result) | (~active & *target);
+                    break;
+                }
+
+                case IMG_OR:
+                {
+                    laneInts result = -((ints[instruction->operand1] != 0)
+                                        | (ints[instruction->operand2] != 0));
+                    *target = (active & result) | (~active & *target);
+                    break;
+                }
+
+                case IMG_NOT:
+                {
+                    laneInts result = -(ints[instruction->operand1] == 0);
+                    *target = (active & result) | (~active & *target);
+                    break;
+                }
+
+                case IMG_PLUS:
+                case IMG_MINUS:
+                case IMG_MULTIPLY:
+                case IMG_DIVIDE:
+                case IMG_MODULO:
+                    if ((type1 == INTEGER) && (type2 == INTEGER))
+                    {
+                        laneInts a = ints[instruction->operand1];
+                        laneInts b = ints[instruction->operand2];
+                        laneInts result = *target;
+                        switch (instruction->op)
+                        {
+                            case IMG_PLUS:
+                                result = a + b;
+                                break;
+                            case IMG_MINUS:
+                                result = a - b;
+                                break;
+                            case IMG_MULTIPLY:
+                                result = a * b;
+                                break;
+                            default:
+                                // There is no vector instruction for integer
+                                // division and the waiting lanes must not
+                                // divide by zero. A faulting lane is stopped
+                                // (as by a guarded executeProgramImage).
+                                for (lane = 0; lane < IMAGE_LANES; lane++)
+                                {
+                                    if (!active[lane])
+                                    {
+                                        continue;
+                                    }
+                                    if ((b[lane] == 0) || ((b[lane] == -1)
+                                                    && (a[lane] == INT_MIN)))
+                                    {
+                                        state->exceeded[lane] = BUDGET_FAULT;
+                                        state->exceededAt[lane] = pc - 1;
+                                        state->pc[lane] = count;
+                                        active[lane] = 0;
+                                        wide[lane] = 0;
+                                        activeCount--;
+                                        continue;
+                                    }
+                                    result[lane] =
+                                        (instruction->op == IMG_DIVIDE)
+                                        ? a[lane] / b[lane]
+                                        : a[lane] % b[lane];
+                                }
+                                // Without active lanes the execution
+                                // continues at the next selection
+                                diverged = (activeCount == 0);
+                                break;
+                        }
+                        *target = (active & result) | (~active & *target);
+                    }
+                    else
+                    {
+                        laneFloats a = (type1 == INTEGER)
+                            ? __builtin_convertvector(
+                                  ints[instruction->operand1], laneFloats)
+                            : floats[instruction->operand1];
+                        laneFloats b = (type2 == INTEGER)
+                            ? __builtin_convertvector(
+                                  ints[instruction->operand2], laneFloats)
+                            : floats[instruction->operand2];
+                        laneFloats result;
+                        switch (instruction->op)
+                        {
+                            case IMG_PLUS:
+                                result = a + b;
+                                break;
+                            case IMG_MINUS:
+                                result = a - b;
+                                break;
+                            case IMG_MULTIPLY:
+                                result = a * b;
+                                break;
+                            default:
+                                result = a / b;
+                                break;
+                        }
+                        *floatTarget = (laneFloats)((wide & (laneMask)result)
+                                       | (~wide & (laneMask)*floatTarget));
+                    }
+                    break;
+
+                case IMG_INCREMENT:
+                    *target -= active;
+                    break;
+
+                case IMG_DECREMENT:
+                    *target += active;
+                    break;
+
+                case IMG_ASSIGN:
+                    if ((type1 == INTEGER)
+                        && (symbols[instruction->target].type == REAL))
+                    {
+                        laneFloats result = __builtin_convertvector(
+                            ints[instruction->operand1], laneFloats);
+                        *floatTarget = (laneFloats)((wide & (laneMask)result)
+                                       | (~wide & (laneMask)*floatTarget));
+                    }
+                    else
+                    {
+                        laneFloats result = floats[instruction->operand1];
+                        *target = (active & ints[instruction->operand1])
+                                  | (~active & *target);
+                        *floatTarget = (laneFloats)((wide & (laneMask)result)
+                                       | (~wide & (laneMask)*floatTarget));
+                    }
+                    break;
+
+                case IMG_CONSTANT:
+                case IMG_INPUT:
+                    for (lane = 0; lane < IMAGE_LANES; lane++)
+                    {
+                        if (!active[lane])
+                        {
+                            continue;
+                        }
+                        imageValue value =
+                            ((instruction->op == IMG_INPUT)
+                             && (state->inputs != 0))
+                            ? state->inputs[instruction->operand2 * IMAGE_LANES
+                                            + lane]
+                            : state->image->constants[instruction->operand1];
+                        (*target)[lane] = value.intValue;
+                        (*floatTarget)[lane] = value.floatValue;
+                    }
+                    break;
+
+                case IMG_EXIT:
+                    for (lane = 0; lane < IMAGE_LANES; lane++)
+                    {
+                        if (!active[lane])
+                        {
+                            continue;
+                        }
+                        state->resultType[lane] = type1 + 1;
+                        if (type1 == REAL)
+                        {
+                            state->result[lane].floatValue =
+                                floats[instruction->operand1][lane];
+                        }
+                        else
+                        {
+                            state->result[lane].intValue =
+                                ints[instruction->operand1][lane];
+                        }
+                    }
+                    break;
+
+                case IMG_JUMP:
+                    pc = instruction->jump;
+                    break;
+
+                case IMG_BRANCH_FALSE:
+                case IMG_BRANCH_TRUE:
+                {
+                    laneInts condition;
+                    evaluateLaneCondition(state, instruction, &active,
+                                          &condition);
+                    if (instruction->op == IMG_BRANCH_FALSE)
+                    {
+                        condition = ~condition;
+                    }
+                    laneInts taken = active & condition;
+                    int takenCount = 0;
+                    for (lane = 0; lane < IMAGE_LANES; lane++)
+                    {
+                        takenCount -= taken[lane];
+                    }
+
+                    if (takenCount == activeCount)
+                    {
+                        pc = instruction->jump;
+                    }
+                    else if (takenCount > 0)
+                    {
+                        // The lanes split up, both parts wait for the next
+                        // selection of the lowest position
+                        for (lane = 0; lane < IMAGE_LANES; lane++)
+                        {
+                            if (active[lane])
+                            {
+                                state->pc[lane] = taken[lane]
+                                    ? (unsigned int)instruction->jump : pc;
+                            }
+                        }
+                        diverged = 1;
+                    }
+                    break;
+                }
+            }
+        }
+
+        if (!diverged)
+        {
+            for (lane = 0; lane < IMAGE_LANES; lane++)
+            {
+                if (active[lane])
+                {
+                    state->pc[lane] = pc;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * This evaluates the condition of a branch instruction including a fused
+ * increment/decrement for the executed lanes.
+ * @param state       The execution state.
+ * @param instruction The branch instruction.
+ * @param active      The executed lanes (<code>-1</code> per lane).
+ * @param condition   Receives <code>-1</code> for every lane whose condition
+ *                    is fulfilled, <code>0</code> otherwise.
+ */
+LANE_TARGETS void evaluateLaneCondition(laneState* state,
+                                        imageInstruction* instruction,
+                                        laneInts* active,
+                                        laneInts* condition)
+{
+    laneInts* ints = state->ints;
+    laneFloats* floats = state->floats;
+    if (instruction->compare == 0)
+    {
+        *condition = (ints[instruction->operand1] != 0);
+        return;
+    }
+
+    if (instruction->step == IMG_INCREMENT)
+    {
+        ints[instruction->target] -= *active;
+    }
+    else if (instruction->step == IMG_DECREMENT)
+    {
+        ints[instruction->target] += *active;
+    }
+
+    symbolTableEntry* symbols = state->image->symbols;
+    dataType type1 = symbols[instruction->operand1].type;
+    dataType type2 = symbols[instruction->operand2].type;
+    if ((type1 == INTEGER) && (type2 == INTEGER))
+    {
+        laneInts a = ints[instruction->operand1];
+        laneInts b = ints[instruction->operand2];
+        switch (instruction->compare)
+        {
+            case IMG_EQUAL:
+                *condition = (a == b);
+                return;
+            case IMG_NOT_EQUAL:
+                *condition = (a != b);
+                return;
+            case IMG_LESS_OR_EQUAL:
+                *condition = (a <= b);
+                return;
+            case IMG_GREATER_OR_EQUAL:
+                *condition = (a >= b);
+                return;
+            case IMG_GREATER:
+                *condition = (a > b);
+                return;
+            default:
+                *condition = (a < b);
+                return;
+        }
+    }
+
+    laneFloats a = (type1 == INTEGER)
+                   ? __builtin_convertvector(ints[instruction->operand1],
+                                             laneFloats)
+                   : floats[instruction->operand1];
+    laneFloats b = (type2 == INTEGER)
+                   ? __builtin_convertvector(ints[instruction->operand2],
+                                             laneFloats)
+                   : floats[instruction->operand2];
+    laneMask compared;
+    switch (instruction->compare)
+    {
+        case IMG_EQUAL:
+            compared = (a == b);
+            break;
+        case IMG_NOT_EQUAL:
+            compared = (a != b);
+            break;
+        case IMG_LESS_OR_EQUAL:
+            compared = (a <= b);
+            break;
+        case IMG_GREATER_OR_EQUAL:
+            compared = (a >= b);
+            break;
+        case IMG_GREATER:
+            compared = (a > b);
+            break;
+        default:
+            compared = (a < b);
+            break;
+    }
+    *condition = __builtin_convertvector(compared, laneInts);
+}
+
+/**
+ * This converts the program result of a lane of a finished execution into a
+ * string (see formatImageResult).
+ * @param state  The finished execution state.
+ * @param lane   The lane.
+ * @param result Receives the result (empty if there is no result).
+ */
+void formatLaneResult(laneState* state, int lane, char* result)
+{
+    // The data type of the result is stored increased by one (0 = no result)
+    *result = 0;
+    if (state->resultType[lane] == INTEGER + 1)
+    {
+        sprintf(result, "%d", state->result[lane].intValue);
+    }
+    else if (state->resultType[lane] == REAL + 1)
+    {
+        snprintf(result, 200, "%.2f", state->result[lane].floatValue);
+    }
+    else if (state->resultType[lane] == BOOLEAN + 1)
+    {
+        sprintf(result, "%s", getBooleanValue(state->result[lane].intValue));
+    }
+}
+
+/**
+ * Determines the instruction set used by executeImageLanes.
+ * @return The name of the instruction set.
+ */
+const char* getLaneInstructionSet()
+{
+#if defined(__x86_64__) && defined(__linux__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? "AVX2" : "SSE2";
+#elif defined(__x86_64__)
+    return "SSE2";
+#else
+    return "generic";
+#endif
+}
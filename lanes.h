@@ -0,0 +1,185 @@
+/**
+ * @file lanes.h
+ * @brief This defines all data structures and functions for executing a
+ *        program image for several inputs at the same time: every instance
+ *        of the program runs in a lane of SIMD vectors, so a single dispatch
+ *        of an instruction performs it for all lanes.<BR>
+ *        Every lane has its own position within the program. The lanes at
+ *        the lowest position are executed together, lanes which took another
+ *        branch wait until the executed lanes reach their position. This way
+ *        lanes which diverge at an IF or WHILE run in lockstep again after the
+ *        structure.
+ */
+
+#include "image.h"
+
+#ifndef LANES_H_
+#define LANES_H_
+
+/**
+ * Number of lanes (program instances executed at the same time).
+ */
+#define IMAGE_LANES 8
+
+/**
+ * Attribute for the definitions of the executing functions: on x86-64 Linux
+ * they are compiled for AVX2 and for the SSE2 baseline, the version is
+ * selected when the program is loaded.
+ */
+#if defined(__x86_64__) && defined(__linux__)
+#define LANE_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define LANE_TARGETS
+#endif
+
+/**
+ * INTEGER and BOOLEAN values of a variable in all lanes.<BR>
+ * The vector types are only aligned like their elements, so they can be
+ * allocated by <code>calloc</code>.
+ */
+typedef int laneInts __attribute__((vector_size(IMAGE_LANES * 4), aligned(8)));
+
+/**
+ * REAL values of a variable in all lanes.
+ */
+typedef double laneFloats
+        __attribute__((vector_size(IMAGE_LANES * 8), aligned(8)));
+
+/**
+ * Mask for laneFloats (<code>-1</code> selects a lane).
+ */
+typedef long long laneMask
+        __attribute__((vector_size(IMAGE_LANES * 8), aligned(8)));
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_laneState laneState;
+
+/**
+ * This structure defines the execution state of a program image in all
+ * lanes.
+ */
+struct s_laneState
+{
+    /**
+     * The executed image.
+     */
+    programImage* image;
+
+    /**
+     * INTEGER and BOOLEAN values of all variables (indexed by symbol index,
+     * index <code>-1</code> is a scratch value for unused operands).
+     */
+    laneInts* ints;
+
+    /**
+     * REAL values of all variables (indexed like ints).
+     */
+    laneFloats* floats;
+
+    /**
+     * Index of the next instruction of every lane (the number of
+     * instructions if the lane has finished or is unused).
+     */
+    unsigned int pc[IMAGE_LANES];
+
+    /**
+     * Data type of the program result of every lane increased by one
+     * (<code>0</code> if there is no result).
+     */
+    int resultType[IMAGE_LANES];
+
+    /**
+     * Value of the program result of every lane.
+     */
+    imageValue result[IMAGE_LANES];
+
+    /**
+     * Reason for stopping every lane (BUDGET_FAULT, <code>0</code> if the
+     * lane has not been stopped).
+     */
+    int exceeded[IMAGE_LANES];
+
+    /**
+     * Index of the instruction at which every lane has been stopped.
+     */
+    unsigned int exceededAt[IMAGE_LANES];
+
+    /**
+     * Values of the inputs (<code>IMAGE_LANES</code> entries per input
+     * number, <code>null</code> to use the default values).
+     */
+    imageValue* inputs;
+
+    /**
+     * Number of dispatched instructions.
+     */
+    long dispatches;
+
+    /**
+     * Number of instructions executed by all lanes (at most dispatches
+     * multiplied by the number of used lanes).
+     */
+    long laneInstructions;
+};
+
+/**
+ * This creates an execution state for all lanes.
+ * @param image The program image to be executed.
+ * @return The new execution state.
+ */
+laneState* createLaneState(programImage* image);
+
+/**
+ * This frees an execution state.
+ * @param state The execution state created by createLaneState.
+ */
+void freeLaneState(laneState* state);
+
+/**
+ * This resets an execution state, so that the program can be executed again.
+ * <BR>
+ * The values of the inputs and the counters are kept.
+ * @param state The execution state.
+ * @param lanes Number of used lanes (the first lanes are used).
+ */
+void resetLaneState(laneState* state, int lanes);
+
+/**
+ * This executes the instructions of a program image in all used lanes until
+ * the end of the program. Every lane computes the same result as
+ * executeProgramImage (a lane dividing by zero is stopped like a guarded
+ * execution).
+ * @param state The execution state (updated).
+ */
+void executeImageLanes(laneState* state);
+
+/**
+ * This evaluates the condition of a branch instruction including a fused
+ * increment/decrement for the executed lanes.
+ * @param state       The execution state.
+ * @param instruction The branch instruction.
+ * @param active      The executed lanes (<code>-1</code> per lane).
+ * @param condition   Receives <code>-1</code> for every lane whose condition
+ *                    is fulfilled, <code>0</code> otherwise.
+ */
+void evaluateLaneCondition(laneState* state, imageInstruction* instruction,
+                           laneInts* active, laneInts* condition);
+
+/**
+ * This converts the program result of a lane of a finished execution into a
+ * string (see formatImageResult).
+ * @param state  The finished execution state.
+ * @param lane   The lane.
+ * @param result Receives the result (empty if there is no result).
+ */
+void formatLaneResult(laneState* state, int lane, char* result);
+
+/**
+ * Determines the instruction set used by executeImageLanes.
+ * @return The name of the instruction set.
+ */
+const char* getLaneInstructionSet();
+
+#endif /*LANES_H_*/
@@ -0,0 +1,690 @@
+/**
+ * @file main.c
+ * @brief This contains the command line driver of the compiler. All other
+ *        modules are part of the library <code>libmathdh</code>.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "compiler.h"
+#include "symboltable.h"
+#include "generator.h"
+#include "optimizer.h"
+#include "interpreter.h"
+#include "profiler.h"
+#include "statistics.h"
+#include "jit.h"
+#include "assembly.h"
+#include "hotloop.h"
+#include "perfmap.h"
+#include "image.h"
+#include "cache.h"
+#include "batch.h"
+#include "server.h"
+#include "checkpoint.h"
+#include "input.h"
+#include "lanes.h"
+#include "context.h"
+
+/**
+ * Variable to enable/disable debug mode<BR>
+ * [defined in file compiler.c]
+ */
+extern int debug;
+
+/**
+ * Variable to enable/disable the optimizer.<BR>
+ * [defined in file compiler.c]
+ */
+extern int optimize;
+
+/**
+ * Variable to enable/disable profiling mode.<BR>
+ * [defined in file compiler.c]
+ */
+extern int profile;
+
+/**
+ * Variable to enable/disable the execution of the program.<BR>
+ * [defined in file compiler.c]
+ */
+extern int execute;
+
+/**
+ * Variable to enable/disable native code execution.<BR>
+ * [defined in file compiler.c]
+ */
+extern int jit;
+
+/**
+ * Variable to enable/disable the C backend.<BR>
+ * [defined in file compiler.c]
+ */
+extern int cBackend;
+
+/**
+ * File name of the native executable to be created by the system C compiler
+ * from the C backend output.<BR>
+ * [defined in file compiler.c]
+ */
+extern char* executable;
+
+/**
+ * Variable to enable/disable the assembly backend.<BR>
+ * [defined in file compiler.c]
+ */
+extern int assemblyBackend;
+
+/**
+ * File name of the native executable to be created by <code>as</code> and
+ * <code>ld</code> from the assembly backend output.<BR>
+ * [defined in file compiler.c]
+ */
+extern char* assemblyExecutable;
+
+/**
+ * File name of the program image to be written from the intermediate code.
+ * <BR>
+ * [defined in file compiler.c]
+ */
+extern char* imageFile;
+
+/**
+ * File name of the program image to be executed instead of compiling the
+ * source code from STDIN.<BR>
+ * [defined in file compiler.c]
+ */
+extern char* programFile;
+
+/**
+ * Variable to enable/disable the compilation cache.<BR>
+ * [defined in file compiler.c]
+ */
+extern int cache;
+
+/**
+ * Maximum size of all program images within the compilation cache in bytes.
+ * <BR>
+ * [defined in file compiler.c]
+ */
+extern long cacheLimit;
+
+/**
+ * Number of loop iterations after which the interpreter executes a loop as
+ * native code (see runHotLoop).<BR>
+ * [defined in file compiler.c]
+ */
+extern long hotLoopThreshold;
+
+/**
+ * Maximum number of instructions executed by a program.<BR>
+ * [defined in file compiler.c]
+ */
+extern long instructionBudget;
+
+/**
+ * Maximum execution time of a program in seconds.<BR>
+ * [defined in file compiler.c]
+ */
+extern double timeBudget;
+
+/**
+ * Maximum number of instructions for executing the program at compile time.
+ * <BR>
+ * [defined in file compiler.c]
+ */
+extern long evaluationBudget;
+
+/**
+ * Variable to select the output for the perf profiler.<BR>
+ * [defined in file compiler.c]
+ */
+extern int perfMap;
+
+/**
+ * Variable to select the statistics output.<BR>
+ * [defined in file compiler.c]
+ */
+extern int statistics;
+
+/**
+ * Main application entry point.<BR>
+ * Uses input from STDIN and forwards it to the scanner for processing.<BR>
+ * If the input has been parsed successfully, the intermediate code is written
+ * and executed afterwards.
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.<BR>
+ *             <code>-O</code> enables the optimizer.<BR>
+ *             <code>-p</code> enables profiling mode.<BR>
+ *             <code>-c</code> disables the execution (compile only).<BR>
+ *             <code>-j</code> executes the program as native code.<BR>
+ *             <code>-C</code> writes the program as C source code.<BR>
+ *             <code>-o FILE</code> compiles the C source code into the
+ *             executable FILE.<BR>
+ *             <code>-S</code> writes the program as x86-64 assembly.<BR>
+ *             <code>-a FILE</code> assembles and links the assembly into the
+ *             executable FILE.<BR>
+ *             <code>-b FILE</code> writes the compiled program as program
+ *             image FILE.<BR>
+ *             <code>-r FILE</code> executes the program image FILE instead of
+ *             compiling the source code.<BR>
+ *             <code>--cache</code> executes cached programs and caches
+ *             compiled programs.<BR>
+ *             <code>--cache-limit=BYTES</code> enables the cache and limits
+ *             its size (default: 16 MiB).<BR>
+ *             <code>--cache-stats</code> prints the cache statistics.<BR>
+ *             <code>--hotloops[=N]</code> executes loops as native code
+ *             after N iterations (default: 1000).<BR>
+ *             <code>--max-instructions=N</code> stops the execution at the
+ *             end of the first loop iteration after N instructions.<BR>
+ *             <code>--timeout=SECONDS</code> stops the execution at the end
+ *             of the first loop iteration after SECONDS seconds.<BR>
+ *             The limits disable <code>-j</code> and
+ *             <code>--hotloops</code> and need to precede
+ *             <code>--batch</code> and <code>--server</code> (applied to
+ *             every request).<BR>
+ *             <code>--evaluate[=N]</code> executes the program at compile
+ *             time and replaces it by its result if it finishes within N
+ *             instructions (default: 1000000, must precede
+ *             <code>--batch</code>).<BR>
+ *             <code>--checkpoint=FILE</code> executes the program image and
+ *             writes its execution state into FILE periodically, on SIGUSR1
+ *             and on SIGINT/SIGTERM.<BR>
+ *             <code>--checkpoint-interval=SECONDS</code> sets the period of
+ *             the checkpoints (default: 60).<BR>
+ *             <code>--resume=FILE</code> resumes the execution of the same
+ *             program from the checkpoint FILE.<BR>
+ *             <code>--perfmap</code> writes a perf map for native code.
+ *             <BR>
+ *             <code>--perfmap=jitdump</code> writes a perf map and a jitdump
+ *             file for native code.<BR>
+ *             <code>--batch[=N] FILE...</code> compiles and executes all
+ *             following files with N threads (default: one per processor).
+ *             <BR>
+ *             <code>--server[=N] SOCKET</code> runs the compile server on
+ *             the Unix domain socket SOCKET with N threads (default: one per
+ *             processor).<BR>
+ *             <code>--quantum=N</code> lets the compile server switch to
+ *             another program after N instructions (default: 10000, must
+ *             precede <code>--server</code>).<BR>
+ *             <code>--loadtest[=N] SOCKET FILE...</code> sends requests for
+ *             all following files to the compile server over N connections
+ *             (default: 4) and prints the latencies.<BR>
+ *             <code>-i NAME=VALUE</code> sets the value of the input NAME
+ *             (may be repeated).<BR>
+ *             <code>--inputs=FILE</code> sets the inputs to the first row of
+ *             the CSV file FILE.<BR>
+ *             <code>--sweep[=N] FILE</code> executes the program for every
+ *             row of the CSV file FILE with N threads (default: one per
+ *             processor) instead of executing it once.<BR>
+ *             <code>--lanes=N</code> executes N rows of a sweep at the same
+ *             time in SIMD lanes (default: 8, 1 disables the lanes).<BR>
+ *             <code>--stats</code> prints the compiler statistics.<BR>
+ *             <code>--stats=trace</code> writes the compiler statistics as
+ *             trace file.<BR>
+ *             <code>-d</code> enables debug output.
+ * @return <code>0</code> on success, <code>1</code> otherwise.
+ */
+int main(int argc, char **argv)
+{
+    char** assignments = (char**)malloc(sizeof(char*) * argc);
+    int assignmentCount = 0;
+    char* inputFile = 0;
+    char* sweepFile = 0;
+    int sweepThreads = 0;
+    int sweepLanes = IMAGE_LANES;
+    long quantum = SCHEDULER_QUANTUM;
+    char* checkpointFile = 0;
+    char* resumeFile = 0;
+    double checkpointInterval = CHECKPOINT_INTERVAL;
+    int i;
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-O") == 0)
+        {
+            optimize = 1;
+        }
+        else if (strcmp(argv[i], "-p") == 0)
+        {
+            profile = 1;
+        }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            execute = 0;
+        }
+        else if (strcmp(argv[i], "-j") == 0)
+        {
+            jit = 1;
+        }
+        else if (strcmp(argv[i], "-C") == 0)
+        {
+            cBackend = 1;
+        }
+        else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc))
+        {
+            cBackend = 1;
+            executable = argv[++i];
+        }
+        else if (strcmp(argv[i], "-S") == 0)
+        {
+            assemblyBackend = 1;
+        }
+        else if ((strcmp(argv[i], "-a") == 0) && (i + 1 < argc))
+        {
+            assemblyBackend = 1;
+            assemblyExecutable = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-b") == 0) && (i + 1 < argc))
+        {
+            imageFile = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            programFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cache") == 0)
+        {
+            cache = 1;
+        }
+        else if ((strncmp(argv[i], "--cache-limit=", 14) == 0)
+                 && (atol(argv[i] + 14) > 0))
+        {
+            cache = 1;
+            cacheLimit = atol(argv[i] + 14);
+        }
+        else if (strcmp(argv[i], "--cache-stats") == 0)
+        {
+            printCacheStatistics();
+            return 0;
+        }
+        else if (strcmp(argv[i], "--hotloops") == 0)
+        {
+            hotLoopThreshold = 1000;
+        }
+        else if ((strncmp(argv[i], "--hotloops=", 11) == 0)
+                 && (atol(argv[i] + 11) > 0))
+        {
+            hotLoopThreshold = atol(argv[i] + 11);
+        }
+        else if ((strncmp(argv[i], "--max-instructions=", 19) == 0)
+                 && (atol(argv[i] + 19) > 0))
+        {
+            instructionBudget = atol(argv[i] + 19);
+        }
+        else if ((strncmp(argv[i], "--timeout=", 10) == 0)
+                 && (atof(argv[i] + 10) > 0))
+        {
+            timeBudget = atof(argv[i] + 10);
+        }
+        else if (strcmp(argv[i], "--evaluate") == 0)
+        {
+            evaluationBudget = EVALUATION_BUDGET;
+        }
+        else if ((strncmp(argv[i], "--evaluate=", 11) == 0)
+                 && (atol(argv[i] + 11) > 0))
+        {
+            evaluationBudget = atol(argv[i] + 11);
+        }
+        else if ((strncmp(argv[i], "--checkpoint=", 13) == 0)
+                 && (argv[i][13] != 0))
+        {
+            checkpointFile = argv[i] + 13;
+        }
+        else if ((strncmp(argv[i], "--checkpoint-interval=", 22) == 0)
+                 && (atof(argv[i] + 22) > 0))
+        {
+            checkpointInterval = atof(argv[i] + 22);
+        }
+        else if ((strncmp(argv[i], "--resume=", 9) == 0)
+                 && (argv[i][9] != 0))
+        {
+            resumeFile = argv[i] + 9;
+        }
+        else if (strcmp(argv[i], "--perfmap") == 0)
+        {
+            perfMap = 1;
+        }
+        else if (strcmp(argv[i], "--perfmap=jitdump") == 0)
+        {
+            perfMap = 2;
+        }
+        else if ((strcmp(argv[i], "--batch") == 0)
+                 || (strncmp(argv[i], "--batch=", 8) == 0))
+        {
+            int threads = (argv[i][7] == '=') ? atoi(argv[i] + 8) : 0;
+            return runBatch(argv + i + 1, argc - i - 1, threads);
+        }
+        else if (((strcmp(argv[i], "--server") == 0)
+                  || (strncmp(argv[i], "--server=", 9) == 0))
+                 && (i + 1 < argc))
+        {
+            int workers = (argv[i][8] == '=') ? atoi(argv[i] + 9) : 0;
+            return runServer(argv[i + 1], workers, quantum);
+        }
+        else if ((strncmp(argv[i], "--quantum=", 10) == 0)
+                 && (atol(argv[i] + 10) > 0))
+        {
+            quantum = atol(argv[i] + 10);
+        }
+        else if (((strcmp(argv[i], "--loadtest") == 0)
+                  || (strncmp(argv[i], "--loadtest=", 11) == 0))
+                 && (i + 1 < argc))
+        {
+            int connections = (argv[i][10] == '=') ? atoi(argv[i] + 11) : 0;
+            return runLoadTest(argv[i + 1], argv + i + 2, argc - i - 2,
+                               connections);
+        }
+        else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc))
+        {
+            assignments[assignmentCount++] = argv[++i];
+        }
+        else if (strncmp(argv[i], "--inputs=", 9) == 0)
+        {
+            inputFile = argv[i] + 9;
+        }
+        else if (((strcmp(argv[i], "--sweep") == 0)
+                  || (strncmp(argv[i], "--sweep=", 8) == 0))
+                 && (i + 1 < argc))
+        {
+            // The sweep replaces the execution of the program
+            sweepThreads = (argv[i][7] == '=') ? atoi(argv[i] + 8) : 0;
+            sweepFile = argv[++i];
+            execute = 0;
+        }
+        else if ((strncmp(argv[i], "--lanes=", 8) == 0)
+                 && (atoi(argv[i] + 8) >= 1)
+                 && (atoi(argv[i] + 8) <= IMAGE_LANES))
+        {
+            sweepLanes = atoi(argv[i] + 8);
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+        {
+            statistics = 1;
+        }
+        else if (strcmp(argv[i], "--stats=trace") == 0)
+        {
+            statistics = 2;
+        }
+        else if (strcmp(argv[i], "-d") == 0)
+        {
+            debug = 1;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // Native code cannot be stopped, so limited programs are only executed
+    // by the interpreter and the image executor
+    if (instructionBudget || (timeBudget > 0))
+    {
+        jit = 0;
+        hotLoopThreshold = 0;
+    }
+
+    // Only the image executor keeps its state outside of the C stack, so
+    // checkpoints replace the interpreter by the image executor
+    int checkpoints = (checkpointFile != 0) || (resumeFile != 0);
+    if (checkpoints && profile)
+    {
+        fprintf(stderr, "Checkpoints cannot be combined with profiling\n");
+        return 1;
+    }
+
+    // The cache is only used if no other output of the compilation is
+    // requested
+    if (profile || jit || cBackend || assemblyBackend || imageFile
+        || hotLoopThreshold || (programFile != 0))
+    {
+        cache = 0;
+    }
+
+    // Inputs are part of the compiled program, so the source code is no
+    // sufficient cache key
+    if (assignmentCount || inputFile || sweepFile)
+    {
+        if (programFile != 0)
+        {
+            fprintf(stderr, "Inputs cannot be set for a program image\n");
+            return 1;
+        }
+        cache = 0;
+    }
+
+    // Keep the source code for the annotated profile listing and the cache
+    // key
+    char* source = 0;
+    char* cachePath = 0;
+    FILE *input = stdin;
+    if (profile || cache)
+    {
+        source = readInput(stdin);
+        input = fmemopen(source, strlen(source), "r");
+    }
+
+    // A single program is compiled within the context of the main thread
+    compilationContext* context = createCompilationContext();
+    useCompilationContext(context);
+
+    for (i = 0; i < assignmentCount; i++)
+    {
+        if (!addInputAssignment(assignments[i]))
+        {
+            fprintf(stderr, "Invalid input: %s\n", assignments[i]);
+            return 1;
+        }
+    }
+    free(assignments);
+    if ((inputFile != 0) && !addInputFile(inputFile))
+    {
+        return 1;
+    }
+
+    if (statistics)
+    {
+        openCounters();
+    }
+
+    phase* current;
+    int result;
+    programImage* image = 0;
+    if (programFile != 0)
+    {
+        // A program image replaces parsing and code generation
+        current = startPhase("loadProgramImage");
+        image = loadProgramImage(programFile);
+        endPhase(current);
+        result = (image == 0);
+    }
+    else
+    {
+        if (cache)
+        {
+            current = startPhase("lookupCache");
+            cachePath = getCachePath(source);
+            image = lookupCache(cachePath);
+            endPhase(current);
+        }
+
+        if (image == 0)
+        {
+            current = startPhase("yyparse");
+            result = parseProgram(context, input);
+            if ((result == 0) && !checkInputAssignments())
+            {
+                result = 1;
+            }
+            endPhase(current);
+
+            current = startPhase("printSymbolTable");
+            printSymbolTable();
+            endPhase(current);
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+
+    if ((result == 0) && (image != 0))
+    {
+        if (execute)
+        {
+            current = startPhase("runProgramImage");
+            if (!checkpoints)
+            {
+                runProgramImage(image);
+            }
+            else if (!runCheckpointedImage(image, checkpointFile, resumeFile,
+                                           checkpointInterval))
+            {
+                result = 1;
+            }
+            endPhase(current);
+            if (context->budgetExceeded)
+            {
+                result = 1;
+            }
+        }
+        freeProgramImage(image);
+    }
+    else if (result == 0)
+    {
+        if (optimize)
+        {
+            current = startPhase("optimizeCode");
+            optimizeCode();
+            endPhase(current);
+        }
+
+        if (evaluationBudget)
+        {
+            current = startPhase("evaluateProgram");
+            evaluateProgram(evaluationBudget);
+            endPhase(current);
+        }
+
+        current = startPhase("printCode");
+        printCode();
+        endPhase(current);
+
+        if (cachePath != 0)
+        {
+            current = startPhase("storeCache");
+            storeCache(cachePath);
+            endPhase(current);
+        }
+
+        if (imageFile != 0)
+        {
+            current = startPhase("writeProgramImage");
+            if (!writeProgramImage(imageFile))
+            {
+                result = 1;
+            }
+            endPhase(current);
+        }
+
+        if (cBackend)
+        {
+            current = startPhase("printCCode");
+            printCCode();
+            endPhase(current);
+        }
+
+        if (executable != 0)
+        {
+            current = startPhase("compileCCode");
+            if (!compileCCode(executable))
+            {
+                result = 1;
+            }
+            endPhase(current);
+        }
+
+        if (assemblyBackend)
+        {
+            current = startPhase("printAssembly");
+            printAssembly();
+            endPhase(current);
+        }
+
+        if (assemblyExecutable != 0)
+        {
+            current = startPhase("assembleProgram");
+            if (!assembleProgram(assemblyExecutable))
+            {
+                result = 1;
+            }
+            endPhase(current);
+        }
+
+        if (sweepFile != 0)
+        {
+            current = startPhase("runSweep");
+            if (runSweep(sweepFile, sweepThreads, sweepLanes) != 0)
+            {
+                result = 1;
+            }
+            endPhase(current);
+        }
+
+        nativeCode* native = 0;
+        if (execute && jit && !profile && !checkpoints)
+        {
+            current = startPhase("compileNativeCode");
+            native = compileNativeCode();
+            endPhase(current);
+        }
+
+        if (execute)
+        {
+            current = startPhase("runCode");
+            if (checkpoints)
+            {
+                programImage* program = createProgramImage();
+                if (!runCheckpointedImage(program, checkpointFile, resumeFile,
+                                          checkpointInterval))
+                {
+                    result = 1;
+                }
+                freeProgramImage(program);
+            }
+            else if (native != 0)
+            {
+                runNativeCode(native);
+            }
+            else
+            {
+                runCode();
+            }
+            endPhase(current);
+            if (context->budgetExceeded)
+            {
+                result = 1;
+            }
+        }
+
+        if (profile && execute)
+        {
+            current = startPhase("printProfile");
+            printProfile(source);
+            endPhase(current);
+        }
+    }
+
+    closePerfMap();
+
+    if (statistics == 1)
+    {
+        printStatistics();
+    }
+    else if (statistics == 2)
+    {
+        printTrace();
+    }
+    return result != 0;
+}
@@ -0,0 +1,473 @@
+/**
+ * @file mathdh.c
+ * @brief This contains all function implementations of the embeddable
+ *        interface of the library <code>libmathdh</code>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mathdh.h"
+#include "optimizer.h"
+#include "context.h"
+
+/**
+ * This structure defines a compiled program.
+ */
+struct s_mathdhProgram
+{
+    /**
+     * The program image (<code>null</code> if the compilation failed).
+     */
+    programImage* image;
+
+    /**
+     * Pointer to the first error of the compilation.
+     */
+    compilationError* errors;
+
+    /**
+     * Number of entries within errors.
+     */
+    int errorCount;
+};
+
+/**
+ * This structure defines a single execution of a compiled program.
+ */
+struct s_mathdhExecution
+{
+    /**
+     * The executed program.
+     */
+    const mathdhProgram* program;
+
+    /**
+     * Result and variable values of the execution.
+     */
+    imageState* state;
+};
+
+/**
+ * This compiles a program.<BR>
+ * The source code is never written to a file and no output is printed, errors
+ * are only recorded within the program.
+ * @param source The source code of the program (null-terminated).
+ * @param flags  <code>0</code> or MATHDH_OPTIMIZE.
+ * @return The program (<code>null</code> only if no memory is available).
+ *         Use mathdhIsCompiled to check for errors.
+ */
+mathdhProgram* mathdhCompile(const char* source, int flags)
+{
+    mathdhProgram* program = (mathdhProgram*)calloc(1, sizeof(mathdhProgram));
+    if (program == 0)
+    {
+        return 0;
+    }
+
+    // The caller may be in the middle of its own compilation
+    compilationContext* previous = compilation;
+    compilationContext* context = createCompilationContext();
+    context->quiet = 1;
+
+    if (parseProgramText(context, source) == 0)
+    {
+        if (flags & MATHDH_OPTIMIZE)
+        {
+            optimizeCode();
+        }
+        program->image = createProgramImage();
+    }
+
+    // The errors are kept by the program, everything else is freed
+    program->errors = context->errors;
+    context->errors = 0;
+    compilationError* error;
+    for (error = program->errors; error != 0; error = error->next)
+    {
+        program->errorCount++;
+    }
+    freeCompilationContext(context);
+    useCompilationContext(previous);
+
+    return program;
+}
+
+/**
+ * Determines whether a program has been compiled successfully.
+ * @param program The program.
+ * @return <code>1</code> if the program can be executed.<BR>
+ *         <code>0</code> otherwise (see mathdhGetErrorMessage).
+ */
+int mathdhIsCompiled(const mathdhProgram* program)
+{
+    return program->image != 0;
+}
+
+/**
+ * Determines the number of errors of the compilation.
+ * @param program The program.
+ * @return The number of errors.
+ */
+int mathdhGetErrorCount(const mathdhProgram* program)
+{
+    return program->errorCount;
+}
+
+/**
+ * Determines the message of an error of the compilation.
+ * @param program The program.
+ * @param index   Index of the error (<code>0</code> is the first error).
+ * @return The message (<code>null</code> for an invalid index).
+ */
+const char* mathdhGetErrorMessage(const mathdhProgram* program, int index)
+{
+    compilationError* error = program->errors;
+    while ((error != 0) && (index-- > 0))
+    {
+        error = error->next;
+    }
+    return ((error != 0) && (index == -1)) ? error->message : 0;
+}
+
+/**
+ * Determines the source code line of an error of the compilation.
+ * @param program The program.
+ * @param index   Index of the error (<code>0</code> is the first error).
+ * @return The line (<code>0</code> for an invalid index).
+ */
+int mathdhGetErrorLine(const mathdhProgram* program, int index)
+{
+    compilationError* error = program->errors;
+    while ((error != 0) && (index-- > 0))
+    {
+        error = error->next;
+    }
+    return ((error != 0) && (index == -1)) ? error->line : 0;
+}
+
+/**
+ * Determines the number of variables of a compiled program.<BR>
+ * This includes the helper variables of the compiler (named
+ * <code>_H</code>...).
+ * @param program The program.
+ * @return The number of variables (<code>0</code> if the program has not been
+ *         compiled).
+ */
+int mathdhGetVariableCount(const mathdhProgram* program)
+{
+    return (program->image != 0) ? program->image->header->symbolCount : 0;
+}
+
+/**
+ * Determines the name of a variable.
+ * @param program The program.
+ * @param index   Index of the variable.
+ * @return The name (<code>null</code> for an invalid index).
+ */
+const char* mathdhGetVariableName(const mathdhProgram* program, int index)
+{
+    if ((index < 0) || (index >= mathdhGetVariableCount(program)))
+    {
+        return 0;
+    }
+    return program->image->symbols[index].name;
+}
+
+/**
+ * Determines the data type of a variable.
+ * @param program The program.
+ * @param index   Index of the variable.
+ * @return The data type (MATHDH_NONE for an invalid index).
+ */
+mathdhType mathdhGetVariableType(const mathdhProgram* program, int index)
+{
+    if ((index < 0) || (index >= mathdhGetVariableCount(program)))
+    {
+        return MATHDH_NONE;
+    }
+    // The data types are declared in the same order as dataType
+    return (mathdhType)(program->image->symbols[index].type + 1);
+}
+
+/**
+ * Searches a variable by its name.
+ * @param program The program.
+ * @param name    Name of the variable.
+ * @return Index of the variable (<code>-1</code> if it does not exist).
+ */
+int mathdhFindVariable(const mathdhProgram* program, const char* name)
+{
+    int count = mathdhGetVariableCount(program);
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        if (strcmp(program->image->symbols[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * This executes a compiled program until its end.
+ * @param program The compiled program.
+ * @return The execution, which keeps the result and the variable values
+ *         (<code>null</code> if the program has not been compiled).
+ */
+mathdhExecution* mathdhExecute(const mathdhProgram* program)
+{
+    mathdhExecution* execution = mathdhStart(program);
+    if (execution != 0)
+    {
+        mathdhContinue(execution, -1);
+    }
+    return execution;
+}
+
+/**
+ * This prepares the execution of a compiled program without executing any
+ * instruction (see mathdhContinue).
+ * @param program The compiled program.
+ * @return The execution (<code>null</code> if the program has not been
+ *         compiled).
+ */
+mathdhExecution* mathdhStart(const mathdhProgram* program)
+{
+    if (program->image == 0)
+    {
+        return 0;
+    }
+
+    // The image is only read, so it is shared by all executions
+    mathdhExecution* execution = (mathdhExecution*)
+                                 malloc(sizeof(mathdhExecution));
+    execution->program = program;
+    execution->state = createImageState(program->image);
+
+    // A division fault must not raise SIGFPE within the host process
+    execution->state->guarded = 1;
+    return execution;
+}
+
+/**
+ * This continues an execution for a limited number of instructions, so that
+ * a thread can alternate between several executions and a long running loop
+ * does not block the other programs.<BR>
+ * The number is only checked at the end of loop iterations.
+ * @param execution The execution created by mathdhStart.
+ * @param quantum   Number of instructions (<code>-1</code> for no limit).
+ * @return <code>1</code> if the program has finished.<BR>
+ *         <code>0</code> if it needs to be continued.
+ */
+int mathdhContinue(mathdhExecution* execution, long quantum)
+{
+    if (execution->state->exceeded)
+    {
+        return 1;
+    }
+    return executeProgramImageSlice(execution->state, quantum);
+}
+
+/**
+ * This limits an execution. Like the quantum of mathdhContinue, the limits
+ * are only checked at the end of loop iterations.
+ * @param execution    The execution created by mathdhStart.
+ * @param instructions Maximum number of executed instructions
+ *                     (<code>0</code> for no limit).
+ * @param seconds      Maximum execution time starting now (<code>0</code>
+ *                     for no limit).
+ */
+void mathdhSetBudget(mathdhExecution* execution, long instructions,
+                     double seconds)
+{
+    setImageBudget(execution->state, instructions, seconds);
+}
+
+/**
+ * Determines why an execution has been stopped before the end of the
+ * program.<BR>
+ * A stopped execution cannot be continued, its variables keep the values at
+ * the time of the stop.
+ * @param execution The execution.
+ * @return The reason (MATHDH_NOT_STOPPED if the execution has not been
+ *         stopped).
+ */
+mathdhStop mathdhGetStopReason(const mathdhExecution* execution)
+{
+    // The reasons are declared in the same order as the BUDGET_ constants
+    return (mathdhStop)execution->state->exceeded;
+}
+
+/**
+ * Determines the source code line at which an execution has been stopped.
+ * @param execution The execution.
+ * @return The line (<code>0</code> if the execution has not been stopped).
+ */
+int mathdhGetStopLine(const mathdhExecution* execution)
+{
+    if (!execution->state->exceeded)
+    {
+        return 0;
+    }
+    return getImageSourceLine(execution->program->image,
+                              execution->state->exceededAt);
+}
+
+/**
+ * Determines the number of instructions executed so far.
+ * @param execution The execution.
+ * @return The number of instructions.
+ */
+long mathdhGetInstructionCount(const mathdhExecution* execution)
+{
+    return execution->state->executed;
+}
+
+/**
+ * Determines the data type of the value returned by the program.
+ * @param execution The execution.
+ * @return The data type (MATHDH_NONE if no value has been returned).
+ */
+mathdhType mathdhGetResultType(const mathdhExecution* execution)
+{
+    // imageState.resultType is the data type increased by one as well
+    return (mathdhType)execution->state->resultType;
+}
+
+/**
+ * Determines the value returned by the program as integer.
+ * @param execution The execution.
+ * @return The value (REAL values are truncated).
+ */
+int mathdhGetResultInt(const mathdhExecution* execution)
+{
+    if (execution->state->resultType == MATHDH_REAL)
+    {
+        return (int)execution->state->result.floatValue;
+    }
+    return execution->state->result.intValue;
+}
+
+/**
+ * Determines the value returned by the program as float.
+ * @param execution The execution.
+ * @return The value.
+ */
+double mathdhGetResultReal(const mathdhExecution* execution)
+{
+    if (execution->state->resultType == MATHDH_REAL)
+    {
+        return execution->state->result.floatValue;
+    }
+    return execution->state->result.intValue;
+}
+
+/**
+ * Determines the value returned by the program as boolean.
+ * @param execution The execution.
+ * @return <code>1</code> for <code>true</code>, <code>0</code> otherwise.
+ */
+int mathdhGetResultBool(const mathdhExecution* execution)
+{
+    return mathdhGetResultReal(execution) != 0;
+}
+
+/**
+ * Determines whether a variable has been written by the execution.
+ * @param execution The execution.
+ * @param index     Index of the variable (see mathdhFindVariable).
+ * @return <code>1</code> if the variable has a value, <code>0</code>
+ *         otherwise.
+ */
+int mathdhIsWritten(const mathdhExecution* execution, int index)
+{
+    if ((index < 0)
+        || (index >= mathdhGetVariableCount(execution->program)))
+    {
+        return 0;
+    }
+    return execution->state->sequence[index] != 0;
+}
+
+/**
+ * Determines the value of a variable as integer.
+ * @param execution The execution.
+ * @param index     Index of the variable (see mathdhFindVariable).
+ * @return The value (REAL values are truncated, <code>0</code> for an invalid
+ *         index).
+ */
+int mathdhGetInt(const mathdhExecution* execution, int index)
+{
+    return (int)mathdhGetReal(execution, index);
+}
+
+/**
+ * Determines the value of a variable as float.
+ * @param execution The execution.
+ * @param index     Index of the variable (see mathdhFindVariable).
+ * @return The value (<code>0</code> for an invalid index).
+ */
+double mathdhGetReal(const mathdhExecution* execution, int index)
+{
+    switch (mathdhGetVariableType(execution->program, index))
+    {
+        case MATHDH_REAL:
+            return execution->state->values[index].floatValue;
+        case MATHDH_INTEGER:
+        case MATHDH_BOOLEAN:
+            return execution->state->values[index].intValue;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Determines the value of a variable as boolean.
+ * @param execution The execution.
+ * @param index     Index of the variable (see mathdhFindVariable).
+ * @return <code>1</code> for <code>true</code>, <code>0</code> otherwise.
+ */
+int mathdhGetBool(const mathdhExecution* execution, int index)
+{
+    return mathdhGetReal(execution, index) != 0;
+}
+
+/**
+ * This frees an execution.
+ * @param execution The execution created by mathdhExecute.
+ */
+void mathdhFreeExecution(mathdhExecution* execution)
+{
+    if (execution != 0)
+    {
+        freeImageState(execution->state);
+        free(execution);
+    }
+}
+
+/**
+ * This frees a program.<BR>
+ * All executions of the program need to be freed before.
+ * @param program The program created by mathdhCompile.
+ */
+void mathdhFreeProgram(mathdhProgram* program)
+{
+    if (program == 0)
+    {
+        return;
+    }
+    compilationError* error = program->errors;
+    while (error != 0)
+    {
+        compilationError* next = error->next;
+        free(error->message);
+        free(error);
+        error = next;
+    }
+    if (program->image != 0)
+    {
+        freeProgramImage(program->image);
+    }
+    free(program);
+}
@@ -0,0 +1,322 @@
+/**
+ * @file mathdh.h
+ * @brief This defines the embeddable interface of the library
+ *        <code>libmathdh</code>: a program is compiled once from a source
+ *        buffer and can then be executed any number of times without
+ *        touching the filesystem.<BR>
+ *        Programs are compiled within their own compilation context, so
+ *        several threads may compile at the same time. A compiled program is
+ *        read-only, so it may be executed by several threads at the same time
+ *        as long as every thread uses its own execution.
+ */
+
+#ifndef MATHDH_H_
+#define MATHDH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Flag for mathdhCompile to run all optimization passes on the program.
+ */
+#define MATHDH_OPTIMIZE 1
+
+/**
+ * This enumeration contains the data types of variables and of the program
+ * result.
+ */
+enum e_mathdhType
+{
+    /**
+     * No value (e.g. the program has not returned a value).
+     */
+    MATHDH_NONE,
+
+    /**
+     * Integer numbers.
+     */
+    MATHDH_INTEGER,
+
+    /**
+     * Floating point numbers.
+     */
+    MATHDH_REAL,
+
+    /**
+     * Boolean values.
+     */
+    MATHDH_BOOLEAN
+};
+
+/**
+ * Type definition to simplify usage of the enumeration (declared after the
+ * enumeration, as C++ does not allow to declare it in advance).
+ */
+typedef enum e_mathdhType mathdhType;
+
+/**
+ * This enumeration contains the reasons for stopping an execution before the
+ * end of the program.
+ */
+enum e_mathdhStop
+{
+    /**
+     * The execution has not been stopped.
+     */
+    MATHDH_NOT_STOPPED,
+
+    /**
+     * The instruction budget has been exceeded (see mathdhSetBudget).
+     */
+    MATHDH_INSTRUCTIONS,
+
+    /**
+     * The time limit has been exceeded (see mathdhSetBudget).
+     */
+    MATHDH_TIME,
+
+    /**
+     * INTEGER division by zero or overflow of an INTEGER division.
+     */
+    MATHDH_FAULT
+};
+
+/**
+ * Type definition to simplify usage of the enumeration.
+ */
+typedef enum e_mathdhStop mathdhStop;
+
+/**
+ * A compiled program (or the diagnostics of a failed compilation).
+ */
+typedef struct s_mathdhProgram mathdhProgram;
+
+/**
+ * A single execution of a compiled program including its variable values.
+ */
+typedef struct s_mathdhExecution mathdhExecution;
+
+/**
+ * This compiles a program.<BR>
+ * The source code is never written to a file and no output is printed, errors
+ * are only recorded within the program.
+ * @param source The source code of the program (null-terminated).
+ * @param flags  <code>0</code> or MATHDH_OPTIMIZE.
+ * @return The program (<code>null</code> only if no memory is available).
+ *         Use mathdhIsCompiled to check for errors.
+ */
+mathdhProgram* mathdhCompile(const char* source, int flags);
+
+/**
+ * Determines whether a program has been compiled successfully.
+ * @param program The program.
+ * @return <code>1</code> if the program can be executed.<BR>
+ *         <code>0</code> otherwise (see mathdhGetErrorMessage).
+ */
+int mathdhIsCompiled(const mathdhProgram* program);
+
+/**
+ * Determines the number of errors of the compilation.
+ * @param program The program.
+ * @return The number of errors.
+ */
+int mathdhGetErrorCount(const mathdhProgram* program);
+
+/**
+ * Determines the message of an error of the compilation.
+ * @param program The program.
+ * @param index   Index of the error (<code>0</code> is the first error).
+ * @return The message (<code>null</code> for an invalid index).
+ */
+const char* mathdhGetErrorMessage(const mathdhProgram* program, int index);
+
+/**
+ * Determines the source code line of an error of the compilation.
+ * @param program The program.
+ * @param index   Index of the error (<code>0</code> is the first error).
+ * @return The line (<code>0</code> for an invalid index).
+ */
+int mathdhGetErrorLine(const mathdhProgram* program, int index);
+
+/**
+ * Determines the number of variables of a compiled program.<BR>
+ * This includes the helper variables of the compiler (named
+ * <code>_H</code>...).
+ * @param program The program.
+ * @return The number of variables (<code>0</code> if the program has not been
+ *         compiled).
+ */
+int mathdhGetVariableCount(const mathdhProgram* program);
+
+/**
+ * Determines the name of a variable.
+ * @param program The program.
+ * @param index   Index of the variable.
+ * @return The name (<code>null</code> for an invalid index).
+ */
+const char* mathdhGetVariableName(const mathdhProgram* program, int index);
+
+/**
+ * Determines the data type of a variable.
+ * @param program The program.
+ * @param index   Index of the variable.
+ * @return The data type (MATHDH_NONE for an invalid index).
+ */
+mathdhType mathdhGetVariableType(const mathdhProgram* program, int index);
+
+/**
+ * Searches a variable by its name.
+ * @param program The program.
+ * @param name    Name of the variable.
+ * @return Index of the variable (<code>-1</code> if it does not exist).
+ */
+int mathdhFindVariable(const mathdhProgram* program, const char* name);
+
+/**
+ * This executes a compiled program until its end.
+ * @param program The compiled program.
+ * @return The execution, which keeps the result and the variable values
+ *         (<code>null</code> if the program has not been compiled).
+ */
+mathdhExecution* mathdhExecute(const mathdhProgram* program);
+
+/**
+ * This prepares the execution of a compiled program without executing any
+ * instruction (see mathdhContinue).
+ * @param program The compiled program.
+ * @return The execution (<code>null</code> if the program has not been
+ *         compiled).
+ */
+mathdhExecution* mathdhStart(const mathdhProgram* program);
+
+/**
+ * This continues an execution for a limited number of instructions, so that
+ * a thread can alternate between several executions and a long running loop
+ * does not block the other programs.<BR>
+ * The number is only checked at the end of loop iterations.
+ * @param execution The execution created by mathdhStart.
+ * @param quantum   Number of instructions (<code>-1</code> for no limit).
+ * @return <code>1</code> if the program has finished or has been stopped
+ *         (see mathdhGetStopReason).<BR>
+ *         <code>0</code> if it needs to be continued.
+ */
+int mathdhContinue(mathdhExecution* execution, long quantum);
+
+/**
+ * This limits an execution. Like the quantum of mathdhContinue, the limits
+ * are only checked at the end of loop iterations.
+ * @param execution    The execution created by mathdhStart.
+ * @param instructions Maximum number of executed instructions
+ *                     (<code>0</code> for no limit).
+ * @param seconds      Maximum execution time starting now (<code>0</code>
+ *                     for no limit).
+ */
+void mathdhSetBudget(mathdhExecution* execution, long instructions,
+                     double seconds);
+
+/**
+ * Determines why an execution has been stopped before the end of the
+ * program.<BR>
+ * A stopped execution cannot be continued, its variables keep the values at
+ * the time of the stop.
+ * @param execution The execution.
+ * @return The reason (MATHDH_NOT_STOPPED if the execution has not been
+ *         stopped).
+ */
+mathdhStop mathdhGetStopReason(const mathdhExecution* execution);
+
+/**
+ * Determines the source code line at which an execution has been stopped.
+ * @param execution The execution.
+ * @return The line (<code>0</code> if the execution has not been stopped).
+ */
+int mathdhGetStopLine(const mathdhExecution* execution);
+
+/**
+ * Determines the number of instructions executed so far.
+ * @param execution The execution.
+ * @return The number of instructions.
+ */
+long mathdhGetInstructionCount(const mathdhExecution* execution);
+
+/**
+ * Determines the data type of the value returned by the program.
+ * @param execution The execution.
+ * @return The data type (MATHDH_NONE if no value has been returned).
+ */
+mathdhType mathdhGetResultType(const mathdhExecution* execution);
+
+/**
+ * Determines the value returned by the program as integer.
+ * @param execution The execution.
+ * @return The value (REAL values are truncated).
+ */
+int mathdhGetResultInt(const mathdhExecution* execution);
+
+/**
+ * Determines the value returned by the program as float.
+ * @param execution The execution.
+ * @return The value.
+ */
+double mathdhGetResultReal(const mathdhExecution* execution);
+
+/**
+ * Determines the value returned by the program as boolean.
+ * @param execution The execution.
+ * @return <code>1</code> for <code>true</code>, <code>0</code> otherwise.
+ */
+int mathdhGetResultBool(const mathdhExecution* execution);
+
+/**
+ * Determines whether a variable has been written by the execution.
+ * @param execution The execution.
+ * @param index     Index of the variable (see mathdhFindVariable).
+ * @return <code>1</code> if the variable has a value, <code>0</code>
+ *         otherwise.
+ */
+int mathdhIsWritten(const mathdhExecution* execution, int index);
+
+/**
+ * Determines the value of a variable as integer.
+ * @param execution The execution.
+ * @param index     Index of the variable (see mathdhFindVariable).
+ * @return The value (REAL values are truncated, <code>0</code> for an invalid
+ *         index).
+ */
+int mathdhGetInt(const mathdhExecution* execution, int index);
+
+/**
+ * Determines the value of a variable as float.
+ * @param execution The execution.
+ * @param index     Index of the variable (see mathdhFindVariable).
+ * @return The value (<code>0</code> for an invalid index).
+ */
+double mathdhGetReal(const mathdhExecution* execution, int index);
+
+/**
+ * Determines the value of a variable as boolean.
+ * @param execution The execution.
+ * @param index     Index of the variable (see mathdhFindVariable).
+ * @return <code>1</code> for <code>true</code>, <code>0</code> otherwise.
+ */
+int mathdhGetBool(const mathdhExecution* execution, int index);
+
+/**
+ * This frees an execution.
+ * @param execution The execution created by mathdhExecute.
+ */
+void mathdhFreeExecution(mathdhExecution* execution);
+
+/**
+ * This frees a program.<BR>
+ * All executions of the program need to be freed before.
+ * @param program The program created by mathdhCompile.
+ */
+void mathdhFreeProgram(mathdhProgram* program);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*MATHDH_H_*/
@@ -0,0 +1,1122 @@
+/**
+ * @file optimizer.c
+ * @brief This contains all function implementations for optimizing the
+ *        intermediate code.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "optimizer.h"
+#include "generator.h"
+#include "symboltable.h"
+#include "compiler.h"
+#include "context.h"
+#include "image.h"
+
+/**
+ * Variable to enable/disable debug mode.<BR>
+ * [defined in file compiler.c]
+ */
+extern int debug;
+
+/**
+ * Maximum number of instructions executed by a program.<BR>
+ * [defined in file compiler.c]
+ */
+extern long instructionBudget;
+
+/**
+ * This runs all optimization passes on the intermediate code.<BR>
+ * Note: This needs to be called after complete parsing and before the
+ *       intermediate code is printed or executed.
+ */
+void optimizeCode()
+{
+    // Counted loops are recognized in their original form, then rotation
+    // needs to be done, so that the conditions at the end of the rotated loop
+    // bodies can be fused as well
+    loopState* state = createLoopState(0);
+    int replaced = replaceInductionLoops(&compilation->codeList, state);
+    freeLoopState(state);
+    int rotated = rotateLoops(&compilation->codeList);
+    int fused = fuseCompareAndBranch(&compilation->codeList);
+    compilation->optimized = 1;
+    
+    if (debug > 0)
+    {
+        printf("Optimizer: %d closed-form loops\n", replaced);
+        printf("Optimizer: %d rotated loops\n", rotated);
+        printf("Optimizer: %d compare-and-branch superinstructions\n", fused);
+    }
+}
+
+/**
+ * Determines whether an operation is a numeric comparison.
+ * @param op The operation to be checked.
+ * @return <code>1</code> for OP_EQUAL, OP_NOT_EQUAL, OP_LESS_OR_EQUAL,
+ *         OP_GREATER_OR_EQUAL, OP_GREATER and OP_LESS.<BR>
+ *         <code>0</code> otherwise.
+ */
+int isNumericComparison(operation op)
+{
+    return (op == OP_EQUAL) || (op == OP_NOT_EQUAL) ||
+           (op == OP_LESS_OR_EQUAL) || (op == OP_GREATER_OR_EQUAL) ||
+           (op == OP_GREATER) || (op == OP_LESS);
+}
+
+/**
+ * This rotates all WHILE loops into a guarded bottom-tested form:<BR>
+ * <code>MARKER; cond; WHILE c DO body END</code> becomes
+ * <code>cond; IF c THEN DO body; cond WHILE c END</code>.<BR>
+ * The condition is calculated once per loop at the end of the loop body and
+ * the loop needs a single backward branch only. The WHILE markers are removed.
+ * <BR>Nested code lists are processed recursively.
+ * @param list Reference to the pointer to the first entry of the code list.
+ *             <BR>The pointer is updated if the first entry is removed.
+ * @return The number of rotated loops.
+ */
+int rotateLoops(codeEntry** list)
+{
+    int rotated = 0;
+    codeEntry** link = list;
+    codeEntry** markerLink = 0;
+    
+    while (*link != 0)
+    {
+        codeEntry* entry = *link;
+        
+        // Process nested structures first
+        if (entry->sub_1 != 0)
+        {
+            rotated += rotateLoops(&entry->sub_1);
+        }
+        if (entry->sub_2 != 0)
+        {
+            rotated += rotateLoops(&entry->sub_2);
+        }
+        
+        if (entry->op == OP_MARKER_WHILE)
+        {
+            markerLink = link;
+        }
+        else if ((entry->op == OP_WHILE) && (markerLink != 0))
+        {
+            codeEntry* marker = *markerLink;
+            
+            // Create the bottom-tested loop with the original body
+            codeEntry* loop = createCodeEntry(entry->sourceLine, OP_DO_WHILE, 0,
+                                              entry->operand1, 0, 0, 0, 0);
+            loop->parent = entry;
+            loop->sub_1 = entry->sub_1;
+            
+            codeEntry* iterator = loop->sub_1;
+            while (iterator->next != 0)
+            {
+                iterator->parent = loop;
+                iterator = iterator->next;
+            }
+            iterator->parent = loop;
+            
+            // Append a copy of the condition calculation to the body
+            codeEntry* region = marker->next;
+            while (region != entry)
+            {
+                iterator->next = copyCodeEntry(region);
+                iterator = iterator->next;
+                iterator->parent = loop;
+                region = region->next;
+            }
+            
+            // The WHILE statement itself becomes the guard
+            codeEntry* guard = createCodeEntry(entry->sourceLine, OP_NOP, 0, 0,
+                                               0, 0, 0, 0);
+            guard->parent = entry;
+            guard->next = loop;
+            entry->op = OP_IF;
+            entry->sub_1 = guard;
+            
+            // Remove the marker
+            *markerLink = marker->next;
+            free(marker);
+            markerLink = 0;
+            rotated++;
+        }
+        
+        link = &entry->next;
+    }
+    
+    return rotated;
+}
+
+/**
+ * This peephole pass fuses numeric comparisons with the directly following
+ * IF/WHILE statement into compare-and-branch superinstructions
+ * (OP_IF_COMPARE / OP_WHILE_COMPARE). For rotated loops, the comparison at the
+ * end of the loop body is fused into the DO WHILE statement
+ * (OP_DO_WHILE_COMPARE).<BR>
+ * An increment/decrement of one of the compared operands directly in front of
+ * the comparison is fused as well.<BR>
+ * Nested code lists are processed recursively.
+ * @param list Reference to the pointer to the first entry of the code list.
+ *             <BR>The pointer is updated if the first entry is removed.
+ * @return The number of created superinstructions.
+ */
+int fuseCompareAndBranch(codeEntry** list)
+{
+    int fused = 0;
+    
+    // Links (next pointers) referencing the current entry and its two
+    // predecessors, so that fused entries can be removed from the list
+    codeEntry** link = list;
+    codeEntry** compareLink = 0;
+    codeEntry** stepLink = 0;
+    
+    while (*link != 0)
+    {
+        codeEntry* entry = *link;
+        
+        // Process nested structures first
+        if (entry->sub_1 != 0)
+        {
+            fused += fuseCompareAndBranch(&entry->sub_1);
+        }
+        if (entry->sub_2 != 0)
+        {
+            fused += fuseCompareAndBranch(&entry->sub_2);
+        }
+        
+        // The condition of a DO WHILE loop is calculated at the end of its body
+        if (entry->op == OP_DO_WHILE)
+        {
+            codeEntry** bodyLink = &entry->sub_1;
+            codeEntry** bodyCompareLink = 0;
+            codeEntry** bodyStepLink = 0;
+            while (*bodyLink != 0)
+            {
+                bodyStepLink = bodyCompareLink;
+                bodyCompareLink = bodyLink;
+                bodyLink = &(*bodyLink)->next;
+            }
+            fused += fuseCondition(entry, bodyCompareLink, bodyStepLink);
+        }
+        
+        if (((entry->op == OP_IF) || (entry->op == OP_WHILE)) &&
+            fuseCondition(entry, compareLink, stepLink))
+        {
+            // Restart the window behind the superinstruction
+            fused++;
+            compareLink = 0;
+            stepLink = 0;
+            link = &entry->next;
+            continue;
+        }
+        
+        stepLink = compareLink;
+        compareLink = link;
+        link = &entry->next;
+    }
+    
+    return fused;
+}
+
+/**
+ * This fuses a numeric comparison (and an optional increment/decrement in
+ * front of it) into a control flow statement.
+ * @param branch      The IF/WHILE/DO WHILE code entry reading the result of the
+ *                    comparison.
+ * @param compareLink Reference to the pointer to the comparison entry.<BR>
+ *                    The comparison is removed from its code list when fused.
+ * @param stepLink    Reference to the pointer to the entry in front of the
+ *                    comparison (<code>null</code> if not existing).<BR>
+ *                    The entry is removed from its code list when fused.
+ * @return <code>1</code> if the comparison has been fused.<BR>
+ *         <code>0</code> otherwise.
+ */
+int fuseCondition(codeEntry* branch, codeEntry** compareLink,
+                  codeEntry** stepLink)
+{
+    codeEntry* compare = compareLink ? *compareLink : 0;
+    
+    // The BOOLEAN temporary of the comparison must be the condition
+    if (!compare || !isNumericComparison(compare->op) ||
+        (compare->target != branch->operand1))
+    {
+        return 0;
+    }
+    
+    switch (branch->op)
+    {
+        case OP_IF:
+            branch->op = OP_IF_COMPARE;
+            break;
+        case OP_WHILE:
+            branch->op = OP_WHILE_COMPARE;
+            break;
+        case OP_DO_WHILE:
+            branch->op = OP_DO_WHILE_COMPARE;
+            break;
+        default:
+            return 0;
+    }
+    branch->compare = compare->op;
+    branch->operand1 = compare->operand1;
+    branch->operand2 = compare->operand2;
+    *compareLink = compare->next;
+    free(compare);
+    
+    // Fuse an increment/decrement of a compared operand as well
+    codeEntry* step = stepLink ? *stepLink : 0;
+    if (step && ((step->op == OP_INCREMENT) || (step->op == OP_DECREMENT)) &&
+        ((step->target == branch->operand1) ||
+         (step->target == branch->operand2)))
+    {
+        branch->step = step->op;
+        branch->target = step->target;
+        *stepLink = step->next;
+        free(step);
+    }
+    
+    return 1;
+}
+
+/**
+ * This replaces counted WHILE loops by closed-form updates of their induction
+ * variables.<BR>
+ * A loop qualifies if its condition compares an induction variable (an
+ * INTEGER variable increased by a constant step in every iteration) with a
+ * constant, the start value of the variable is known from the preceding code
+ * and the body contains straight-line code only, in which every other
+ * variable that is read before being written is either loop invariant or an
+ * induction variable as well. The number of iterations is calculated at
+ * compile time and the loop becomes:<BR>
+ * <code>V := V + (n - 1) * step (for every induction variable V); cond;
+ * body; cond</code><BR>
+ * So only the last iteration is executed, which writes all variables in the
+ * same order and with the same final values as the complete loop.<BR>
+ * Nested code lists are processed recursively (inner loops first).
+ * @param list  Reference to the pointer to the first entry of the code list.
+ *              <BR>The pointer is updated if the first entry is replaced.
+ * @param state The variables written and known in front of the code list.
+ *              <BR>The state is updated for the complete code list.
+ * @return The number of replaced loops.
+ */
+int replaceInductionLoops(codeEntry** list, loopState* state)
+{
+    int replaced = 0;
+    codeEntry** link = list;
+    
+    while (*link != 0)
+    {
+        codeEntry* entry = *link;
+        
+        if (entry->op == OP_MARKER_WHILE)
+        {
+            // The calculation of the condition is followed by the loop
+            codeEntry* loop = entry->next;
+            while (loop->op != OP_WHILE)
+            {
+                loop = loop->next;
+            }
+            
+            // The body is entered after the condition has been calculated
+            loopState* nested = createLoopState(state);
+            codeEntry* region;
+            for (region = entry->next; region != loop; region = region->next)
+            {
+                if (region->target != 0)
+                {
+                    nested->written[region->target->index] = 1;
+                }
+            }
+            replaced += replaceInductionLoops(&loop->sub_1, nested);
+            freeLoopState(nested);
+            
+            // The replacement is straight-line code, which is tracked below
+            if (replaceInductionLoop(link, loop, state))
+            {
+                replaced++;
+                continue;
+            }
+            
+            // Only values calculated from constants stay known
+            forgetWrittenValues(entry->next, loop->next, state);
+            for (region = entry->next; region != loop; region = region->next)
+            {
+                trackKnownValue(region, state);
+            }
+            link = &loop->next;
+            continue;
+        }
+        
+        if ((entry->sub_1 != 0) || (entry->sub_2 != 0))
+        {
+            // Nested code is executed conditionally
+            loopState* nested = createLoopState(state);
+            if (entry->sub_1 != 0)
+            {
+                replaced += replaceInductionLoops(&entry->sub_1, nested);
+            }
+            freeLoopState(nested);
+            nested = createLoopState(state);
+            if (entry->sub_2 != 0)
+            {
+                replaced += replaceInductionLoops(&entry->sub_2, nested);
+            }
+            freeLoopState(nested);
+            forgetWrittenValues(entry->sub_1, 0, state);
+            forgetWrittenValues(entry->sub_2, 0, state);
+        }
+        else
+        {
+            trackKnownValue(entry, state);
+        }
+        
+        link = &entry->next;
+    }
+    
+    return replaced;
+}
+
+/**
+ * This replaces a single WHILE loop by closed-form updates of its induction
+ * variables if possible (see replaceInductionLoops).
+ * @param markerLink Reference to the pointer to the WHILE marker.<BR>
+ *                   The pointer is set to the first entry of the replacement.
+ * @param loop       The WHILE code entry.
+ * @param state      The variables written and known in front of the loop.
+ * @return <code>1</code> if the loop has been replaced.<BR>
+ *         <code>0</code> otherwise (the code is not changed).
+ */
+int replaceInductionLoop(codeEntry** markerLink, codeEntry* loop,
+                         loopState* state)
+{
+    codeEntry* marker = *markerLink;
+    int count = state->count;
+    affineValue* values = (affineValue*)calloc(count, sizeof(affineValue));
+    
+    // Per variable: 1 = changed by the loop, 2 = written by the condition,
+    // 4 = written by the body, 8 = value at the start of an iteration read
+    char* flags = (char*)calloc(count, 1);
+    
+    codeEntry* condition = 0;
+    codeEntry* entry;
+    int valid = (marker->next != loop);
+    for (entry = marker->next; valid && (entry != loop); entry = entry->next)
+    {
+        valid = (entry->sub_1 == 0) && (entry->sub_2 == 0);
+        if (entry->target != 0)
+        {
+            flags[entry->target->index] |= 1;
+        }
+        condition = entry;
+    }
+    for (entry = loop->sub_1; valid && (entry != 0); entry = entry->next)
+    {
+        valid = (entry->sub_1 == 0) && (entry->sub_2 == 0);
+        if (entry->target != 0)
+        {
+            flags[entry->target->index] |= 1;
+        }
+    }
+    
+    // The condition needs to be the comparison calculated last
+    affineValue left;
+    affineValue right;
+    memset(&left, 0, sizeof(left));
+    memset(&right, 0, sizeof(right));
+    valid = valid && isNumericComparison(condition->op)
+            && (condition->target == loop->operand1);
+    for (entry = marker->next; valid && (entry != loop); entry = entry->next)
+    {
+        if (entry == condition)
+        {
+            left = readAffineValue(entry->operand1, values, flags, state);
+            right = readAffineValue(entry->operand2, values, flags, state);
+        }
+        valid = evaluateAffineEntry(entry, values, flags, 2, state);
+    }
+    for (entry = loop->sub_1; valid && (entry != 0); entry = entry->next)
+    {
+        valid = evaluateAffineEntry(entry, values, flags, 4, state);
+    }
+    
+    // Every variable read before being written needs to be loop invariant or
+    // an induction variable
+    int i;
+    for (i = 0; valid && (i < count); i++)
+    {
+        if (flags[i] & 8)
+        {
+            valid = !(flags[i] & 2)
+                    && (!(flags[i] & 4)
+                        || (values[i].affine && (values[i].base == i)));
+        }
+    }
+    
+    // Normalize the condition to INDUCTION + OFFSET COMPARE BOUND
+    operation compare = valid ? condition->op : OP_NOP;
+    if (valid && (left.base < 0))
+    {
+        affineValue swap = left;
+        left = right;
+        right = swap;
+        compare = (compare == OP_LESS) ? OP_GREATER
+                  : (compare == OP_GREATER) ? OP_LESS
+                  : (compare == OP_LESS_OR_EQUAL) ? OP_GREATER_OR_EQUAL
+                  : (compare == OP_GREATER_OR_EQUAL) ? OP_LESS_OR_EQUAL
+                  : compare;
+    }
+    valid = valid && left.affine && right.affine && (left.base >= 0)
+            && (right.base < 0) && state->known[left.base];
+    
+    long long iterations = -1;
+    if (valid)
+    {
+        int induction = left.base;
+        long long step = (flags[induction] & 4)
+                         ? (int)values[induction].offset : 0;
+        long long start = state->values[induction];
+        long long offset = (int)left.offset;
+        iterations = countLoopIterations(compare, start + offset, step,
+                                         (int)right.offset);
+        
+        // The induction variable must not overflow within the loop
+        long long end = start + iterations * step;
+        valid = (iterations >= 0) && (start + offset >= INT_MIN)
+                && (start + offset <= INT_MAX) && (end >= INT_MIN)
+                && (end <= INT_MAX) && (end + offset >= INT_MIN)
+                && (end + offset <= INT_MAX);
+    }
+    
+    // The closed-form updates must not change the order of the first writes
+    for (i = 0; valid && (iterations > 1) && (i < count); i++)
+    {
+        if ((flags[i] & 8) && (flags[i] & 4) && values[i].offset)
+        {
+            valid = state->written[i];
+        }
+    }
+    if (!valid)
+    {
+        free(values);
+        free(flags);
+        return 0;
+    }
+    
+    // Closed-form updates up to the start of the last iteration
+    codeEntry* first = 0;
+    codeEntry* last = 0;
+    for (i = 0; (iterations > 1) && (i < count); i++)
+    {
+        unsigned int amount = (unsigned int)((unsigned long long)
+                              (iterations - 1) * (int)values[i].offset);
+        if (!(flags[i] & 8) || !(flags[i] & 4) || (amount == 0))
+        {
+            continue;
+        }
+        if (state->symbols[count - 1] == 0)
+        {
+            state->symbols[count - 1] = addEntryToSymbolTable(getName(),
+                                            INTEGER, loop->sourceLine);
+        }
+        symbolTableEntry* helper = state->symbols[count - 1];
+        codeEntry* constant = createCodeEntry(loop->sourceLine,
+                                              OP_INT_CONSTANT, helper, 0, 0,
+                                              (int)amount, 0, 0);
+        codeEntry* update = createCodeEntry(loop->sourceLine, OP_PLUS,
+                                            state->symbols[i],
+                                            state->symbols[i], helper, 0, 0,
+                                            0);
+        constant->next = update;
+        if (last != 0)
+        {
+            last->next = constant;
+        }
+        else
+        {
+            first = constant;
+        }
+        last = update;
+    }
+    
+    // The condition is calculated in front of and behind the last iteration
+    codeEntry* copy = 0;
+    codeEntry* copyLast = 0;
+    for (entry = marker->next; (iterations > 0) && (entry != loop);
+         entry = entry->next)
+    {
+        codeEntry* duplicate = copyCodeEntry(entry);
+        if (copyLast != 0)
+        {
+            copyLast->next = duplicate;
+        }
+        else
+        {
+            copy = duplicate;
+        }
+        copyLast = duplicate;
+    }
+    if (last != 0)
+    {
+        last->next = marker->next;
+    }
+    else
+    {
+        first = marker->next;
+    }
+    last = condition;
+    
+    codeEntry* body = loop->sub_1;
+    loop->sub_1 = 0;
+    while ((iterations > 0) && (body != 0))
+    {
+        entry = body;
+        body = body->next;
+        if (entry->op == OP_NOP)
+        {
+            free(entry);
+            continue;
+        }
+        last->next = entry;
+        last = entry;
+    }
+    freeCodeList(body);
+    if (copy != 0)
+    {
+        last->next = copy;
+        last = copyLast;
+    }
+    last->next = loop->next;
+    
+    for (entry = first; entry != loop->next; entry = entry->next)
+    {
+        entry->parent = marker->parent;
+    }
+    *markerLink = first;
+    free(marker);
+    free(loop);
+    free(values);
+    free(flags);
+    return 1;
+}
+
+/**
+ * This calculates the value written by a straight-line code entry within one
+ * loop iteration as affine function of the values at the start of the
+ * iteration (see replaceInductionLoop).
+ * @param entry  The code entry.
+ * @param values The values of the variables already written within the
+ *               iteration (updated).
+ * @param flags  The flags of the variables (updated).
+ * @param phase  <code>2</code> for the condition, <code>4</code> for the body.
+ * @param state  The variables known in front of the loop.
+ * @return <code>1</code> if the entry can be executed once instead of in every
+ *         iteration.<BR>
+ *         <code>0</code> otherwise (e.g. a division which might fail in an
+ *         earlier iteration).
+ */
+int evaluateAffineEntry(codeEntry* entry, affineValue* values, char* flags,
+                        int phase, loopState* state)
+{
+    if (entry->op == OP_NOP)
+    {
+        return 1;
+    }
+    
+    affineValue a;
+    affineValue b;
+    affineValue result;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    memset(&result, 0, sizeof(result));
+    if (entry->operand1 != 0)
+    {
+        a = readAffineValue(entry->operand1, values, flags, state);
+    }
+    if (entry->operand2 != 0)
+    {
+        b = readAffineValue(entry->operand2, values, flags, state);
+    }
+    
+    switch (entry->op)
+    {
+        case OP_INT_CONSTANT:
+            result.affine = 1;
+            result.base = -1;
+            result.offset = (unsigned int)entry->integer;
+            break;
+        case OP_FLOAT_CONSTANT:
+        case OP_BOOL_CONSTANT:
+        case OP_EQUAL:
+        case OP_NOT_EQUAL:
+        case OP_LESS_OR_EQUAL:
+        case OP_GREATER_OR_EQUAL:
+        case OP_GREATER:
+        case OP_LESS:
+        case OP_AND:
+        case OP_OR:
+        case OP_NOT:
+            break;
+        case OP_ASSIGN:
+            result = a;
+            break;
+        case OP_INCREMENT:
+        case OP_DECREMENT:
+            result = readAffineValue(entry->target, values, flags, state);
+            result.offset += (entry->op == OP_INCREMENT) ? 1 : -1;
+            break;
+        case OP_PLUS:
+            if (a.affine && b.affine && ((a.base < 0) || (b.base < 0)))
+            {
+                result.affine = 1;
+                result.base = (a.base < 0) ? b.base : a.base;
+                result.offset = a.offset + b.offset;
+            }
+            break;
+        case OP_MINUS:
+            if (a.affine && b.affine && (b.base < 0))
+            {
+                result = a;
+                result.offset = a.offset - b.offset;
+            }
+            break;
+        case OP_MULTIPLY:
+            if (a.affine && b.affine && (a.base < 0) && (b.base < 0))
+            {
+                result = a;
+                result.offset = a.offset * b.offset;
+            }
+            break;
+        case OP_DIVIDE:
+        case OP_MODULO:
+            // Only a constant divisor cannot fail in any iteration
+            if (!b.affine || (b.base >= 0) || ((int)b.offset == 0)
+                || ((int)b.offset == -1))
+            {
+                return 0;
+            }
+            break;
+        default:
+            // Control flow
+            return 0;
+    }
+    
+    int target = entry->target->index;
+    if (entry->target->type != INTEGER)
+    {
+        result.affine = 0;
+    }
+    values[target] = result;
+    flags[target] |= phase;
+    return 1;
+}
+
+/**
+ * This determines the value of a variable within a loop iteration as affine
+ * function of the values at the start of the iteration (see
+ * replaceInductionLoop).
+ * @param symbol The variable.
+ * @param values The values of the variables already written within the
+ *               iteration.
+ * @param flags  The flags of the variables (the start value of the variable
+ *               is marked as read if used).
+ * @param state  The variables known in front of the loop.
+ * @return The value (<code>affine</code> is <code>0</code> if the value is no
+ *         affine INTEGER function).
+ */
+affineValue readAffineValue(symbolTableEntry* symbol, affineValue* values,
+                            char* flags, loopState* state)
+{
+    int index = symbol->index;
+    affineValue value;
+    memset(&value, 0, sizeof(value));
+    
+    // Values written within the iteration, then loop invariant constants
+    if (flags[index] & 6)
+    {
+        return values[index];
+    }
+    if (!(flags[index] & 1) && state->known[index])
+    {
+        value.affine = 1;
+        value.base = -1;
+        value.offset = (unsigned int)state->values[index];
+        return value;
+    }
+    
+    flags[index] |= 8;
+    value.affine = (symbol->type == INTEGER);
+    value.base = index;
+    return value;
+}
+
+/**
+ * Calculates the number of iterations of a loop with the condition
+ * <code>X COMPARE BOUND</code>, where X starts at START and is increased by
+ * STEP in every iteration.
+ * @param compare The numeric comparison.
+ * @param start   The value of X in front of the first iteration.
+ * @param step    The increase of X per iteration.
+ * @param bound   The constant bound.
+ * @return The number of iterations.<BR>
+ *         <code>-1</code> if the loop does not end before X overflows.
+ */
+long long countLoopIterations(operation compare, long long start,
+                              long long step, long long bound)
+{
+    int entered;
+    switch (compare)
+    {
+        case OP_EQUAL:
+            entered = (start == bound);
+            break;
+        case OP_NOT_EQUAL:
+            entered = (start != bound);
+            break;
+        case OP_LESS_OR_EQUAL:
+            entered = (start <= bound);
+            break;
+        case OP_GREATER_OR_EQUAL:
+            entered = (start >= bound);
+            break;
+        case OP_GREATER:
+            entered = (start > bound);
+            break;
+        default:
+            entered = (start < bound);
+            break;
+    }
+    if (!entered)
+    {
+        return 0;
+    }
+    
+    switch (compare)
+    {
+        case OP_EQUAL:
+            return (step != 0) ? 1 : -1;
+        case OP_NOT_EQUAL:
+            if ((step != 0) && ((bound - start) % step == 0)
+                && ((bound - start) / step > 0))
+            {
+                return (bound - start) / step;
+            }
+            return -1;
+        case OP_LESS_OR_EQUAL:
+            return (step > 0) ? (bound - start) / step + 1 : -1;
+        case OP_GREATER_OR_EQUAL:
+            return (step < 0) ? (start - bound) / -step + 1 : -1;
+        case OP_GREATER:
+            return (step < 0) ? (start - bound - step - 1) / -step : -1;
+        default:
+            return (step > 0) ? (bound - start + step - 1) / step : -1;
+    }
+}
+
+/**
+ * This updates the written and known variables for a straight-line code
+ * entry (see replaceInductionLoops).
+ * @param entry The code entry.
+ * @param state The state in front of the entry (updated).
+ */
+void trackKnownValue(codeEntry* entry, loopState* state)
+{
+    if (entry->target == 0)
+    {
+        return;
+    }
+    int target = entry->target->index;
+    int op1 = (entry->operand1 != 0) ? entry->operand1->index : target;
+    int op2 = (entry->operand2 != 0) ? entry->operand2->index : target;
+    int known = 0;
+    unsigned int value = 0;
+    
+    switch (entry->op)
+    {
+        case OP_INT_CONSTANT:
+            known = 1;
+            value = (unsigned int)entry->integer;
+            break;
+        case OP_ASSIGN:
+            known = state->known[op1];
+            value = (unsigned int)state->values[op1];
+            break;
+        case OP_INCREMENT:
+        case OP_DECREMENT:
+            known = state->known[target];
+            value = (unsigned int)state->values[target]
+                    + ((entry->op == OP_INCREMENT) ? 1 : -1);
+            break;
+        case OP_PLUS:
+        case OP_MINUS:
+        case OP_MULTIPLY:
+        {
+            // INTEGER arithmetic wraps around
+            unsigned int a = (unsigned int)state->values[op1];
+            unsigned int b = (unsigned int)state->values[op2];
+            known = state->known[op1] && state->known[op2];
+            value = (entry->op == OP_PLUS) ? a + b
+                    : (entry->op == OP_MINUS) ? a - b : a * b;
+            break;
+        }
+        default:
+            break;
+    }
+    
+    state->written[target] = 1;
+    state->known[target] = known && (entry->target->type == INTEGER);
+    state->values[target] = (int)value;
+}
+
+/**
+ * This marks all variables written by a part of a code list (including
+ * nested code lists) as unknown.
+ * @param list  The first entry.
+ * @param end   The entry behind the last entry (<code>null</code> for the
+ *              complete code list).
+ * @param state The state to be updated.
+ */
+void forgetWrittenValues(codeEntry* list, codeEntry* end, loopState* state)
+{
+    while (list != end)
+    {
+        if (list->target != 0)
+        {
+            state->known[list->target->index] = 0;
+        }
+        forgetWrittenValues(list->sub_1, 0, state);
+        forgetWrittenValues(list->sub_2, 0, state);
+        list = list->next;
+    }
+}
+
+/**
+ * This creates the state of replaceInductionLoops for a code list.
+ * @param parent The state in front of the code list (<code>null</code> for
+ *               the program): the written variables are inherited, but no
+ *               values are known.
+ * @return The new state (to be freed by freeLoopState).
+ */
+loopState* createLoopState(loopState* parent)
+{
+    loopState* state = (loopState*)calloc(1, sizeof(loopState));
+    if (parent != 0)
+    {
+        state->count = parent->count;
+        state->symbols = parent->symbols;
+        state->parent = parent;
+    }
+    else
+    {
+        // One additional variable for the closed-form updates
+        symbolTableEntry* symbol;
+        for (symbol = compilation->symbolTable; symbol != 0;
+             symbol = symbol->next)
+        {
+            state->count = symbol->index + 2;
+        }
+        state->symbols = (symbolTableEntry**)calloc(state->count + 1,
+                                                    sizeof(symbolTableEntry*));
+        for (symbol = compilation->symbolTable; symbol != 0;
+             symbol = symbol->next)
+        {
+            state->symbols[symbol->index] = symbol;
+        }
+    }
+    
+    state->written = (char*)calloc(state->count + 1, 1);
+    state->known = (char*)calloc(state->count + 1, 1);
+    state->values = (int*)calloc(state->count + 1, sizeof(int));
+    if (parent != 0)
+    {
+        memcpy(state->written, parent->written, state->count);
+    }
+    return state;
+}
+
+/**
+ * This frees a state created by createLoopState.
+ * @param state The state.
+ */
+void freeLoopState(loopState* state)
+{
+    if (state->parent == 0)
+    {
+        free(state->symbols);
+    }
+    free(state->written);
+    free(state->known);
+    free(state->values);
+    free(state);
+}
+
+/**
+ * This executes the whole program at compile time (by the image executor)
+ * and replaces the intermediate code by its outcome: one constant for every
+ * written variable in the order of the first writes (so the variable table
+ * stays the same) and the program result.<BR>
+ * The code is kept if the program declares inputs, does not finish within the
+ * budget, divides an INTEGER by zero (or overflows) or calculates a REAL value
+ * which has no exact FLOAT constant.
+ * @param budget Maximum number of executed instructions.
+ * @return <code>1</code> if the code has been replaced.<BR>
+ *         <code>0</code> otherwise.
+ */
+int evaluateProgram(long budget)
+{
+    // The values of inputs are only known when the program is executed
+    if (compilation->inputVariables != 0)
+    {
+        if (debug > 0)
+        {
+            printf("Evaluator: program has inputs\n");
+        }
+        return 0;
+    }
+    
+    programImage* image = createProgramImage();
+    imageState* state = createImageState(image);
+    state->guarded = 1;
+    setImageBudget(state, budget, 0);
+    executeProgramImage(state);
+    
+    // A program stopped by its own budget needs to be stopped at runtime
+    int count = image->header->symbolCount;
+    int folded = !state->exceeded
+                 && ((instructionBudget <= 0)
+                     || (state->executed < instructionBudget));
+    int resultSymbol = -1;
+    int i;
+    for (i = 0; folded && (i < count); i++)
+    {
+        if (state->sequence[i] == 0)
+        {
+            continue;
+        }
+        if (image->symbols[i].type == REAL)
+        {
+            double value = state->values[i].floatValue;
+            folded = ((double)(float)value == value);
+        }
+        // The result is set by any variable of its type
+        if ((int)image->symbols[i].type + 1 == state->resultType)
+        {
+            resultSymbol = i;
+        }
+    }
+    if (folded && (state->resultType == REAL + 1))
+    {
+        double value = state->result.floatValue;
+        folded = ((double)(float)value == value);
+    }
+    if (state->resultType != 0)
+    {
+        folded &= (resultSymbol >= 0);
+    }
+    
+    if (debug > 0)
+    {
+        if (state->exceeded == BUDGET_FAULT)
+        {
+            printf("Evaluator: division fault at line %d\n",
+                   getImageSourceLine(image, state->exceededAt));
+        }
+        else if (state->exceeded)
+        {
+            printf("Evaluator: budget of %ld instructions exceeded\n",
+                   budget);
+        }
+        else
+        {
+            printf("Evaluator: %ld instructions executed, %s\n",
+                   state->executed, folded ? "code replaced"
+                                           : "values not representable");
+        }
+    }
+    
+    if (folded)
+    {
+        // The code entries need the symbols of the compilation
+        symbolTableEntry** symbols = (symbolTableEntry**)calloc(count + 1,
+                                         sizeof(symbolTableEntry*));
+        symbolTableEntry* symbol;
+        for (symbol = compilation->symbolTable; symbol != 0;
+             symbol = symbol->next)
+        {
+            symbols[symbol->index] = symbol;
+        }
+        int* order = (int*)calloc(state->counter + 1, sizeof(int));
+        for (i = 0; i < count; i++)
+        {
+            if (state->sequence[i] > 0)
+            {
+                order[state->sequence[i] - 1] = i;
+            }
+        }
+        
+        freeCodeList(compilation->codeList);
+        compilation->codeList = 0;
+        compilation->currentCodeEntry = 0;
+        compilation->currentContext = 0;
+        for (i = 0; i < state->counter; i++)
+        {
+            appendEvaluatedValue(symbols[order[i]], state->values[order[i]]);
+        }
+        
+        // EXIT does not end the program, so the result may differ from the
+        // final value of the variable
+        if (state->resultType != 0)
+        {
+            symbol = symbols[resultSymbol];
+            imageValue final = state->values[resultSymbol];
+            int same = (symbol->type == REAL)
+                       ? (final.floatValue == state->result.floatValue)
+                       : (final.intValue == state->result.intValue);
+            if (!same)
+            {
+                appendEvaluatedValue(symbol, state->result);
+            }
+            appendCodeEntry(createCodeEntry(symbol->line, OP_EXIT, 0, symbol,
+                                            0, 0, 0, 0));
+            if (!same)
+            {
+                appendEvaluatedValue(symbol, final);
+            }
+        }
+        free(order);
+        free(symbols);
+    }
+    
+    freeImageState(state);
+    freeProgramImage(image);
+    return folded;
+}
+
+/**
+ * This appends the assignment of a constant value to a variable to the
+ * program flow (see evaluateProgram).
+ * @param symbol The variable.
+ * @param value  The value (of the data type of the variable).
+ */
+void appendEvaluatedValue(symbolTableEntry* symbol, imageValue value)
+{
+    codeEntry* entry;
+    if (symbol->type == REAL)
+    {
+        entry = createCodeEntry(symbol->line, OP_FLOAT_CONSTANT, symbol, 0, 0,
+                                0, (float)value.floatValue, 0);
+    }
+    else if (symbol->type == BOOLEAN)
+    {
+        entry = createCodeEntry(symbol->line, OP_BOOL_CONSTANT, symbol, 0, 0,
+                                0, 0, value.intValue);
+    }
+    else
+    {
+        entry = createCodeEntry(symbol->line, OP_INT_CONSTANT, symbol, 0, 0,
+                                value.intValue, 0, 0);
+    }
+    appendCodeEntry(entry);
+}
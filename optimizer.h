@@ -0,0 +1,294 @@
+/**
+ * @file optimizer.h
+ * @brief This defines all functions for optimizing the intermediate code.
+ */
+
+#include "generator.h"
+#include "symboltable.h"
+#include "compiler.h"
+#include "image.h"
+#include <stdio.h>
+
+#ifndef OPTIMIZER_H_
+#define OPTIMIZER_H_
+
+/**
+ * Default number of instructions executed by evaluateProgram.
+ */
+#define EVALUATION_BUDGET 1000000
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_affineValue affineValue;
+
+/**
+ * This structure describes the value of an INTEGER variable within a loop
+ * iteration as affine function <code>BASE + OFFSET</code> of the value of a
+ * variable at the start of the iteration (see replaceInductionLoops).
+ */
+struct s_affineValue
+{
+    /**
+     * <code>1</code> if the value is an affine function, <code>0</code> if it
+     * is unknown.
+     */
+    int affine;
+    
+    /**
+     * Symbol index of the variable whose start value is added
+     * (<code>-1</code> for a constant).
+     */
+    int base;
+    
+    /**
+     * The constant part (wraps around like INTEGER arithmetic).
+     */
+    unsigned int offset;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_loopState loopState;
+
+/**
+ * This structure contains the variables written and known in front of a code
+ * entry while replaceInductionLoops processes a code list.
+ */
+struct s_loopState
+{
+    /**
+     * Number of variables, including an additional helper variable for the
+     * closed-form updates.
+     */
+    int count;
+    
+    /**
+     * The variables by symbol index (shared by all states, the helper
+     * variable is created when needed).
+     */
+    symbolTableEntry** symbols;
+    
+    /**
+     * Per variable: <code>1</code> if it is written on every path.
+     */
+    char* written;
+    
+    /**
+     * Per variable: <code>1</code> if its INTEGER value is known.
+     */
+    char* known;
+    
+    /**
+     * The known values.
+     */
+    int* values;
+    
+    /**
+     * The state of the enclosing code list (<code>null</code> for the
+     * program).
+     */
+    loopState* parent;
+};
+
+/**
+ * This runs all optimization passes on the intermediate code.<BR>
+ * Note: This needs to be called after complete parsing and before the
+ *       intermediate code is printed or executed.
+ */
+void optimizeCode();
+
+/**
+ * Determines whether an operation is a numeric comparison.
+ * @param op The operation to be checked.
+ * @return <code>1</code> for OP_EQUAL, OP_NOT_EQUAL, OP_LESS_OR_EQUAL,
+ *         OP_GREATER_OR_EQUAL, OP_GREATER and OP_LESS.<BR>
+ *         <code>0</code> otherwise.
+ */
+int isNumericComparison(operation op);
+
+/**
+ * This rotates all WHILE loops into a guarded bottom-tested form:<BR>
+ * <code>MARKER; cond; WHILE c DO body END</code> becomes
+ * <code>cond; IF c THEN DO body; cond WHILE c END</code>.<BR>
+ * The condition is calculated once per loop at the end of the loop body and
+ * the loop needs a single backward branch only. The WHILE markers are removed.
+ * <BR>Nested code lists are processed recursively.
+ * @param list Reference to the pointer to the first entry of the code list.
+ *             <BR>The pointer is updated if the first entry is removed.
+ * @return The number of rotated loops.
+ */
+int rotateLoops(codeEntry** list);
+
+/**
+ * This peephole pass fuses numeric comparisons with the directly following
+ * IF/WHILE statement into compare-and-branch superinstructions
+ * (OP_IF_COMPARE / OP_WHILE_COMPARE). For rotated loops, the comparison at the
+ * end of the loop body is fused into the DO WHILE statement
+ * (OP_DO_WHILE_COMPARE).<BR>
+ * An increment/decrement of one of the compared operands directly in front of
+ * the comparison is fused as well.<BR>
+ * Nested code lists are processed recursively.
+ * @param list Reference to the pointer to the first entry of the code list.
+ *             <BR>The pointer is updated if the first entry is removed.
+ * @return The number of created superinstructions.
+ */
+int fuseCompareAndBranch(codeEntry** list);
+
+/**
+ * This fuses a numeric comparison (and an optional increment/decrement in
+ * front of it) into a control flow statement.
+ * @param branch      The IF/WHILE/DO WHILE code entry reading the result of the
+ *                    comparison.
+ * @param compareLink Reference to the pointer to the comparison entry.<BR>
+ *                    The comparison is removed from its code list when fused.
+ * @param stepLink    Reference to the pointer to the entry in front of the
+ *                    comparison (<code>null</code> if not existing).<BR>
+ *                    The entry is removed from its code list when fused.
+ * @return <code>1</code> if the comparison has been fused.<BR>
+ *         <code>0</code> otherwise.
+ */
+int fuseCondition(codeEntry* branch, codeEntry** compareLink,
+                  codeEntry** stepLink);
+
+/**
+ * This replaces counted WHILE loops by closed-form updates of their induction
+ * variables.<BR>
+ * A loop qualifies if its condition compares an induction variable (an
+ * INTEGER variable increased by a constant step in every iteration) with a
+ * constant, the start value of the variable is known from the preceding code
+ * and the body contains straight-line code only, in which every other
+ * variable that is read before being written is either loop invariant or an
+ * induction variable as well. The number of iterations is calculated at
+ * compile time and the loop becomes:<BR>
+ * <code>V := V + (n - 1) * step (for every induction variable V); cond;
+ * body; cond</code><BR>
+ * So only the last iteration is executed, which writes all variables in the
+ * same order and with the same final values as the complete loop.<BR>
+ * Nested code lists are processed recursively (inner loops first).
+ * @param list  Reference to the pointer to the first entry of the code list.
+ *              <BR>The pointer is updated if the first entry is replaced.
+ * @param state The variables written and known in front of the code list.
+ *              <BR>The state is updated for the complete code list.
+ * @return The number of replaced loops.
+ */
+int replaceInductionLoops(codeEntry** list, loopState* state);
+
+/**
+ * This replaces a single WHILE loop by closed-form updates of its induction
+ * variables if possible (see replaceInductionLoops).
+ * @param markerLink Reference to the pointer to the WHILE marker.<BR>
+ *                   The pointer is set to the first entry of the replacement.
+ * @param loop       The WHILE code entry.
+ * @param state      The variables written and known in front of the loop.
+ * @return <code>1</code> if the loop has been replaced.<BR>
+ *         <code>0</code> otherwise (the code is not changed).
+ */
+int replaceInductionLoop(codeEntry** markerLink, codeEntry* loop,
+                         loopState* state);
+
+/**
+ * This calculates the value written by a straight-line code entry within one
+ * loop iteration as affine function of the values at the start of the
+ * iteration (see replaceInductionLoop).
+ * @param entry  The code entry.
+ * @param values The values of the variables already written within the
+ *               iteration (updated).
+ * @param flags  The flags of the variables (updated).
+ * @param phase  <code>2</code> for the condition, <code>4</code> for the body.
+ * @param state  The variables known in front of the loop.
+ * @return <code>1</code> if the entry can be executed once instead of in every
+ *         iteration.<BR>
+ *         <code>0</code> otherwise (e.g. a division which might fail in an
+ *         earlier iteration).
+ */
+int evaluateAffineEntry(codeEntry* entry, affineValue* values, char* flags,
+                        int phase, loopState* state);
+
+/**
+ * This determines the value of a variable within a loop iteration as affine
+ * function of the values at the start of the iteration (see
+ * replaceInductionLoop).
+ * @param symbol The variable.
+ * @param values The values of the variables already written within the
+ *               iteration.
+ * @param flags  The flags of the variables (the start value of the variable
+ *               is marked as read if used).
+ * @param state  The variables known in front of the loop.
+ * @return The value (<code>affine</code> is <code>0</code> if the value is no
+ *         affine INTEGER function).
+ */
+affineValue readAffineValue(symbolTableEntry* symbol, affineValue* values,
+                            char* flags, loopState* state);
+
+/**
+ * Calculates the number of iterations of a loop with the condition
+ * <code>X COMPARE BOUND</code>, where X starts at START and is increased by
+ * STEP in every iteration.
+ * @param compare The numeric comparison.
+ * @param start   The value of X in front of the first iteration.
+ * @param step    The increase of X per iteration.
+ * @param bound   The constant bound.
+ * @return The number of iterations.<BR>
+ *         <code>-1</code> if the loop does not end before X overflows.
+ */
+long long countLoopIterations(operation compare, long long start,
+                              long long step, long long bound);
+
+/**
+ * This updates the written and known variables for a straight-line code
+ * entry (see replaceInductionLoops).
+ * @param entry The code entry.
+ * @param state The state in front of the entry (updated).
+ */
+void trackKnownValue(codeEntry* entry, loopState* state);
+
+/**
+ * This marks all variables written by a part of a code list (including
+ * nested code lists) as unknown.
+ * @param list  The first entry.
+ * @param end   The entry behind the last entry (<code>null</code> for the
+ *              complete code list).
+ * @param state The state to be updated.
+ */
+void forgetWrittenValues(codeEntry* list, codeEntry* end, loopState* state);
+
+/**
+ * This creates the state of replaceInductionLoops for a code list.
+ * @param parent The state in front of the code list (<code>null</code> for
+ *               the program): the written variables are inherited, but no
+ *               values are known.
+ * @return The new state (to be freed by freeLoopState).
+ */
+loopState* createLoopState(loopState* parent);
+
+/**
+ * This frees a state created by createLoopState.
+ * @param state The state.
+ */
+void freeLoopState(loopState* state);
+
+/**
+ * This executes the whole program at compile time (by the image executor)
+ * and replaces the intermediate code by its outcome: one constant for every
+ * written variable in the order of the first writes (so the variable table
+ * stays the same) and the program result.<BR>
+ * The code is kept if the program declares inputs, does not finish within the
+ * budget, divides an INTEGER by zero (or overflows) or calculates a REAL value
+ * which has no exact FLOAT constant.
+ * @param budget Maximum number of executed instructions.
+ * @return <code>1</code> if the code has been replaced.<BR>
+ *         <code>0</code> otherwise.
+ */
+int evaluateProgram(long budget);
+
+/**
+ * This appends the assignment of a constant value to a variable to the
+ * program flow (see evaluateProgram).
+ * @param symbol The variable.
+ * @param value  The value (of the data type of the variable).
+ */
+void appendEvaluatedValue(symbolTableEntry* symbol, imageValue value);
+
+#endif /*OPTIMIZER_H_*/
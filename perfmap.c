@@ -0,0 +1,237 @@
+/**
+ * @file perfmap.c
+ * @brief This contains all function implementations for describing native code
+ *        generated at runtime to the Linux <code>perf</code> profiler (perf map
+ *        and jitdump files).
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef __linux__
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#include "perfmap.h"
+
+/**
+ * Variable to select the output for the perf profiler.<BR>
+ * [defined in file compiler.c]
+ */
+extern int perfMap;
+
+/**
+ * The perf map file (<code>null</code> until the first entry is written).
+ */
+FILE *perfMapFile = 0;
+
+/**
+ * The jitdump file (<code>null</code> if not opened).
+ */
+FILE *jitDumpFile = 0;
+
+/**
+ * Address of the memory mapping of the jitdump file.
+ */
+void* jitDumpMapping = 0;
+
+/**
+ * Number of code load records written to the jitdump file.
+ */
+unsigned long long jitDumpIndex = 0;
+
+/**
+ * Name of the compiled program (empty until determined).
+ */
+char programName[256] = "";
+
+/**
+ * This announces a block of native code generated at runtime.<BR>
+ * An entry <code>START SIZE NAME</code> is appended to the file
+ * <code>/tmp/perf-PID.map</code> which <code>perf report</code> uses to name
+ * addresses within anonymous memory. In jitdump mode a code load record
+ * (including a copy of the code) is also written to
+ * <code>/tmp/jit-PID.dump</code> for <code>perf inject --jit</code>.
+ * @param start Address of the first byte of the code.
+ * @param size  Size of the code in bytes.
+ * @param name  Name of the code block.
+ */
+void writePerfMapEntry(void* start, unsigned long size, char* name)
+{
+#ifdef __linux__
+    if (!perfMap || (size == 0))
+    {
+        return;
+    }
+
+    if (perfMapFile == 0)
+    {
+        char path[64];
+        sprintf(path, "/tmp/perf-%d.map", (int)getpid());
+        perfMapFile = fopen(path, "a");
+        if (perfMapFile == 0)
+        {
+            fprintf(stderr, "Error while creating the perf map %s\n", path);
+            perfMap = 0;
+            return;
+        }
+        if (perfMap == 2)
+        {
+            openJitDump();
+        }
+    }
+
+    fprintf(perfMapFile, "%lx %lx %s\n", (unsigned long)start, size, name);
+    fflush(perfMapFile);
+
+    if (jitDumpFile != 0)
+    {
+        // Record header (id 0 = JIT_CODE_LOAD, size, timestamp), followed by
+        // pid, tid, vma, code address, code size, code index, name and code
+        unsigned int header[2];
+        unsigned int ids[2];
+        unsigned long long values[5];
+        header[0] = 0;
+        header[1] = 16 + 40 + strlen(name) + 1 + size;
+        ids[0] = (unsigned int)getpid();
+        ids[1] = (unsigned int)syscall(SYS_gettid);
+        values[0] = getJitDumpTime();
+        values[1] = (unsigned long long)(unsigned long)start;
+        values[2] = values[1];
+        values[3] = size;
+        values[4] = jitDumpIndex++;
+        fwrite(header, sizeof(header), 1, jitDumpFile);
+        fwrite(values, sizeof(values[0]), 1, jitDumpFile);
+        fwrite(ids, sizeof(ids), 1, jitDumpFile);
+        fwrite(values + 1, sizeof(values[0]), 4, jitDumpFile);
+        fwrite(name, strlen(name) + 1, 1, jitDumpFile);
+        fwrite(start, size, 1, jitDumpFile);
+        fflush(jitDumpFile);
+    }
+#endif
+}
+
+/**
+ * This creates the jitdump file and writes its header.<BR>
+ * The file is mapped into memory as executable, as <code>perf record</code>
+ * detects jitdump files by this mapping.
+ * @return <code>1</code> if the file has been created.<BR>
+ *         <code>0</code> otherwise.
+ */
+int openJitDump()
+{
+#ifdef __linux__
+    char path[64];
+    sprintf(path, "/tmp/jit-%d.dump", (int)getpid());
+    jitDumpFile = fopen(path, "w+");
+    if (jitDumpFile == 0)
+    {
+        fprintf(stderr, "Error while creating the jitdump file %s\n", path);
+        return 0;
+    }
+
+    // Header: magic "JiTD", version, header size, ELF machine (x86-64), pad,
+    // pid, timestamp and flags
+    unsigned int header[6];
+    unsigned long long values[2];
+    header[0] = 0x4A695444;
+    header[1] = 1;
+    header[2] = 40;
+    header[3] = 62;
+    header[4] = 0;
+    header[5] = (unsigned int)getpid();
+    values[0] = getJitDumpTime();
+    values[1] = 0;
+    fwrite(header, sizeof(header), 1, jitDumpFile);
+    fwrite(values, sizeof(values), 1, jitDumpFile);
+    fflush(jitDumpFile);
+
+    jitDumpMapping = mmap(0, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC,
+                          MAP_PRIVATE, fileno(jitDumpFile), 0);
+    if (jitDumpMapping == MAP_FAILED)
+    {
+        jitDumpMapping = 0;
+    }
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * This closes the perf map and the jitdump file (if opened).
+ */
+void closePerfMap()
+{
+#ifdef __linux__
+    if (jitDumpFile != 0)
+    {
+        // Record header only (id 3 = JIT_CODE_CLOSE)
+        unsigned int header[2];
+        unsigned long long timestamp = getJitDumpTime();
+        header[0] = 3;
+        header[1] = 16;
+        fwrite(header, sizeof(header), 1, jitDumpFile);
+        fwrite(&timestamp, sizeof(timestamp), 1, jitDumpFile);
+        if (jitDumpMapping != 0)
+        {
+            munmap(jitDumpMapping, sysconf(_SC_PAGESIZE));
+            jitDumpMapping = 0;
+        }
+        fclose(jitDumpFile);
+        jitDumpFile = 0;
+    }
+#endif
+    if (perfMapFile != 0)
+    {
+        fclose(perfMapFile);
+        perfMapFile = 0;
+    }
+}
+
+/**
+ * Determines the name of the compiled program, which is the file name of the
+ * source code redirected to STDIN (<code>stdin</code> if it is unknown).
+ * @return The program name.
+ */
+char* getProgramName()
+{
+    if (programName[0] != 0)
+    {
+        return programName;
+    }
+
+    strcpy(programName, "stdin");
+#ifdef __linux__
+    char path[4096];
+    int length = readlink("/proc/self/fd/0", path, sizeof(path) - 1);
+    if ((length > 0) && (path[0] == '/'))
+    {
+        path[length] = 0;
+        char* name = strrchr(path, '/') + 1;
+        if (*name != 0)
+        {
+            strncpy(programName, name, sizeof(programName) - 1);
+        }
+    }
+#endif
+    return programName;
+}
+
+/**
+ * Determines the current time as used for jitdump records
+ * (<code>CLOCK_MONOTONIC</code>, see <code>perf record -k mono</code>).
+ * @return The time in nanoseconds.
+ */
+unsigned long long getJitDumpTime()
+{
+#ifdef __linux__
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+#else
+    return 0;
+#endif
+}
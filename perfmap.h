@@ -0,0 +1,55 @@
+/**
+ * @file perfmap.h
+ * @brief This defines all functions for describing native code generated at
+ *        runtime to the Linux <code>perf</code> profiler (perf map and
+ *        jitdump files).
+ */
+
+#include "compiler.h"
+#include <stdio.h>
+
+#ifndef PERFMAP_H_
+#define PERFMAP_H_
+
+/**
+ * This announces a block of native code generated at runtime.<BR>
+ * An entry <code>START SIZE NAME</code> is appended to the file
+ * <code>/tmp/perf-PID.map</code> which <code>perf report</code> uses to name
+ * addresses within anonymous memory. In jitdump mode a code load record
+ * (including a copy of the code) is also written to
+ * <code>/tmp/jit-PID.dump</code> for <code>perf inject --jit</code>.
+ * @param start Address of the first byte of the code.
+ * @param size  Size of the code in bytes.
+ * @param name  Name of the code block.
+ */
+void writePerfMapEntry(void* start, unsigned long size, char* name);
+
+/**
+ * This creates the jitdump file and writes its header.<BR>
+ * The file is mapped into memory as executable, as <code>perf record</code>
+ * detects jitdump files by this mapping.
+ * @return <code>1</code> if the file has been created.<BR>
+ *         <code>0</code> otherwise.
+ */
+int openJitDump();
+
+/**
+ * This closes the perf map and the jitdump file (if opened).
+ */
+void closePerfMap();
+
+/**
+ * Determines the name of the compiled program, which is the file name of the
+ * source code redirected to STDIN (<code>stdin</code> if it is unknown).
+ * @return The program name.
+ */
+char* getProgramName();
+
+/**
+ * Determines the current time as used for jitdump records
+ * (<code>CLOCK_MONOTONIC</code>, see <code>perf record -k mono</code>).
+ * @return The time in nanoseconds.
+ */
+unsigned long long getJitDumpTime();
+
+#endif /*PERFMAP_H_*/
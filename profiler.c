@@ -0,0 +1,375 @@
+/**
+ * @file profiler.c
+ * @brief This contains all function implementations for profiling the code
+ *        execution.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "profiler.h"
+#include "interpreter.h"
+#include "generator.h"
+#include "symboltable.h"
+#include "compiler.h"
+#include "context.h"
+
+/**
+ * Determines the current time for profiling purposes.
+ * @return Monotonic time in seconds.
+ */
+double getProfileTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * This executes a single code statement (including nested sub-code) and
+ * collects the number of executions and the execution time within the code
+ * entry.<BR>
+ * The time spent in nested sub-code is accounted separately, so that the self
+ * time of all entries adds up to the total execution time.
+ * @param iterator The code entry which shall be executed.
+ * @param f        Reference to the file for storing the execution output.
+ * @param indent   Current indentation to visualize nesting within the execution
+ *                 output.
+ */
+void profileCodeEntry(codeEntry* iterator, FILE *f, char* indent)
+{
+    // Keep the time of nested sub-code which has been measured for the parent
+    double parentChildTime = compilation->profileChildTime;
+    compilation->profileChildTime = 0;
+    
+    double start = getProfileTime();
+    executeCodeEntry(iterator, f, indent);
+    double elapsed = getProfileTime() - start;
+    
+    iterator->profileHits++;
+    iterator->profileTime += elapsed;
+    iterator->profileSelfTime += elapsed - compilation->profileChildTime;
+    
+    compilation->profileChildTime = parentChildTime + elapsed;
+}
+
+/**
+ * This writes the collected profile into a text file called
+ * <code>5_profile</code> and into a file called
+ * <code>5_profile.folded</code>.<BR>
+ * The text file contains the annotated source listing (hits and percentage of
+ * execution time per source line) followed by the profile per intermediate
+ * code entry.<BR>
+ * The folded file contains one line per call stack of nested if/while
+ * structures with the execution time in nanoseconds. It can be used as input
+ * for flame graph tools.
+ * @param source The source code of the program.<BR>
+ *               If set to <code>null</code>, the listing contains no source
+ *               text.
+ */
+void printProfile(char* source)
+{
+    // Split the source code into lines
+    int sourceLineCount = 0;
+    char** sourceLines = 0;
+    if (source != 0)
+    {
+        char* copy = strdup(source);
+        char* position = copy;
+        int size = 16;
+        sourceLines = (char**)malloc(sizeof(char*) * size);
+        while (*position != 0)
+        {
+            if (sourceLineCount == size)
+            {
+                size *= 2;
+                sourceLines = (char**)realloc(sourceLines,
+                                              sizeof(char*) * size);
+            }
+            sourceLines[sourceLineCount++] = position;
+            position = strchr(position, '\n');
+            if (position == 0)
+            {
+                break;
+            }
+            *position++ = 0;
+        }
+    }
+    
+    int lineCount = getMaxSourceLine(compilation->codeList);
+    if (sourceLineCount > lineCount)
+    {
+        lineCount = sourceLineCount;
+    }
+    
+    long* lineHits = (long*)calloc(lineCount + 1, sizeof(long));
+    double* lineTime = (double*)calloc(lineCount + 1, sizeof(double));
+    double totalTime = collectLineProfile(compilation->codeList, lineHits,
+                                          lineTime);
+    if (totalTime <= 0)
+    {
+        totalTime = 1;
+    }
+    
+    // Annotated source listing
+    FILE *f = fopen("5_profile", "w");
+    fprintf(f, "== PROFILE ==\n");
+    fprintf(f, " Line\tHits\tTime\tSource\n");
+    int i;
+    for (i = 1; i <= lineCount; i++)
+    {
+        fprintf(f, " %d\t%ld\t%6.2f%%\t%s\n", i, lineHits[i],
+                100 * lineTime[i] / totalTime,
+                (i <= sourceLineCount) ? sourceLines[i - 1] : "");
+    }
+    fprintf(f, "== PROFILE ==\n");
+    
+    // Profile per intermediate code entry
+    fprintf(f, "== INSTRUCTION PROFILE ==\n");
+    fprintf(f, " Line\tHits\tSelf\tTotal [ms]\tInstruction\n");
+    printInstructionProfile(f, compilation->codeList, totalTime, "");
+    fprintf(f, "== INSTRUCTION PROFILE ==\n");
+    fclose(f);
+    
+    // Folded call stacks for flame graphs
+    f = fopen("5_profile.folded", "w");
+    printFoldedStacks(f, compilation->codeList, "program");
+    fclose(f);
+    
+    free(lineHits);
+    free(lineTime);
+}
+
+/**
+ * This sums up the profile of a code list per source line.<BR>
+ * Nested code lists are processed recursively.
+ * @param iterator The first entry of the code list.
+ * @param lineHits Number of executions per source line (indexed by line).
+ * @param lineTime Execution time per source line (indexed by line).
+ * @return The total self time of all processed entries.
+ */
+double collectLineProfile(codeEntry* iterator, long* lineHits,
+                          double* lineTime)
+{
+    double totalTime = 0;
+    
+    while (iterator != 0)
+    {
+        // Place holders are no statements of their own
+        if (iterator->op != OP_NOP)
+        {
+            lineHits[iterator->sourceLine] += iterator->profileHits;
+        }
+        lineTime[iterator->sourceLine] += iterator->profileSelfTime;
+        totalTime += iterator->profileSelfTime;
+        
+        if (iterator->sub_1 != 0)
+        {
+            totalTime += collectLineProfile(iterator->sub_1, lineHits,
+                                            lineTime);
+        }
+        if (iterator->sub_2 != 0)
+        {
+            totalTime += collectLineProfile(iterator->sub_2, lineHits,
+                                            lineTime);
+        }
+        iterator = iterator->next;
+    }
+    
+    return totalTime;
+}
+
+/**
+ * Determines the highest source line number within a code list.<BR>
+ * Nested code lists are processed recursively.
+ * @param iterator The first entry of the code list.
+ * @return The highest source line number.
+ */
+int getMaxSourceLine(codeEntry* iterator)
+{
+    int maxLine = 0;
+    
+    while (iterator != 0)
+    {
+        if (iterator->sourceLine > maxLine)
+        {
+            maxLine = iterator->sourceLine;
+        }
+        
+        int subLine = 0;
+        if (iterator->sub_1 != 0)
+        {
+            subLine = getMaxSourceLine(iterator->sub_1);
+        }
+        if (subLine > maxLine)
+        {
+            maxLine = subLine;
+        }
+        if (iterator->sub_2 != 0)
+        {
+            subLine = getMaxSourceLine(iterator->sub_2);
+        }
+        if (subLine > maxLine)
+        {
+            maxLine = subLine;
+        }
+        iterator = iterator->next;
+    }
+    
+    return maxLine;
+}
+
+/**
+ * This writes the profile of all entries of a code list.<BR>
+ * Nested code lists are processed recursively.
+ * @param f         Reference to the profile file.
+ * @param iterator  The first entry of the code list.
+ * @param totalTime The total execution time.
+ * @param indent    Current indentation to visualize nesting.
+ */
+void printInstructionProfile(FILE *f, codeEntry* iterator, double totalTime,
+                             char* indent)
+{
+    char* sub_indent = (char*)malloc(sizeof(char) * (strlen(indent) + 3));
+    sprintf(sub_indent, "%s  ", indent);
+    
+    while (iterator != 0)
+    {
+        if (iterator->op != OP_NOP)
+        {
+            fprintf(f, " %d\t%ld\t%6.2f%%\t%.3f\t\t%s%s", iterator->sourceLine,
+                    iterator->profileHits,
+                    100 * iterator->profileSelfTime / totalTime,
+                    iterator->profileTime * 1000, indent,
+                    getOperationName(iterator->op));
+            if (iterator->target != 0)
+            {
+                fprintf(f, " %s", iterator->target->name);
+            }
+            if (iterator->operand1 != 0)
+            {
+                fprintf(f, " %s", iterator->operand1->name);
+            }
+            if (iterator->operand2 != 0)
+            {
+                fprintf(f, " %s", iterator->operand2->name);
+            }
+            fprintf(f, "\n");
+        }
+        
+        if (iterator->sub_1 != 0)
+        {
+            printInstructionProfile(f, iterator->sub_1, totalTime, sub_indent);
+        }
+        if (iterator->sub_2 != 0)
+        {
+            fprintf(f, " %d\t\t\t\t\t%sELSE\n", iterator->sourceLine, indent);
+            printInstructionProfile(f, iterator->sub_2, totalTime, sub_indent);
+        }
+        iterator = iterator->next;
+    }
+    
+    free(sub_indent);
+}
+
+/**
+ * Determines the frame name of a code entry for folded call stacks.
+ * @param iterator The code entry.
+ * @return The frame name (e.g. <code>WHILE line 6</code>).
+ */
+char* getFrameName(codeEntry* iterator)
+{
+    char* name = (char*)malloc(sizeof(char) * 30);
+    
+    switch (iterator->op)
+    {
+        case OP_IF:
+        case OP_IF_COMPARE:
+            sprintf(name, "IF line %d", iterator->sourceLine);
+            break;
+        case OP_WHILE:
+        case OP_WHILE_COMPARE:
+            sprintf(name, "WHILE line %d", iterator->sourceLine);
+            break;
+        case OP_DO_WHILE:
+        case OP_DO_WHILE_COMPARE:
+            sprintf(name, "DO WHILE line %d", iterator->sourceLine);
+            break;
+        default:
+            sprintf(name, "line %d", iterator->sourceLine);
+    }
+    
+    return name;
+}
+
+/**
+ * This writes the folded call stacks of all entries of a code list.<BR>
+ * Nested code lists are processed recursively. Entries with the same call
+ * stack are combined.
+ * @param f        Reference to the folded stack file.
+ * @param iterator The first entry of the code list.
+ * @param stack    The call stack of the enclosing structure.
+ */
+void printFoldedStacks(FILE *f, codeEntry* iterator, char* stack)
+{
+    char* lastFrame = 0;
+    long lastTime = 0;
+    
+    while (iterator != 0)
+    {
+        char* frame = getFrameName(iterator);
+        long time = (long)(iterator->profileSelfTime * 1e9);
+        
+        // Combine consecutive entries from the same source line
+        if ((lastFrame != 0) && (strcmp(lastFrame, frame) == 0))
+        {
+            lastTime += time;
+            free(frame);
+        }
+        else
+        {
+            if ((lastFrame != 0) && (lastTime > 0))
+            {
+                fprintf(f, "%s;%s %ld\n", stack, lastFrame, lastTime);
+            }
+            free(lastFrame);
+            lastFrame = frame;
+            lastTime = time;
+        }
+        
+        if ((iterator->sub_1 != 0) || (iterator->sub_2 != 0))
+        {
+            // Print the pending frame before the nested frames
+            if (lastTime > 0)
+            {
+                fprintf(f, "%s;%s %ld\n", stack, lastFrame, lastTime);
+            }
+            lastTime = 0;
+            
+            char* subStack = (char*)malloc(sizeof(char) *
+                                           (strlen(stack) + 32));
+            sprintf(subStack, "%s;%s", stack, lastFrame);
+            if (iterator->sub_1 != 0)
+            {
+                printFoldedStacks(f, iterator->sub_1, subStack);
+            }
+            if (iterator->sub_2 != 0)
+            {
+                printFoldedStacks(f, iterator->sub_2, subStack);
+            }
+            free(subStack);
+            
+            // A following entry must not be combined with the structure
+            free(lastFrame);
+            lastFrame = 0;
+        }
+        iterator = iterator->next;
+    }
+    
+    if ((lastFrame != 0) && (lastTime > 0))
+    {
+        fprintf(f, "%s;%s %ld\n", stack, lastFrame, lastTime);
+    }
+    free(lastFrame);
+}
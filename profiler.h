@@ -0,0 +1,96 @@
+/**
+ * @file profiler.h
+ * @brief This defines all functions for profiling the code execution.
+ */
+
+#include "generator.h"
+#include "symboltable.h"
+#include "compiler.h"
+#include <stdio.h>
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+/**
+ * Determines the current time for profiling purposes.
+ * @return Monotonic time in seconds.
+ */
+double getProfileTime();
+
+/**
+ * This executes a single code statement (including nested sub-code) and
+ * collects the number of executions and the execution time within the code
+ * entry.<BR>
+ * The time spent in nested sub-code is accounted separately, so that the self
+ * time of all entries adds up to the total execution time.
+ * @param iterator The code entry which shall be executed.
+ * @param f        Reference to the file for storing the execution output.
+ * @param indent   Current indentation to visualize nesting within the execution
+ *                 output.
+ */
+void profileCodeEntry(codeEntry* iterator, FILE *f, char* indent);
+
+/**
+ * This writes the collected profile into a text file called
+ * <code>5_profile</code> and into a file called
+ * <code>5_profile.folded</code>.<BR>
+ * The text file contains the annotated source listing (hits and percentage of
+ * execution time per source line) followed by the profile per intermediate
+ * code entry.<BR>
+ * The folded file contains one line per call stack of nested if/while
+ * structures with the execution time in nanoseconds. It can be used as input
+ * for flame graph tools.
+ * @param source The source code of the program.<BR>
+ *               If set to <code>null</code>, the listing contains no source
+ *               text.
+ */
+void printProfile(char* source);
+
+/**
+ * This sums up the profile of a code list per source line.<BR>
+ * Nested code lists are processed recursively.
+ * @param iterator The first entry of the code list.
+ * @param lineHits Number of executions per source line (indexed by line).
+ * @param lineTime Execution time per source line (indexed by line).
+ * @return The total self time of all processed entries.
+ */
+double collectLineProfile(codeEntry* iterator, long* lineHits,
+                          double* lineTime);
+
+/**
+ * Determines the highest source line number within a code list.<BR>
+ * Nested code lists are processed recursively.
+ * @param iterator The first entry of the code list.
+ * @return The highest source line number.
+ */
+int getMaxSourceLine(codeEntry* iterator);
+
+/**
+ * This writes the profile of all entries of a code list.<BR>
+ * Nested code lists are processed recursively.
+ * @param f         Reference to the profile file.
+ * @param iterator  The first entry of the code list.
+ * @param totalTime The total execution time.
+ * @param indent    Current indentation to visualize nesting.
+ */
+void printInstructionProfile(FILE *f, codeEntry* iterator, double totalTime,
+                             char* indent);
+
+/**
+ * Determines the frame name of a code entry for folded call stacks.
+ * @param iterator The code entry.
+ * @return The frame name (e.g. <code>WHILE line 6</code>).
+ */
+char* getFrameName(codeEntry* iterator);
+
+/**
+ * This writes the folded call stacks of all entries of a code list.<BR>
+ * Nested code lists are processed recursively. Entries with the same call
+ * stack are combined.
+ * @param f        Reference to the folded stack file.
+ * @param iterator The first entry of the code list.
+ * @param stack    The call stack of the enclosing structure.
+ */
+void printFoldedStacks(FILE *f, codeEntry* iterator, char* stack);
+
+#endif /*PROFILER_H_*/
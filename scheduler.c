@@ -0,0 +1,178 @@
+/**
+ * @file scheduler.c
+ * @brief This contains all function implementations for the time-sliced
+ *        execution of many programs.
+ */
+
+#include <stdlib.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "scheduler.h"
+
+/**
+ * This creates a scheduler and starts its threads.
+ * @param threads Number of threads (<code>0</code> uses one thread per
+ *                processor).
+ * @param quantum Number of instructions of a time slice (<code>0</code> uses
+ *                SCHEDULER_QUANTUM).
+ * @return The new scheduler.
+ */
+scheduler* createScheduler(int threads, long quantum)
+{
+    if (threads <= 0)
+    {
+#ifndef _WIN32
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        if (threads <= 0)
+        {
+            threads = 4;
+        }
+    }
+
+    scheduler* pool = (scheduler*)calloc(1, sizeof(scheduler));
+    pool->quantum = (quantum > 0) ? quantum : SCHEDULER_QUANTUM;
+    pool->threads = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    pthread_mutex_init(&pool->lock, 0);
+    pthread_cond_init(&pool->ready, 0);
+    pthread_cond_init(&pool->done, 0);
+
+    int i;
+    for (i = 0; i < threads; i++)
+    {
+        if (pthread_create(&pool->threads[pool->threadCount], 0,
+                           runSchedulerThread, pool) == 0)
+        {
+            pool->threadCount++;
+        }
+    }
+    return pool;
+}
+
+/**
+ * This stops the threads of a scheduler and frees it.<BR>
+ * No program may be waiting for its execution.
+ * @param pool The scheduler created by createScheduler.
+ */
+void freeScheduler(scheduler* pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stopped = 1;
+    pthread_cond_broadcast(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    int i;
+    for (i = 0; i < pool->threadCount; i++)
+    {
+        pthread_join(pool->threads[i], 0);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->ready);
+    pthread_cond_destroy(&pool->done);
+    free(pool->threads);
+    free(pool);
+}
+
+/**
+ * This executes a program by the threads of a scheduler and waits until it
+ * has finished.
+ * @param pool      The scheduler.
+ * @param execution The execution (see mathdhStart).
+ * @return The number of time slices used by the program.
+ */
+long runScheduledProgram(scheduler* pool, mathdhExecution* execution)
+{
+    scheduledProgram program;
+    program.execution = execution;
+    program.finished = 0;
+    program.slices = 0;
+    program.next = 0;
+
+    // Without threads the caller executes the program itself
+    if (pool->threadCount == 0)
+    {
+        mathdhContinue(execution, -1);
+        return 1;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->last != 0)
+    {
+        pool->last->next = &program;
+    }
+    else
+    {
+        pool->first = &program;
+    }
+    pool->last = &program;
+    pthread_cond_signal(&pool->ready);
+
+    while (!program.finished)
+    {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return program.slices;
+}
+
+/**
+ * This is the main function of a thread of the scheduler: the programs of the
+ * run queue are executed slice by slice until the scheduler is stopped.
+ * @param pool The scheduler.
+ * @return <code>null</code>.
+ */
+void* runSchedulerThread(void* pool)
+{
+    scheduler* state = (scheduler*)pool;
+    pthread_mutex_lock(&state->lock);
+    while (1)
+    {
+        while ((state->first == 0) && !state->stopped)
+        {
+            pthread_cond_wait(&state->ready, &state->lock);
+        }
+        if (state->first == 0)
+        {
+            break;
+        }
+
+        scheduledProgram* program = state->first;
+        state->first = program->next;
+        if (state->first == 0)
+        {
+            state->last = 0;
+        }
+        program->next = 0;
+        pthread_mutex_unlock(&state->lock);
+
+        int finished = mathdhContinue(program->execution, state->quantum);
+
+        pthread_mutex_lock(&state->lock);
+        program->slices++;
+        state->slices++;
+        if (finished)
+        {
+            // The waiting thread owns the program, so it must not be used
+            // after this
+            program->finished = 1;
+            pthread_cond_broadcast(&state->done);
+        }
+        else
+        {
+            // Round robin: the program waits behind all queued programs
+            state->preemptions++;
+            if (state->last != 0)
+            {
+                state->last->next = program;
+            }
+            else
+            {
+                state->first = program;
+            }
+            state->last = program;
+        }
+    }
+    pthread_mutex_unlock(&state->lock);
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file scheduler.h
+ * @brief This defines all data structures and functions for the scheduler
+ *        which executes many programs on a few threads: every thread
+ *        executes the first program of the run queue for a time slice of a
+ *        fixed number of instructions and appends it to the queue again if it
+ *        has not finished. A long running loop therefore only delays the
+ *        other programs by one slice per round.
+ */
+
+#include "mathdh.h"
+#include <pthread.h>
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+/**
+ * Default number of instructions of a time slice.
+ */
+#define SCHEDULER_QUANTUM 10000
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_scheduledProgram scheduledProgram;
+
+/**
+ * This structure defines an execution within the run queue.
+ */
+struct s_scheduledProgram
+{
+    /**
+     * The execution (see mathdhStart).
+     */
+    mathdhExecution* execution;
+
+    /**
+     * <code>1</code> when the program has finished.
+     */
+    int finished;
+
+    /**
+     * Number of time slices used by the program.
+     */
+    long slices;
+
+    /**
+     * Pointer to the next program of the run queue.
+     */
+    scheduledProgram* next;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_scheduler scheduler;
+
+/**
+ * This structure defines the state shared by all threads of the scheduler.
+ */
+struct s_scheduler
+{
+    /**
+     * Number of instructions of a time slice.
+     */
+    long quantum;
+
+    /**
+     * First program of the run queue.
+     */
+    scheduledProgram* first;
+
+    /**
+     * Last program of the run queue.
+     */
+    scheduledProgram* last;
+
+    /**
+     * The threads.
+     */
+    pthread_t* threads;
+
+    /**
+     * Number of threads.
+     */
+    int threadCount;
+
+    /**
+     * <code>1</code> when the threads shall end.
+     */
+    int stopped;
+
+    /**
+     * Number of executed time slices.
+     */
+    long slices;
+
+    /**
+     * Number of time slices after which the program had to be continued.
+     */
+    long preemptions;
+
+    /**
+     * Lock for all fields of the scheduler and of the queued programs.
+     */
+    pthread_mutex_t lock;
+
+    /**
+     * Signaled when a program has been added to the run queue.
+     */
+    pthread_cond_t ready;
+
+    /**
+     * Signaled when a program has finished.
+     */
+    pthread_cond_t done;
+};
+
+/**
+ * This creates a scheduler and starts its threads.
+ * @param threads Number of threads (<code>0</code> uses one thread per
+ *                processor).
+ * @param quantum Number of instructions of a time slice (<code>0</code> uses
+ *                SCHEDULER_QUANTUM).
+ * @return The new scheduler.
+ */
+scheduler* createScheduler(int threads, long quantum);
+
+/**
+ * This stops the threads of a scheduler and frees it.<BR>
+ * No program may be waiting for its execution.
+ * @param pool The scheduler created by createScheduler.
+ */
+void freeScheduler(scheduler* pool);
+
+/**
+ * This executes a program by the threads of a scheduler and waits until it
+ * has finished.
+ * @param pool      The scheduler.
+ * @param execution The execution (see mathdhStart).
+ * @return The number of time slices used by the program.
+ */
+long runScheduledProgram(scheduler* pool, mathdhExecution* execution);
+
+/**
+ * This is the main function of a thread of the scheduler: the programs of the
+ * run queue are executed slice by slice until the scheduler is stopped.
+ * @param pool The scheduler.
+ * @return <code>null</code>.
+ */
+void* runSchedulerThread(void* pool);
+
+#endif /*SCHEDULER_H_*/
@@ -0,0 +1,795 @@
+/**
+ * @file server.c
+ * @brief This contains all function implementations for the compile server
+ *        and its load test client (see server.h for the protocol).
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+#include "server.h"
+#include "compiler.h"
+#include "generator.h"
+#include "hotloop.h"
+#include "interpreter.h"
+#include "profiler.h"
+
+/**
+ * Variable to enable/disable the optimizer.<BR>
+ * [defined in file compiler.c]
+ */
+extern int optimize;
+
+/**
+ * Maximum number of instructions executed by a program.<BR>
+ * [defined in file compiler.c]
+ */
+extern long instructionBudget;
+
+/**
+ * Maximum execution time of a program in seconds.<BR>
+ * [defined in file compiler.c]
+ */
+extern double timeBudget;
+
+/**
+ * This is set to <code>1</code> by stopServer.
+ */
+volatile sig_atomic_t serverStopped = 0;
+
+/**
+ * This runs the compile server until it receives SIGINT or SIGTERM.<BR>
+ * The statistics of the server are printed to STDOUT afterwards.
+ * @param path    Path of the Unix domain socket (replaced if it exists).
+ * @param workers Number of threads executing programs (<code>0</code> uses
+ *                one thread per processor).
+ * @param quantum Number of instructions a program is executed before the
+ *                thread continues another program (<code>0</code> uses
+ *                SCHEDULER_QUANTUM).
+ * @return <code>0</code> on success, <code>1</code> if the socket cannot be
+ *         created.
+ */
+int runServer(char* path, int workers, long quantum)
+{
+#ifndef _WIN32
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return 1;
+    }
+    strcpy(address.sun_path, path);
+
+    compileServer* server = (compileServer*)calloc(1, sizeof(compileServer));
+    server->socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if ((server->socket < 0)
+        || (bind(server->socket, (struct sockaddr*)&address,
+                 sizeof(address)) != 0)
+        || (listen(server->socket, SERVER_QUEUE) != 0))
+    {
+        fprintf(stderr, "Failed to listen on %s: %s\n", path,
+                strerror(errno));
+        free(server);
+        return 1;
+    }
+    pthread_mutex_init(&server->lock, 0);
+    pthread_cond_init(&server->waiting, 0);
+    pthread_cond_init(&server->space, 0);
+
+    server->executor = createScheduler(workers, quantum);
+    int i;
+    for (i = 0; i < SERVER_CONNECTIONS; i++)
+    {
+        pthread_t worker;
+        if (pthread_create(&worker, 0, runServerWorker, server) == 0)
+        {
+            pthread_detach(worker);
+        }
+    }
+
+    // Without SA_RESTART the signals interrupt accept
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stopServer;
+    sigaction(SIGINT, &action, 0);
+    sigaction(SIGTERM, &action, 0);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Compile server listening on %s (%d threads, %ld instructions "
+           "per slice)\n", path, server->executor->threadCount,
+           server->executor->quantum);
+    if (instructionBudget || (timeBudget > 0))
+    {
+        printf("Programs are stopped after %ld instructions or %.3f s "
+               "(0: no limit)\n", instructionBudget, timeBudget);
+    }
+    fflush(stdout);
+
+    while (!serverStopped)
+    {
+        int client = accept(server->socket, 0, 0);
+        if (client < 0)
+        {
+            continue;
+        }
+        pthread_mutex_lock(&server->lock);
+        while (server->queueCount == SERVER_QUEUE)
+        {
+            pthread_cond_wait(&server->space, &server->lock);
+        }
+        server->queue[(server->queueStart + server->queueCount)
+                      % SERVER_QUEUE] = client;
+        server->queueCount++;
+        pthread_cond_signal(&server->waiting);
+        pthread_mutex_unlock(&server->lock);
+    }
+
+    close(server->socket);
+    unlink(path);
+
+    // Open connections are dropped when the process exits, so the programs
+    // are not freed here while threads might still use them
+    pthread_mutex_lock(&server->lock);
+    printf("== SERVER ==\n");
+    printf("Requests:  %ld\n", server->requests);
+    printf("Programs:  %d (%ld compiled, %ld reused, %ld evicted)\n",
+           server->programCount, server->misses, server->hits,
+           server->evictions);
+    pthread_mutex_lock(&server->executor->lock);
+    printf("Slices:    %ld (%ld preempted)\n", server->executor->slices,
+           server->executor->preemptions);
+    pthread_mutex_unlock(&server->executor->lock);
+    printf("== SERVER ==\n");
+    pthread_mutex_unlock(&server->lock);
+    return 0;
+#else
+    fprintf(stderr, "The compile server requires Unix domain sockets\n");
+    return 1;
+#endif
+}
+
+/**
+ * This is the signal handler for SIGINT and SIGTERM of the server.
+ * @param received The received signal (both stop the server).
+ */
+void stopServer(int received)
+{
+    (void)received;
+    serverStopped = 1;
+}
+
+/**
+ * This is the main function of a thread of the server: connections are taken
+ * from the queue and served until the client closes the connection.
+ * @param server The compileServer.
+ * @return <code>null</code>.
+ */
+void* runServerWorker(void* server)
+{
+    compileServer* state = (compileServer*)server;
+    serverConnection* connection = (serverConnection*)
+                                   malloc(sizeof(serverConnection));
+    while (1)
+    {
+        pthread_mutex_lock(&state->lock);
+        while (state->queueCount == 0)
+        {
+            pthread_cond_wait(&state->waiting, &state->lock);
+        }
+        connection->socket = state->queue[state->queueStart];
+        state->queueStart = (state->queueStart + 1) % SERVER_QUEUE;
+        state->queueCount--;
+        pthread_cond_signal(&state->space);
+        pthread_mutex_unlock(&state->lock);
+
+        connection->start = 0;
+        connection->end = 0;
+        serveConnection(state, connection);
+#ifndef _WIN32
+        close(connection->socket);
+#endif
+    }
+    return 0;
+}
+
+/**
+ * This handles all requests of a connection.
+ * @param server     The server.
+ * @param connection The connection.
+ */
+void serveConnection(compileServer* server, serverConnection* connection)
+{
+    char line[100];
+    while (readConnectionLine(connection, line, sizeof(line)))
+    {
+        char flags[20];
+        int size;
+        if ((sscanf(line, "RUN %19s %d", flags, &size) != 2) || (size < 0)
+            || (size > SERVER_SOURCE_LIMIT))
+        {
+            char* message = "ERROR 16\nInvalid request\n";
+            writeConnection(connection->socket, message, strlen(message));
+            return;
+        }
+
+        char* source = (char*)malloc(size + 1);
+        if (!readConnection(connection, source, size))
+        {
+            free(source);
+            return;
+        }
+        source[size] = 0;
+
+        char* response;
+        int length = handleRequest(server, source, flags, &response);
+        free(source);
+        int sent = writeConnection(connection->socket, response, length);
+        free(response);
+        if (!sent)
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * This executes a program for a request and creates the response.
+ * @param server    The server.
+ * @param source    The source code.
+ * @param flags     The flags of the request (see the protocol in server.h).
+ * @param response  Receives the complete response (to be freed by the
+ *                  caller).
+ * @return The size of the response in bytes.
+ */
+int handleRequest(compileServer* server, char* source, char* flags,
+                  char** response)
+{
+    serverProgram* entry = acquireProgram(server, source,
+                                          strchr(flags, 'O') != 0);
+    mathdhProgram* program = entry->program;
+
+    int count = mathdhGetVariableCount(program);
+    int errors = mathdhGetErrorCount(program);
+    int capacity = 1000;
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        capacity += strlen(mathdhGetVariableName(program, i)) + 500;
+    }
+    for (i = 0; i < errors; i++)
+    {
+        capacity += strlen(mathdhGetErrorMessage(program, i)) + 1;
+    }
+    char* body = (char*)malloc(capacity);
+    int length = 0;
+    int failed = !mathdhIsCompiled(program);
+
+    if (failed)
+    {
+        for (i = 0; i < errors; i++)
+        {
+            length += sprintf(body + length, "%s\n",
+                              mathdhGetErrorMessage(program, i));
+        }
+    }
+    else
+    {
+        // Every request has its own budget and a division fault only stops
+        // the program of the request
+        mathdhExecution* execution = mathdhStart(program);
+        mathdhSetBudget(execution, instructionBudget, timeBudget);
+        runScheduledProgram(server->executor, execution);
+        failed = (mathdhGetStopReason(execution) != MATHDH_NOT_STOPPED);
+        char value[400] = "";
+        switch (mathdhGetResultType(execution))
+        {
+            case MATHDH_INTEGER:
+                sprintf(value, "%d", mathdhGetResultInt(execution));
+                break;
+            case MATHDH_REAL:
+                sprintf(value, "%.2f", mathdhGetResultReal(execution));
+                break;
+            case MATHDH_BOOLEAN:
+                sprintf(value, "%s",
+                        getBooleanValue(mathdhGetResultBool(execution)));
+                break;
+            default:
+                break;
+        }
+        if (failed)
+        {
+            describeBudgetStop(mathdhGetStopReason(execution),
+                               mathdhGetStopLine(execution), value);
+            length += sprintf(body + length, "Execution stopped: %s\n",
+                              value);
+        }
+        else
+        {
+            length += sprintf(body + length, "PROGRAM RESULT = %s\n", value);
+        }
+
+        // Same format as 4_variabletable (in the order of the declaration,
+        // with the values at the time of a stop)
+        if (strchr(flags, 'v') != 0)
+        {
+            length += sprintf(body + length, "== VARIABLE TABLE ==\n"
+                                             " Name\tType\tValue\n");
+            for (i = 0; i < count; i++)
+            {
+                if (!mathdhIsWritten(execution, i))
+                {
+                    continue;
+                }
+                char* type;
+                switch (mathdhGetVariableType(program, i))
+                {
+                    case MATHDH_INTEGER:
+                        type = "INTEGER";
+                        sprintf(value, "%d", mathdhGetInt(execution, i));
+                        break;
+                    case MATHDH_REAL:
+                        type = "REAL";
+                        sprintf(value, "%.2f", mathdhGetReal(execution, i));
+                        break;
+                    default:
+                        type = "BOOLEAN";
+                        sprintf(value, "%s",
+                                getBooleanValue(mathdhGetBool(execution, i)));
+                        break;
+                }
+                length += sprintf(body + length, " %s\t%s\t%s\n",
+                                  mathdhGetVariableName(program, i), type,
+                                  value);
+            }
+            length += sprintf(body + length, "== VARIABLE TABLE ==\n");
+        }
+        mathdhFreeExecution(execution);
+    }
+
+    *response = (char*)malloc(length + 40);
+    int headerLength = sprintf(*response, "%s %d\n",
+                               failed ? "ERROR" : "OK", length);
+    memcpy(*response + headerLength, body, length);
+    free(body);
+    releaseProgram(server, entry);
+    return headerLength + length;
+}
+
+/**
+ * This searches a program within the programs kept by the server and
+ * compiles it if it is not found. The least recently used programs are
+ * removed if the server keeps more than SERVER_PROGRAMS programs.<BR>
+ * The program is used until it is given back by releaseProgram.
+ * @param server   The server.
+ * @param source   The source code.
+ * @param optimize <code>1</code> to optimize the program.
+ * @return The program.
+ */
+serverProgram* acquireProgram(compileServer* server, char* source,
+                              int optimize)
+{
+    char* key = (char*)malloc(strlen(source) + 20);
+    sprintf(key, "optimize %d\n%s", optimize, source);
+    unsigned long long hash = hashText(key);
+    free(key);
+
+    pthread_mutex_lock(&server->lock);
+    server->requests++;
+    serverProgram* entry;
+    for (entry = server->programs; entry != 0; entry = entry->next)
+    {
+        if ((entry->hash == hash) && (entry->optimized == optimize)
+            && (strcmp(entry->source, source) == 0))
+        {
+            entry->users++;
+            entry->lastUse = ++server->clock;
+            server->hits++;
+            pthread_mutex_unlock(&server->lock);
+            return entry;
+        }
+    }
+    pthread_mutex_unlock(&server->lock);
+
+    // Compilations of different programs run in parallel, a program
+    // requested by several connections at the same time might be compiled
+    // more than once
+    entry = (serverProgram*)calloc(1, sizeof(serverProgram));
+    entry->hash = hash;
+    entry->optimized = optimize;
+    entry->source = strdup(source);
+    entry->program = mathdhCompile(source, optimize ? MATHDH_OPTIMIZE : 0);
+    entry->users = 1;
+
+    pthread_mutex_lock(&server->lock);
+    entry->lastUse = ++server->clock;
+    entry->next = server->programs;
+    server->programs = entry;
+    server->programCount++;
+    server->misses++;
+    evictPrograms(server);
+    pthread_mutex_unlock(&server->lock);
+    return entry;
+}
+
+/**
+ * This gives back a program used by a request (see acquireProgram).
+ * @param server  The server.
+ * @param program The program.
+ */
+void releaseProgram(compileServer* server, serverProgram* program)
+{
+    pthread_mutex_lock(&server->lock);
+    program->users--;
+    evictPrograms(server);
+    pthread_mutex_unlock(&server->lock);
+}
+
+/**
+ * This removes the least recently used programs which are not used by any
+ * request until the server keeps at most SERVER_PROGRAMS programs.<BR>
+ * The lock of the server needs to be held by the caller.
+ * @param server The server.
+ */
+void evictPrograms(compileServer* server)
+{
+    while (server->programCount > SERVER_PROGRAMS)
+    {
+        serverProgram** oldest = 0;
+        serverProgram** iterator;
+        for (iterator = &server->programs; *iterator != 0;
+             iterator = &(*iterator)->next)
+        {
+            if (((*iterator)->users == 0)
+                && ((oldest == 0) || ((*iterator)->lastUse
+                                      < (*oldest)->lastUse)))
+            {
+                oldest = iterator;
+            }
+        }
+        if (oldest == 0)
+        {
+            return;
+        }
+
+        serverProgram* entry = *oldest;
+        *oldest = entry->next;
+        server->programCount--;
+        server->evictions++;
+        mathdhFreeProgram(entry->program);
+        free(entry->source);
+        free(entry);
+    }
+}
+
+/**
+ * This sends requests for a list of programs to the compile server over
+ * several connections and prints the latency percentiles and the throughput
+ * to STDOUT.
+ * @param path        Path of the Unix domain socket of the server.
+ * @param files       Names of the source files (sent round robin).
+ * @param count       Number of source files.
+ * @param connections Number of connections (<code>0</code> uses four
+ *                    connections).
+ * @return <code>0</code> if all requests succeeded, <code>1</code>
+ *         otherwise.
+ */
+int runLoadTest(char* path, char** files, int count, int connections)
+{
+    if (count == 0)
+    {
+        fprintf(stderr, "No source files given for the load test\n");
+        return 1;
+    }
+
+    loadTest test;
+    test.path = path;
+    test.count = count;
+    test.connections = (connections > 0) ? connections : 4;
+    test.requests = (char**)calloc(count, sizeof(char*));
+    test.sizes = (int*)calloc(count, sizeof(int));
+    test.responses = (char**)calloc(count, sizeof(char*));
+    test.latencies = (double*)calloc(LOADTEST_REQUESTS, sizeof(double));
+    test.failures = 0;
+    test.started = 0;
+    pthread_mutex_init(&test.lock, 0);
+
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        FILE *input = fopen(files[i], "r");
+        if (input == 0)
+        {
+            fprintf(stderr, "Cannot read %s\n", files[i]);
+            return 1;
+        }
+        char* source = readInput(input);
+        fclose(input);
+
+        int size = strlen(source);
+        test.requests[i] = (char*)malloc(size + 40);
+        test.sizes[i] = sprintf(test.requests[i], "RUN %s %d\n",
+                                optimize ? "Ov" : "v", size);
+        memcpy(test.requests[i] + test.sizes[i], source, size);
+        test.sizes[i] += size;
+        free(source);
+    }
+
+    double start = getProfileTime();
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t)
+                                            * test.connections);
+    for (i = 0; i < test.connections; i++)
+    {
+        pthread_create(&threads[i], 0, runLoadTestConnection, &test);
+    }
+    for (i = 0; i < test.connections; i++)
+    {
+        pthread_join(threads[i], 0);
+    }
+    double elapsed = getProfileTime() - start;
+
+    qsort(test.latencies, LOADTEST_REQUESTS, sizeof(double),
+          compareLatencies);
+
+    printf("== LOAD TEST ==\n");
+    for (i = 0; i < count; i++)
+    {
+        char* result = (test.responses[i] != 0)
+                       ? strstr(test.responses[i], "PROGRAM RESULT") : 0;
+        if (result != 0)
+        {
+            printf("%s: %.*s\n", files[i], (int)strcspn(result, "\n"),
+                   result);
+        }
+        else
+        {
+            printf("%s: %s", files[i], (test.responses[i] != 0)
+                   ? test.responses[i] : "no response\n");
+        }
+    }
+    printf("== LOAD TEST ==\n");
+    printf("Requests:    %d (%d failed)\n", LOADTEST_REQUESTS, test.failures);
+    printf("Connections: %d\n", test.connections);
+    printf("Time:        %.3f ms\n", elapsed * 1000);
+    if (elapsed > 0)
+    {
+        printf("Throughput:  %.1f requests/s\n", LOADTEST_REQUESTS / elapsed);
+    }
+    printf("Latency:     p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+           test.latencies[LOADTEST_REQUESTS / 2] * 1000,
+           test.latencies[LOADTEST_REQUESTS * 99 / 100] * 1000,
+           test.latencies[LOADTEST_REQUESTS - 1] * 1000);
+    printf("== LOAD TEST ==\n");
+
+    int result = (test.failures > 0);
+    for (i = 0; i < count; i++)
+    {
+        free(test.requests[i]);
+        free(test.responses[i]);
+    }
+    pthread_mutex_destroy(&test.lock);
+    free(test.requests);
+    free(test.sizes);
+    free(test.responses);
+    free(test.latencies);
+    free(threads);
+    return result;
+}
+
+/**
+ * This is the main function of a connection of the load test client.
+ * @param test The loadTest.
+ * @return <code>null</code>.
+ */
+void* runLoadTestConnection(void* test)
+{
+    loadTest* state = (loadTest*)test;
+    serverConnection* connection = (serverConnection*)
+                                   calloc(1, sizeof(serverConnection));
+    connection->socket = connectServer(state->path);
+
+    // Connection c sends the requests c, c + connections, ...
+    pthread_mutex_lock(&state->lock);
+    int number = state->started++;
+    pthread_mutex_unlock(&state->lock);
+
+    int request;
+    for (request = number; request < LOADTEST_REQUESTS;
+         request += state->connections)
+    {
+        int file = request % state->count;
+        double start = getProfileTime();
+
+        char line[100];
+        int size = 0;
+        int success = (connection->socket >= 0)
+            && writeConnection(connection->socket, state->requests[file],
+                               state->sizes[file])
+            && readConnectionLine(connection, line, sizeof(line))
+            && (sscanf(line + strcspn(line, " "), "%d", &size) == 1)
+            && (size >= 0);
+        char* response = success ? (char*)malloc(size + 1) : 0;
+        success = success && readConnection(connection, response, size);
+        state->latencies[request] = getProfileTime() - start;
+
+        if (success)
+        {
+            response[size] = 0;
+            success = (strncmp(line, "OK ", 3) == 0);
+        }
+        pthread_mutex_lock(&state->lock);
+        if (!success)
+        {
+            state->failures++;
+        }
+        if ((request < state->count) && (state->responses[file] == 0))
+        {
+            state->responses[file] = (response != 0) ? strdup(response)
+                                                     : 0;
+        }
+        pthread_mutex_unlock(&state->lock);
+        free(response);
+    }
+
+#ifndef _WIN32
+    if (connection->socket >= 0)
+    {
+        close(connection->socket);
+    }
+#endif
+    free(connection);
+    return 0;
+}
+
+/**
+ * Comparison function for sorting latencies (see <code>qsort</code>).
+ * @param first  The first latency.
+ * @param second The second latency.
+ * @return Negative, zero or positive as for <code>strcmp</code>.
+ */
+int compareLatencies(const void* first, const void* second)
+{
+    double a = *(const double*)first;
+    double b = *(const double*)second;
+    return (a > b) - (a < b);
+}
+
+/**
+ * This connects to the Unix domain socket of a compile server.
+ * @param path Path of the socket.
+ * @return The connected socket (<code>-1</code> on failure).
+ */
+int connectServer(char* path)
+{
+#ifndef _WIN32
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((client >= 0) && (connect(client, (struct sockaddr*)&address,
+                                  sizeof(address)) != 0))
+    {
+        fprintf(stderr, "Failed to connect to %s: %s\n", path,
+                strerror(errno));
+        close(client);
+        client = -1;
+    }
+    return client;
+#else
+    return -1;
+#endif
+}
+
+/**
+ * This reads a line (without the line break) from a connection.
+ * @param connection The connection.
+ * @param line       Receives the line.
+ * @param size       Size of line in bytes.
+ * @return <code>1</code> if a line has been read, <code>0</code> if the
+ *         connection has been closed or the line is too long.
+ */
+int readConnectionLine(serverConnection* connection, char* line, int size)
+{
+    int length = 0;
+    while (length < size - 1)
+    {
+        if (!readConnection(connection, line + length, 1))
+        {
+            return 0;
+        }
+        if (line[length] == '\n')
+        {
+            line[length] = 0;
+            return 1;
+        }
+        length++;
+    }
+    return 0;
+}
+
+/**
+ * This reads a given number of bytes from a connection.
+ * @param connection The connection.
+ * @param data       Receives the data.
+ * @param size       Number of bytes to be read.
+ * @return <code>1</code> if all bytes have been read, <code>0</code> if the
+ *         connection has been closed.
+ */
+int readConnection(serverConnection* connection, char* data, int size)
+{
+    while (size > 0)
+    {
+        if (connection->start == connection->end)
+        {
+#ifndef _WIN32
+            int count = read(connection->socket, connection->buffer,
+                             sizeof(connection->buffer));
+            if ((count < 0) && (errno == EINTR))
+            {
+                continue;
+            }
+#else
+            int count = 0;
+#endif
+            if (count <= 0)
+            {
+                return 0;
+            }
+            connection->start = 0;
+            connection->end = count;
+        }
+
+        int count = connection->end - connection->start;
+        if (count > size)
+        {
+            count = size;
+        }
+        memcpy(data, connection->buffer + connection->start, count);
+        connection->start += count;
+        data += count;
+        size -= count;
+    }
+    return 1;
+}
+
+/**
+ * This writes data to a socket.
+ * @param socket The socket.
+ * @param data   The data.
+ * @param size   Number of bytes to be written.
+ * @return <code>1</code> if all bytes have been written, <code>0</code>
+ *         otherwise.
+ */
+int writeConnection(int socket, char* data, int size)
+{
+#ifndef _WIN32
+    while (size > 0)
+    {
+        int count = write(socket, data, size);
+        if ((count < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            return 0;
+        }
+        data += count;
+        size -= count;
+    }
+    return 1;
+#else
+    return 0;
+#endif
+}
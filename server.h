@@ -0,0 +1,423 @@
+/**
+ * @file server.h
+ * @brief This defines all data structures and functions for the compile
+ *        server: a daemon which receives programs over a Unix domain socket,
+ *        keeps the compiled programs in memory and executes them time-sliced
+ *        by a scheduler (see scheduler.h), and the load test client for the
+ *        server.<BR>
+ *        Every request is a line <code>RUN FLAGS SIZE</code> followed by SIZE
+ *        bytes of source code. FLAGS is <code>-</code> or a combination of
+ *        <code>O</code> (optimize) and <code>v</code> (return the variable
+ *        table). Every response is a line <code>OK SIZE</code> or
+ *        <code>ERROR SIZE</code> followed by SIZE bytes of text (the program
+ *        result and the variable table or the compilation errors). A program
+ *        which exceeds the limits of the server (<code>--max-instructions
+ *        </code>, <code>--timeout</code>) or divides an INTEGER by zero is
+ *        stopped and answered by <code>ERROR</code> and the reason.
+ */
+
+#include "mathdh.h"
+#include "scheduler.h"
+#include <pthread.h>
+
+#ifndef SERVER_H_
+#define SERVER_H_
+
+/**
+ * Maximum number of compiled programs kept by the server.
+ */
+#define SERVER_PROGRAMS 256
+
+/**
+ * Number of threads serving connections. A thread waits while the scheduler
+ * executes the program of its request, so there are more of them than
+ * executing threads.
+ */
+#define SERVER_CONNECTIONS 64
+
+/**
+ * Maximum number of accepted connections waiting for a thread.
+ */
+#define SERVER_QUEUE 64
+
+/**
+ * Maximum size of the source code of a request in bytes.
+ */
+#define SERVER_SOURCE_LIMIT (16 * 1024 * 1024)
+
+/**
+ * Number of requests sent by the load test client.
+ */
+#define LOADTEST_REQUESTS 10000
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_serverConnection serverConnection;
+
+/**
+ * This structure defines a buffered connection of the server or of the load
+ * test client.
+ */
+struct s_serverConnection
+{
+    /**
+     * The connected socket.
+     */
+    int socket;
+
+    /**
+     * Received data which has not been read yet.
+     */
+    char buffer[4096];
+
+    /**
+     * Index of the first unread byte within buffer.
+     */
+    int start;
+
+    /**
+     * Index after the last received byte within buffer.
+     */
+    int end;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_serverProgram serverProgram;
+
+/**
+ * This structure defines a program kept by the server.
+ */
+struct s_serverProgram
+{
+    /**
+     * Hash of the flags and the source code.
+     */
+    unsigned long long hash;
+
+    /**
+     * <code>1</code> if the program has been optimized.
+     */
+    int optimized;
+
+    /**
+     * The source code (to detect hash collisions).
+     */
+    char* source;
+
+    /**
+     * The compiled program (or its errors).
+     */
+    mathdhProgram* program;
+
+    /**
+     * Number of requests currently executing the program (the program is not
+     * evicted while it is used).
+     */
+    int users;
+
+    /**
+     * Value of compileServer.clock at the last use (for the eviction of the
+     * least recently used program).
+     */
+    long lastUse;
+
+    /**
+     * Pointer to the next program.
+     */
+    serverProgram* next;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_compileServer compileServer;
+
+/**
+ * This structure defines the state shared by all threads of the server.
+ */
+struct s_compileServer
+{
+    /**
+     * The listening socket.
+     */
+    int socket;
+
+    /**
+     * Accepted connections waiting for a thread (ring buffer).
+     */
+    int queue[SERVER_QUEUE];
+
+    /**
+     * Index of the first waiting connection within queue.
+     */
+    int queueStart;
+
+    /**
+     * Number of waiting connections within queue.
+     */
+    int queueCount;
+
+    /**
+     * Pointer to the first program kept by the server.
+     */
+    serverProgram* programs;
+
+    /**
+     * Number of programs within programs.
+     */
+    int programCount;
+
+    /**
+     * Number of program lookups (used as time for lastUse).
+     */
+    long clock;
+
+    /**
+     * Number of handled requests.
+     */
+    long requests;
+
+    /**
+     * Number of requests for programs which had been compiled before.
+     */
+    long hits;
+
+    /**
+     * Number of compiled programs.
+     */
+    long misses;
+
+    /**
+     * Number of programs removed to stay within SERVER_PROGRAMS.
+     */
+    long evictions;
+
+    /**
+     * The scheduler executing the programs.
+     */
+    scheduler* executor;
+
+    /**
+     * Lock for all fields of the server.
+     */
+    pthread_mutex_t lock;
+
+    /**
+     * Signaled when a connection has been added to queue.
+     */
+    pthread_cond_t waiting;
+
+    /**
+     * Signaled when a connection has been removed from queue.
+     */
+    pthread_cond_t space;
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_loadTest loadTest;
+
+/**
+ * This structure defines the state shared by all connections of the load
+ * test client.
+ */
+struct s_loadTest
+{
+    /**
+     * Path of the server socket.
+     */
+    char* path;
+
+    /**
+     * Complete requests (header and source code) of all files.
+     */
+    char** requests;
+
+    /**
+     * Size of every request in bytes.
+     */
+    int* sizes;
+
+    /**
+     * Number of files.
+     */
+    int count;
+
+    /**
+     * Number of connections.
+     */
+    int connections;
+
+    /**
+     * Number of connections which have been started (used to number the
+     * connections).
+     */
+    int started;
+
+    /**
+     * Latency of every request in seconds (indexed by request number).
+     */
+    double* latencies;
+
+    /**
+     * Number of requests which failed (no response or ERROR).
+     */
+    int failures;
+
+    /**
+     * Response to the first request of every file.
+     */
+    char** responses;
+
+    /**
+     * Lock for failures and responses.
+     */
+    pthread_mutex_t lock;
+};
+
+/**
+ * This runs the compile server until it receives SIGINT or SIGTERM.<BR>
+ * The statistics of the server are printed to STDOUT afterwards.
+ * @param path    Path of the Unix domain socket (replaced if it exists).
+ * @param workers Number of threads executing programs (<code>0</code> uses
+ *                one thread per processor).
+ * @param quantum Number of instructions a program is executed before the
+ *                thread continues another program (<code>0</code> uses
+ *                SCHEDULER_QUANTUM).
+ * @return <code>0</code> on success, <code>1</code> if the socket cannot be
+ *         created.
+ */
+int runServer(char* path, int workers, long quantum);
+
+/**
+ * This is the signal handler for SIGINT and SIGTERM of the server.
+ * @param received The received signal (both stop the server).
+ */
+void stopServer(int received);
+
+/**
+ * This is the main function of a thread of the server: connections are taken
+ * from the queue and served until the client closes the connection.
+ * @param server The compileServer.
+ * @return <code>null</code>.
+ */
+void* runServerWorker(void* server);
+
+/**
+ * This handles all requests of a connection.
+ * @param server     The server.
+ * @param connection The connection.
+ */
+void serveConnection(compileServer* server, serverConnection* connection);
+
+/**
+ * This executes a program for a request and creates the response.
+ * @param server    The server.
+ * @param source    The source code.
+ * @param flags     The flags of the request (see the protocol in server.h).
+ * @param response  Receives the complete response (to be freed by the
+ *                  caller).
+ * @return The size of the response in bytes.
+ */
+int handleRequest(compileServer* server, char* source, char* flags,
+                  char** response);
+
+/**
+ * This searches a program within the programs kept by the server and
+ * compiles it if it is not found. The least recently used programs are
+ * removed if the server keeps more than SERVER_PROGRAMS programs.<BR>
+ * The program is used until it is given back by releaseProgram.
+ * @param server   The server.
+ * @param source   The source code.
+ * @param optimize <code>1</code> to optimize the program.
+ * @return The program.
+ */
+serverProgram* acquireProgram(compileServer* server, char* source,
+                              int optimize);
+
+/**
+ * This gives back a program used by a request (see acquireProgram).
+ * @param server  The server.
+ * @param program The program.
+ */
+void releaseProgram(compileServer* server, serverProgram* program);
+
+/**
+ * This removes the least recently used programs which are not used by any
+ * request until the server keeps at most SERVER_PROGRAMS programs.<BR>
+ * The lock of the server needs to be held by the caller.
+ * @param server The server.
+ */
+void evictPrograms(compileServer* server);
+
+/**
+ * This sends requests for a list of programs to the compile server over
+ * several connections and prints the latency percentiles and the throughput
+ * to STDOUT.
+ * @param path        Path of the Unix domain socket of the server.
+ * @param files       Names of the source files (sent round robin).
+ * @param count       Number of source files.
+ * @param connections Number of connections (<code>0</code> uses four
+ *                    connections).
+ * @return <code>0</code> if all requests succeeded, <code>1</code>
+ *         otherwise.
+ */
+int runLoadTest(char* path, char** files, int count, int connections);
+
+/**
+ * This is the main function of a connection of the load test client.
+ * @param test The loadTest.
+ * @return <code>null</code>.
+ */
+void* runLoadTestConnection(void* test);
+
+/**
+ * Comparison function for sorting latencies (see <code>qsort</code>).
+ * @param first  The first latency.
+ * @param second The second latency.
+ * @return Negative, zero or positive as for <code>strcmp</code>.
+ */
+int compareLatencies(const void* first, const void* second);
+
+/**
+ * This connects to the Unix domain socket of a compile server.
+ * @param path Path of the socket.
+ * @return The connected socket (<code>-1</code> on failure).
+ */
+int connectServer(char* path);
+
+/**
+ * This reads a line (without the line break) from a connection.
+ * @param connection The connection.
+ * @param line       Receives the line.
+ * @param size       Size of line in bytes.
+ * @return <code>1</code> if a line has been read, <code>0</code> if the
+ *         connection has been closed or the line is too long.
+ */
+int readConnectionLine(serverConnection* connection, char* line, int size);
+
+/**
+ * This reads a given number of bytes from a connection.
+ * @param connection The connection.
+ * @param data       Receives the data.
+ * @param size       Number of bytes to be read.
+ * @return <code>1</code> if all bytes have been read, <code>0</code> if the
+ *         connection has been closed.
+ */
+int readConnection(serverConnection* connection, char* data, int size);
+
+/**
+ * This writes data to a socket.
+ * @param socket The socket.
+ * @param data   The data.
+ * @param size   Number of bytes to be written.
+ * @return <code>1</code> if all bytes have been written, <code>0</code>
+ *         otherwise.
+ */
+int writeConnection(int socket, char* data, int size);
+
+#endif /*SERVER_H_*/
@@ -0,0 +1,439 @@
+/**
+ * @file statistics.c
+ * @brief This contains all function implementations for measuring the compiler
+ *        phases (time, hardware counters, sizes and memory usage).
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "statistics.h"
+#include "interpreter.h"
+#include "profiler.h"
+#include "context.h"
+
+/**
+ * Variable to enable/disable debug mode.<BR>
+ * [defined in file compiler.c]
+ */
+extern int debug;
+
+/**
+ * Pointer to the first measured phase.<BR>
+ * This variable is automatically initialized when starting the first phase.
+ */
+phase* phaseList = 0;
+
+/**
+ * File descriptors of the hardware performance counters (indexed by counter).
+ * <BR>
+ * All counters are opened as one group with the cycle counter as leader.
+ * Unavailable counters are set to <code>-1</code>.
+ */
+int counterFd[COUNTERS] = { -1, -1, -1, -1 };
+
+/**
+ * Determines the CPU time consumed by the process.
+ * @return CPU time in seconds.
+ */
+double getCpuTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * This opens the hardware performance counters for the process.<BR>
+ * If the counters are not supported by the system (or not permitted), the
+ * phases are measured without counters (always on Windows).
+ * @return Number of available counters.
+ */
+int openCounters()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    unsigned long long config[COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+
+    int available = 0;
+    int i;
+    for (i = 0; i < COUNTERS; i++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config[i];
+        attr.disabled = (i == 0);
+        // User space only, this works with the default paranoid level
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        int leader = (i == 0) ? -1 : counterFd[0];
+        if (i > 0 && leader == -1)
+        {
+            break;
+        }
+
+        counterFd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+        if (counterFd[i] != -1)
+        {
+            available++;
+        }
+        else if (debug)
+        {
+            printf("Hardware counter %s not available\n", getCounterName(i));
+        }
+    }
+
+    if (counterFd[0] != -1)
+    {
+        ioctl(counterFd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(counterFd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    return available;
+#endif
+}
+
+/**
+ * Reads the current values of all hardware performance counters.
+ * @param values Array receiving the counter values.<BR>
+ *               Unavailable counters are set to <code>-1</code>.
+ */
+void readCounters(long long* values)
+{
+    int i;
+    for (i = 0; i < COUNTERS; i++)
+    {
+        values[i] = -1;
+#ifndef _WIN32
+        if (counterFd[i] != -1)
+        {
+            long long value;
+            if (read(counterFd[i], &value, sizeof(value)) == sizeof(value))
+            {
+                values[i] = value;
+            }
+        }
+#endif
+    }
+}
+
+/**
+ * Determines the display name of a hardware performance counter.
+ * @param type The counter.
+ * @return The name of the counter.<BR>
+ *         If an invalid value is given, the text <code>-UNKNOWN-</code> will be
+ *         returned.
+ */
+char* getCounterName(counter type)
+{
+    switch (type)
+    {
+        case COUNTER_CYCLES:
+            return "cycles";
+        case COUNTER_INSTRUCTIONS:
+            return "instructions";
+        case COUNTER_BRANCH_MISSES:
+            return "branch-misses";
+        case COUNTER_CACHE_MISSES:
+            return "cache-misses";
+        default:
+            return "-UNKNOWN-";
+    }
+}
+
+/**
+ * This starts the measurement of a new phase and appends it to the list of
+ * phases.
+ * @param name The name of the phase.
+ * @return Pointer to the new phase.
+ */
+phase* startPhase(char* name)
+{
+    phase* newPhase = (phase*)malloc(sizeof(phase));
+    newPhase->name = name;
+    newPhase->wallTime = 0;
+    newPhase->cpuTime = 0;
+    newPhase->next = 0;
+
+    if (!phaseList)
+    {
+        phaseList = newPhase;
+    }
+    else
+    {
+        phase* iterator = phaseList;
+        while (iterator->next)
+        {
+            iterator = iterator->next;
+        }
+        iterator->next = newPhase;
+    }
+
+    // Take the start time last to keep the list handling out of the phase
+    newPhase->cpuStart = getCpuTime();
+    newPhase->wallStart = getProfileTime();
+    readCounters(newPhase->counterStart);
+    return newPhase;
+}
+
+/**
+ * This stops the measurement of a phase.
+ * @param current The phase which has been started by startPhase.
+ */
+void endPhase(phase* current)
+{
+    readCounters(current->counters);
+    current->wallTime = getProfileTime() - current->wallStart;
+    current->cpuTime = getCpuTime() - current->cpuStart;
+
+    int i;
+    for (i = 0; i < COUNTERS; i++)
+    {
+        if (current->counters[i] != -1 && current->counterStart[i] != -1)
+        {
+            current->counters[i] -= current->counterStart[i];
+        }
+        else
+        {
+            current->counters[i] = -1;
+        }
+    }
+}
+
+/**
+ * Counts all entries of a code list (including nested code lists).
+ * @param iterator The first entry of the code list.
+ * @return Number of code entries.
+ */
+int countCodeEntries(codeEntry* iterator)
+{
+    int count = 0;
+    while (iterator)
+    {
+        count += 1 + countCodeEntries(iterator->sub_1)
+                   + countCodeEntries(iterator->sub_2);
+        iterator = iterator->next;
+    }
+    return count;
+}
+
+/**
+ * Determines the peak memory usage (resident set size) of the process.
+ * @return Peak memory usage in kilobytes (<code>0</code> if not available).
+ */
+long getPeakMemory()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return usage.ru_maxrss;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * This prints the duration and the hardware performance counters of all
+ * phases, the number of symbol table operations and code generation calls,
+ * the sizes of the symbol table, the intermediate code and the variable table
+ * as well as the peak memory usage to STDOUT.
+ */
+void printStatistics()
+{
+    int symbols = 0;
+    int temporaries = 0;
+    symbolTableEntry* symbol = compilation->symbolTable;
+    while (symbol)
+    {
+        if (strncmp(symbol->name, "_H", 2) == 0)
+        {
+            temporaries++;
+        }
+        else
+        {
+            symbols++;
+        }
+        symbol = symbol->next;
+    }
+
+    int variables = 0;
+    variableTableEntry* variable = compilation->variableTable;
+    while (variable)
+    {
+        variables++;
+        variable = variable->next;
+    }
+
+    printf("== STATISTICS ==\n");
+    printf(" %-20s %12s %12s\n", "Phase", "Wall [ms]", "CPU [ms]");
+    double wallTotal = 0;
+    double cpuTotal = 0;
+    phase* iterator = phaseList;
+    while (iterator)
+    {
+        printf(" %-20s %12.3f %12.3f\n", iterator->name,
+               iterator->wallTime * 1e3, iterator->cpuTime * 1e3);
+        wallTotal += iterator->wallTime;
+        cpuTotal += iterator->cpuTime;
+        iterator = iterator->next;
+    }
+    printf(" %-20s %12.3f %12.3f\n", "Total", wallTotal * 1e3, cpuTotal * 1e3);
+    printf("\n");
+
+    // Both operations are part of the yyparse phase (and optimizeCode), their
+    // time is not measured per call as this would dominate the calls. Steps
+    // are the walked through entries (one per code generation call).
+    printf(" %-20s %12s %12s\n", "Operation", "Calls", "Steps");
+    printf(" %-20s %12ld %12ld\n", "symbol table",
+           compilation->symbolTableCalls, compilation->symbolTableSteps);
+    printf(" %-20s %12ld %12ld\n", "code generation",
+           compilation->codeGenerationCalls, compilation->codeGenerationCalls);
+    printf("\n");
+
+    if (counterFd[0] == -1)
+    {
+        printf(" Hardware counters not available\n");
+    }
+    else
+    {
+        printf(" %-20s %14s %14s %6s %14s %14s\n", "Phase", "Cycles",
+               "Instructions", "IPC", "Branch misses", "Cache misses");
+        iterator = phaseList;
+        while (iterator)
+        {
+            printf(" %-20s", iterator->name);
+            int i;
+            for (i = 0; i < COUNTERS; i++)
+            {
+                if (i == COUNTER_BRANCH_MISSES)
+                {
+                    long long cycles = iterator->counters[COUNTER_CYCLES];
+                    long long instr = iterator->counters[COUNTER_INSTRUCTIONS];
+                    if (cycles > 0 && instr != -1)
+                    {
+                        printf(" %6.2f", (double)instr / cycles);
+                    }
+                    else
+                    {
+                        printf(" %6s", "n/a");
+                    }
+                }
+                if (iterator->counters[i] != -1)
+                {
+                    printf(" %14lld", iterator->counters[i]);
+                }
+                else
+                {
+                    printf(" %14s", "n/a");
+                }
+            }
+            printf("\n");
+            iterator = iterator->next;
+        }
+    }
+    printf("\n");
+    printf(" Symbols:                %d\n", symbols);
+    printf(" Temporaries:            %d\n", temporaries);
+    printf(" Code entries:           %d\n",
+           countCodeEntries(compilation->codeList));
+    printf(" Variable table entries: %d\n", variables);
+    printf(" Executed instructions:  %ld\n", compilation->executedInstructions);
+    printf(" Peak memory:            %ld KB\n", getPeakMemory());
+    printf("== STATISTICS ==\n");
+}
+
+/**
+ * This writes the duration and the hardware performance counters of all phases
+ * in the Chrome trace event format into a file called
+ * <code>6_trace.json</code>.<BR>
+ * The file can be loaded by <code>chrome://tracing</code> or Perfetto. The
+ * sizes and the peak memory usage are stored as counter events.
+ */
+void printTrace()
+{
+    FILE *f = fopen("6_trace.json", "w");
+    if (f == NULL)
+    {
+        fprintf(stderr, "Error while opening file 6_trace.json\n");
+        return;
+    }
+
+    int symbols = 0;
+    symbolTableEntry* symbol = compilation->symbolTable;
+    while (symbol)
+    {
+        symbols++;
+        symbol = symbol->next;
+    }
+
+    int variables = 0;
+    variableTableEntry* variable = compilation->variableTable;
+    while (variable)
+    {
+        variables++;
+        variable = variable->next;
+    }
+
+    // Timestamps are given in microseconds relative to the first phase
+    double origin = phaseList ? phaseList->wallStart : 0;
+    double end = 0;
+
+    fprintf(f, "{\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+               "\"args\":{\"name\":\"compiler\"}}");
+    phase* iterator = phaseList;
+    while (iterator)
+    {
+        double start = (iterator->wallStart - origin) * 1e6;
+        fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"phase\",\"ph\":\"X\","
+                   "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1,"
+                   "\"args\":{\"cpu_us\":%.3f",
+                iterator->name, start, iterator->wallTime * 1e6,
+                iterator->cpuTime * 1e6);
+        int i;
+        for (i = 0; i < COUNTERS; i++)
+        {
+            if (iterator->counters[i] != -1)
+            {
+                fprintf(f, ",\"%s\":%lld", getCounterName(i),
+                        iterator->counters[i]);
+            }
+        }
+        fprintf(f, "}}");
+        end = start + iterator->wallTime * 1e6;
+        iterator = iterator->next;
+    }
+    fprintf(f, ",\n{\"name\":\"sizes\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,"
+               "\"args\":{\"symbols\":%d,\"code_entries\":%d,"
+               "\"variables\":%d,\"executed_instructions\":%ld}}",
+            end, symbols, countCodeEntries(compilation->codeList), variables,
+            compilation->executedInstructions);
+    fprintf(f, ",\n{\"name\":\"operations\",\"ph\":\"C\",\"ts\":%.3f,"
+               "\"pid\":1,\"args\":{\"symbol_table_calls\":%ld,"
+               "\"symbol_table_steps\":%ld,\"code_generation_calls\":%ld}}",
+            end, compilation->symbolTableCalls, compilation->symbolTableSteps,
+            compilation->codeGenerationCalls);
+    fprintf(f, ",\n{\"name\":\"memory\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,"
+               "\"args\":{\"peak_kb\":%ld}}",
+            end, getPeakMemory());
+    fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    fclose(f);
+}
@@ -0,0 +1,182 @@
+/**
+ * @file statistics.h
+ * @brief This defines all data structures and functions for measuring the
+ *        compiler phases (time, hardware counters, sizes and memory usage).
+ */
+
+#include "generator.h"
+#include "symboltable.h"
+#include "compiler.h"
+#include <stdio.h>
+
+#ifndef STATISTICS_H_
+#define STATISTICS_H_
+
+/**
+ * Type definition to simplify usage of the enumeration.
+ */
+typedef enum e_counter counter;
+
+/**
+ * This enumeration contains all hardware performance counters which are
+ * measured per phase.
+ */
+enum e_counter
+{
+    /**
+     * CPU cycles.
+     */
+    COUNTER_CYCLES,
+
+    /**
+     * Retired machine instructions.
+     */
+    COUNTER_INSTRUCTIONS,
+
+    /**
+     * Mispredicted branch instructions.
+     */
+    COUNTER_BRANCH_MISSES,
+
+    /**
+     * Cache misses (usually last level cache).
+     */
+    COUNTER_CACHE_MISSES,
+
+    /**
+     * Number of counters (not a counter itself).
+     */
+    COUNTERS
+};
+
+/**
+ * Type definition to simplify usage of the structure.
+ */
+typedef struct s_phase phase;
+
+/**
+ * This structure defines a measured phase of the compiler (e.g. parsing or
+ * execution).
+ */
+struct s_phase
+{
+    /**
+     * The name of the phase.
+     */
+    char* name;
+
+    /**
+     * Wall clock time (in seconds) when the phase has been started.
+     */
+    double wallStart;
+
+    /**
+     * Process CPU time (in seconds) when the phase has been started.
+     */
+    double cpuStart;
+
+    /**
+     * Elapsed wall clock time of the phase (in seconds).
+     */
+    double wallTime;
+
+    /**
+     * Consumed CPU time of the phase (in seconds).
+     */
+    double cpuTime;
+
+    /**
+     * Values of the hardware performance counters when the phase has been
+     * started.
+     */
+    long long counterStart[COUNTERS];
+
+    /**
+     * Hardware performance counter values of the phase (indexed by counter).
+     * <BR>
+     * Unavailable counters are set to <code>-1</code>.
+     */
+    long long counters[COUNTERS];
+
+    /**
+     * Pointer to the following phase.<BR>
+     * This is supposed to be set to <code>null</code> for the last phase.
+     */
+    phase* next;
+};
+
+/**
+ * Determines the CPU time consumed by the process.
+ * @return CPU time in seconds.
+ */
+double getCpuTime();
+
+/**
+ * This opens the hardware performance counters for the process.<BR>
+ * If the counters are not supported by the system (or not permitted), the
+ * phases are measured without counters (always on Windows).
+ * @return Number of available counters.
+ */
+int openCounters();
+
+/**
+ * Reads the current values of all hardware performance counters.
+ * @param values Array receiving the counter values.<BR>
+ *               Unavailable counters are set to <code>-1</code>.
+ */
+void readCounters(long long* values);
+
+/**
+ * Determines the display name of a hardware performance counter.
+ * @param type The counter.
+ * @return The name of the counter.<BR>
+ *         If an invalid value is given, the text <code>-UNKNOWN-</code> will be
+ *         returned.
+ */
+char* getCounterName(counter type);
+
+/**
+ * This starts the measurement of a new phase and appends it to the list of
+ * phases.
+ * @param name The name of the phase.
+ * @return Pointer to the new phase.
+ */
+phase* startPhase(char* name);
+
+/**
+ * This stops the measurement of a phase.
+ * @param current The phase which has been started by startPhase.
+ */
+void endPhase(phase* current);
+
+/**
+ * Counts all entries of a code list (including nested code lists).
+ * @param iterator The first entry of the code list.
+ * @return Number of code entries.
+ */
+int countCodeEntries(codeEntry* iterator);
+
+/**
+ * Determines the peak memory usage (resident set size) of the process.
+ * @return Peak memory usage in kilobytes (<code>0</code> if not available).
+ */
+long getPeakMemory();
+
+/**
+ * This prints the duration and the hardware performance counters of all
+ * phases, the number of symbol table operations and code generation calls,
+ * the sizes of the symbol table, the intermediate code and the variable table
+ * as well as the peak memory usage to STDOUT.
+ */
+void printStatistics();
+
+/**
+ * This writes the duration and the hardware performance counters of all phases
+ * in the Chrome trace event format into a file called
+ * <code>6_trace.json</code>.<BR>
+ * The file can be loaded by <code>chrome://tracing</code> or Perfetto. The
+ * sizes and the peak memory usage are stored as counter events.
+ */
+void printTrace();
+
+#endif /*STATISTICS_H_*/
@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "symboltable.h"
+#include "context.h"
 
 /**
  * Variable to enable/disable debug mode.<BR>
@@ -17,20 +18,6 @@
  */
 extern int debug;
 
-/**
- * Variable to track current line number.<BR>
- * [defined in file compiler.l]
- */
-extern int inputLineNumber;
-int helperCounter = 0;
-
-
-/**
- * Pointer to the first entry of the symbol table.<BR>
- * This variable is automatically initialized when adding the first entry.
- */
-symbolTableEntry* symbolTable = 0;
-
 /**
  * Determines the display name of a data type.
  * @param type input type
@@ -56,7 +43,8 @@ char* getTypeName(dataType type)
 
 /**
  * This adds a new entry to the symbol table.
- * @param name Name of the variable to be added.<BR>
+ * @param name Name of the variable to be added (allocated by malloc, the
+ *             symbol table takes it over).<BR>
  *             Note: This function does not check whether the entry is already
  *             existing within the symbol table.<BR>
  *             Prevention of duplicates need to be taken care of before calling
@@ -74,22 +62,23 @@ symbolTableEntry* addEntryToSymbolTable(char* name, dataType type, int line)
     // Validate parameter values
     if ((name == 0) || (strlen(name) == 0))
     {
-        fprintf(stderr, "Call to addEntryToSymbolTable failed: "
-                        "No variable name given.");
+        reportError("Call to addEntryToSymbolTable failed: "
+                    "No variable name given.");
+        free(name);
         return 0;
     }
     if ((type != INTEGER) && (type != REAL) && (type != BOOLEAN))
     {
-        fprintf(stderr, "Call to addEntryToSymbolTable failed: "
-                        "Invalid type given.");
+        reportError("Call to addEntryToSymbolTable failed: "
+                    "Invalid type given.");
+        free(name);
         return 0;
     }
 
     // Allocate required memory
     symbolTableEntry* newSymtabEntry = (symbolTableEntry*)
                                        malloc(sizeof(symbolTableEntry));
-    newSymtabEntry->name = (char*) malloc(strlen(name) +1);
-    strcpy(newSymtabEntry->name,name);
+    newSymtabEntry->name = name;
     newSymtabEntry->type = type;
     newSymtabEntry->line = line;
     newSymtabEntry->next = 0;
@@ -103,21 +92,26 @@ symbolTableEntry* addEntryToSymbolTable(char* name, dataType type, int line)
     }
 
     // Assign as new symbol table for 1st entry
-    if (!symbolTable)
+    if (!compilation->symbolTable)
     {
-        symbolTable = newSymtabEntry;
+        newSymtabEntry->index = 0;
+        compilation->symbolTable = newSymtabEntry;
     }
     // Add at the end otherwise
     else
     {
-        symbolTableEntry* iterator = symbolTable;
+        symbolTableEntry* iterator = compilation->symbolTable;
         while (iterator->next)
         {
             iterator = iterator->next;
         }
+        newSymtabEntry->index = iterator->index + 1;
         iterator->next = newSymtabEntry;
     }
 
+    // All existing entries have been walked through
+    compilation->symbolTableCalls++;
+    compilation->symbolTableSteps += newSymtabEntry->index;
     return newSymtabEntry;
 }
 
@@ -133,13 +127,17 @@ symbolTableEntry* addEntryToSymbolTable(char* name, dataType type, int line)
 symbolTableEntry* getEntryFromSymbolTable(char* name)
 {
     // Loop until all entries in the symbol table and check the name
-    symbolTableEntry* iterator = symbolTable;
+    symbolTableEntry* iterator = compilation->symbolTable;
+    long steps = 0;
 
     while ((iterator != 0) && (strcmp(iterator->name, name) != 0))
     {
         iterator = iterator->next;
+        steps++;
     }
 
+    compilation->symbolTableCalls++;
+    compilation->symbolTableSteps += steps;
     return iterator;
 }
 
@@ -149,7 +147,7 @@ symbolTableEntry* getEntryFromSymbolTable(char* name)
  **/
 void printSymbolTable()
 {
-  symbolTableEntry* iterator2 = symbolTable;
+  symbolTableEntry* iterator2 = compilation->symbolTable;
     printf("== Begin Symbol Table ==\n");
     if (iterator2) {
     for (;iterator2->next;iterator2=iterator2->next)
@@ -166,6 +164,6 @@ void printSymbolTable()
 char* getName()
 {
   char* number= malloc(sizeof(char)*10);
-  sprintf(number, "_H%d", helperCounter++);
+  sprintf(number, "_H%d", compilation->helperCounter++);
   return number;
 }
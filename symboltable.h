@@ -63,6 +63,13 @@ struct s_symbolTableEntry
      */
     int line;
 
+    /**
+     * Position of the entry within the symbol table (starting with
+     * <code>0</code>).<BR>
+     * This is used to assign a slot in the variable frame of native code.
+     */
+    int index;
+
     /**
      * Pointer to the following entry of the symbol table.<BR>
      * This is supposed to be set to <code>null</code> for the last entry.
@@ -82,7 +89,8 @@ char* getTypeName(dataType type);
 
 /**
  * This adds a new entry to the symbol table.
- * @param name Name of the variable to be added.<BR>
+ * @param name Name of the variable to be added (allocated by malloc, the
+ *             symbol table takes it over).<BR>
  *             Note: This function does not check whether the entry is already
  *             existing within the symbol table.<BR>
  *             Prevention of duplicates need to be taken care of before calling
@@ -4,3 +4,54 @@ echo "Run testing for specific Problems"
 for i in $(ls Sample/); \
 do echo "${i}" && bin/compiler < "Sample/${i}" && echo \
 ; done
+
+echo "Compare native code execution with the interpreter"
+
+failed=0
+for i in $(ls Sample/); \
+do rm -f 4_variabletable; \
+expected=$(bin/compiler < "Sample/${i}" 2>/dev/null; cat 4_variabletable 2>/dev/null); \
+rm -f 4_variabletable; \
+actual=$(bin/compiler -j < "Sample/${i}" 2>/dev/null; cat 4_variabletable 2>/dev/null); \
+if [ "${expected}" != "${actual}" ]; then echo "${i}: native code differs" && failed=1; fi \
+; done
+
+echo "Compare C backend executables with the interpreter"
+
+for i in $(ls Sample/); \
+do expected=$(bin/compiler < "Sample/${i}" 2>/dev/null | grep "PROGRAM RESULT"); \
+bin/compiler -c -o bin/program < "Sample/${i}" > /dev/null 2>&1 || continue; \
+actual=$(bin/program | grep "PROGRAM RESULT"); \
+if [ "${expected}" != "${actual}" ]; then echo "${i}: C backend differs" && failed=1; fi \
+; done
+
+echo "Compare assembly backend executables with the interpreter"
+
+for i in $(ls Sample/); \
+do expected=$(bin/compiler < "Sample/${i}" 2>/dev/null | grep "PROGRAM RESULT"); \
+bin/compiler -c -a bin/program < "Sample/${i}" > /dev/null 2>&1 || continue; \
+actual=$(bin/program | grep "PROGRAM RESULT"); \
+if [ "${expected}" != "${actual}" ]; then echo "${i}: assembly backend differs" && failed=1; fi \
+; done
+
+echo "Compare reads of unassigned variables in the assembly backend"
+
+printf 'int A = 8, D;\n++D;\nexit (D);\n' \
+> bin/unassigned.math
+expected=$(bin/compiler < bin/unassigned.math 2>/dev/null | grep "PROGRAM RESULT")
+bin/compiler -c -a bin/program < bin/unassigned.math > /dev/null 2>&1 \
+&& actual=$(bin/program | grep "PROGRAM RESULT") \
+&& if [ "${expected}" != "${actual}" ] || [ "${expected}" != "PROGRAM RESULT = 1" ]; \
+then echo "unassigned read: assembly backend differs" && failed=1; fi
+
+echo "Compare batch mode with the interpreter"
+
+bin/compiler --batch Sample/*.math > bin/batch.txt 2>/dev/null
+for i in $(ls Sample/); \
+do expected=$(bin/compiler < "Sample/${i}" 2>/dev/null | grep "PROGRAM RESULT"); \
+[ -z "${expected}" ] && continue; \
+actual=$(grep "^Sample/${i}: " bin/batch.txt | grep -o "PROGRAM RESULT = .*"); \
+if [ "${expected}" != "${actual}" ]; then echo "${i}: batch mode differs" && failed=1; fi \
+; done
+rm -f bin/program bin/batch.txt bin/unassigned.math
+exit ${failed}